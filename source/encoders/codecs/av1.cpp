@@ -19,6 +19,20 @@
 // SOFTWARE.
 
 #include "av1.hpp"
+#include "bitstream.hpp"
+
+extern "C" {
+#include <obs-avc.h>
+}
+
+namespace {
+	enum class frame_type : uint8_t {
+		KEY        = 0,
+		INTER      = 1,
+		INTRA_ONLY = 2,
+		SWITCH     = 3,
+	};
+} // namespace
 
 const char* streamfx::encoder::codec::av1::profile_to_string(profile p)
 {
@@ -33,3 +47,232 @@ const char* streamfx::encoder::codec::av1::profile_to_string(profile p)
 		return "Unknown";
 	}
 }
+
+bool streamfx::encoder::codec::av1::extract_sequence_header(const uint8_t* data, std::size_t sz_data,
+															 std::vector<uint8_t>& header)
+{
+	bitstream::obu_reader reader{data, sz_data};
+	for (bitstream::obu unit; reader.next(unit);) {
+		if (static_cast<obu_type>(unit.type) == obu_type::SEQUENCE_HEADER) {
+			header.assign(unit.header, unit.end());
+			return true;
+		}
+	}
+	return false;
+}
+
+bool streamfx::encoder::codec::av1::parse_sequence_header(const uint8_t* data, std::size_t sz_data,
+														   sequence_header& header)
+{
+	bitstream::bit_reader br{data, sz_data};
+	sequence_header       sh;
+
+	br.read(3); // seq_profile
+	br.read(1); // still_picture
+	sh.reduced_still_picture_header = br.read_bit();
+	if (sh.reduced_still_picture_header) {
+		br.read(5); // seq_level_idx[0]
+		sh.operating_points = 1;
+	} else {
+		uint8_t buffer_delay_length = 0;
+
+		if (br.read_bit()) { // timing_info_present_flag
+			br.read(32);     // num_units_in_display_tick
+			br.read(32);     // time_scale
+			sh.equal_picture_interval = br.read_bit();
+			if (sh.equal_picture_interval) {
+				br.read_uvlc(); // num_ticks_per_picture_minus_1
+			}
+
+			sh.decoder_model_info_present = br.read_bit();
+			if (sh.decoder_model_info_present) {
+				buffer_delay_length = static_cast<uint8_t>(br.read(5) + 1);
+				br.read(32); // num_units_in_decoding_tick
+				sh.buffer_removal_time_length     = static_cast<uint8_t>(br.read(5) + 1);
+				sh.frame_presentation_time_length = static_cast<uint8_t>(br.read(5) + 1);
+			}
+		}
+
+		bool initial_display_delay_present = br.read_bit();
+		sh.operating_points                = static_cast<uint8_t>(br.read(5) + 1);
+		for (size_t op = 0; op < sh.operating_points; op++) {
+			sh.operating_point_idc[op] = static_cast<uint16_t>(br.read(12));
+			if (br.read(5) > 7) { // seq_level_idx
+				br.read(1);       // seq_tier
+			}
+			if (sh.decoder_model_info_present) {
+				sh.decoder_model_present_for_op[op] = br.read_bit();
+				if (sh.decoder_model_present_for_op[op]) {
+					br.read(buffer_delay_length); // decoder_buffer_delay
+					br.read(buffer_delay_length); // encoder_buffer_delay
+					br.read(1);                   // low_delay_mode_flag
+				}
+			}
+			if (initial_display_delay_present && br.read_bit()) {
+				br.read(4); // initial_display_delay_minus_1
+			}
+		}
+	}
+
+	uint8_t frame_width_bits  = static_cast<uint8_t>(br.read(4) + 1);
+	uint8_t frame_height_bits = static_cast<uint8_t>(br.read(4) + 1);
+	br.read(frame_width_bits);  // max_frame_width_minus_1
+	br.read(frame_height_bits); // max_frame_height_minus_1
+	if (!sh.reduced_still_picture_header) {
+		sh.frame_id_numbers_present = br.read_bit();
+	}
+	if (sh.frame_id_numbers_present) {
+		uint8_t delta_frame_id_length = static_cast<uint8_t>(br.read(4) + 2);
+		sh.frame_id_length            = static_cast<uint8_t>(br.read(3) + 1 + delta_frame_id_length);
+	}
+	br.read(1); // use_128x128_superblock
+	br.read(1); // enable_filter_intra
+	br.read(1); // enable_intra_edge_filter
+	if (sh.reduced_still_picture_header) {
+		sh.seq_force_screen_content_tools = 2;
+		sh.seq_force_integer_mv           = 2;
+	} else {
+		br.read(1); // enable_interintra_compound
+		br.read(1); // enable_masked_compound
+		br.read(1); // enable_warped_motion
+		br.read(1); // enable_dual_filter
+		bool enable_order_hint = br.read_bit();
+		if (enable_order_hint) {
+			br.read(1); // enable_jnt_comp
+			br.read(1); // enable_ref_frame_mvs
+		}
+
+		if (br.read_bit()) { // seq_choose_screen_content_tools
+			sh.seq_force_screen_content_tools = 2;
+		} else {
+			sh.seq_force_screen_content_tools = static_cast<uint8_t>(br.read(1));
+		}
+
+		if (sh.seq_force_screen_content_tools > 0) {
+			if (br.read_bit()) { // seq_choose_integer_mv
+				sh.seq_force_integer_mv = 2;
+			} else {
+				sh.seq_force_integer_mv = static_cast<uint8_t>(br.read(1));
+			}
+		} else {
+			sh.seq_force_integer_mv = 2;
+		}
+
+		if (enable_order_hint) {
+			sh.order_hint_bits = static_cast<uint8_t>(br.read(3) + 1);
+		}
+	}
+
+	// Everything after this point is irrelevant for parsing Frame Headers up to 'refresh_frame_flags'.
+	if (br.overrun()) {
+		return false;
+	}
+
+	sh.valid = true;
+	header   = sh;
+	return true;
+}
+
+int streamfx::encoder::codec::av1::get_packet_priority(const uint8_t* data, std::size_t sz_data,
+														sequence_header& header)
+{
+	int  priority = OBS_NAL_PRIORITY_DISPOSABLE;
+	bool found    = false;
+
+	bitstream::obu_reader reader{data, sz_data};
+	for (bitstream::obu unit; reader.next(unit);) {
+		switch (static_cast<obu_type>(unit.type)) {
+		case obu_type::SEQUENCE_HEADER:
+			parse_sequence_header(unit.data, unit.size, header);
+			continue;
+		case obu_type::FRAME_HEADER:
+		case obu_type::FRAME:
+			break;
+		default:
+			continue;
+		}
+		if (!header.valid) {
+			continue;
+		}
+
+		// uncompressed_header(), up to and including 'refresh_frame_flags'.
+		bitstream::bit_reader br{unit.data, unit.size};
+		auto                  type       = frame_type::KEY;
+		bool                  show_frame = true;
+		uint8_t               refresh    = 0xFF;
+		if (!header.reduced_still_picture_header) {
+			if (br.read_bit()) { // show_existing_frame
+				// Only shows an already decoded frame, nothing depends on this.
+				found = true;
+				continue;
+			}
+
+			type       = static_cast<frame_type>(br.read(2));
+			show_frame = br.read_bit();
+			if (show_frame && header.decoder_model_info_present && !header.equal_picture_interval) {
+				br.read(header.frame_presentation_time_length); // temporal_point_info()
+			}
+			if (!show_frame) {
+				br.read(1); // showable_frame
+			}
+
+			bool error_resilient_mode = true;
+			if ((type != frame_type::SWITCH) && !((type == frame_type::KEY) && show_frame)) {
+				error_resilient_mode = br.read_bit();
+			}
+
+			br.read(1); // disable_cdf_update
+			uint8_t allow_screen_content_tools = header.seq_force_screen_content_tools;
+			if (allow_screen_content_tools == 2) {
+				allow_screen_content_tools = static_cast<uint8_t>(br.read(1));
+			}
+			if (allow_screen_content_tools && (header.seq_force_integer_mv == 2)) {
+				br.read(1); // force_integer_mv
+			}
+			if (header.frame_id_numbers_present) {
+				br.read(header.frame_id_length); // current_frame_id
+			}
+			if (type != frame_type::SWITCH) {
+				br.read(1); // frame_size_override_flag
+			}
+			br.read(header.order_hint_bits); // order_hint
+			if ((type != frame_type::KEY) && (type != frame_type::INTRA_ONLY) && !error_resilient_mode) {
+				br.read(3); // primary_ref_frame
+			}
+
+			if (header.decoder_model_info_present && br.read_bit()) { // buffer_removal_time_present_flag
+				for (size_t op = 0; op < header.operating_points; op++) {
+					if (!header.decoder_model_present_for_op[op]) {
+						continue;
+					}
+
+					uint16_t idc = header.operating_point_idc[op];
+					if ((idc == 0)
+						|| (((idc >> unit.temporal_id) & 1) && ((idc >> (unit.spatial_id + 8)) & 1))) {
+						br.read(header.buffer_removal_time_length); // buffer_removal_time
+					}
+				}
+			}
+
+			if ((type != frame_type::SWITCH) && !((type == frame_type::KEY) && show_frame)) {
+				refresh = static_cast<uint8_t>(br.read(8));
+			}
+		}
+		if (br.overrun()) {
+			continue;
+		}
+
+		found = true;
+		if ((type == frame_type::KEY) && show_frame) {
+			priority = std::max(priority, static_cast<int>(OBS_NAL_PRIORITY_HIGHEST));
+		} else if (refresh == 0) {
+			// Nothing will ever reference this frame.
+		} else if (unit.temporal_id > 0) {
+			priority = std::max(priority, static_cast<int>(OBS_NAL_PRIORITY_LOW));
+		} else {
+			priority = std::max(priority, static_cast<int>(OBS_NAL_PRIORITY_HIGH));
+		}
+	}
+
+	return found ? priority : -1;
+}
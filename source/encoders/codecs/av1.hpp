@@ -32,5 +32,56 @@ namespace streamfx::encoder::codec::av1 {
 		UNKNOWN      = -1,
 	};
 
+	enum class obu_type : uint8_t {
+		SEQUENCE_HEADER        = 1,
+		TEMPORAL_DELIMITER     = 2,
+		FRAME_HEADER           = 3,
+		TILE_GROUP             = 4,
+		METADATA               = 5,
+		FRAME                  = 6,
+		REDUNDANT_FRAME_HEADER = 7,
+		TILE_LIST              = 8,
+		PADDING                = 15,
+	};
+
+	/// Sequence Header fields required to parse Frame Headers up to 'refresh_frame_flags'.
+	struct sequence_header {
+		bool     valid                            = false;
+		bool     reduced_still_picture_header     = false;
+		bool     decoder_model_info_present       = false;
+		bool     equal_picture_interval           = false;
+		bool     frame_id_numbers_present         = false;
+		uint8_t  buffer_removal_time_length       = 0;
+		uint8_t  frame_presentation_time_length   = 0;
+		uint8_t  frame_id_length                  = 0;
+		uint8_t  order_hint_bits                  = 0;
+		uint8_t  seq_force_screen_content_tools   = 2;
+		uint8_t  seq_force_integer_mv             = 2;
+		uint8_t  operating_points                 = 0;
+		uint16_t operating_point_idc[32]          = {};
+		bool     decoder_model_present_for_op[32] = {};
+	};
+
 	const char* profile_to_string(profile p);
+
+	/** Parse the payload of a Sequence Header OBU.
+	 *
+	 * @return true if the header was parsed, in which case 'header.valid' is also set.
+	 */
+	bool parse_sequence_header(const uint8_t* data, std::size_t sz_data, sequence_header& header);
+
+	/** Classify a temporal unit for OBS's congestion handling by the 'refresh_frame_flags' of its frames.
+	 *
+	 * Frames that refresh no reference slots are disposable, all others are needed by later frames. Sequence
+	 * Headers contained in the temporal unit update 'header', which is required to parse any Frame Header.
+	 *
+	 * @return One of the OBS_NAL_PRIORITY_* values, or -1 if no Frame Header could be parsed.
+	 */
+	int get_packet_priority(const uint8_t* data, std::size_t sz_data, sequence_header& header);
+
+	/** Extract the Sequence Header OBU from a low-overhead AV1 bitstream.
+	 *
+	 * @return true if a Sequence Header was found and stored into 'header'.
+	 */
+	bool extract_sequence_header(const uint8_t* data, std::size_t sz_data, std::vector<uint8_t>& header);
 } // namespace streamfx::encoder::codec::av1
@@ -0,0 +1,230 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bitstream.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ST_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+using namespace streamfx::encoder::codec;
+
+#ifdef ST_SSE2
+static inline uint32_t find_first_set(uint32_t mask)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return static_cast<uint32_t>(index);
+#else
+	return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+const uint8_t* bitstream::find_start_code(const uint8_t* ptr, const uint8_t* end)
+{
+	if ((end - ptr) < 3) {
+		return end;
+	}
+
+	// The last position at which a start code can begin is 'end - 3'.
+	const uint8_t* last = end - 2;
+
+#ifdef ST_SSE2
+	{ // Test 16 positions at once by comparing the packet against itself shifted by one and two bytes.
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one  = _mm_set1_epi8(1);
+		for (; (last - ptr) >= 16; ptr += 16) {
+			__m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+			__m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + 1));
+			__m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + 2));
+			__m128i m  = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)),
+									  _mm_cmpeq_epi8(b2, one));
+			if (uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(m)); mask != 0) {
+				return ptr + find_first_set(mask);
+			}
+		}
+	}
+#endif
+
+	// Whatever is left is searched for the '01' byte, for which the C library has vectorized routines.
+	while (ptr < last) {
+		auto pos = static_cast<const uint8_t*>(std::memchr(ptr + 2, 0x01, static_cast<size_t>(end - (ptr + 2))));
+		if (!pos) {
+			break;
+		}
+		if ((pos[-1] == 0x00) && (pos[-2] == 0x00)) {
+			return pos - 2;
+		}
+		ptr = pos - 1;
+	}
+
+	return end;
+}
+
+bool bitstream::read_leb128(const uint8_t*& ptr, const uint8_t* end, uint64_t& value)
+{
+	value = 0;
+	for (size_t idx = 0; idx < 8; idx++) {
+		if (ptr >= end) {
+			return false;
+		}
+
+		uint8_t byte = *(ptr++);
+		value |= static_cast<uint64_t>(byte & 0x7F) << (idx * 7);
+		if ((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+
+	// The specification limits values to 8 bytes.
+	return false;
+}
+
+uint64_t bitstream::hash(const uint8_t* data, std::size_t size, uint64_t hash)
+{
+	for (const uint8_t* end = data + size; data < end; data++) {
+		hash = (hash ^ *data) * 0x100000001B3ull;
+	}
+	return hash;
+}
+
+bitstream::bit_reader::bit_reader(const uint8_t* data, std::size_t size) : _data(data), _size(size), _bit(0) {}
+
+bool bitstream::bit_reader::read_bit()
+{
+	size_t bit = _bit++;
+	if ((bit >> 3) >= _size) {
+		return false;
+	}
+	return ((_data[bit >> 3] >> (7 - (bit & 7))) & 1) != 0;
+}
+
+uint32_t bitstream::bit_reader::read(uint8_t bits)
+{
+	uint32_t value = 0;
+	for (uint8_t idx = 0; idx < bits; idx++) {
+		value = (value << 1) | (read_bit() ? 1u : 0u);
+	}
+	return value;
+}
+
+uint32_t bitstream::bit_reader::read_uvlc()
+{
+	uint8_t leading_zeros = 0;
+	while (!read_bit()) {
+		if (overrun() || (++leading_zeros >= 32)) {
+			return 0;
+		}
+	}
+	return static_cast<uint32_t>((1ull << leading_zeros) - 1) + read(leading_zeros);
+}
+
+bool bitstream::bit_reader::overrun() const
+{
+	return _bit > (_size << 3);
+}
+
+bitstream::annexb_reader::annexb_reader(const uint8_t* data, std::size_t size)
+	: _start(), _ptr(find_start_code(data, data + size)), _end(data + size)
+{
+	_start = ((_ptr > data) && (_ptr < _end) && (_ptr[-1] == 0x00)) ? _ptr - 1 : _ptr;
+}
+
+bool bitstream::annexb_reader::next(nal_unit& nal)
+{
+	while (_ptr < _end) {
+		const uint8_t* start = _start;
+		const uint8_t* data  = _ptr + 3;
+		const uint8_t* next  = find_start_code(data, _end);
+
+		// Trailing zero bytes belong to the next start code ('zero_byte') or are padding ('trailing_zero_8bits').
+		const uint8_t* tail = next;
+		while ((tail > data) && (tail[-1] == 0x00)) {
+			--tail;
+		}
+		_start = (tail < next) ? next - 1 : next;
+		_ptr   = next;
+
+		// Skip start codes without any content.
+		if (tail == data) {
+			continue;
+		}
+
+		nal.start_code = start;
+		nal.data       = data;
+		nal.size       = static_cast<size_t>(tail - data);
+		return true;
+	}
+
+	return false;
+}
+
+bitstream::obu_reader::obu_reader(const uint8_t* data, std::size_t size) : _ptr(data), _end(data + size) {}
+
+bool bitstream::obu_reader::next(obu& unit)
+{
+	const uint8_t* ptr = _ptr;
+	if (ptr >= _end) {
+		return false;
+	}
+
+	// obu_header()
+	uint8_t header        = *(ptr++);
+	bool    has_extension = (header & 0x04) != 0;
+	bool    has_size      = (header & 0x02) != 0;
+	if ((header & 0x80) != 0) { // obu_forbidden_bit
+		_ptr = _end;
+		return false;
+	}
+	unit.header      = _ptr;
+	unit.type        = (header >> 3) & 0x0F;
+	unit.temporal_id = 0;
+	unit.spatial_id  = 0;
+
+	// obu_extension_header()
+	if (has_extension) {
+		if (ptr >= _end) {
+			_ptr = _end;
+			return false;
+		}
+		uint8_t extension = *(ptr++);
+		unit.temporal_id  = (extension >> 5) & 0x07;
+		unit.spatial_id   = (extension >> 3) & 0x03;
+	}
+
+	// obu_size
+	uint64_t size = static_cast<uint64_t>(_end - ptr);
+	if (has_size && (!read_leb128(ptr, _end, size) || (size > static_cast<uint64_t>(_end - ptr)))) {
+		_ptr = _end;
+		return false;
+	}
+
+	unit.data = ptr;
+	unit.size = static_cast<size_t>(size);
+	_ptr      = ptr + size;
+	return true;
+}
@@ -0,0 +1,120 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+
+namespace streamfx::encoder::codec::bitstream {
+	/** Find the next Annex-B start code ('00 00 01') at or after 'ptr'.
+	 *
+	 * @return Pointer to the first byte of the start code, or 'end' if there is none.
+	 */
+	const uint8_t* find_start_code(const uint8_t* ptr, const uint8_t* end);
+
+	/** Read a LEB128 encoded value, as used by AV1.
+	 *
+	 * @return true if a complete value was read, 'ptr' is then advanced past it.
+	 */
+	bool read_leb128(const uint8_t*& ptr, const uint8_t* end, uint64_t& value);
+
+	/** Hash a range of bytes (64-bit FNV-1a).
+	 *
+	 * Pass the result of a previous call as 'hash' to continue hashing over multiple ranges.
+	 */
+	uint64_t hash(const uint8_t* data, std::size_t size, uint64_t hash = 0xCBF29CE484222325ull);
+
+	/** MSB-first bit reader over a byte buffer without emulation prevention, as used by AV1 headers.
+	 *
+	 * Reading past the end yields zero bits and marks the reader as overrun, so callers only need to check once.
+	 */
+	class bit_reader {
+		const uint8_t* _data;
+		std::size_t    _size;
+		std::size_t    _bit;
+
+		public:
+		bit_reader(const uint8_t* data, std::size_t size);
+
+		bool read_bit();
+
+		uint32_t read(uint8_t bits);
+
+		uint32_t read_uvlc();
+
+		bool overrun() const;
+	};
+
+	/// View into a single H.264 or HEVC NAL unit.
+	struct nal_unit {
+		const uint8_t* start_code; // Start code preceding the NAL unit, including the optional 'zero_byte'.
+		const uint8_t* data;       // First byte of the NAL unit header.
+		std::size_t    size;       // Size of the NAL unit, excluding start code and trailing zero bytes.
+
+		const uint8_t* end() const
+		{
+			return data + size;
+		}
+	};
+
+	/** Iterate over all NAL units of an Annex-B byte stream without copying them.
+	 *
+	 * All views returned are only valid for as long as the underlying buffer is.
+	 */
+	class annexb_reader {
+		const uint8_t* _start;
+		const uint8_t* _ptr;
+		const uint8_t* _end;
+
+		public:
+		annexb_reader(const uint8_t* data, std::size_t size);
+
+		bool next(nal_unit& nal);
+	};
+
+	/// View into a single AV1 Open Bitstream Unit.
+	struct obu {
+		uint8_t        type;
+		uint8_t        temporal_id;
+		uint8_t        spatial_id;
+		const uint8_t* header; // First byte of the OBU header.
+		const uint8_t* data;   // First byte of the OBU payload.
+		std::size_t    size;   // Size of the OBU payload.
+
+		const uint8_t* end() const
+		{
+			return data + size;
+		}
+	};
+
+	/** Iterate over all OBUs of a low-overhead AV1 bitstream ('Section 5') without copying them.
+	 *
+	 * Stops at the first malformed OBU, or at the first OBU without a size field that isn't the last one.
+	 */
+	class obu_reader {
+		const uint8_t* _ptr;
+		const uint8_t* _end;
+
+		public:
+		obu_reader(const uint8_t* data, std::size_t size);
+
+		bool next(obu& unit);
+	};
+} // namespace streamfx::encoder::codec::bitstream
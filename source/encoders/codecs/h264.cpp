@@ -20,3 +20,94 @@
 // SOFTWARE.
 
 #include "h264.hpp"
+#include "bitstream.hpp"
+
+extern "C" {
+#include <obs-avc.h>
+}
+
+using namespace streamfx::encoder::codec;
+
+enum class nal_unit_type : uint8_t { // 5 bits
+	UNSPECIFIED        = 0,
+	SLICE              = 1,
+	SLICE_DATA_A       = 2,
+	SLICE_DATA_B       = 3,
+	SLICE_DATA_C       = 4,
+	SLICE_IDR          = 5,
+	SEI                = 6,
+	SPS                = 7,
+	PPS                = 8,
+	AUD                = 9,
+	END_OF_SEQUENCE    = 10,
+	END_OF_STREAM      = 11,
+	FILLER             = 12,
+	SPS_EXTENSION      = 13,
+	PREFIX             = 14,
+	SUBSET_SPS         = 15,
+	DPS                = 16,
+	SLICE_AUXILIARY    = 19,
+	SLICE_EXTENSION    = 20,
+	SLICE_EXTENSION_3D = 21,
+};
+
+void h264::extract_header_sei(const uint8_t* data, std::size_t sz_data, std::vector<uint8_t>& header,
+							  std::vector<uint8_t>& sei)
+{
+	bitstream::annexb_reader reader{data, sz_data};
+	for (bitstream::nal_unit nal; reader.next(nal);) {
+		// nal_unit_header(): forbidden_zero_bit (1), nal_ref_idc (2), nal_unit_type (5)
+		switch (static_cast<nal_unit_type>(nal.data[0] & 0x1F)) {
+		case nal_unit_type::SPS:
+		case nal_unit_type::PPS:
+			header.insert(header.end(), nal.start_code, nal.end());
+			break;
+		case nal_unit_type::SEI:
+			sei.insert(sei.end(), nal.start_code, nal.end());
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+uint64_t h264::hash_header(const uint8_t* data, std::size_t sz_data)
+{
+	uint64_t hash  = 0xCBF29CE484222325ull;
+	bool     found = false;
+
+	bitstream::annexb_reader reader{data, sz_data};
+	for (bitstream::nal_unit nal; reader.next(nal);) {
+		switch (static_cast<nal_unit_type>(nal.data[0] & 0x1F)) {
+		case nal_unit_type::SPS:
+		case nal_unit_type::PPS:
+			hash  = bitstream::hash(nal.data, nal.size, hash);
+			found = true;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return found ? hash : 0;
+}
+
+int h264::get_packet_priority(const uint8_t* data, std::size_t sz_data)
+{
+	int priority = -1;
+
+	bitstream::annexb_reader reader{data, sz_data};
+	for (bitstream::nal_unit nal; reader.next(nal);) {
+		switch (static_cast<nal_unit_type>(nal.data[0] & 0x1F)) {
+		case nal_unit_type::SLICE:
+		case nal_unit_type::SLICE_IDR:
+			// nal_ref_idc is 0 for pictures that are never referenced, and maps directly to OBS's priorities.
+			priority = std::max(priority, (nal.data[0] >> 5) & 0x03);
+			break;
+		default:
+			break;
+		}
+	}
+
+	return priority;
+}
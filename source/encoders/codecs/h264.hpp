@@ -60,4 +60,19 @@ namespace streamfx::encoder::codec::h264 {
 		L6_2,
 		UNKNOWN = -1,
 	};
+
+	void extract_header_sei(const uint8_t* data, std::size_t sz_data, std::vector<uint8_t>& header,
+							std::vector<uint8_t>& sei);
+
+	/** Hash all parameter sets (SPS and PPS) contained in a packet, without copying them.
+	 *
+	 * @return The hash, or 0 if the packet contains no parameter sets.
+	 */
+	uint64_t hash_header(const uint8_t* data, std::size_t sz_data);
+
+	/** Classify a packet for OBS's congestion handling by the highest 'nal_ref_idc' of its slices.
+	 *
+	 * @return One of the OBS_NAL_PRIORITY_* values (higher values are dropped last), or -1 if there are no slices.
+	 */
+	int get_packet_priority(const uint8_t* data, std::size_t sz_data);
 } // namespace streamfx::encoder::codec::h264
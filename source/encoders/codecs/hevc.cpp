@@ -20,6 +20,11 @@
 // SOFTWARE.
 
 #include "hevc.hpp"
+#include "bitstream.hpp"
+
+extern "C" {
+#include <obs-avc.h>
+}
 
 using namespace streamfx::encoder::codec;
 
@@ -90,150 +95,93 @@ enum class nal_unit_type : uint8_t { // 6 bits
 	UNSPEC63       = 63,
 };
 
-struct hevc_nal_unit_header {
-	bool          zero_bit : 1;
-	nal_unit_type nut : 6;
-	uint8_t       layer_id : 6;
-	uint8_t       temporal_id_plus1 : 3;
-};
-
-struct hevc_nal {
-	hevc_nal_unit_header* header;
-	std::size_t           size = 0;
-	uint8_t*              data = nullptr;
-};
-
-bool is_nal(uint8_t* data, uint8_t* end)
-{
-	std::size_t s = static_cast<size_t>(end - data);
-	if (s < 4)
-		return false;
-
-	if (*data != 0x0)
-		return false;
-	if (*(data + 1) != 0x0)
-		return false;
-	if (*(data + 2) != 0x0)
-		return false;
-	if (*(data + 3) != 0x1)
-		return false;
-
-	return true;
-}
-
-bool seek_to_nal(uint8_t*& data, uint8_t* end)
+void hevc::extract_header_sei(const uint8_t* data, std::size_t sz_data, std::vector<uint8_t>& header,
+							  std::vector<uint8_t>& sei)
 {
-	if (data > end)
-		return false;
-
-	for (; data <= end; data++) {
-		if (is_nal(data, end)) {
-			return true;
+	bitstream::annexb_reader reader{data, sz_data};
+	for (bitstream::nal_unit nal; reader.next(nal);) {
+		// nal_unit_header(): forbidden_zero_bit (1), nal_unit_type (6), nuh_layer_id (6), nuh_temporal_id_plus1 (3)
+		if (nal.size < 2) {
+			continue;
 		}
-	}
-
-	return false;
-}
 
-std::size_t get_nal_size(uint8_t* data, uint8_t* end)
-{
-	uint8_t* ptr = data + 4;
-	if (!seek_to_nal(ptr, end)) {
-		return static_cast<size_t>(end - data);
+		switch (static_cast<nal_unit_type>((nal.data[0] >> 1) & 0x3F)) {
+		case nal_unit_type::VPS:
+		case nal_unit_type::SPS:
+		case nal_unit_type::PPS:
+			header.insert(header.end(), nal.start_code, nal.end());
+			break;
+		case nal_unit_type::PREFIX_SEI:
+		case nal_unit_type::SUFFIX_SEI:
+			sei.insert(sei.end(), nal.start_code, nal.end());
+			break;
+		default:
+			break;
+		}
 	}
-	return static_cast<size_t>(ptr - data);
 }
 
-bool is_discard_marker(uint8_t* data, uint8_t* end)
+uint64_t hevc::hash_header(const uint8_t* data, std::size_t sz_data)
 {
-	std::size_t s = static_cast<size_t>(end - data);
-	if (s < 4)
-		return false;
-
-	if (*data != 0x0)
-		return false;
-	if (*(data + 1) != 0x0)
-		return false;
-
-	if (*(data + 2) == 0x3) {
-		// Discard marker only if the next byte is not 0x0, 0x1, 0x2 or 0x3.
-		if (*(data + 3) != 0x0)
-			return false;
-		if (*(data + 3) != 0x1)
-			return false;
-		if (*(data + 3) != 0x2)
-			return false;
-		if (*(data + 3) != 0x3)
-			return false;
-
-		return true;
-	} else {
-		if (*(data + 2) == 0x0)
-			return true;
-		if (*(data + 2) == 0x1)
-			return true;
-		if (*(data + 2) == 0x2)
-			return true;
-
-		return false;
-	}
-}
+	uint64_t hash  = 0xCBF29CE484222325ull;
+	bool     found = false;
 
-bool should_discard_nal(uint8_t* data, uint8_t* end)
-{
-	if (data > end)
-		return true;
+	bitstream::annexb_reader reader{data, sz_data};
+	for (bitstream::nal_unit nal; reader.next(nal);) {
+		if (nal.size < 2) {
+			continue;
+		}
 
-	for (; data <= end; data++) {
-		if (is_discard_marker(data, end))
-			return true;
+		switch (static_cast<nal_unit_type>((nal.data[0] >> 1) & 0x3F)) {
+		case nal_unit_type::VPS:
+		case nal_unit_type::SPS:
+		case nal_unit_type::PPS:
+			hash  = bitstream::hash(nal.data, nal.size, hash);
+			found = true;
+			break;
+		default:
+			break;
+		}
 	}
 
-	return false;
+	return found ? hash : 0;
 }
 
-void progress_parse(uint8_t*& ptr, uint8_t* end, size_t& sz)
-{
-	ptr += sz;
-	sz = get_nal_size(ptr, end);
-}
-
-void hevc::extract_header_sei(uint8_t* data, std::size_t sz_data, std::vector<uint8_t>& header,
-							  std::vector<uint8_t>& sei)
+int hevc::get_packet_priority(const uint8_t* data, std::size_t sz_data, uint8_t& max_temporal_id)
 {
-	uint8_t* ptr = data;
-	uint8_t* end = data + sz_data;
+	int priority = -1;
 
-	// Reserve enough memory to store the entire packet data if necessary.
-	header.reserve(sz_data);
-	sei.reserve(sz_data);
-
-	if (!seek_to_nal(ptr, end)) {
-		return;
-	}
-
-	for (std::size_t nal_sz = get_nal_size(ptr, end); nal_sz > 0; progress_parse(ptr, end, nal_sz)) {
-		if (should_discard_nal(ptr + 4, ptr + nal_sz)) {
+	bitstream::annexb_reader reader{data, sz_data};
+	for (bitstream::nal_unit nal; reader.next(nal);) {
+		// A 'nuh_temporal_id_plus1' of 0 is forbidden, and would otherwise wrap around to the unknown highest layer.
+		if ((nal.size < 2) || ((nal.data[1] & 0x07) == 0)) {
 			continue;
 		}
 
-		hevc_nal nal;
-		nal.header = reinterpret_cast<hevc_nal_unit_header*>(ptr + 4);
-		nal.size   = nal_sz - 4 - 2;
-		nal.data   = ptr + 4 + 2;
-
-		switch (nal.header->nut) {
-		case nal_unit_type::VPS:
-		case nal_unit_type::SPS:
-		case nal_unit_type::PPS:
-			header.insert(header.end(), ptr, ptr + nal_sz);
-			break;
-		case nal_unit_type::PREFIX_SEI:
-		case nal_unit_type::SUFFIX_SEI:
-			sei.insert(sei.end(), ptr, ptr + nal_sz);
-			break;
-		default:
-			break;
+		auto    type        = static_cast<nal_unit_type>((nal.data[0] >> 1) & 0x3F);
+		uint8_t temporal_id = static_cast<uint8_t>((nal.data[1] & 0x07) - 1);
+		if (type == nal_unit_type::SPS) {
+			// sps_video_parameter_set_id u(4), sps_max_sub_layers_minus1 u(3), sps_temporal_id_nesting_flag u(1)
+			if (nal.size >= 3) {
+				max_temporal_id = static_cast<uint8_t>((nal.data[2] >> 1) & 0x07);
+			}
+			continue;
+		} else if (type > nal_unit_type::RSV_VCL31) {
+			// Not a slice.
+			continue;
+		} else if ((type >= nal_unit_type::BLA_W_LP) && (type <= nal_unit_type::RSV_IRAP_VCL23)) {
+			priority = std::max(priority, static_cast<int>(OBS_NAL_PRIORITY_HIGHEST));
+		} else if ((type <= nal_unit_type::RSV_VCL_R15) && ((static_cast<uint8_t>(type) & 1) == 0)
+				   && (temporal_id == max_temporal_id)) {
+			// Sub-layer non-reference pictures ('*_N') are not referenced by anything in the same temporal layer, and
+			// in the highest temporal layer there is nothing else left that could reference them.
+			priority = std::max(priority, static_cast<int>(OBS_NAL_PRIORITY_DISPOSABLE));
+		} else if (temporal_id > 0) {
+			priority = std::max(priority, static_cast<int>(OBS_NAL_PRIORITY_LOW));
+		} else {
+			priority = std::max(priority, static_cast<int>(OBS_NAL_PRIORITY_HIGH));
 		}
 	}
+
+	return priority;
 }
@@ -59,6 +59,24 @@ namespace streamfx::encoder::codec::hevc {
 		UNKNOWN = -1,
 	};
 
-	void extract_header_sei(uint8_t* data, std::size_t sz_data, std::vector<uint8_t>& header,
+	void extract_header_sei(const uint8_t* data, std::size_t sz_data, std::vector<uint8_t>& header,
 							std::vector<uint8_t>& sei);
+
+	/** Hash all parameter sets (VPS, SPS and PPS) contained in a packet, without copying them.
+	 *
+	 * @return The hash, or 0 if the packet contains no parameter sets.
+	 */
+	uint64_t hash_header(const uint8_t* data, std::size_t sz_data);
+
+	/** Classify a packet for OBS's congestion handling by NAL unit type and temporal layer of its slices.
+	 *
+	 * IRAP pictures are the most important, and reference pictures in higher temporal layers are only referenced by
+	 * other pictures in those layers. Sub-layer non-reference pictures are only disposable in the highest temporal
+	 * layer, as pictures of higher layers may still reference them otherwise.
+	 *
+	 * @param max_temporal_id Highest TemporalId of the stream, updated from any SPS in the packet. Start with
+	 *                        UINT8_MAX if it is not known yet, which never treats a picture as disposable.
+	 * @return One of the OBS_NAL_PRIORITY_* values (higher values are dropped last), or -1 if there are no slices.
+	 */
+	int get_packet_priority(const uint8_t* data, std::size_t sz_data, uint8_t& max_temporal_id);
 } // namespace streamfx::encoder::codec::hevc
@@ -31,6 +31,7 @@
 #define S_CODEC_PRORES_PROFILE_APCH "Codec.ProRes.Profile.APCH"
 #define S_CODEC_PRORES_PROFILE_AP4H "Codec.ProRes.Profile.AP4H"
 #define S_CODEC_PRORES_PROFILE_AP4X "Codec.ProRes.Profile.AP4X"
+#define S_CODEC_PRORES_ALPHA "Codec.ProRes.Alpha"
 
 namespace streamfx::encoder::codec::prores {
 	enum class profile : int32_t {
@@ -21,6 +21,7 @@
 #include "encoder-aom-av1.hpp"
 #include <filesystem>
 #include <thread>
+#include "ffmpeg/plane-copy.hpp"
 #include "util/util-logging.hpp"
 
 #ifdef _DEBUG
@@ -41,6 +42,10 @@
 
 // Preset
 #define ST_I18N_ENCODER ST_I18N ".Encoder"
+#define ST_I18N_ENCODER_MODE ST_I18N_ENCODER ".Mode"
+#define ST_I18N_ENCODER_MODE_CUSTOM ST_I18N_ENCODER_MODE ".Custom"
+#define ST_I18N_ENCODER_MODE_REALTIMESCREENCONTENT ST_I18N_ENCODER_MODE ".RealTimeScreenContent"
+#define ST_KEY_ENCODER_MODE "Encoder.Mode"
 #define ST_I18N_ENCODER_USAGE ST_I18N_ENCODER ".Usage"
 #define ST_I18N_ENCODER_USAGE_GOODQUALITY ST_I18N_ENCODER_USAGE ".GoodQuality"
 #define ST_I18N_ENCODER_USAGE_REALTIME ST_I18N_ENCODER_USAGE ".RealTime"
@@ -58,6 +63,8 @@
 #define ST_I18N_ENCODER_CPUUSAGE_8 ST_I18N_ENCODER ".CPUUsage.8"
 #define ST_I18N_ENCODER_CPUUSAGE_9 ST_I18N_ENCODER ".CPUUsage.9"
 #define ST_KEY_ENCODER_CPUUSAGE "Encoder.CPUUsage"
+#define ST_I18N_ENCODER_CPUUSAGE_ADAPTIVE ST_I18N_ENCODER_CPUUSAGE ".Adaptive"
+#define ST_KEY_ENCODER_CPUUSAGE_ADAPTIVE "Encoder.CPUUsage.Adaptive"
 #define ST_KEY_ENCODER_PROFILE "Encoder.Profile"
 
 // Rate Control
@@ -100,6 +107,8 @@
 #define ST_I18N_KEYFRAMES_INTERVAL ST_I18N_KEYFRAMES ".Interval"
 #define ST_KEY_KEYFRAMES_INTERVAL_SECONDS "KeyFrames.Interval.Seconds"
 #define ST_KEY_KEYFRAMES_INTERVAL_FRAMES "KeyFrames.Interval.Frames"
+#define ST_I18N_KEYFRAMES_SCENEAWARE ST_I18N_KEYFRAMES ".SceneAware"
+#define ST_KEY_KEYFRAMES_SCENEAWARE "KeyFrames.SceneAware"
 
 // Advanced
 #define ST_I18N_ADVANCED ST_I18N ".Advanced"
@@ -125,11 +134,19 @@
 #define ST_I18N_ADVANCED_TUNE_CONTENT_SCREEN ST_I18N_ADVANCED_TUNE_CONTENT ".Screen"
 #define ST_I18N_ADVANCED_TUNE_CONTENT_FILM ST_I18N_ADVANCED_TUNE_CONTENT ".Film"
 #define ST_KEY_ADVANCED_TUNE_CONTENT "Advanced.Tune.Content"
+#define ST_I18N_ADVANCED_FIRSTPASS ST_I18N_ADVANCED ".FirstPass"
+#define ST_KEY_ADVANCED_FIRSTPASS "Advanced.FirstPass"
+#define ST_I18N_ADVANCED_FIRSTPASS_DESCRIPTION ST_I18N_ADVANCED_FIRSTPASS ".Description"
+#define ST_I18N_ADVANCED_FIRSTPASS_PATH ST_I18N_ADVANCED_FIRSTPASS ".Path"
+#define ST_KEY_ADVANCED_FIRSTPASS_PATH "Advanced.FirstPass.Path"
 
 using namespace streamfx::encoder::aom::av1;
 
 static constexpr std::string_view HELP_URL = "https://github.com/Xaymar/obs-StreamFX/wiki/Encoder-AOM-AV1";
 
+// Each statistics packet is a few hundred bytes, so this covers several minutes before the file has to grow.
+static constexpr size_t FIRSTPASS_INITIAL_SIZE = 16 * 1024 * 1024;
+
 const char* obs_video_format_to_string(video_format format)
 {
 	switch (format) {
@@ -170,6 +187,18 @@ const char* obs_video_format_to_string(video_format format)
 	}
 }
 
+const char* encoder_mode_to_string(encoder_mode mode)
+{
+	switch (mode) {
+	case encoder_mode::CUSTOM:
+		return "Custom";
+	case encoder_mode::REALTIME_SCREEN_CONTENT:
+		return "Real-Time Screen Content";
+	default:
+		return "Unknown";
+	}
+}
+
 const char* aom_color_format_to_string(aom_img_fmt format)
 {
 	switch (format) {
@@ -304,7 +333,9 @@ const char* aom_tune_content_to_string(aom_tune_content tune)
 
 aom_av1_instance::aom_av1_instance(obs_data_t* settings, obs_encoder_t* self, bool is_hw)
 	: obs::encoder_instance(settings, self, is_hw), _factory(aom_av1_factory::get()), _iface(nullptr), _ctx(), _cfg(),
-	  _image_index(0), _images(), _global_headers(nullptr), _initialized(false), _settings()
+	  _image_index(0), _images(), _global_headers(nullptr), _fp_ctx(), _fp_cfg(), _fp_file(), _fp_size(0),
+	  _initialized(false), _frames_pending(0), _latency_warned(false), _settings(), _pacer(), _scene_analyzer(),
+	  _roi_supported(true), _roi_clock(), _roi_regions(), _roi_map()
 {
 	if (is_hw) {
 		throw std::runtime_error("Hardware encoding isn't even registered, how did you get here?");
@@ -389,6 +420,7 @@ aom_av1_instance::aom_av1_instance(obs_data_t* settings, obs_encoder_t* self, bo
 		}
 
 		{ // Encoder
+			_settings.mode    = static_cast<encoder_mode>(obs_data_get_int(settings, ST_KEY_ENCODER_MODE));
 			_settings.profile = static_cast<codec::av1::profile>(obs_data_get_int(settings, ST_KEY_ENCODER_PROFILE));
 			if (_settings.profile == codec::av1::profile::UNKNOWN) {
 				// Resolve the automatic profile to a proper value.
@@ -408,6 +440,11 @@ aom_av1_instance::aom_av1_instance(obs_data_t* settings, obs_encoder_t* self, bo
 		{ // Rate Control
 			_settings.rc_mode      = static_cast<aom_rc_mode>(obs_data_get_int(settings, ST_KEY_RATECONTROL_MODE));
 			_settings.rc_lookahead = static_cast<int8_t>(obs_data_get_int(settings, ST_KEY_RATECONTROL_LOOKAHEAD));
+			if (_settings.mode == encoder_mode::REALTIME_SCREEN_CONTENT) {
+				// Any look-ahead delays the output by at least one frame.
+				_settings.rc_mode      = AOM_CBR;
+				_settings.rc_lookahead = 0;
+			}
 		}
 
 		{ // Threading
@@ -431,6 +468,9 @@ aom_av1_instance::aom_av1_instance(obs_data_t* settings, obs_encoder_t* self, bo
 			}
 			_settings.tune_content =
 				static_cast<aom_tune_content>(obs_data_get_int(settings, ST_KEY_ADVANCED_TUNE_CONTENT));
+			if (_settings.mode == encoder_mode::REALTIME_SCREEN_CONTENT) {
+				_settings.tune_content = AOM_CONTENT_SCREEN;
+			}
 		}
 	}
 
@@ -581,6 +621,16 @@ aom_av1_instance::aom_av1_instance(obs_data_t* settings, obs_encoder_t* self, bo
 		image.r_h = image.h;
 	}
 
+	// Initialize First-Pass statistics, if requested.
+	if (obs_data_get_bool(settings, ST_KEY_ADVANCED_FIRSTPASS)) {
+		try {
+			initialize_first_pass(settings);
+		} catch (const std::exception& ex) {
+			D_LOG_WARNING("First-Pass statistics are unavailable: %s", ex.what());
+			_fp_file.reset();
+		}
+	}
+
 	// Log Settings
 	log();
 
@@ -614,6 +664,17 @@ aom_av1_instance::~aom_av1_instance()
 			   _profiler_packet->count());
 #endif
 
+	if (_scene_analyzer) {
+		D_LOG_INFO("Scene Analysis: %" PRIu64 " cut(s), %" PRIu64 " deferred key-frame(s).",
+				   _scene_analyzer->count_cuts(), _scene_analyzer->count_deferrals());
+	}
+
+	if (_pacer) {
+		D_LOG_INFO("Pacing: %" PRIu64 " downgrade(s), %" PRIu64 " upgrade(s), %" PRIu64
+				   " overload(s), ended at CPU Usage %" PRId32 ".",
+				   _pacer->count_downgrades(), _pacer->count_upgrades(), _pacer->count_overloads(), _pacer->get());
+	}
+
 	// Deallocate global buffer.
 	if (_global_headers) {
 		/* Breaks heap
@@ -626,6 +687,23 @@ aom_av1_instance::~aom_av1_instance()
 		*/
 	}
 
+	// Finish First-Pass statistics.
+	if (_fp_file) {
+		// Drain the look-ahead of the First-Pass encoder, which also emits the summary packet.
+		do {
+			_factory->libaom_codec_encode(&_fp_ctx, nullptr, -1, 1, 0);
+		} while (receive_first_pass());
+
+		// Cut off the unused reserved space.
+		_fp_file->resize(_fp_size);
+		_fp_file->flush();
+		D_LOG_INFO("Wrote %" PRIuPTR " bytes of First-Pass statistics to '%s'.", _fp_size,
+				   _fp_file->path().u8string().c_str());
+
+		_fp_file.reset();
+		_factory->libaom_codec_destroy(&_fp_ctx);
+	}
+
 	// Deallocate frames.
 	for (auto& image : _images) {
 		_factory->libaom_img_free(&image);
@@ -655,6 +733,11 @@ bool aom_av1_instance::update(obs_data_t* settings)
 
 		{ // Encoder
 			_settings.preset = static_cast<int8_t>(obs_data_get_int(settings, ST_KEY_ENCODER_CPUUSAGE));
+			if ((_settings.mode == encoder_mode::REALTIME_SCREEN_CONTENT) && (_settings.preset == -1)) {
+				// libaom's own default is far too slow to keep up with real-time input.
+				_settings.preset = 8;
+			}
+			_settings.preset_adaptive = obs_data_get_bool(settings, ST_KEY_ENCODER_CPUUSAGE_ADAPTIVE);
 		}
 
 		{ // Rate Control
@@ -688,6 +771,11 @@ bool aom_av1_instance::update(obs_data_t* settings)
 				_settings.kf_distance_max =
 					static_cast<unsigned int>(obs_data_get_int(settings, ST_KEY_KEYFRAMES_INTERVAL_FRAMES));
 			}
+			_settings.kf_scene_aware = obs_data_get_bool(settings, ST_KEY_KEYFRAMES_SCENEAWARE);
+			if (_settings.kf_scene_aware) {
+				// The scene analyzer places the scheduled key-frames, and may hold them back up to twice as long.
+				_settings.kf_distance_max *= 2;
+			}
 			_settings.kf_distance_min = _settings.kf_distance_max;
 		}
 
@@ -697,6 +785,7 @@ bool aom_av1_instance::update(obs_data_t* settings)
 			_settings.kf_mode         = AOM_KF_DISABLED;
 			_settings.kf_distance_min = 0;
 			_settings.kf_distance_max = 0;
+			_settings.kf_scene_aware  = false;
 		}
 	}
 
@@ -704,6 +793,9 @@ bool aom_av1_instance::update(obs_data_t* settings)
 
 		{ // Usage and Defaults
 			_cfg.g_usage = static_cast<unsigned int>(obs_data_get_int(settings, ST_KEY_ENCODER_USAGE));
+			if (_settings.mode == encoder_mode::REALTIME_SCREEN_CONTENT) {
+				_cfg.g_usage = AOM_USAGE_REALTIME;
+			}
 			_factory->libaom_codec_enc_config_default(_iface, &_cfg, _cfg.g_usage);
 		}
 
@@ -732,7 +824,7 @@ bool aom_av1_instance::update(obs_data_t* settings)
 
 		{ // Rate Control
 			// Mode
-			_cfg.rc_end_usage = static_cast<aom_rc_mode>(obs_data_get_int(settings, ST_KEY_RATECONTROL_MODE));
+			_cfg.rc_end_usage = _settings.rc_mode;
 
 			// Look-Ahead
 			SET_IF_NOT_DEFAULT(_settings.rc_lookahead, _cfg.g_lag_in_frames);
@@ -763,6 +855,12 @@ bool aom_av1_instance::update(obs_data_t* settings)
 
 			// Threading
 			SET_IF_NOT_DEFAULT(_settings.threads, _cfg.g_threads);
+
+			// Error Resilience
+			if (_settings.mode == encoder_mode::REALTIME_SCREEN_CONTENT) {
+				// Allows viewers to recover from lost packets without waiting for the next Key-Frame.
+				_cfg.g_error_resilient = AOM_ERROR_RESILIENT_DEFAULT;
+			}
 		}
 
 		// TODO: Future
@@ -778,8 +876,6 @@ bool aom_av1_instance::update(obs_data_t* settings)
 		//_cfg.fwd_kf_enabled = ?;
 		//_cfg.g_forced_max_frame_width = ?;
 		//_cfg.g_forced_max_frame_height = ?;
-		//_cfg.g_error_resilient = ?;
-		//_cfg.g_lag_in_frames = ?;
 		//_cfg.sframe_dist = ?;
 		//_cfg.sframe_mode      = 0;
 		//_cfg.large_scale_tile = 0;
@@ -925,12 +1021,67 @@ bool aom_av1_instance::update(obs_data_t* settings)
 					);
 				}
 			}
+#endif
+		}
+
+		if (_settings.mode == encoder_mode::REALTIME_SCREEN_CONTENT) { // Real-Time Screen Content
+#ifdef AOM_CTRL_AV1E_SET_AQ_MODE
+			// Cyclic Refresh spreads intra-refresh over several frames, avoiding bitrate spikes from Key-Frames.
+			if (auto error = _factory->libaom_codec_control(&_ctx, AV1E_SET_AQ_MODE, 3); error != AOM_CODEC_OK) {
+				const char* errstr = _factory->libaom_codec_err_to_string(error);
+				const char* err    = _factory->libaom_codec_error(&_ctx);
+				const char* errdtl = _factory->libaom_codec_error_detail(&_ctx);
+				D_LOG_WARNING("Error changing '%s': %s (code %" PRIu32 ")%s%s%s%s",   //
+							  "AV1E_SET_AQ_MODE",                                     //
+							  (errstr ? errstr : ""), error,                          //
+							  (err ? "\n\tMessage: " : ""), (err ? err : ""),         //
+							  (errdtl ? "\n\tDetails: " : ""), (errdtl ? errdtl : "") //
+				);
+			}
+#endif
+
+#ifdef AOM_CTRL_AV1E_SET_ENABLE_PALETTE
+			if (auto error = _factory->libaom_codec_control(&_ctx, AV1E_SET_ENABLE_PALETTE, 1); error != AOM_CODEC_OK) {
+				const char* errstr = _factory->libaom_codec_err_to_string(error);
+				const char* err    = _factory->libaom_codec_error(&_ctx);
+				const char* errdtl = _factory->libaom_codec_error_detail(&_ctx);
+				D_LOG_WARNING("Error changing '%s': %s (code %" PRIu32 ")%s%s%s%s",   //
+							  "AV1E_SET_ENABLE_PALETTE",                              //
+							  (errstr ? errstr : ""), error,                          //
+							  (err ? "\n\tMessage: " : ""), (err ? err : ""),         //
+							  (errdtl ? "\n\tDetails: " : ""), (errdtl ? errdtl : "") //
+				);
+			}
 #endif
 		}
 	}
 
 #undef SET_IF_NOT_DEFAULT
 
+	{ // Pacing
+		// Only an explicit CPU Usage gives a known place to start from.
+		_pacer.reset();
+		if (_settings.preset_adaptive && (_settings.preset != -1)) {
+			// Good Quality does not go past 6, the other usages go up to 9.
+			int32_t              fastest = (_cfg.g_usage == AOM_USAGE_GOOD_QUALITY) ? 6 : 9;
+			std::vector<int32_t> ladder;
+			for (int32_t preset = _settings.preset; preset <= std::max<int32_t>(fastest, _settings.preset); preset++) {
+				ladder.push_back(preset);
+			}
+			_pacer = std::make_unique<::streamfx::encoder::pacer>(_settings.fps.num, _settings.fps.den, ladder);
+		}
+	}
+
+	{ // Scene Analysis
+		_scene_analyzer.reset();
+		if (_settings.kf_scene_aware && (_cfg.g_usage != AOM_USAGE_ALL_INTRA)) {
+			uint32_t distance = static_cast<uint32_t>(_settings.kf_distance_max / 2);
+			_scene_analyzer   = std::make_unique<::streamfx::encoder::scene_analyzer>(
+				  _settings.width, _settings.height, std::max<uint32_t>(_settings.fps.num / _settings.fps.den / 2, 1),
+				  distance, distance * 2);
+		}
+	}
+
 	// Log the changed settings.
 	if (_initialized) {
 		log();
@@ -945,6 +1096,8 @@ void aom_av1_instance::log()
 	D_LOG_INFO("  Video: %" PRIu16 "x%" PRIu16 "@%1.2ffps (%" PRIu32 "/%" PRIu32 ")", _settings.width, _settings.height,
 			   static_cast<double>(_settings.fps.num) / static_cast<float>(_settings.fps.den), _settings.fps.num,
 			   _settings.fps.den);
+	D_LOG_INFO("  Mode: %s", encoder_mode_to_string(_settings.mode));
+	D_LOG_INFO("  CPU Usage: %" PRId8 "%s", _settings.preset, _pacer ? " (Adaptive)" : "");
 	D_LOG_INFO("  Color: %s/%s/%s%s", aom_color_format_to_string(_settings.color_format),
 			   aom_color_trc_to_string(_settings.color_trc),
 			   _settings.color_range == AOM_CR_FULL_RANGE ? "Full" : "Partial",
@@ -963,6 +1116,7 @@ void aom_av1_instance::log()
 	// Key-Frames
 	D_LOG_INFO("  Key-Frames: %s", aom_kf_mode_to_string(_settings.kf_mode));
 	D_LOG_INFO("    Distance: %" PRId32 " - %" PRId32 " frames", _settings.kf_distance_min, _settings.kf_distance_max);
+	D_LOG_INFO("    Scene-Aware: %s", _scene_analyzer ? "Enabled" : "Disabled");
 
 	// Advanced
 	D_LOG_INFO("  Advanced: ", "");
@@ -973,6 +1127,92 @@ void aom_av1_instance::log()
 	D_LOG_INFO("   Tiling: %" PRId8 "x%" PRId8, _settings.tile_columns, _settings.tile_rows);
 	D_LOG_INFO("   Tune: %s (Metric), %s (Content)", aom_tune_metric_to_string(_settings.tune_metric),
 			   aom_tune_content_to_string(_settings.tune_content));
+	D_LOG_INFO("   First-Pass: %s", _fp_file ? _fp_file->path().u8string().c_str() : "Disabled");
+}
+
+void aom_av1_instance::initialize_first_pass(obs_data_t* settings)
+{
+	auto path = std::filesystem::u8path(obs_data_get_string(settings, ST_KEY_ADVANCED_FIRSTPASS_PATH));
+	if (path.empty()) {
+		throw std::runtime_error("No path for the statistics file was given.");
+	}
+
+	{ // Name the file after the time capture started, so that multiple captures don't overwrite each other.
+		std::array<char, 64> name;
+		std::time_t          now = std::time(nullptr);
+		std::tm              local;
+#ifdef D_PLATFORM_WINDOWS
+		localtime_s(&local, &now);
+#else
+		localtime_r(&now, &local);
+#endif
+		std::strftime(name.data(), name.size(), "aom-av1-%Y%m%d-%H%M%S.fpf", &local);
+		path /= name.data();
+	}
+
+	{ // Configuration
+		// libaom only supports multiple passes with Good Quality usage.
+		_factory->libaom_codec_enc_config_default(_iface, &_fp_cfg, AOM_USAGE_GOOD_QUALITY);
+		_fp_cfg.g_pass            = AOM_RC_FIRST_PASS;
+		_fp_cfg.g_w               = _cfg.g_w;
+		_fp_cfg.g_h               = _cfg.g_h;
+		_fp_cfg.g_timebase        = _cfg.g_timebase;
+		_fp_cfg.g_bit_depth       = _cfg.g_bit_depth;
+		_fp_cfg.g_input_bit_depth = _cfg.g_input_bit_depth;
+		_fp_cfg.g_profile         = _cfg.g_profile;
+		_fp_cfg.g_threads         = _cfg.g_threads;
+		_fp_cfg.monochrome        = _cfg.monochrome;
+		_fp_cfg.rc_target_bitrate = _cfg.rc_target_bitrate;
+		_fp_cfg.kf_mode           = _cfg.kf_mode;
+		_fp_cfg.kf_min_dist       = _cfg.kf_min_dist;
+		_fp_cfg.kf_max_dist       = _cfg.kf_max_dist;
+	}
+
+	if (auto error = _factory->libaom_codec_enc_init_ver(&_fp_ctx, _iface, &_fp_cfg, 0, AOM_ENCODER_ABI_VERSION);
+		error != AOM_CODEC_OK) {
+		throw std::runtime_error(_factory->libaom_codec_err_to_string(error));
+	}
+
+	try {
+		_fp_file = std::make_shared<streamfx::util::mapped_file>(path, FIRSTPASS_INITIAL_SIZE);
+		_fp_size = 0;
+	} catch (...) {
+		_factory->libaom_codec_destroy(&_fp_ctx);
+		throw;
+	}
+}
+
+bool aom_av1_instance::receive_first_pass()
+{
+	bool received = false;
+
+	aom_codec_iter_t iter = NULL;
+	for (auto* pkt = _factory->libaom_codec_get_cx_data(&_fp_ctx, &iter); pkt != nullptr;
+		 pkt       = _factory->libaom_codec_get_cx_data(&_fp_ctx, &iter)) {
+		if (pkt->kind == AOM_CODEC_STATS_PKT) {
+			store_first_pass(pkt);
+			received = true;
+		}
+	}
+
+	return received;
+}
+
+void aom_av1_instance::store_first_pass(const aom_codec_cx_pkt_t* pkt)
+{
+	if (!_fp_file) {
+		return;
+	}
+
+	// Grow the file geometrically, remapping it is expensive.
+	size_t required = _fp_size + pkt->data.twopass_stats.sz;
+	if (required > _fp_file->size()) {
+		_fp_file->resize(std::max(required, _fp_file->size() * 2));
+	}
+
+	std::memcpy(static_cast<uint8_t*>(_fp_file->data()) + _fp_size, pkt->data.twopass_stats.buf,
+				pkt->data.twopass_stats.sz);
+	_fp_size = required;
 }
 
 bool aom_av1_instance::get_extra_data(uint8_t** extra_data, size_t* size)
@@ -1047,23 +1287,131 @@ void aom_av1_instance::get_video_info(struct video_scale_info* info)
 	}
 }
 
+void aom_av1_instance::pace(std::chrono::nanoseconds duration)
+{
+	switch (_pacer->submit(duration)) {
+	case ::streamfx::encoder::pacer_event::DOWNGRADED:
+		D_LOG_WARNING("Encoding is falling behind, raising CPU Usage to %" PRId32 " (downgrade #%" PRIu64 ").",
+					  _pacer->get(), _pacer->count_downgrades());
+		break;
+	case ::streamfx::encoder::pacer_event::UPGRADED:
+		D_LOG_INFO("Encoding has caught up, lowering CPU Usage to %" PRId32 " (upgrade #%" PRIu64 ").", _pacer->get(),
+				   _pacer->count_upgrades());
+		break;
+	case ::streamfx::encoder::pacer_event::OVERLOADED:
+		D_LOG_WARNING("Encoding is falling behind even at CPU Usage %" PRId32 ", frames will be dropped.",
+					  _pacer->get());
+		return;
+	case ::streamfx::encoder::pacer_event::RECOVERED:
+		D_LOG_INFO("Encoding is keeping up with the frame interval again.", "");
+		return;
+	default:
+		return;
+	}
+
+#ifdef AOM_CTRL_AOME_SET_CPUUSED
+	if (auto error = _factory->libaom_codec_control(&_ctx, AOME_SET_CPUUSED, _pacer->get()); error != AOM_CODEC_OK) {
+		const char* errstr = _factory->libaom_codec_err_to_string(error);
+		const char* err    = _factory->libaom_codec_error(&_ctx);
+		const char* errdtl = _factory->libaom_codec_error_detail(&_ctx);
+		D_LOG_WARNING("Error changing '%s': %s (code %" PRIu32 ")%s%s%s%s",   //
+					  "AOME_SET_CPUUSED",                                     //
+					  (errstr ? errstr : ""), error,                          //
+					  (err ? "\n\tMessage: " : ""), (err ? err : ""),         //
+					  (errdtl ? "\n\tDetails: " : ""), (errdtl ? errdtl : "") //
+		);
+	}
+#endif
+}
+
+void aom_av1_instance::update_regions(int64_t pts)
+{
+#ifdef AOM_CTRL_AOME_SET_ROI_MAP
+	auto regions = ::streamfx::encoder::roi_channel::get()->query(_roi_clock.get(pts, _settings.fps.num));
+	if (regions == _roi_regions) {
+		return;
+	}
+	_roi_regions = regions;
+
+	// The map is in units of 4x4 pixels, covering the frame size rounded up to a multiple of 8.
+	unsigned int cols = ((static_cast<unsigned int>(_settings.width) + 7) & ~7u) / 4;
+	unsigned int rows = ((static_cast<unsigned int>(_settings.height) + 7) & ~7u) / 4;
+	_roi_map.assign(static_cast<size_t>(cols) * rows, 0);
+
+	// Segment 0 is left untouched, segments 1 to 7 get progressively more bits. libaom has no way to take bits away
+	// from a segment without also affecting rate control for the rest, so negative weights are ignored.
+	for (auto& region : _roi_regions) {
+		uint8_t segment = static_cast<uint8_t>(std::clamp<long>(std::lround(region.weight * 7.), 0, 7));
+		if (segment == 0) {
+			continue;
+		}
+
+		std::size_t x0 = static_cast<size_t>(std::floor(region.left * cols));
+		std::size_t y0 = static_cast<size_t>(std::floor(region.top * rows));
+		std::size_t x1 = std::min<size_t>(static_cast<size_t>(std::ceil(region.right * cols)), cols);
+		std::size_t y1 = std::min<size_t>(static_cast<size_t>(std::ceil(region.bottom * rows)), rows);
+		for (std::size_t y = y0; y < y1; y++) {
+			for (std::size_t x = x0; x < x1; x++) {
+				uint8_t& value = _roi_map[y * cols + x];
+				value          = std::max(value, segment);
+			}
+		}
+	}
+
+	aom_roi_map_t roi = {};
+	roi.roi_map       = _roi_map.data();
+	roi.rows          = rows;
+	roi.cols          = cols;
+	for (int segment = 0; segment < 8; segment++) {
+		roi.delta_q[segment] = -segment * 8;
+		// 0 would be INTRA_FRAME, forcing every block of the segment to intra. -1 leaves the choice to the encoder.
+		roi.ref_frame[segment] = -1;
+	}
+
+	if (auto error = _factory->libaom_codec_control(&_ctx, AOME_SET_ROI_MAP, &roi); error != AOM_CODEC_OK) {
+		const char* errstr = _factory->libaom_codec_err_to_string(error);
+		D_LOG_WARNING("Regions of Interest are not supported by this encoder configuration, ignoring them: %s (code "
+					  "%" PRIu32 ")",
+					  (errstr ? errstr : ""), error);
+		_roi_supported = false;
+	}
+#else
+	_roi_supported = false;
+#endif
+}
+
 bool streamfx::encoder::aom::av1::aom_av1_instance::encode_video(encoder_frame* frame, encoder_packet* packet,
 																 bool* received_packet)
 {
+	auto start = std::chrono::high_resolution_clock::now();
+
 	// Retrieve current indexed image.
 	auto& image = _images.at(_image_index);
 
+	// Regions of Interest, for the encoder configurations that support them.
+	if (_roi_supported) {
+		update_regions(frame->pts);
+	}
+
+	// Look at the luma plane while it is being copied anyway.
+	bool force_keyframe = false;
+	if (_scene_analyzer) {
+		force_keyframe = _scene_analyzer->analyze(frame->data[0], static_cast<size_t>(frame->linesize[0]));
+	}
+
 	{ // Copy Image data.
 #ifdef ENABLE_PROFILING
 		auto profile = _profiler_copy->track();
 #endif
-		std::memcpy(image.planes[AOM_PLANE_Y], frame->data[0], frame->linesize[0] * image.h);
-		if (image.fmt == AOM_IMG_FMT_I420) {
-			std::memcpy(image.planes[AOM_PLANE_U], frame->data[1], frame->linesize[1] * image.h / 2);
-			std::memcpy(image.planes[AOM_PLANE_V], frame->data[2], frame->linesize[2] * image.h / 2);
-		} else {
-			std::memcpy(image.planes[AOM_PLANE_U], frame->data[1], frame->linesize[1] * image.h);
-			std::memcpy(image.planes[AOM_PLANE_V], frame->data[2], frame->linesize[2] * image.h);
+		std::size_t bytes_per_sample = (image.fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+		for (std::size_t plane = AOM_PLANE_Y; plane <= AOM_PLANE_V; plane++) {
+			std::size_t shift_x = (plane != AOM_PLANE_Y) ? image.x_chroma_shift : 0;
+			std::size_t shift_y = (plane != AOM_PLANE_Y) ? image.y_chroma_shift : 0;
+			std::size_t width   = ((image.d_w + shift_x) >> shift_x) * bytes_per_sample;
+			std::size_t height  = (image.d_h + shift_y) >> shift_y;
+
+			::streamfx::ffmpeg::copy_plane(image.planes[plane], static_cast<size_t>(image.stride[plane]),
+										   frame->data[plane], frame->linesize[plane], width, height);
 		}
 	}
 
@@ -1072,7 +1420,7 @@ bool streamfx::encoder::aom::av1::aom_av1_instance::encode_video(encoder_frame*
 		auto profile = _profiler_encode->track();
 #endif
 		aom_enc_frame_flags_t flags = 0;
-		if (_cfg.g_usage == AOM_USAGE_ALL_INTRA) {
+		if ((_cfg.g_usage == AOM_USAGE_ALL_INTRA) || force_keyframe) {
 			flags = AOM_EFLAG_FORCE_KF;
 		}
 		if (auto error = _factory->libaom_codec_encode(&_ctx, &image, frame->pts, 1, flags); error != AOM_CODEC_OK) {
@@ -1083,6 +1431,23 @@ bool streamfx::encoder::aom::av1::aom_av1_instance::encode_video(encoder_frame*
 		} else {
 			// Increment the image index.
 			_image_index = (_image_index++) % _images.size();
+			++_frames_pending;
+		}
+
+		// Run the same image through the First-Pass encoder. This happens synchronously on the encode thread, so
+		// enabling the statistics roughly doubles the time spent per frame. The First-Pass encoder needs every image
+		// in order and reads it from the same ring of images as the main encoder, so it can't easily be deferred.
+		if (_fp_file) {
+			if (auto error = _factory->libaom_codec_encode(&_fp_ctx, &image, frame->pts, 1, flags);
+				error != AOM_CODEC_OK) {
+				const char* errstr = _factory->libaom_codec_err_to_string(error);
+				D_LOG_WARNING("First-Pass analysis failed with error: %s (code %" PRIu32 "), disabling it.", errstr,
+							  error);
+				_fp_file.reset();
+				_factory->libaom_codec_destroy(&_fp_ctx);
+			} else {
+				receive_first_pass();
+			}
 		}
 	}
 
@@ -1117,7 +1482,9 @@ bool streamfx::encoder::aom::av1::aom_av1_instance::encode_video(encoder_frame*
 			}
 #endif
 
-			if (pkt->kind == AOM_CODEC_CX_FRAME_PKT) {
+			if (pkt->kind == AOM_CODEC_STATS_PKT) {
+				store_first_pass(pkt);
+			} else if (pkt->kind == AOM_CODEC_CX_FRAME_PKT) {
 				// Status
 				packet->type     = OBS_ENCODER_VIDEO;
 				packet->keyframe = ((pkt->data.frame.flags & AOM_FRAME_IS_KEY) == AOM_FRAME_IS_KEY)
@@ -1146,12 +1513,21 @@ bool streamfx::encoder::aom::av1::aom_av1_instance::encode_video(encoder_frame*
 				packet->dts = pkt->data.frame.pts;
 
 				*received_packet = true;
+				if (_frames_pending > 0) {
+					--_frames_pending;
+				}
 			}
 
 			if (*received_packet == true)
 				break;
 		}
 
+		// Real-Time Screen Content promises that every frame leaves the encoder in the same call it entered it.
+		if ((_settings.mode == encoder_mode::REALTIME_SCREEN_CONTENT) && (_frames_pending >= 1) && !_latency_warned) {
+			D_LOG_WARNING("Encoder latency exceeded one frame, output is no longer real-time.", "");
+			_latency_warned = true;
+		}
+
 		if (!*received_packet) {
 			packet->type = OBS_ENCODER_VIDEO;
 			packet->data = nullptr;
@@ -1171,6 +1547,10 @@ bool streamfx::encoder::aom::av1::aom_av1_instance::encode_video(encoder_frame*
 		}
 	}
 
+	if (_pacer) {
+		pace(std::chrono::high_resolution_clock::now() - start);
+	}
+
 	return true;
 }
 
@@ -1189,8 +1569,10 @@ aom_av1_factory::aom_av1_factory()
 #else
 	// Try loading from the data directory first.
 	libs.push_back(streamfx::data_file_path("libaom.so"));
-	// In any other case, load the system-wide binary.
-	libs.push_back("libaom");
+	// In any other case, load the system-wide binary. Distributions only install the unversioned name with the
+	// development files, so also try the current ABI.
+	libs.push_back("libaom.so");
+	libs.push_back("libaom.so.3");
 #endif
 
 	for (auto lib : libs) {
@@ -1302,8 +1684,10 @@ void* aom_av1_factory::create(obs_data_t* settings, obs_encoder_t* encoder, bool
 void aom_av1_factory::get_defaults2(obs_data_t* settings)
 {
 	{ // Presets
+		obs_data_set_default_int(settings, ST_KEY_ENCODER_MODE, static_cast<long long>(encoder_mode::CUSTOM));
 		obs_data_set_default_int(settings, ST_KEY_ENCODER_USAGE, static_cast<long long>(AOM_USAGE_REALTIME));
 		obs_data_set_default_int(settings, ST_KEY_ENCODER_CPUUSAGE, -1);
+		obs_data_set_default_bool(settings, ST_KEY_ENCODER_CPUUSAGE_ADAPTIVE, false);
 		obs_data_set_default_int(settings, ST_KEY_ENCODER_PROFILE,
 								 static_cast<long long>(codec::av1::profile::UNKNOWN));
 	}
@@ -1329,6 +1713,7 @@ void aom_av1_factory::get_defaults2(obs_data_t* settings)
 		obs_data_set_default_int(settings, ST_KEY_KEYFRAMES_INTERVALTYPE, 0);
 		obs_data_set_default_double(settings, ST_KEY_KEYFRAMES_INTERVAL_SECONDS, 2.0);
 		obs_data_set_default_int(settings, ST_KEY_KEYFRAMES_INTERVAL_FRAMES, 300);
+		obs_data_set_default_bool(settings, ST_KEY_KEYFRAMES_SCENEAWARE, false);
 	}
 
 	{ // Advanced Options
@@ -1338,18 +1723,26 @@ void aom_av1_factory::get_defaults2(obs_data_t* settings)
 		obs_data_set_default_int(settings, ST_KEY_ADVANCED_TILE_ROWS, -1);
 		obs_data_set_default_int(settings, ST_KEY_ADVANCED_TUNE_METRIC, -1);
 		obs_data_set_default_int(settings, ST_KEY_ADVANCED_TUNE_CONTENT, static_cast<long long>(AOM_CONTENT_DEFAULT));
+		obs_data_set_default_bool(settings, ST_KEY_ADVANCED_FIRSTPASS, false);
+		obs_data_set_default_string(settings, ST_KEY_ADVANCED_FIRSTPASS_PATH, "");
 	}
 }
 
 static bool modified_usage(obs_properties_t* props, obs_property_t*, obs_data_t* settings) noexcept
 try {
+	bool is_custom    = obs_data_get_int(settings, ST_KEY_ENCODER_MODE) == static_cast<long long>(encoder_mode::CUSTOM);
 	bool is_all_intra = false;
-	if (obs_data_get_int(settings, ST_KEY_ENCODER_USAGE) == AOM_USAGE_ALL_INTRA) {
+	if (is_custom && (obs_data_get_int(settings, ST_KEY_ENCODER_USAGE) == AOM_USAGE_ALL_INTRA)) {
 		is_all_intra = true;
 	}
 
+	// Modes other than Custom decide these on their own.
+	obs_property_set_visible(obs_properties_get(props, ST_KEY_ENCODER_USAGE), is_custom);
+	obs_property_set_visible(obs_properties_get(props, ST_KEY_RATECONTROL_MODE), is_custom);
+	obs_property_set_visible(obs_properties_get(props, ST_KEY_ADVANCED_TUNE_CONTENT), is_custom);
+
 	// All-Intra does not support these.
-	obs_property_set_visible(obs_properties_get(props, ST_KEY_RATECONTROL_LOOKAHEAD), !is_all_intra);
+	obs_property_set_visible(obs_properties_get(props, ST_KEY_RATECONTROL_LOOKAHEAD), is_custom && !is_all_intra);
 	obs_property_set_visible(obs_properties_get(props, ST_I18N_KEYFRAMES), !is_all_intra);
 
 	return true;
@@ -1367,8 +1760,11 @@ try {
 	bool is_overundershoot_visible = false;
 	bool is_quality_visible        = false;
 
-	// Fix rate control mode selection if ALL_INTRA is selected.
-	if (obs_data_get_int(settings, ST_KEY_ENCODER_USAGE) == AOM_USAGE_ALL_INTRA) {
+	// Fix rate control mode selection if ALL_INTRA or Real-Time Screen Content is selected.
+	if (obs_data_get_int(settings, ST_KEY_ENCODER_MODE)
+		== static_cast<long long>(encoder_mode::REALTIME_SCREEN_CONTENT)) {
+		obs_data_set_int(settings, ST_KEY_RATECONTROL_MODE, static_cast<long long>(aom_rc_mode::AOM_CBR));
+	} else if (obs_data_get_int(settings, ST_KEY_ENCODER_USAGE) == AOM_USAGE_ALL_INTRA) {
 		obs_data_set_int(settings, ST_KEY_RATECONTROL_MODE, static_cast<long long>(aom_rc_mode::AOM_Q));
 	}
 
@@ -1406,6 +1802,19 @@ try {
 	return false;
 }
 
+static bool modified_firstpass(obs_properties_t* props, obs_property_t*, obs_data_t* settings) noexcept
+try {
+	bool is_enabled = obs_data_get_bool(settings, ST_KEY_ADVANCED_FIRSTPASS);
+	obs_property_set_visible(obs_properties_get(props, ST_KEY_ADVANCED_FIRSTPASS_PATH), is_enabled);
+	return true;
+} catch (const std::exception& ex) {
+	DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
+	return false;
+} catch (...) {
+	DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+	return false;
+}
+
 static bool modified_keyframes(obs_properties_t* props, obs_property_t*, obs_data_t* settings) noexcept
 try {
 	bool is_seconds = obs_data_get_int(settings, ST_KEY_KEYFRAMES_INTERVALTYPE) == 0;
@@ -1436,6 +1845,16 @@ obs_properties_t* aom_av1_factory::get_properties2(instance_t* data)
 		obs_properties_add_group(props, ST_I18N_ENCODER, D_TRANSLATE(ST_I18N_ENCODER), OBS_GROUP_NORMAL, grp);
 		//obs_properties_add_group(props, S_CODEC_AV1, D_TRANSLATE(S_CODEC_AV1), OBS_GROUP_NORMAL, grp);
 
+		{ // Mode
+			auto p = obs_properties_add_list(grp, ST_KEY_ENCODER_MODE, D_TRANSLATE(ST_I18N_ENCODER_MODE),
+											 OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+			obs_property_set_modified_callback(p, modified_usage);
+			obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_ENCODER_MODE_CUSTOM),
+									  static_cast<long long>(encoder_mode::CUSTOM));
+			obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_ENCODER_MODE_REALTIMESCREENCONTENT),
+									  static_cast<long long>(encoder_mode::REALTIME_SCREEN_CONTENT));
+		}
+
 		{ // Usage
 			auto p = obs_properties_add_list(grp, ST_KEY_ENCODER_USAGE, D_TRANSLATE(ST_I18N_ENCODER_USAGE),
 											 OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
@@ -1464,6 +1883,11 @@ obs_properties_t* aom_av1_factory::get_properties2(instance_t* data)
 			obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_ENCODER_CPUUSAGE_1), 1);
 			obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_ENCODER_CPUUSAGE_0), 0);
 		}
+
+		{ // Adaptive CPU Usage
+			obs_properties_add_bool(grp, ST_KEY_ENCODER_CPUUSAGE_ADAPTIVE,
+									D_TRANSLATE(ST_I18N_ENCODER_CPUUSAGE_ADAPTIVE));
+		}
 #endif
 
 		{ // Profile
@@ -1595,6 +2019,10 @@ obs_properties_t* aom_av1_factory::get_properties2(instance_t* data)
 									   0, std::numeric_limits<int32_t>::max(), 1);
 			obs_property_int_set_suffix(p, " frames");
 		}
+
+		{ // Scene-Aware Key-Frames
+			obs_properties_add_bool(grp, ST_KEY_KEYFRAMES_SCENEAWARE, D_TRANSLATE(ST_I18N_KEYFRAMES_SCENEAWARE));
+		}
 	}
 
 	{ // Advanced Options
@@ -1670,6 +2098,15 @@ obs_properties_t* aom_av1_factory::get_properties2(instance_t* data)
 			}
 #endif
 		}
+
+		{ // First-Pass Statistics
+			auto p = obs_properties_add_bool(grp, ST_KEY_ADVANCED_FIRSTPASS, D_TRANSLATE(ST_I18N_ADVANCED_FIRSTPASS));
+			obs_property_set_long_description(p, D_TRANSLATE(ST_I18N_ADVANCED_FIRSTPASS_DESCRIPTION));
+			obs_property_set_modified_callback(p, modified_firstpass);
+
+			obs_properties_add_path(grp, ST_KEY_ADVANCED_FIRSTPASS_PATH, D_TRANSLATE(ST_I18N_ADVANCED_FIRSTPASS_PATH),
+									OBS_PATH_DIRECTORY, nullptr, nullptr);
+		}
 	}
 
 	return props;
@@ -23,8 +23,12 @@
 #include <memory>
 #include <queue>
 #include "encoders/codecs/av1.hpp"
+#include "encoders/encoder-pacer.hpp"
+#include "encoders/encoder-roi.hpp"
+#include "encoders/encoder-scene-analyzer.hpp"
 #include "obs/obs-encoder-factory.hpp"
 #include "util/util-library.hpp"
+#include "util/util-mapped-file.hpp"
 #include "util/util-profiler.hpp"
 
 #include <aom/aomcx.h>
@@ -32,6 +36,11 @@
 namespace streamfx::encoder::aom::av1 {
 	class aom_av1_factory;
 
+	enum class encoder_mode : int8_t {
+		CUSTOM                  = 0, // Every option is user controlled.
+		REALTIME_SCREEN_CONTENT = 1, // Low-latency live streaming of screen content.
+	};
+
 	class aom_av1_instance : public obs::encoder_instance {
 		std::shared_ptr<aom_av1_factory> _factory;
 
@@ -42,7 +51,15 @@ namespace streamfx::encoder::aom::av1 {
 		std::vector<aom_image_t> _images;
 		aom_fixed_buf_t*         _global_headers;
 
-		bool _initialized;
+		// First-Pass Statistics
+		aom_codec_ctx_t                              _fp_ctx;
+		aom_codec_enc_cfg_t                          _fp_cfg;
+		std::shared_ptr<streamfx::util::mapped_file> _fp_file;
+		size_t                                       _fp_size;
+
+		bool     _initialized;
+		uint64_t _frames_pending;
+		bool     _latency_warned;
 		struct {
 			// Video (All Static)
 			uint16_t width;
@@ -61,8 +78,10 @@ namespace streamfx::encoder::aom::av1 {
 			bool                           monochrome;
 
 			// Encoder
+			encoder_mode        mode;    // Static
 			codec::av1::profile profile; // Static
 			int8_t              preset;
+			bool                preset_adaptive;
 
 			// Rate Control
 			aom_rc_mode rc_mode;      // Static
@@ -81,6 +100,7 @@ namespace streamfx::encoder::aom::av1 {
 			aom_kf_mode kf_mode;
 			int32_t     kf_distance_min;
 			int32_t     kf_distance_max;
+			bool        kf_scene_aware;
 
 			// Threads and Tiling (All Static)
 			int8_t           threads;
@@ -91,6 +111,18 @@ namespace streamfx::encoder::aom::av1 {
 			aom_tune_content tune_content;
 		} _settings;
 
+		// Pacing
+		std::unique_ptr<::streamfx::encoder::pacer> _pacer;
+
+		// Scene Analysis
+		std::unique_ptr<::streamfx::encoder::scene_analyzer> _scene_analyzer;
+
+		// Regions of Interest
+		bool                                    _roi_supported;
+		::streamfx::encoder::roi_clock           _roi_clock;
+		std::vector<::streamfx::encoder::region> _roi_regions;
+		std::vector<uint8_t>                    _roi_map;
+
 #ifdef ENABLE_PROFILING
 		std::shared_ptr<streamfx::util::profiler> _profiler_copy;
 		std::shared_ptr<streamfx::util::profiler> _profiler_encode;
@@ -114,6 +146,17 @@ namespace streamfx::encoder::aom::av1 {
 		virtual void get_video_info(struct video_scale_info* info);
 
 		virtual bool encode_video(encoder_frame* frame, encoder_packet* packet, bool* received_packet);
+
+		private:
+		void initialize_first_pass(obs_data_t* settings);
+
+		bool receive_first_pass();
+
+		void store_first_pass(const aom_codec_cx_pkt_t* pkt);
+
+		void pace(std::chrono::nanoseconds duration);
+
+		void update_regions(int64_t pts);
 	};
 
 	class aom_av1_factory : public obs::encoder_factory<aom_av1_factory, aom_av1_instance> {
@@ -22,7 +22,12 @@
 #include "encoder-ffmpeg.hpp"
 #include "strings.hpp"
 #include <sstream>
+#include "codecs/av1.hpp"
+#include "codecs/h264.hpp"
 #include "codecs/hevc.hpp"
+#include "encoder-roi.hpp"
+#include "ffmpeg/plane-copy.hpp"
+#include "ffmpeg/probe-cache.hpp"
 #include "ffmpeg/tools.hpp"
 #include "handlers/debug_handler.hpp"
 #include "obs/gs/gs-helper.hpp"
@@ -51,6 +56,7 @@ extern "C" {
 #include <libavutil/frame.h>
 #include <libavutil/opt.h>
 #include <libavutil/pixdesc.h>
+#include <libavutil/samplefmt.h>
 #pragma warning(pop)
 }
 
@@ -71,6 +77,8 @@ extern "C" {
 #define ST_KEY_FFMPEG_STANDARDCOMPLIANCE "FFmpeg.StandardCompliance"
 #define ST_I18N_FFMPEG_GPU ST_I18N_FFMPEG ".GPU"
 #define ST_KEY_FFMPEG_GPU "FFmpeg.GPU"
+#define ST_I18N_FFMPEG_SHAREDCONVERSION ST_I18N_FFMPEG ".SharedConversion"
+#define ST_KEY_FFMPEG_SHAREDCONVERSION "FFmpeg.SharedConversion"
 
 #define ST_I18N_KEYFRAMES ST_I18N_FFMPEG ".KeyFrames"
 #define ST_I18N_KEYFRAMES_INTERVALTYPE ST_I18N_KEYFRAMES ".IntervalType"
@@ -79,6 +87,13 @@ extern "C" {
 #define ST_I18N_KEYFRAMES_INTERVAL ST_I18N_KEYFRAMES ".Interval"
 #define ST_KEY_KEYFRAMES_INTERVAL_SECONDS "KeyFrames.Interval.Seconds"
 #define ST_KEY_KEYFRAMES_INTERVAL_FRAMES "KeyFrames.Interval.Frames"
+#define ST_I18N_KEYFRAMES_SCENEAWARE ST_I18N_KEYFRAMES ".SceneAware"
+#define ST_KEY_KEYFRAMES_SCENEAWARE "KeyFrames.SceneAware"
+
+#define ST_SIGNAL_EXTRA_DATA_CHANGED "extra_data_changed"
+
+// Free frames kept for re-use, which covers the delay of the encoders this is used with.
+#define FREE_FRAMES_CAPACITY 32
 
 using namespace streamfx::encoder::ffmpeg;
 using namespace streamfx::encoder::codec;
@@ -92,14 +107,23 @@ ffmpeg_instance::ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool
 
 	  _codec(_factory->get_avcodec()), _context(nullptr), _handler(ffmpeg_manager::get()->get_handler(_codec->name)),
 
-	  _scaler(), _packet(),
+	  _scaler(), _scaler_widen(false), _packet(), _group(),
 
 	  _hwapi(), _hwinst(),
 
-	  _lag_in_frames(0), _sent_frames(0), _have_first_frame(false), _extra_data(), _sei_data(),
+	  _lag_in_frames(0), _sent_frames(0), _have_first_frame(false), _extra_data_hash(0), _extra_data(), _sei_data(),
+	  _av1_sequence_header(), _hevc_max_temporal_id(std::numeric_limits<uint8_t>::max()), _scene_analyzer(),
+	  _roi_clock(),
 
-	  _free_frames(), _used_frames(), _free_frames_last_used()
+	  _free_frames(true, FREE_FRAMES_CAPACITY), _used_frames()
 {
+#ifdef ENABLE_PROFILING
+	// Profilers
+	_profiler_copy    = streamfx::util::profiler::create();
+	_profiler_send    = streamfx::util::profiler::create();
+	_profiler_receive = streamfx::util::profiler::create();
+#endif
+
 	// Initialize GPU Stuff
 	if (is_hw) {
 		// Abort if user specified manual override.
@@ -150,10 +174,61 @@ ffmpeg_instance::ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool
 	if (res < 0) {
 		throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
 	}
+
+	// Audio encoders create their global header when opened, and outputs may ask for it before the first packet.
+	if ((_codec->type == AVMEDIA_TYPE_AUDIO) && (_context->extradata != nullptr)) {
+		_extra_data.assign(_context->extradata, _context->extradata + _context->extradata_size);
+	}
 }
 
+#ifdef ENABLE_PROFILING
+static void log_timings(const char* codec, const char* name, std::shared_ptr<streamfx::util::profiler> profiler)
+{
+	DLOG_INFO("[%s] %-7s | %13.1f | %13" PRId64 " | %13" PRId64 " | %13" PRId64 " | %9" PRIu64, codec, name,
+			  profiler->average_duration() / 1000.,
+			  std::chrono::duration_cast<std::chrono::microseconds>(profiler->percentile(0.999)).count(),
+			  std::chrono::duration_cast<std::chrono::microseconds>(profiler->percentile(0.990)).count(),
+			  std::chrono::duration_cast<std::chrono::microseconds>(profiler->percentile(0.950)).count(),
+			  profiler->count());
+}
+#endif
+
 ffmpeg_instance::~ffmpeg_instance()
 {
+#ifdef ENABLE_PROFILING
+	// Profiling
+	DLOG_INFO("[%s] Timings | Avg. µs       | 99.9ile µs    | 99.0ile µs    | 95.0ile µs    | Samples  ", _codec->name);
+	DLOG_INFO("[%s] --------+---------------+---------------+---------------+---------------+----------", _codec->name);
+	log_timings(_codec->name, "Copy", _profiler_copy);
+	log_timings(_codec->name, "Send", _profiler_send);
+	log_timings(_codec->name, "Receive", _profiler_receive);
+	{
+		// Throughput if this encoder had a core to itself, ignoring time spent waiting on libOBS.
+		auto total = _profiler_copy->total_duration() + _profiler_send->total_duration()
+					 + _profiler_receive->total_duration();
+		if (total.count() > 0) {
+			DLOG_INFO("[%s] Throughput: %.2f frames per second", _codec->name,
+					  static_cast<double_t>(_profiler_send->count())
+						  / std::chrono::duration_cast<std::chrono::duration<double_t>>(total).count());
+		}
+	}
+#endif
+
+	if (_scene_analyzer) {
+		DLOG_INFO("[%s] Scene Analysis: %" PRIu64 " cut(s), %" PRIu64 " deferred key-frame(s).", _codec->name,
+				  _scene_analyzer->count_cuts(), _scene_analyzer->count_deferrals());
+	}
+
+	{
+		auto stats = _free_frames.get_statistics();
+		DLOG_INFO("[%s] Frame Pool: %" PRIu64 " reused, %" PRIu64 " recycled, %" PRIu64 " allocated, %" PRIu64
+				  " released.", _codec->name, stats.hits, stats.recycled, stats.misses, stats.dropped);
+	}
+
+	if (_group) {
+		_group->leave(this);
+	}
+
 	auto gctx = streamfx::obs::gs::context();
 	if (_context) {
 		// Flush encoders that require it.
@@ -183,6 +258,8 @@ void ffmpeg_instance::get_properties(obs_properties_t* props)
 	obs_property_set_enabled(obs_properties_get(props, ST_KEY_KEYFRAMES_INTERVALTYPE), false);
 	obs_property_set_enabled(obs_properties_get(props, ST_KEY_KEYFRAMES_INTERVAL_SECONDS), false);
 	obs_property_set_enabled(obs_properties_get(props, ST_KEY_KEYFRAMES_INTERVAL_FRAMES), false);
+	obs_property_set_enabled(obs_properties_get(props, ST_KEY_KEYFRAMES_SCENEAWARE), false);
+	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_SHAREDCONVERSION), false);
 
 	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_COLORFORMAT), false);
 	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_THREADS), false);
@@ -196,6 +273,17 @@ void ffmpeg_instance::migrate(obs_data_t* settings, uint64_t version)
 		_handler->migrate(settings, version, _codec, _context);
 }
 
+static bool has_luma_plane(AVPixelFormat format)
+{
+	// Any YUV/Gray format with 8-bit luma packed tightly into the first plane works, which includes NV12.
+	const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+	if (!desc || (desc->flags & (AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_HWACCEL))) {
+		return false;
+	}
+	return (desc->comp[0].plane == 0) && (desc->comp[0].step == 1) && (desc->comp[0].offset == 0)
+		   && (desc->comp[0].depth == 8);
+}
+
 bool ffmpeg_instance::update(obs_data_t* settings)
 {
 	// FFmpeg Options
@@ -212,7 +300,7 @@ bool ffmpeg_instance::update(obs_data_t* settings)
 			_context->thread_type |= FF_THREAD_SLICE;
 		}
 		if (_context->thread_type != 0) {
-			int64_t threads = obs_data_get_int(settings, ST_I18N_FFMPEG_THREADS);
+			int64_t threads = obs_data_get_int(settings, ST_KEY_FFMPEG_THREADS);
 			if (threads > 0) {
 				_context->thread_count = static_cast<int>(threads);
 			} else {
@@ -249,6 +337,23 @@ bool ffmpeg_instance::update(obs_data_t* settings)
 		} else {
 			_context->gop_size = static_cast<int>(obs_data_get_int(settings, ST_KEY_KEYFRAMES_INTERVAL_FRAMES));
 		}
+
+		// Scene analysis needs the luma plane of the input, which hardware frames don't give us.
+		_scene_analyzer.reset();
+		if (!_hwinst && obs_data_get_bool(settings, ST_KEY_KEYFRAMES_SCENEAWARE)
+			&& has_luma_plane(_scaler.get_source_format())) {
+			uint32_t distance = static_cast<uint32_t>(std::max(_context->gop_size, 0));
+			_scene_analyzer   = std::make_unique<::streamfx::encoder::scene_analyzer>(
+				  _scaler.get_source_width(), _scaler.get_source_height(),
+				  std::max<uint32_t>(ovi.fps_num / ovi.fps_den / 2, 1), distance, distance * 2);
+
+			// The analyzer places the scheduled key-frames, and may hold them back up to twice as long.
+			_context->gop_size *= 2;
+
+			// NVENC only turns forced I-frames into IDR frames when asked to.
+			av_opt_set_int(_context, "forced-idr", 1, AV_OPT_SEARCH_CHILDREN);
+		}
+
 		_context->keyint_min = _context->gop_size;
 	}
 
@@ -295,6 +400,7 @@ bool ffmpeg_instance::update(obs_data_t* settings)
 					  ::streamfx::ffmpeg::tools::get_pixel_format_name(_scaler.get_target_format()),
 					  ::streamfx::ffmpeg::tools::get_color_space_name(_scaler.get_target_colorspace()),
 					  _scaler.is_target_full_range() ? "Full" : "Partial");
+			DLOG_INFO("[%s]     Shared Conversion: %s", _codec->name, _group ? "Enabled" : "Disabled");
 			if (!_hwinst)
 				DLOG_INFO("[%s]     On GPU Index: %lli", _codec->name, obs_data_get_int(settings, ST_KEY_FFMPEG_GPU));
 		}
@@ -325,37 +431,132 @@ static inline void copy_data(encoder_frame* frame, AVFrame* vframe)
 			continue;
 
 		std::size_t plane_height = static_cast<size_t>(vframe->height) >> (idx ? v_chroma_shift : 0);
+		std::size_t ls_in        = static_cast<size_t>(frame->linesize[idx]);
+		std::size_t ls_out       = static_cast<size_t>(vframe->linesize[idx]);
 
-		if (static_cast<uint32_t>(vframe->linesize[idx]) == frame->linesize[idx]) {
-			std::memcpy(vframe->data[idx], frame->data[idx], frame->linesize[idx] * plane_height);
-		} else {
-			std::size_t ls_in  = static_cast<size_t>(frame->linesize[idx]);
-			std::size_t ls_out = static_cast<size_t>(vframe->linesize[idx]);
-			std::size_t bytes  = ls_in < ls_out ? ls_in : ls_out;
-
-			uint8_t* to   = vframe->data[idx];
-			uint8_t* from = frame->data[idx];
+		::streamfx::ffmpeg::copy_plane(vframe->data[idx], ls_out, frame->data[idx], ls_in, std::min(ls_in, ls_out),
+									   plane_height);
+	}
+}
 
-			for (std::size_t y = 0; y < plane_height; y++) {
-				std::memcpy(to, from, bytes);
-				to += ls_out;
-				from += ls_in;
-			}
+static bool can_widen_data(AVPixelFormat source, AVPixelFormat target)
+{
+	// Only planar YUV/Gray formats that differ in nothing but bit depth, from 8-bit to little-endian 9 to 16-bit.
+	const uint64_t unsupported_flags = AV_PIX_FMT_FLAG_BE | AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM
+									   | AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_FLOAT;
+	const AVPixFmtDescriptor* src = av_pix_fmt_desc_get(source);
+	const AVPixFmtDescriptor* dst = av_pix_fmt_desc_get(target);
+	if (!src || !dst || (source == target)) {
+		return false;
+	}
+	if (((src->flags | dst->flags) & unsupported_flags) || !(src->flags & dst->flags & AV_PIX_FMT_FLAG_PLANAR)) {
+		return false;
+	}
+	if ((src->nb_components != dst->nb_components) || (src->log2_chroma_w != dst->log2_chroma_w)
+		|| (src->log2_chroma_h != dst->log2_chroma_h)) {
+		return false;
+	}
+	for (std::size_t idx = 0; idx < src->nb_components; idx++) {
+		const AVComponentDescriptor& in  = src->comp[idx];
+		const AVComponentDescriptor& out = dst->comp[idx];
+		if ((in.plane != out.plane) || (in.depth != 8) || (in.step != 1) || (in.shift != 0) || (out.depth <= 8)
+			|| (out.depth != dst->comp[0].depth) || (out.step != 2) || (out.shift != 0)) {
+			return false;
 		}
 	}
+	return true;
+}
+
+static inline void widen_data(encoder_frame* frame, AVFrame* vframe, bool full_range)
+{
+	const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(vframe->format));
+
+	for (std::size_t idx = 0; idx < desc->nb_components; idx++) {
+		const AVComponentDescriptor& comp = desc->comp[idx];
+		if (!frame->data[comp.plane] || !vframe->data[comp.plane])
+			continue;
+
+		// Component 0 is luma, 1 and 2 are chroma, and 3 is always full range alpha.
+		bool        is_chroma = (idx == 1) || (idx == 2);
+		bool        replicate = (idx == 3) || ((idx == 0) && full_range);
+		int         w_shift   = is_chroma ? desc->log2_chroma_w : 0;
+		int         h_shift   = is_chroma ? desc->log2_chroma_h : 0;
+		std::size_t width     = (static_cast<size_t>(vframe->width) + (1ull << w_shift) - 1) >> w_shift;
+		std::size_t height    = (static_cast<size_t>(vframe->height) + (1ull << h_shift) - 1) >> h_shift;
+
+		::streamfx::ffmpeg::widen_plane(reinterpret_cast<uint16_t*>(vframe->data[comp.plane]),
+										static_cast<size_t>(vframe->linesize[comp.plane]), frame->data[comp.plane],
+										static_cast<size_t>(frame->linesize[comp.plane]), width, height,
+										static_cast<uint8_t>(comp.depth), replicate);
+	}
 }
 
 bool ffmpeg_instance::encode_audio(struct encoder_frame* frame, struct encoder_packet* packet, bool* received_packet)
 {
-	throw std::logic_error("The method or operation is not implemented.");
+	// libOBS always delivers exactly get_frame_size() samples, in the format requested by get_audio_info().
+	std::size_t frame_size = get_frame_size();
+	if (frame->frames > frame_size) {
+		DLOG_ERROR("Received %" PRIu32 " samples, but expected at most %" PRIu64 ".", frame->frames,
+				   static_cast<uint64_t>(frame_size));
+		return false;
+	}
+
+	std::shared_ptr<AVFrame> aframe = pop_free_frame(); // Retrieve an empty frame.
+
+	// Recycled frames keep the sample count of their last use, while their buffer still holds a full frame. The encoder
+	// may also still hold a reference to it, in which case it needs a fresh buffer of the full size.
+	aframe->nb_samples = static_cast<int>(frame_size);
+	if (int res = av_frame_make_writable(aframe.get()); res < 0) {
+		DLOG_ERROR("Failed to prepare frame: %s (%" PRId32 ").", ::streamfx::ffmpeg::tools::get_error_description(res),
+				   res);
+		return false;
+	}
+
+	{
+#ifdef ENABLE_PROFILING
+		auto profile = _profiler_copy->track();
+#endif
+		aframe->nb_samples = static_cast<int>(frame->frames);
+		aframe->pts        = frame->pts;
+		av_samples_copy(aframe->extended_data, frame->data, 0, 0, aframe->nb_samples, _context->channels,
+						_context->sample_fmt);
+	}
+
+	if (!encode_avframe(aframe, packet, received_packet))
+		return false;
+
+	return true;
 }
 
 bool ffmpeg_instance::encode_video(struct encoder_frame* frame, struct encoder_packet* packet, bool* received_packet)
 {
-	std::shared_ptr<AVFrame> vframe = pop_free_frame(); // Retrieve an empty frame.
+	std::shared_ptr<AVFrame> vframe;
+
+	// Look at the luma plane while it is being copied anyway.
+	bool is_cut =
+		_scene_analyzer && _scene_analyzer->analyze(frame->data[0], static_cast<size_t>(frame->linesize[0]));
 
 	// Convert frame.
-	{
+	if (_group) {
+#ifdef ENABLE_PROFILING
+		auto profile = _profiler_copy->track();
+#endif
+		// Whichever encoder of the group gets here first converts the frame for all of them.
+		vframe = _group->convert(this, frame);
+		if (!vframe) {
+			DLOG_ERROR("[%s] Failed to retrieve frame from shared conversion.", _codec->name);
+			return false;
+		}
+
+		vframe->color_primaries = _context->color_primaries;
+		vframe->color_trc       = _context->color_trc;
+		vframe->pts             = frame->pts;
+	} else {
+#ifdef ENABLE_PROFILING
+		auto profile = _profiler_copy->track();
+#endif
+		vframe = pop_free_frame(); // Retrieve an empty frame.
+
 		vframe->height          = _context->height;
 		vframe->format          = _context->pix_fmt;
 		vframe->color_range     = _context->color_range;
@@ -368,6 +569,8 @@ bool ffmpeg_instance::encode_video(struct encoder_frame* frame, struct encoder_p
 			&& (_scaler.get_source_colorspace() == _scaler.get_target_colorspace())
 			&& (_scaler.get_source_format() == _scaler.get_target_format())) {
 			copy_data(frame, vframe.get());
+		} else if (_scaler_widen) {
+			widen_data(frame, vframe.get(), _scaler.is_target_full_range());
 		} else {
 			int res = _scaler.convert(reinterpret_cast<uint8_t**>(frame->data), reinterpret_cast<int*>(frame->linesize),
 									  0, _context->height, vframe->data, vframe->linesize);
@@ -379,6 +582,9 @@ bool ffmpeg_instance::encode_video(struct encoder_frame* frame, struct encoder_p
 		}
 	}
 
+	// Frames are recycled, so always reset the type.
+	vframe->pict_type = is_cut ? AV_PICTURE_TYPE_I : AV_PICTURE_TYPE_NONE;
+
 	if (!encode_avframe(vframe, packet, received_packet))
 		return false;
 
@@ -396,7 +602,12 @@ bool ffmpeg_instance::encode_video(uint32_t handle, int64_t pts, uint64_t lock_k
 	}
 
 	std::shared_ptr<AVFrame> vframe = pop_free_frame();
-	_hwinst->copy_from_obs(_context->hw_frames_ctx, handle, lock_key, next_key, vframe);
+	{
+#ifdef ENABLE_PROFILING
+		auto profile = _profiler_copy->track();
+#endif
+		_hwinst->copy_from_obs(_context->hw_frames_ctx, handle, lock_key, next_key, vframe);
+	}
 
 	vframe->color_range     = _context->color_range;
 	vframe->colorspace      = _context->colorspace;
@@ -465,7 +676,16 @@ void ffmpeg_instance::initialize_sw(obs_data_t* settings)
 		// provides better support for scaling algorithms, such as Bicubic.
 		_context->chroma_sample_location = AVCHROMA_LOC_CENTER;
 
-		_scaler.set_source_size(static_cast<uint32_t>(_context->width), static_cast<uint32_t>(_context->height));
+		// Encoders of the same video output may share a single conversion and downscale pyramid, in which case that
+		// takes over scaling from libOBS and frames arrive at the size of the video output.
+		if (obs_data_get_bool(settings, ST_KEY_FFMPEG_SHAREDCONVERSION)) {
+			_group = ::streamfx::ffmpeg::encode_group::get(obs_encoder_video(_self));
+			_group->join(this, {static_cast<uint32_t>(_context->width), static_cast<uint32_t>(_context->height),
+								_pixfmt_target, _context->colorspace, _context->color_range == AVCOL_RANGE_JPEG});
+			_scaler.set_source_size(_group->get_input().width, _group->get_input().height);
+		} else {
+			_scaler.set_source_size(static_cast<uint32_t>(_context->width), static_cast<uint32_t>(_context->height));
+		}
 		_scaler.set_source_color(_context->color_range == AVCOL_RANGE_JPEG, _context->colorspace);
 		_scaler.set_source_format(_pixfmt_source);
 
@@ -484,6 +704,57 @@ void ffmpeg_instance::initialize_sw(obs_data_t* settings)
 				 << (_scaler.is_source_full_range() ? "full" : "partial") << " range.";
 			throw std::runtime_error(sstr.str());
 		}
+
+		// Conversions that only add bit depth don't need the full scaler, which is a lot slower at them.
+		_scaler_widen = (_scaler.is_source_full_range() == _scaler.is_target_full_range())
+						&& (_scaler.get_source_colorspace() == _scaler.get_target_colorspace())
+						&& can_widen_data(_pixfmt_source, _pixfmt_target);
+
+		// Frames for the encoder are allocated by the pool at the size and format of the encoder.
+		_free_frames.set_resolution(_context->width, _context->height);
+		_free_frames.set_pixel_format(_pixfmt_target);
+	} else if (_codec->type == AVMEDIA_TYPE_AUDIO) {
+		// Initialize Audio Encoding
+		auto aoi = audio_output_get_info(obs_encoder_audio(_self));
+
+		// Setup from OBS information.
+		::streamfx::ffmpeg::tools::context_setup_from_obs(aoi, _context);
+
+		// libOBS converts audio into whatever get_audio_info() asks for, so pick a format the encoder accepts directly.
+		// The native format is preferred, followed by the order of preference of the encoder.
+		if (_codec->sample_fmts) {
+			AVSampleFormat sample_fmt = AV_SAMPLE_FMT_NONE;
+			for (auto ptr = _codec->sample_fmts; *ptr != AV_SAMPLE_FMT_NONE; ptr++) {
+				if (*ptr == _context->sample_fmt) {
+					sample_fmt = *ptr;
+					break;
+				} else if ((sample_fmt == AV_SAMPLE_FMT_NONE)
+						   && (::streamfx::ffmpeg::tools::avsampleformat_to_obs_audioformat(*ptr)
+							   != AUDIO_FORMAT_UNKNOWN)) {
+					sample_fmt = *ptr;
+				}
+			}
+			if (sample_fmt == AV_SAMPLE_FMT_NONE) {
+				throw std::runtime_error("Encoder does not support any sample format provided by libOBS.");
+			}
+			_context->sample_fmt = sample_fmt;
+		}
+
+		// Same for the sample rate, where the closest supported one is used.
+		if (_codec->supported_samplerates) {
+			int sample_rate = 0;
+			for (auto ptr = _codec->supported_samplerates; *ptr != 0; ptr++) {
+				if ((sample_rate == 0)
+					|| (std::abs(*ptr - _context->sample_rate) < std::abs(sample_rate - _context->sample_rate))) {
+					sample_rate = *ptr;
+				}
+			}
+			_context->sample_rate   = sample_rate;
+			_context->time_base.den = sample_rate;
+		}
+
+		// Outputs expect codec configuration to be available out-of-band.
+		_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
 	}
 }
 
@@ -525,25 +796,28 @@ void ffmpeg_instance::initialize_hw(obs_data_t*)
 
 void ffmpeg_instance::push_free_frame(std::shared_ptr<AVFrame> frame)
 {
-	auto now = std::chrono::high_resolution_clock::now();
-	if (_free_frames.size() > 0) {
-		if ((now - _free_frames_last_used) < std::chrono::seconds(1)) {
-			_free_frames.push(frame);
-		}
-	} else {
-		_free_frames.push(frame);
-		_free_frames_last_used = std::chrono::high_resolution_clock::now();
+	if (!frame) {
+		return;
+	}
+	if (_group && (_codec->type == AVMEDIA_TYPE_VIDEO)) {
+		// These reference the buffers of the group, which converts into new ones once nobody else uses them.
+		return;
 	}
+
+	// The pool is a fixed size ring, which releases whatever doesn't fit instead of growing without bounds.
+	_free_frames.push(frame);
 }
 
 std::shared_ptr<AVFrame> ffmpeg_instance::pop_free_frame()
 {
-	std::shared_ptr<AVFrame> frame;
-	if (_free_frames.size() > 0) {
-		// Re-use existing frames first.
-		frame = _free_frames.top();
-		_free_frames.pop();
-	} else {
+	if (!_hwinst && (_codec->type == AVMEDIA_TYPE_VIDEO)) {
+		// Allocates a frame of the configured size and format if none are left.
+		return _free_frames.pop();
+	}
+
+	// Re-use existing frames first.
+	std::shared_ptr<AVFrame> frame = _free_frames.pop_only();
+	if (!frame) {
 		if (_hwinst) {
 			frame = _hwinst->allocate_frame(_context->hw_frames_ctx);
 		} else {
@@ -552,11 +826,12 @@ std::shared_ptr<AVFrame> ffmpeg_instance::pop_free_frame()
 				av_frame_free(&frame);
 			});
 
-			frame->width  = _context->width;
-			frame->height = _context->height;
-			frame->format = _context->pix_fmt;
+			frame->nb_samples     = static_cast<int>(get_frame_size());
+			frame->format         = _context->sample_fmt;
+			frame->channel_layout = _context->channel_layout;
+			frame->channels       = _context->channels;
 
-			int res = av_frame_get_buffer(frame.get(), 32);
+			int res = av_frame_get_buffer(frame.get(), 0);
 			if (res < 0) {
 				throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
 			}
@@ -573,9 +848,17 @@ void ffmpeg_instance::push_used_frame(std::shared_ptr<AVFrame> frame)
 
 std::shared_ptr<AVFrame> ffmpeg_instance::pop_used_frame()
 {
-	auto frame = _used_frames.front();
-	_used_frames.pop();
-	return frame;
+	return _used_frames.pop_only();
+}
+
+size_t ffmpeg_instance::get_frame_size()
+{
+	// libOBS buffers audio until a full frame is available, so reporting the encoder frame size lets it do the
+	// adaptation in its own ring buffer. Encoders without a fixed frame size take what libOBS mixes.
+	if (_context->frame_size > 0) {
+		return static_cast<size_t>(_context->frame_size);
+	}
+	return AUDIO_OUTPUT_FRAMES;
 }
 
 bool ffmpeg_instance::get_extra_data(uint8_t** data, size_t* size)
@@ -598,12 +881,23 @@ bool ffmpeg_instance::get_sei_data(uint8_t** data, size_t* size)
 	return true;
 }
 
+void ffmpeg_instance::get_audio_info(struct audio_convert_info* info)
+{
+	info->format          = ::streamfx::ffmpeg::tools::avsampleformat_to_obs_audioformat(_context->sample_fmt);
+	info->samples_per_sec = static_cast<uint32_t>(_context->sample_rate);
+}
+
 void ffmpeg_instance::get_video_info(struct video_scale_info* info)
 {
 	if (!is_hardware_encode()) {
 		// Override input with supported format if software encode.
 		info->format = ::streamfx::ffmpeg::tools::avpixelformat_to_obs_videoformat(_scaler.get_source_format());
 	}
+	if (_group) {
+		// Scaling happens in the group, so ask for the unscaled frame.
+		info->width  = _scaler.get_source_width();
+		info->height = _scaler.get_source_height();
+	}
 }
 
 int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet* packet)
@@ -613,6 +907,9 @@ int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet
 	av_packet_unref(&_packet);
 
 	{
+#ifdef ENABLE_PROFILING
+		auto profile = _profiler_receive->track();
+#endif
 		auto gctx = streamfx::obs::gs::context();
 		res       = avcodec_receive_packet(_context, &_packet);
 	}
@@ -620,64 +917,114 @@ int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet
 		return res;
 	}
 
-	if (!_have_first_frame) {
-		if (_codec->id == AV_CODEC_ID_H264) {
-			uint8_t*    tmp_packet;
-			uint8_t*    tmp_header;
-			uint8_t*    tmp_sei;
-			std::size_t sz_packet, sz_header, sz_sei;
+	update_extra_data(!!(_packet.flags & AV_PKT_FLAG_KEY));
 
-			obs_extract_avc_headers(_packet.data, static_cast<size_t>(_packet.size), &tmp_packet, &sz_packet,
-									&tmp_header, &sz_header, &tmp_sei, &sz_sei);
+	// Allow Handler Post-Processing
+	if (_handler)
+		_handler->process_avpacket(_packet, _codec, _context);
 
-			if (sz_header) {
-				_extra_data.resize(sz_header);
-				std::memcpy(_extra_data.data(), tmp_header, sz_header);
-			}
+	packet->type     = (_codec->type == AVMEDIA_TYPE_AUDIO) ? OBS_ENCODER_AUDIO : OBS_ENCODER_VIDEO;
+	packet->pts      = _packet.pts;
+	packet->dts      = _packet.dts;
+	packet->data     = _packet.data;
+	packet->size     = static_cast<size_t>(_packet.size);
+	packet->keyframe = !!(_packet.flags & AV_PKT_FLAG_KEY);
+	if (packet->type == OBS_ENCODER_VIDEO) {
+		packet->priority      = get_packet_priority(packet->keyframe);
+		packet->drop_priority = packet->priority;
+	}
+	*received_packet = true;
 
-			if (sz_sei) {
-				_sei_data.resize(sz_sei);
-				std::memcpy(_sei_data.data(), tmp_sei, sz_sei);
-			}
+	push_free_frame(pop_used_frame());
+
+	return res;
+}
 
-			// Not required, we only need the Extra Data and SEI Data anyway.
-			//std::memcpy(_current_packet.data, tmp_packet, sz_packet);
-			//_current_packet.size = static_cast<int>(sz_packet);
+void ffmpeg_instance::update_extra_data(bool is_keyframe)
+{
+	if ((_codec->id == AV_CODEC_ID_H264) || (_codec->id == AV_CODEC_ID_HEVC)) {
+		// Parameter sets can only change on Key-Frames, so skip the scan for everything else.
+		if (_have_first_frame && !is_keyframe) {
+			return;
+		}
 
-			bfree(tmp_packet);
-			bfree(tmp_header);
-			bfree(tmp_sei);
-		} else if (_codec->id == AV_CODEC_ID_HEVC) {
+		uint64_t hash = (_codec->id == AV_CODEC_ID_H264)
+							? h264::hash_header(_packet.data, static_cast<size_t>(_packet.size))
+							: hevc::hash_header(_packet.data, static_cast<size_t>(_packet.size));
+		if ((hash == 0) || (hash == _extra_data_hash)) {
+			_have_first_frame = true;
+			return;
+		}
+
+		_extra_data.clear();
+		_sei_data.clear();
+		if (_codec->id == AV_CODEC_ID_H264) {
+			h264::extract_header_sei(_packet.data, static_cast<size_t>(_packet.size), _extra_data, _sei_data);
+		} else {
 			hevc::extract_header_sei(_packet.data, static_cast<size_t>(_packet.size), _extra_data, _sei_data);
-		} else if (_context->extradata != nullptr) {
+		}
+		_extra_data_hash = hash;
+
+		if (_have_first_frame) {
+			DLOG_INFO("[%s] Parameter sets changed in-band, refreshed extra data.", _codec->name);
+
+			calldata_t cd;
+			calldata_init(&cd);
+			calldata_set_ptr(&cd, "encoder", _self);
+			signal_handler_signal(obs_encoder_get_signal_handler(_self), ST_SIGNAL_EXTRA_DATA_CHANGED, &cd);
+			calldata_free(&cd);
+		}
+	} else if (!_have_first_frame) {
+		if (_context->extradata != nullptr) {
 			_extra_data.resize(static_cast<size_t>(_context->extradata_size));
 			std::memcpy(_extra_data.data(), _context->extradata, static_cast<size_t>(_context->extradata_size));
+		} else if (_codec->id == AV_CODEC_ID_AV1) {
+			av1::extract_sequence_header(_packet.data, static_cast<size_t>(_packet.size), _extra_data);
 		}
-		_have_first_frame = true;
 	}
 
-	// Allow Handler Post-Processing
-	if (_handler)
-		_handler->process_avpacket(_packet, _codec, _context);
+	_have_first_frame = true;
+}
 
-	packet->type          = OBS_ENCODER_VIDEO;
-	packet->pts           = _packet.pts;
-	packet->dts           = _packet.dts;
-	packet->data          = _packet.data;
-	packet->size          = static_cast<size_t>(_packet.size);
-	packet->keyframe      = !!(_packet.flags & AV_PKT_FLAG_KEY);
-	packet->drop_priority = packet->keyframe ? 0 : 1;
-	*received_packet      = true;
+int ffmpeg_instance::get_packet_priority(bool is_keyframe)
+{
+	int priority = -1;
+	switch (_codec->id) {
+	case AV_CODEC_ID_H264:
+		priority = h264::get_packet_priority(_packet.data, static_cast<size_t>(_packet.size));
+		break;
+	case AV_CODEC_ID_HEVC:
+		if ((_hevc_max_temporal_id == std::numeric_limits<uint8_t>::max()) && (_context->extradata != nullptr)) {
+			// With global headers the SPS may only ever appear in the extra data.
+			hevc::get_packet_priority(_context->extradata, static_cast<size_t>(_context->extradata_size),
+									  _hevc_max_temporal_id);
+		}
+		priority = hevc::get_packet_priority(_packet.data, static_cast<size_t>(_packet.size), _hevc_max_temporal_id);
+		break;
+	case AV_CODEC_ID_AV1:
+		priority = av1::get_packet_priority(_packet.data, static_cast<size_t>(_packet.size), _av1_sequence_header);
+		break;
+	default:
+		break;
+	}
 
-	push_free_frame(pop_used_frame());
+	// Key-Frames are what everything else depends on, so never trust the bitstream to say otherwise. AV1 still has
+	// to be parsed for them, as they carry the Sequence Header required for all following frames.
+	if (is_keyframe) {
+		return OBS_NAL_PRIORITY_HIGHEST;
+	}
 
-	return res;
+	// Without any information about the packet, assume that later frames depend on it.
+	return (priority < 0) ? OBS_NAL_PRIORITY_HIGH : priority;
 }
 
 int ffmpeg_instance::send_frame(std::shared_ptr<AVFrame> const frame)
 {
 	int res = 0;
 	{
+#ifdef ENABLE_PROFILING
+		auto profile = _profiler_send->track();
+#endif
 		auto gctx = streamfx::obs::gs::context();
 		res       = avcodec_send_frame(_context, frame.get());
 	}
@@ -688,8 +1035,42 @@ int ffmpeg_instance::send_frame(std::shared_ptr<AVFrame> const frame)
 	return res;
 }
 
+static void apply_regions(AVFrame* frame, int width, int height, uint64_t timestamp)
+{
+	// Frames are recycled, so old regions must go even if there are no new ones.
+	av_frame_remove_side_data(frame, AV_FRAME_DATA_REGIONS_OF_INTEREST);
+
+	auto regions = ::streamfx::encoder::roi_channel::get()->query(timestamp);
+	if (regions.empty()) {
+		return;
+	}
+
+	AVFrameSideData* side_data = av_frame_new_side_data(frame, AV_FRAME_DATA_REGIONS_OF_INTEREST,
+														sizeof(AVRegionOfInterest) * regions.size());
+	if (!side_data) {
+		return;
+	}
+
+	auto rois = reinterpret_cast<AVRegionOfInterest*>(side_data->data);
+	for (std::size_t idx = 0; idx < regions.size(); idx++) {
+		rois[idx].self_size = sizeof(AVRegionOfInterest);
+		rois[idx].left      = static_cast<int>(std::floor(regions[idx].left * width));
+		rois[idx].top       = static_cast<int>(std::floor(regions[idx].top * height));
+		rois[idx].right     = static_cast<int>(std::ceil(regions[idx].right * width));
+		rois[idx].bottom    = static_cast<int>(std::ceil(regions[idx].bottom * height));
+		// FFmpeg's quantizer offsets are inverted, negative values mean better quality.
+		rois[idx].qoffset = av_make_q(-static_cast<int>(std::lround(regions[idx].weight * 100.)), 100);
+	}
+}
+
 bool ffmpeg_instance::encode_avframe(std::shared_ptr<AVFrame> frame, encoder_packet* packet, bool* received_packet)
 {
+	// Regions of Interest, for the encoders that support them.
+	if (frame && (_codec->type == AVMEDIA_TYPE_VIDEO)) {
+		apply_regions(frame.get(), _context->width, _context->height,
+					  _roi_clock.get(frame->pts, static_cast<uint32_t>(_context->time_base.den)));
+	}
+
 	bool sent_frame  = false;
 	bool recv_packet = false;
 	bool should_lag  = (_sent_frames >= _lag_in_frames);
@@ -980,6 +1361,32 @@ const char* ffmpeg_factory::get_name()
 	return _name.c_str();
 }
 
+void* ffmpeg_factory::create(obs_data_t* settings, obs_encoder_t* encoder, bool is_hw)
+{
+	{ // Let downstream consumers know when in-band parameter sets replace the extra data.
+		// The signal handler belongs to the encoder and outlives its instances, so only declare the signal once.
+		std::lock_guard<std::mutex> lock(_signals_lock);
+		bool                        declared = false;
+		for (auto itr = _signals.begin(); itr != _signals.end();) {
+			if (obs_encoder_t* ref = obs_weak_encoder_get_encoder(itr->get()); ref) {
+				declared |= (ref == encoder);
+				obs_encoder_release(ref);
+				++itr;
+			} else {
+				itr = _signals.erase(itr);
+			}
+		}
+
+		if (!declared) {
+			signal_handler_add(obs_encoder_get_signal_handler(encoder),
+							   "void " ST_SIGNAL_EXTRA_DATA_CHANGED "(ptr encoder)");
+			_signals.emplace_back(obs_encoder_get_weak_encoder(encoder), obs_weak_encoder_release);
+		}
+	}
+
+	return obs::encoder_factory<ffmpeg_factory, ffmpeg_instance>::create(settings, encoder, is_hw);
+}
+
 void ffmpeg_factory::get_defaults2(obs_data_t* settings)
 {
 	if (_handler)
@@ -989,6 +1396,7 @@ void ffmpeg_factory::get_defaults2(obs_data_t* settings)
 		obs_data_set_default_int(settings, ST_KEY_KEYFRAMES_INTERVALTYPE, 0);
 		obs_data_set_default_double(settings, ST_KEY_KEYFRAMES_INTERVAL_SECONDS, 2.0);
 		obs_data_set_default_int(settings, ST_KEY_KEYFRAMES_INTERVAL_FRAMES, 300);
+		obs_data_set_default_bool(settings, ST_KEY_KEYFRAMES_SCENEAWARE, false);
 	}
 
 	{ // Integrated Options
@@ -997,6 +1405,7 @@ void ffmpeg_factory::get_defaults2(obs_data_t* settings)
 		obs_data_set_default_int(settings, ST_KEY_FFMPEG_COLORFORMAT, static_cast<int64_t>(AV_PIX_FMT_NONE));
 		obs_data_set_default_int(settings, ST_KEY_FFMPEG_THREADS, 0);
 		obs_data_set_default_int(settings, ST_KEY_FFMPEG_GPU, -1);
+		obs_data_set_default_bool(settings, ST_KEY_FFMPEG_SHAREDCONVERSION, false);
 		obs_data_set_default_int(settings, ST_KEY_FFMPEG_STANDARDCOMPLIANCE, FF_COMPLIANCE_STRICT);
 	}
 }
@@ -1061,6 +1470,9 @@ obs_properties_t* ffmpeg_factory::get_properties2(instance_t* data)
 									   0, std::numeric_limits<int32_t>::max(), 1);
 			obs_property_int_set_suffix(p, " frames");
 		}
+		{ // Scene-Aware Key-Frames
+			obs_properties_add_bool(grp, ST_KEY_KEYFRAMES_SCENEAWARE, D_TRANSLATE(ST_I18N_KEYFRAMES_SCENEAWARE));
+		}
 	}
 
 	{
@@ -1082,6 +1494,11 @@ obs_properties_t* ffmpeg_factory::get_properties2(instance_t* data)
 											std::numeric_limits<uint8_t>::max(), 1);
 		}
 
+		if ((_avcodec->type == AVMEDIA_TYPE_VIDEO) && !(_handler && _handler->is_hardware_encoder(this))) {
+			auto p = obs_properties_add_bool(grp, ST_KEY_FFMPEG_SHAREDCONVERSION,
+											 D_TRANSLATE(ST_I18N_FFMPEG_SHAREDCONVERSION));
+		}
+
 		if (_handler && _handler->has_threading_support(this)) {
 			auto p = obs_properties_add_int_slider(grp, ST_KEY_FFMPEG_THREADS, D_TRANSLATE(ST_I18N_FFMPEG_THREADS), 0,
 												   static_cast<int64_t>(std::thread::hardware_concurrency() * 2), 1);
@@ -1221,14 +1638,21 @@ std::shared_ptr<ffmpeg_manager> _ffmepg_encoder_factory_instance = nullptr;
 void ffmpeg_manager::initialize()
 {
 	if (!_ffmepg_encoder_factory_instance) {
+		::streamfx::ffmpeg::probe_cache::initialize();
+
 		_ffmepg_encoder_factory_instance = std::make_shared<ffmpeg_manager>();
 		_ffmepg_encoder_factory_instance->register_encoders();
+
+		// Registration used cached probes where possible, verify them without blocking startup.
+		::streamfx::ffmpeg::probe_cache::get()->refresh();
 	}
 }
 
 void ffmpeg_manager::finalize()
 {
 	_ffmepg_encoder_factory_instance.reset();
+
+	::streamfx::ffmpeg::probe_cache::finalize();
 }
 
 std::shared_ptr<ffmpeg_manager> ffmpeg_manager::get()
@@ -22,17 +22,21 @@
 #pragma once
 #include "common.hpp"
 #include <condition_variable>
+#include <list>
 #include <map>
 #include <mutex>
-#include <queue>
-#include <stack>
 #include <thread>
 #include <vector>
+#include "codecs/av1.hpp"
+#include "encoder-roi.hpp"
+#include "encoder-scene-analyzer.hpp"
 #include "ffmpeg/avframe-queue.hpp"
+#include "ffmpeg/encode-group.hpp"
 #include "ffmpeg/hwapi/base.hpp"
 #include "ffmpeg/swscale.hpp"
 #include "handlers/handler.hpp"
 #include "obs/obs-encoder-factory.hpp"
+#include "util/util-profiler.hpp"
 
 extern "C" {
 #ifdef _MSC_VER
@@ -58,8 +62,12 @@ namespace streamfx::encoder::ffmpeg {
 		std::shared_ptr<handler::handler> _handler;
 
 		::streamfx::ffmpeg::swscale _scaler;
+		bool                        _scaler_widen;
 		AVPacket                    _packet;
 
+		// Shared Conversion
+		std::shared_ptr<::streamfx::ffmpeg::encode_group> _group;
+
 		std::shared_ptr<::streamfx::ffmpeg::hwapi::base>     _hwapi;
 		std::shared_ptr<::streamfx::ffmpeg::hwapi::instance> _hwinst;
 
@@ -68,13 +76,29 @@ namespace streamfx::encoder::ffmpeg {
 
 		// Extra Data
 		bool                 _have_first_frame;
+		uint64_t             _extra_data_hash;
 		std::vector<uint8_t> _extra_data;
 		std::vector<uint8_t> _sei_data;
 
-		// Frame Stack and Queue
-		std::stack<std::shared_ptr<AVFrame>>           _free_frames;
-		std::queue<std::shared_ptr<AVFrame>>           _used_frames;
-		std::chrono::high_resolution_clock::time_point _free_frames_last_used;
+		// Drop Priority
+		::streamfx::encoder::codec::av1::sequence_header _av1_sequence_header;
+		uint8_t                                          _hevc_max_temporal_id;
+
+		// Scene Analysis
+		std::unique_ptr<::streamfx::encoder::scene_analyzer> _scene_analyzer;
+
+		// Regions of Interest
+		::streamfx::encoder::roi_clock _roi_clock;
+
+		// Frame Pool and Queue
+		::streamfx::ffmpeg::avframe_queue _free_frames;
+		::streamfx::ffmpeg::avframe_queue _used_frames;
+
+#ifdef ENABLE_PROFILING
+		std::shared_ptr<streamfx::util::profiler> _profiler_copy;
+		std::shared_ptr<streamfx::util::profiler> _profiler_send;
+		std::shared_ptr<streamfx::util::profiler> _profiler_receive;
+#endif
 
 		public:
 		ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool is_hw);
@@ -94,10 +118,14 @@ namespace streamfx::encoder::ffmpeg {
 		bool encode_video(uint32_t handle, int64_t pts, uint64_t lock_key, uint64_t* next_key,
 						  struct encoder_packet* packet, bool* received_packet) override;
 
+		size_t get_frame_size() override;
+
 		bool get_extra_data(uint8_t** extra_data, size_t* size) override;
 
 		bool get_sei_data(uint8_t** sei_data, size_t* size) override;
 
+		void get_audio_info(struct audio_convert_info* info) override;
+
 		void get_video_info(struct video_scale_info* info) override;
 
 		public:
@@ -112,6 +140,10 @@ namespace streamfx::encoder::ffmpeg {
 
 		int receive_packet(bool* received_packet, struct encoder_packet* packet);
 
+		void update_extra_data(bool is_keyframe);
+
+		int get_packet_priority(bool is_keyframe);
+
 		int send_frame(std::shared_ptr<AVFrame> frame);
 
 		bool encode_avframe(std::shared_ptr<AVFrame> frame, struct encoder_packet* packet, bool* received_packet);
@@ -135,12 +167,17 @@ namespace streamfx::encoder::ffmpeg {
 
 		std::shared_ptr<handler::handler> _handler;
 
+		std::mutex                                     _signals_lock;
+		std::list<std::shared_ptr<obs_weak_encoder_t>> _signals;
+
 		public:
 		ffmpeg_factory(const AVCodec* codec);
 		virtual ~ffmpeg_factory();
 
 		const char* get_name() override;
 
+		void* create(obs_data_t* settings, obs_encoder_t* encoder, bool is_hw) override;
+
 		void get_defaults2(obs_data_t* data) override;
 
 		obs_properties_t* get_properties2(instance_t* data) override;
@@ -0,0 +1,131 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "encoder-pacer.hpp"
+#include <algorithm>
+
+// Fraction of the budget the 95th percentile may use before stepping down.
+#define THRESHOLD_HIGH 0.9
+// Fraction of the budget the 95th percentile must stay under before stepping up again.
+#define THRESHOLD_LOW 0.5
+// Consecutive calm frames required before stepping up, as a multiple of the window size.
+#define UPGRADE_DELAY 4
+
+streamfx::encoder::pacer::pacer(uint32_t fps_num, uint32_t fps_den, std::vector<int32_t> ladder)
+	: _budget(), _ladder(ladder), _step(0), _overloaded(false), _samples(), _sample_index(0), _calm(0),
+	  _downgrades(0), _upgrades(0), _overloads(0)
+{
+	if ((fps_num == 0) || (fps_den == 0)) {
+		throw std::invalid_argument("Frame rate must not be zero.");
+	}
+	if (_ladder.empty()) {
+		throw std::invalid_argument("Ladder must have at least one step.");
+	}
+
+	_budget = std::chrono::nanoseconds(static_cast<int64_t>(1000000000ull * fps_den / fps_num));
+
+	// Look at roughly a second worth of frames, but never so few that a single hiccup decides.
+	_samples.resize(std::max<std::size_t>(30, (fps_num + fps_den - 1) / fps_den));
+}
+
+streamfx::encoder::pacer::~pacer() {}
+
+streamfx::encoder::pacer_event streamfx::encoder::pacer::submit(std::chrono::nanoseconds duration)
+{
+	_samples[_sample_index % _samples.size()] = duration;
+	_sample_index++;
+
+	if (_sample_index < _samples.size()) {
+		return pacer_event::NONE;
+	}
+
+	std::vector<std::chrono::nanoseconds> sorted{_samples};
+	auto                                  p95 = sorted.begin() + static_cast<ptrdiff_t>(sorted.size() * 95 / 100);
+	std::nth_element(sorted.begin(), p95, sorted.end());
+
+	// Falling behind is acted on right away, while stepping up waits for a long enough run of calm frames.
+	pacer_event event = pacer_event::NONE;
+	if (static_cast<double_t>(p95->count()) > (static_cast<double_t>(_budget.count()) * THRESHOLD_HIGH)) {
+		_calm = 0;
+		if ((_step + 1) < _ladder.size()) {
+			_step++;
+			_downgrades++;
+			event = pacer_event::DOWNGRADED;
+		} else if (!_overloaded) {
+			_overloaded = true;
+			_overloads++;
+			event = pacer_event::OVERLOADED;
+		}
+	} else if (static_cast<double_t>(p95->count()) < (static_cast<double_t>(_budget.count()) * THRESHOLD_LOW)) {
+		_calm++;
+		if (_overloaded) {
+			_overloaded = false;
+			event       = pacer_event::RECOVERED;
+		} else if ((_step > 0) && (_calm >= (_samples.size() * UPGRADE_DELAY))) {
+			_step--;
+			_upgrades++;
+			event = pacer_event::UPGRADED;
+		}
+	} else {
+		_calm = 0;
+	}
+
+	if ((event == pacer_event::DOWNGRADED) || (event == pacer_event::UPGRADED)) {
+		// Samples from before the change say nothing about the new step, so start over.
+		_sample_index = 0;
+		_calm         = 0;
+	}
+	return event;
+}
+
+int32_t streamfx::encoder::pacer::get()
+{
+	return _ladder[_step];
+}
+
+std::size_t streamfx::encoder::pacer::get_step()
+{
+	return _step;
+}
+
+bool streamfx::encoder::pacer::is_overloaded()
+{
+	return _overloaded;
+}
+
+std::chrono::nanoseconds streamfx::encoder::pacer::get_budget()
+{
+	return _budget;
+}
+
+uint64_t streamfx::encoder::pacer::count_downgrades()
+{
+	return _downgrades;
+}
+
+uint64_t streamfx::encoder::pacer::count_upgrades()
+{
+	return _upgrades;
+}
+
+uint64_t streamfx::encoder::pacer::count_overloads()
+{
+	return _overloads;
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include <chrono>
+#include <vector>
+
+namespace streamfx::encoder {
+	enum class pacer_event {
+		NONE,       // Nothing changed.
+		DOWNGRADED, // Moved one step further along the ladder, trading quality for speed.
+		UPGRADED,   // Moved one step back towards the configured value.
+		OVERLOADED, // Out of budget with no faster step left.
+		RECOVERED,  // Back within budget after having been overloaded.
+	};
+
+	/** Tracks how long each frame takes to encode against the frame interval.
+	 *
+	 * libOBS drops frames without telling the encoder when it falls behind, so the encoder has to notice on its own.
+	 * Decisions are made on the 95th percentile of a window of recent frames. Stepping down happens as soon as that
+	 * exceeds most of the budget, while stepping back up needs plenty of headroom for a run of consecutive frames many
+	 * times the window, so that the encoder does not oscillate between two steps.
+	 */
+	class pacer {
+		std::chrono::nanoseconds _budget;
+		std::vector<int32_t>     _ladder;
+		std::size_t              _step;
+		bool                     _overloaded;
+
+		std::vector<std::chrono::nanoseconds> _samples;
+		std::size_t                           _sample_index;
+		std::size_t                           _calm;
+
+		uint64_t _downgrades;
+		uint64_t _upgrades;
+		uint64_t _overloads;
+
+		public:
+		/** Create a new pacer.
+		 *
+		 * @param fps_num Frame rate numerator.
+		 * @param fps_den Frame rate denominator.
+		 * @param ladder Values to step through, starting with the configured one and ordered from slowest to fastest.
+		 *               A ladder with a single value only reports overload.
+		 */
+		pacer(uint32_t fps_num, uint32_t fps_den, std::vector<int32_t> ladder);
+		~pacer();
+
+		/** Submit the time spent encoding a single frame.
+		 *
+		 * @return What changed, if anything. The caller is expected to apply the new value of get() on a step.
+		 */
+		pacer_event submit(std::chrono::nanoseconds duration);
+
+		int32_t get();
+
+		std::size_t get_step();
+
+		bool is_overloaded();
+
+		std::chrono::nanoseconds get_budget();
+
+		uint64_t count_downgrades();
+
+		uint64_t count_upgrades();
+
+		uint64_t count_overloads();
+	};
+} // namespace streamfx::encoder
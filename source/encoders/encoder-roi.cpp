@@ -0,0 +1,121 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "encoder-roi.hpp"
+#include <iterator>
+
+// Publications older than this are considered stale.
+#define PUBLICATION_TIMEOUT 250000000ull
+
+// How far back publications are kept for encoders that run behind rendering.
+#define PUBLICATION_HISTORY 1000000000ull
+
+bool streamfx::encoder::region::operator==(const region& other) const
+{
+	return (left == other.left) && (top == other.top) && (right == other.right) && (bottom == other.bottom)
+		   && (weight == other.weight);
+}
+
+streamfx::encoder::roi_channel::roi_channel() : _lock(), _publications() {}
+
+streamfx::encoder::roi_channel::~roi_channel() {}
+
+void streamfx::encoder::roi_channel::publish(const void* publisher, uint64_t timestamp, std::vector<region> regions)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+
+	// Keep only regions that actually cover something.
+	auto& history = _publications[publisher];
+	auto& entry   = history[timestamp];
+	entry.clear();
+	for (auto& region : regions) {
+		region.left   = std::clamp<float_t>(region.left, 0., 1.);
+		region.top    = std::clamp<float_t>(region.top, 0., 1.);
+		region.right  = std::clamp<float_t>(region.right, 0., 1.);
+		region.bottom = std::clamp<float_t>(region.bottom, 0., 1.);
+		region.weight = std::clamp<float_t>(region.weight, -1., 1.);
+		if ((region.left < region.right) && (region.top < region.bottom) && (region.weight != 0.)) {
+			entry.push_back(region);
+		}
+	}
+
+	// Forget what no encoder will ask for anymore. The last publication before the cut off still applies after it.
+	uint64_t newest = history.rbegin()->first;
+	if (newest > PUBLICATION_HISTORY) {
+		auto keep = history.lower_bound(newest - PUBLICATION_HISTORY);
+		if (keep != history.begin()) {
+			history.erase(history.begin(), std::prev(keep));
+		}
+	}
+}
+
+void streamfx::encoder::roi_channel::retract(const void* publisher)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	_publications.erase(publisher);
+}
+
+std::vector<streamfx::encoder::region> streamfx::encoder::roi_channel::query(uint64_t timestamp)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	std::vector<region>          regions;
+
+	for (auto& [publisher, history] : _publications) {
+		// The publication for this frame, or the last one before it.
+		auto found = history.upper_bound(timestamp);
+		if (found == history.begin()) {
+			continue;
+		}
+		found--;
+		if ((found->first + PUBLICATION_TIMEOUT) < timestamp) {
+			continue;
+		}
+		regions.insert(regions.end(), found->second.begin(), found->second.end());
+	}
+
+	return regions;
+}
+
+std::shared_ptr<streamfx::encoder::roi_channel> streamfx::encoder::roi_channel::get()
+{
+	static std::shared_ptr<roi_channel> instance = std::make_shared<roi_channel>();
+	return instance;
+}
+
+streamfx::encoder::roi_clock::roi_clock() : _anchored(false), _epoch(0) {}
+
+streamfx::encoder::roi_clock::~roi_clock() {}
+
+uint64_t streamfx::encoder::roi_clock::get(int64_t pts, uint32_t fps_num)
+{
+	// Split into whole seconds and the remainder, which can't overflow.
+	uint64_t offset = 0;
+	if ((fps_num > 0) && (pts > 0)) {
+		uint64_t units = static_cast<uint64_t>(pts);
+		offset         = (units / fps_num) * 1000000000ull + (units % fps_num) * 1000000000ull / fps_num;
+	}
+
+	if (!_anchored) {
+		uint64_t now = obs_get_video_frame_time();
+		_epoch       = (now > offset) ? (now - offset) : 0;
+		_anchored    = true;
+	}
+	return _epoch + offset;
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace streamfx::encoder {
+	struct region {
+		// Edges, normalized so that 0 is the top/left and 1 the bottom/right edge of the canvas that
+		// encoders of the main video output see.
+		float_t left;
+		float_t top;
+		float_t right;
+		float_t bottom;
+
+		// Importance, from -1 (spend fewer bits) over 0 (no change) to 1 (spend more bits).
+		float_t weight;
+
+		bool operator==(const region& other) const;
+	};
+
+	/** Process-local side channel through which filters tell encoders which parts of the picture matter.
+	 *
+	 * Timestamps are in the video clock of obs_get_video_frame_time(), so that a publication belongs to the frame it
+	 * was rendered for. Encoders run a few frames behind rendering, so every publisher keeps a short history, and a
+	 * query picks the publication of each publisher that was made for that frame, or the last one before it.
+	 * Publications are only valid for a while, so that a publisher which stops rendering does not leave stale regions
+	 * behind.
+	 */
+	class roi_channel {
+		std::mutex                                                     _lock;
+		std::map<const void*, std::map<uint64_t, std::vector<region>>> _publications;
+
+		public:
+		roi_channel();
+		~roi_channel();
+
+		/// Replace the regions of a publisher from the given frame on.
+		void publish(const void* publisher, uint64_t timestamp, std::vector<region> regions);
+
+		/// Forget everything a publisher published.
+		void retract(const void* publisher);
+
+		/// Collect the regions of all publishers for the frame at the given time.
+		std::vector<region> query(uint64_t timestamp);
+
+		public: // Singleton
+		static std::shared_ptr<roi_channel> get();
+	};
+
+	/** Maps the pts of the frames libobs hands to an encoder onto the video clock that regions are published in.
+	 *
+	 * libobs counts pts in units of 1/fps_num seconds from the first frame an encoder receives, but doesn't tell the
+	 * encoder when that frame was rendered. The clock is anchored on the time of the last rendered frame when the first
+	 * frame arrives instead, which can be a frame or two late as frames take a moment to reach the encoder.
+	 */
+	class roi_clock {
+		bool     _anchored;
+		uint64_t _epoch;
+
+		public:
+		roi_clock();
+		~roi_clock();
+
+		/// The video time of the frame with the given pts, for video running at fps_num/fps_den.
+		uint64_t get(int64_t pts, uint32_t fps_num);
+	};
+} // namespace streamfx::encoder
@@ -0,0 +1,157 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "encoder-scene-analyzer.hpp"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ST_SSE2
+#include <emmintrin.h>
+#endif
+
+// Size of the blocks the luma plane is reduced to.
+#define BLOCK_SIZE 8
+// Number of histogram bins, each covering 256 / HISTOGRAM_BINS luma values.
+#define HISTOGRAM_BINS 32
+// A cut needs at least this fraction of the histogram to move...
+#define CUT_HISTOGRAM 0.35
+// ...and at least this mean absolute difference between thumbnails.
+#define CUT_DIFFERENCE 16.0
+// Content with a mean absolute difference below this is considered static.
+#define STATIC_DIFFERENCE 0.5
+
+streamfx::encoder::scene_analyzer::scene_analyzer(uint32_t width, uint32_t height, uint32_t distance_min,
+												  uint32_t distance, uint32_t distance_max)
+	: _width(width / BLOCK_SIZE), _height(height / BLOCK_SIZE), _current(), _previous(),
+	  _current_histogram(HISTOGRAM_BINS), _previous_histogram(HISTOGRAM_BINS), _have_previous(false),
+	  _distance_min(distance_min), _distance(distance), _distance_max(std::max(distance, distance_max)),
+	  _since_keyframe(0), _deferring(false), _cuts(0), _deferrals(0)
+{
+	if ((_width == 0) || (_height == 0)) {
+		throw std::invalid_argument("Frame is too small to analyze.");
+	}
+
+	// Padded to a multiple of 16 so that the comparison needs no tail handling.
+	std::size_t size = (_width * _height + 15) & ~static_cast<std::size_t>(15);
+	_current.resize(size, 0);
+	_previous.resize(size, 0);
+}
+
+streamfx::encoder::scene_analyzer::~scene_analyzer() {}
+
+bool streamfx::encoder::scene_analyzer::analyze(const uint8_t* luma, std::size_t stride)
+{
+	// Reduce the frame to a thumbnail, using the middle row of each block.
+	std::fill(_current_histogram.begin(), _current_histogram.end(), 0);
+	for (std::size_t y = 0; y < _height; y++) {
+		const uint8_t* row = luma + (y * BLOCK_SIZE + BLOCK_SIZE / 2) * stride;
+		uint8_t*       out = _current.data() + y * _width;
+		std::size_t    x   = 0;
+#ifdef ST_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		for (; (x + 2) <= _width; x += 2) {
+			// Sums each half of the 16 bytes, which is exactly two blocks.
+			__m128i sums = _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x * BLOCK_SIZE)), zero);
+			out[x]       = static_cast<uint8_t>(_mm_cvtsi128_si32(sums) / BLOCK_SIZE);
+			out[x + 1]   = static_cast<uint8_t>(_mm_extract_epi16(sums, 4) / BLOCK_SIZE);
+		}
+#endif
+		for (; x < _width; x++) {
+			uint32_t sum = 0;
+			for (std::size_t idx = 0; idx < BLOCK_SIZE; idx++) {
+				sum += row[x * BLOCK_SIZE + idx];
+			}
+			out[x] = static_cast<uint8_t>(sum / BLOCK_SIZE);
+		}
+		for (x = 0; x < _width; x++) {
+			_current_histogram[out[x] / (256 / HISTOGRAM_BINS)]++;
+		}
+	}
+
+	bool is_cut    = false;
+	bool is_static = false;
+	if (_have_previous) {
+		uint64_t    difference = 0;
+		std::size_t idx        = 0;
+#ifdef ST_SSE2
+		__m128i sum = _mm_setzero_si128();
+		for (; idx < _current.size(); idx += 16) {
+			sum = _mm_add_epi64(sum, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&_current[idx])),
+												  _mm_loadu_si128(reinterpret_cast<const __m128i*>(&_previous[idx]))));
+		}
+		alignas(16) uint64_t lanes[2];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), sum);
+		difference = lanes[0] + lanes[1];
+#endif
+		for (; idx < _current.size(); idx++) {
+			difference += static_cast<uint64_t>(std::abs(_current[idx] - _previous[idx]));
+		}
+
+		uint64_t histogram = 0;
+		for (std::size_t bin = 0; bin < HISTOGRAM_BINS; bin++) {
+			histogram += static_cast<uint64_t>(std::abs(_current_histogram[bin] - _previous_histogram[bin]));
+		}
+
+		// Padding is zero in both thumbnails, so it adds nothing to the difference.
+		double_t count = static_cast<double_t>(_width * _height);
+		double_t mean  = static_cast<double_t>(difference) / count;
+		double_t moved = static_cast<double_t>(histogram) / (count * 2.);
+		is_cut         = (moved >= CUT_HISTOGRAM) && (mean >= CUT_DIFFERENCE);
+		is_static      = (mean < STATIC_DIFFERENCE);
+	}
+	std::swap(_current, _previous);
+	std::swap(_current_histogram, _previous_histogram);
+
+	if (!_have_previous) {
+		// Encoders always start with a key-frame on their own.
+		_have_previous  = true;
+		_since_keyframe = 0;
+		return false;
+	}
+
+	_since_keyframe++;
+	if (is_cut && (_since_keyframe >= _distance_min)) {
+		_cuts++;
+	} else if ((_distance > 0) && (_since_keyframe >= _distance)) {
+		if (is_static && (_since_keyframe < _distance_max)) {
+			if (!_deferring) {
+				_deferring = true;
+				_deferrals++;
+			}
+			return false;
+		}
+	} else {
+		return false;
+	}
+
+	_since_keyframe = 0;
+	_deferring      = false;
+	return true;
+}
+
+uint64_t streamfx::encoder::scene_analyzer::count_cuts()
+{
+	return _cuts;
+}
+
+uint64_t streamfx::encoder::scene_analyzer::count_deferrals()
+{
+	return _deferrals;
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include <vector>
+
+namespace streamfx::encoder {
+	/** Decides where key-frames go based on what is actually in the frames.
+	 *
+	 * Each frame's luma plane is reduced to a thumbnail of 8x8 block averages (sampling one row per block), which is
+	 * then compared against the previous one by mean absolute difference and by luma histogram. A large change in both
+	 * is treated as a hard cut and gets a key-frame right away, while a scheduled key-frame is held back for as long
+	 * as the picture does not change at all, since it would cost a lot of bits for no gain.
+	 */
+	class scene_analyzer {
+		std::size_t          _width;
+		std::size_t          _height;
+		std::vector<uint8_t> _current;
+		std::vector<uint8_t> _previous;
+		std::vector<int32_t> _current_histogram;
+		std::vector<int32_t> _previous_histogram;
+		bool                 _have_previous;
+
+		uint32_t _distance_min;
+		uint32_t _distance;
+		uint32_t _distance_max;
+		uint32_t _since_keyframe;
+		bool     _deferring;
+
+		uint64_t _cuts;
+		uint64_t _deferrals;
+
+		public:
+		/** Create a new analyzer.
+		 *
+		 * @param width Width of the luma plane.
+		 * @param height Height of the luma plane.
+		 * @param distance_min Minimum number of frames between a key-frame and a cut that forces another one.
+		 * @param distance Regular key-frame interval in frames, or 0 to leave scheduling to the encoder.
+		 * @param distance_max Number of frames a scheduled key-frame may be held back to during static content.
+		 */
+		scene_analyzer(uint32_t width, uint32_t height, uint32_t distance_min, uint32_t distance,
+					   uint32_t distance_max);
+		~scene_analyzer();
+
+		/** Analyze the next frame.
+		 *
+		 * @return true if the frame should be encoded as a key-frame.
+		 */
+		bool analyze(const uint8_t* luma, std::size_t stride);
+
+		uint64_t count_cuts();
+
+		uint64_t count_deferrals();
+	};
+} // namespace streamfx::encoder
@@ -20,6 +20,7 @@
 // SOFTWARE.
 
 #include "amf_shared.hpp"
+#include "ffmpeg/probe-cache.hpp"
 #include "ffmpeg/tools.hpp"
 
 extern "C" {
@@ -116,12 +117,20 @@ bool streamfx::encoder::ffmpeg::handler::amf::is_available()
 	std::filesystem::path lib_name = std::filesystem::u8path("libamfrt32.so.1");
 #endif
 #endif
-	try {
-		streamfx::util::library::load(lib_name);
-		return true;
-	} catch (...) {
-		return false;
+	auto probe = [lib_name]() {
+		try {
+			streamfx::util::library::load(lib_name);
+			return true;
+		} catch (...) {
+			return false;
+		}
+	};
+
+	// Loading the runtime is slow, so prefer the result from a previous start.
+	if (auto cache = ::streamfx::ffmpeg::probe_cache::get(); cache) {
+		return cache->probe("amf", lib_name.u8string(), probe);
 	}
+	return probe();
 }
 
 void amf::get_defaults(obs_data_t* settings, const AVCodec* codec, AVCodecContext* context)
@@ -21,6 +21,7 @@
 
 #include "nvenc_shared.hpp"
 #include "encoders/encoder-ffmpeg.hpp"
+#include "ffmpeg/probe-cache.hpp"
 #include "ffmpeg/tools.hpp"
 
 extern "C" {
@@ -161,12 +162,20 @@ bool streamfx::encoder::ffmpeg::handler::nvenc::is_available()
 #else
 	std::filesystem::path lib_name = "libnvidia-encode.so.1";
 #endif
-	try {
-		streamfx::util::library::load(lib_name);
-		return true;
-	} catch (...) {
-		return false;
+	auto probe = [lib_name]() {
+		try {
+			streamfx::util::library::load(lib_name);
+			return true;
+		} catch (...) {
+			return false;
+		}
+	};
+
+	// Loading the driver is slow, so prefer the result from a previous start.
+	if (auto cache = ::streamfx::ffmpeg::probe_cache::get(); cache) {
+		return cache->probe("nvenc", lib_name.u8string(), probe);
 	}
+	return probe();
 }
 
 void nvenc::override_update(ffmpeg_instance* instance, obs_data_t*)
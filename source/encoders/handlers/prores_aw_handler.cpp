@@ -49,11 +49,22 @@ void prores_aw_handler::override_colorformat(AVPixelFormat& target_format, obs_d
 			break;
 		}
 	}
+
+	// 4:4:4:4 profiles can carry alpha, but only encode it if asked to, as it costs bitrate and time.
+	if ((target_format == AV_PIX_FMT_YUV444P10) && obs_data_get_bool(settings, S_CODEC_PRORES_ALPHA)) {
+		for (auto ptr = codec->pix_fmts; ptr && (*ptr != AV_PIX_FMT_NONE); ptr++) {
+			if (*ptr == AV_PIX_FMT_YUVA444P10) {
+				target_format = AV_PIX_FMT_YUVA444P10;
+				break;
+			}
+		}
+	}
 }
 
 void prores_aw_handler::get_defaults(obs_data_t* settings, const AVCodec*, AVCodecContext*, bool)
 {
 	obs_data_set_default_int(settings, S_CODEC_PRORES_PROFILE, 0);
+	obs_data_set_default_bool(settings, S_CODEC_PRORES_ALPHA, false);
 }
 
 bool prores_aw_handler::has_pixel_format_support(ffmpeg_factory* instance)
@@ -81,16 +92,28 @@ inline const char* profile_to_name(const AVProfile* ptr)
 	}
 }
 
+static bool modified_profile(obs_properties_t* props, obs_property_t*, obs_data_t* settings) noexcept
+{
+	auto profile_id = static_cast<profile>(obs_data_get_int(settings, S_CODEC_PRORES_PROFILE));
+	obs_property_set_visible(obs_properties_get(props, S_CODEC_PRORES_ALPHA),
+							 (profile_id == profile::AP4H) || (profile_id == profile::AP4X));
+	return true;
+}
+
 void prores_aw_handler::get_properties(obs_properties_t* props, const AVCodec* codec, AVCodecContext* context, bool)
 {
 	if (!context) {
 		auto p = obs_properties_add_list(props, S_CODEC_PRORES_PROFILE, D_TRANSLATE(S_CODEC_PRORES_PROFILE),
 										 OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+		obs_property_set_modified_callback(p, modified_profile);
 		for (auto ptr = codec->profiles; ptr->profile != FF_PROFILE_UNKNOWN; ptr++) {
 			obs_property_list_add_int(p, profile_to_name(ptr), static_cast<int64_t>(ptr->profile));
 		}
+
+		obs_properties_add_bool(props, S_CODEC_PRORES_ALPHA, D_TRANSLATE(S_CODEC_PRORES_ALPHA));
 	} else {
 		obs_property_set_enabled(obs_properties_get(props, S_CODEC_PRORES_PROFILE), false);
+		obs_property_set_enabled(obs_properties_get(props, S_CODEC_PRORES_ALPHA), false);
 	}
 }
 
@@ -22,10 +22,22 @@
 #include "avframe-queue.hpp"
 #include "tools.hpp"
 
+// Maximum number of mismatched frames kept per size and format.
+#define BUCKET_CAPACITY 8
+
 using namespace streamfx::ffmpeg;
 
 std::shared_ptr<AVFrame> avframe_queue::create_frame()
 {
+	// Frames from an earlier switch to this size and format are as good as new ones.
+	if (auto bucket = _buckets.find({_resolution.first, _resolution.second, _format});
+		(bucket != _buckets.end()) && !bucket->second.empty()) {
+		std::shared_ptr<AVFrame> frame = std::move(bucket->second.back());
+		bucket->second.pop_back();
+		_recycled.fetch_add(1, std::memory_order_relaxed);
+		return frame;
+	}
+
 	std::shared_ptr<AVFrame> frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame* frame) {
 		av_frame_unref(frame);
 		av_frame_free(&frame);
@@ -39,10 +51,54 @@ std::shared_ptr<AVFrame> avframe_queue::create_frame()
 		throw std::runtime_error(tools::get_error_description(res));
 	}
 
+	_misses.fetch_add(1, std::memory_order_relaxed);
 	return frame;
 }
 
-avframe_queue::avframe_queue() {}
+void avframe_queue::recycle_frame(std::shared_ptr<AVFrame> frame)
+{
+	auto& bucket = _buckets[{frame->width, frame->height, frame->format}];
+	if (bucket.size() < BUCKET_CAPACITY) {
+		bucket.push_back(std::move(frame));
+	} else {
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+std::shared_ptr<AVFrame> avframe_queue::pop_frame()
+{
+	if (!_spsc) {
+		if (_frames.empty()) {
+			return nullptr;
+		}
+		std::shared_ptr<AVFrame> ret = std::move(_frames.front());
+		_frames.pop_front();
+		return ret;
+	}
+
+	std::size_t head = _ring_head.load(std::memory_order_relaxed);
+	if (head == _ring_tail.load(std::memory_order_acquire)) {
+		return nullptr;
+	}
+	std::shared_ptr<AVFrame> ret = std::move(_ring[head & _ring_mask]);
+	_ring_head.store(head + 1, std::memory_order_release);
+	return ret;
+}
+
+avframe_queue::avframe_queue(bool single_producer_consumer, std::size_t capacity)
+	: _frames(), _lock(), _spsc(single_producer_consumer), _ring(), _ring_mask(0), _ring_head(0), _ring_tail(0),
+	  _buckets(), _resolution(), _hits(0), _recycled(0), _misses(0), _dropped(0)
+{
+	if (_spsc) {
+		// Round up to a power of two, so that indices can wrap around freely.
+		std::size_t size = 1;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		_ring.resize(size);
+		_ring_mask = size - 1;
+	}
+}
 
 avframe_queue::~avframe_queue()
 {
@@ -84,66 +140,99 @@ AVPixelFormat avframe_queue::get_pixel_format()
 void avframe_queue::precache(std::size_t count)
 {
 	for (std::size_t n = 0; n < count; n++) {
-		push(create_frame());
+		std::shared_ptr<AVFrame> frame;
+		{
+			std::unique_lock<std::mutex> ulock(this->_lock);
+			frame = create_frame();
+		}
+		push(frame);
 	}
 }
 
 void avframe_queue::clear()
 {
 	std::unique_lock<std::mutex> ulock(this->_lock);
-	_frames.clear();
+	if (_spsc) {
+		while (pop_frame()) {
+		}
+	} else {
+		_frames.clear();
+	}
+	_buckets.clear();
 }
 
 void avframe_queue::push(std::shared_ptr<AVFrame> const frame)
 {
-	std::unique_lock<std::mutex> ulock(this->_lock);
-	_frames.push_back(frame);
+	if (!_spsc) {
+		std::unique_lock<std::mutex> ulock(this->_lock);
+		_frames.push_back(frame);
+		return;
+	}
+
+	std::size_t tail = _ring_tail.load(std::memory_order_relaxed);
+	if ((tail - _ring_head.load(std::memory_order_acquire)) > _ring_mask) {
+		// The ring is full, so the consumer has more than enough frames already.
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	_ring[tail & _ring_mask] = frame;
+	_ring_tail.store(tail + 1, std::memory_order_release);
 }
 
 std::shared_ptr<AVFrame> avframe_queue::pop()
 {
-	std::unique_lock<std::mutex> ulock(this->_lock);
-	std::shared_ptr<AVFrame>     ret;
-	while (ret == nullptr) {
-		if (_frames.size() == 0) {
-			ret = create_frame();
-		} else {
-			ret = _frames.front();
-			if (ret == nullptr) {
-				ret = create_frame();
-			} else {
-				_frames.pop_front();
-				if ((static_cast<int32_t>(ret->width) != this->_resolution.first)
-					|| (static_cast<int32_t>(ret->height) != this->_resolution.second)
-					|| (ret->format != this->_format)) {
-					ret = nullptr;
-				}
-			}
+	std::unique_lock<std::mutex> ulock(this->_lock, std::defer_lock);
+	if (!_spsc) {
+		ulock.lock();
+	}
+
+	while (std::shared_ptr<AVFrame> ret = pop_frame()) {
+		if ((static_cast<int32_t>(ret->width) == this->_resolution.first)
+			&& (static_cast<int32_t>(ret->height) == this->_resolution.second) && (ret->format == this->_format)) {
+			_hits.fetch_add(1, std::memory_order_relaxed);
+			return ret;
 		}
+		recycle_frame(std::move(ret));
 	}
-	return ret;
+
+	return create_frame();
 }
 
 std::shared_ptr<AVFrame> avframe_queue::pop_only()
 {
-	std::unique_lock<std::mutex> ulock(this->_lock);
-	if (_frames.size() == 0) {
-		return nullptr;
+	std::unique_lock<std::mutex> ulock(this->_lock, std::defer_lock);
+	if (!_spsc) {
+		ulock.lock();
 	}
-	std::shared_ptr<AVFrame> ret = _frames.front();
-	if (ret == nullptr) {
-		return nullptr;
+
+	std::shared_ptr<AVFrame> ret = pop_frame();
+	if (ret) {
+		_hits.fetch_add(1, std::memory_order_relaxed);
 	}
-	_frames.pop_front();
 	return ret;
 }
 
 bool avframe_queue::empty()
 {
-	return _frames.empty();
+	return size() == 0;
 }
 
 std::size_t avframe_queue::size()
 {
+	if (_spsc) {
+		// The head never passes the tail, so it has to be read first.
+		std::size_t head = _ring_head.load(std::memory_order_acquire);
+		return _ring_tail.load(std::memory_order_acquire) - head;
+	}
 	return _frames.size();
 }
+
+avframe_queue::statistics avframe_queue::get_statistics()
+{
+	return {
+		_hits.load(std::memory_order_relaxed),
+		_recycled.load(std::memory_order_relaxed),
+		_misses.load(std::memory_order_relaxed),
+		_dropped.load(std::memory_order_relaxed),
+	};
+}
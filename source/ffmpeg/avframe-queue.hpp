@@ -21,8 +21,11 @@
 
 #pragma once
 #include "common.hpp"
+#include <atomic>
 #include <deque>
+#include <map>
 #include <mutex>
+#include <tuple>
 
 extern "C" {
 #ifdef _MSC_VER
@@ -36,17 +39,57 @@ extern "C" {
 }
 
 namespace streamfx::ffmpeg {
+	/** Queue of reusable AVFrames.
+	 *
+	 * By default every call is guarded by a mutex. In single-producer/single-consumer mode the queue is a fixed size
+	 * lock-free ring instead, where exactly one thread may call push() and exactly one other thread may call every
+	 * other function. precache() must then be called before either thread starts.
+	 *
+	 * Frames that no longer match the configured resolution or format are kept in per size and format buckets, so
+	 * that switching back and forth does not need to allocate new frames.
+	 */
 	class avframe_queue {
+		public:
+		struct statistics {
+			uint64_t hits;     // Frames served directly from the queue.
+			uint64_t recycled; // Frames served from a bucket of previously mismatched frames.
+			uint64_t misses;   // Frames that had to be allocated.
+			uint64_t dropped;  // Frames released because the ring or their bucket was full.
+		};
+
+		private:
+		typedef std::tuple<int32_t, int32_t, int> bucket_key_t;
+
+		// Locked Mode
 		std::deque<std::shared_ptr<AVFrame>> _frames;
 		std::mutex                           _lock;
 
+		// Single-Producer/Single-Consumer Mode
+		bool                                  _spsc;
+		std::vector<std::shared_ptr<AVFrame>> _ring;
+		std::size_t                           _ring_mask;
+		std::atomic<std::size_t>              _ring_head; // Next slot to pop, only written by the consumer.
+		std::atomic<std::size_t>              _ring_tail; // Next slot to push, only written by the producer.
+
+		// Mismatched frames, only accessed by the consumer.
+		std::map<bucket_key_t, std::vector<std::shared_ptr<AVFrame>>> _buckets;
+
 		std::pair<int32_t, int32_t> _resolution;
 		AVPixelFormat               _format = AV_PIX_FMT_NONE;
 
+		std::atomic<uint64_t> _hits;
+		std::atomic<uint64_t> _recycled;
+		std::atomic<uint64_t> _misses;
+		std::atomic<uint64_t> _dropped;
+
 		std::shared_ptr<AVFrame> create_frame();
 
+		void recycle_frame(std::shared_ptr<AVFrame> frame);
+
+		std::shared_ptr<AVFrame> pop_frame();
+
 		public:
-		avframe_queue();
+		avframe_queue(bool single_producer_consumer = false, std::size_t capacity = 32);
 		~avframe_queue();
 
 		void    set_resolution(int32_t width, int32_t height);
@@ -70,5 +113,7 @@ namespace streamfx::ffmpeg {
 		bool empty();
 
 		std::size_t size();
+
+		statistics get_statistics();
 	};
 } // namespace streamfx::ffmpeg
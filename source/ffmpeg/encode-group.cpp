@@ -0,0 +1,330 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "encode-group.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <tuple>
+#include "plugin.hpp"
+#include "tools.hpp"
+#include "util/util-logging.hpp"
+#include "util/util-threadpool.hpp"
+
+extern "C" {
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4242 4244 4365)
+#endif
+#include <libavutil/imgutils.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+}
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<ffmpeg::encode_group> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+using namespace streamfx::ffmpeg;
+
+bool rendition::operator<(const rendition& other) const
+{
+	return std::tie(width, height, format, colorspace, full_range)
+		   < std::tie(other.width, other.height, other.format, other.colorspace, other.full_range);
+}
+
+encode_group::encode_group(video_t* video) : _lock(), _input(), _members(), _levels(), _roots(), _current(), _consumed()
+{
+	auto voi          = video_output_get_info(video);
+	_input.width      = voi->width;
+	_input.height     = voi->height;
+	_input.format     = ::streamfx::ffmpeg::tools::obs_videoformat_to_avpixelformat(voi->format);
+	_input.colorspace = ::streamfx::ffmpeg::tools::obs_to_av_color_space(voi->colorspace);
+	_input.full_range = (voi->range == VIDEO_RANGE_FULL);
+	if (_input.format == AV_PIX_FMT_NONE) {
+		throw std::runtime_error("Video output format is not supported by FFmpeg.");
+	}
+}
+
+encode_group::~encode_group() {}
+
+const rendition& encode_group::get_input()
+{
+	return _input;
+}
+
+void encode_group::join(const void* member, const rendition& target)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	auto                         members = _members;
+	_members[member]                     = target;
+	try {
+		rebuild();
+	} catch (...) {
+		// Leave the group as it was, so that the other members are unaffected.
+		_members = members;
+		rebuild();
+		throw;
+	}
+}
+
+void encode_group::leave(const void* member)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	_members.erase(member);
+	try {
+		rebuild();
+	} catch (const std::exception& ex) {
+		D_LOG_ERROR("Failed to rebuild conversion after a member left: %s", ex.what());
+	}
+}
+
+std::shared_ptr<AVFrame> encode_group::convert(const void* member, const encoder_frame* frame)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+
+	auto kv = _members.find(member);
+	if (kv == _members.end()) {
+		return nullptr;
+	}
+
+	// libOBS hands the same frame to every encoder with identical requirements, so a frame nobody has seen yet, or one
+	// that this member has already consumed, means that a new frame has started.
+	if ((frame->data[0] != _current) || (_consumed.count(member) != 0)) {
+		process(frame);
+		_current = frame->data[0];
+		_consumed.clear();
+	}
+	_consumed.insert(member);
+
+	level* target = _levels.at(kv->second).get();
+	if (!target->valid) {
+		return nullptr;
+	}
+
+	AVFrame* clone = av_frame_clone(target->frame.get());
+	if (!clone) {
+		return nullptr;
+	}
+	return std::shared_ptr<AVFrame>(clone, [](AVFrame* frame) { av_frame_free(&frame); });
+}
+
+void encode_group::rebuild()
+{
+	_levels.clear();
+	_roots.clear();
+	_current = nullptr;
+	_consumed.clear();
+
+	// Largest renditions first, so that every level can find its parent among the ones before it.
+	std::vector<level*> order;
+	for (auto& kv : _members) {
+		auto& ptr = _levels[kv.second];
+		if (!ptr) {
+			ptr         = std::make_unique<level>();
+			ptr->target = kv.second;
+			ptr->parent = nullptr;
+			ptr->valid  = false;
+			ptr->frame  = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame* frame) { av_frame_free(&frame); });
+			order.push_back(ptr.get());
+
+			ptr->pool_size = av_image_get_buffer_size(ptr->target.format, static_cast<int>(ptr->target.width),
+													  static_cast<int>(ptr->target.height), 32);
+			if (ptr->pool_size < 0) {
+				throw std::runtime_error("Unsupported frame size or format.");
+			}
+			ptr->pool = std::shared_ptr<AVBufferPool>(av_buffer_pool_init(ptr->pool_size, nullptr),
+													  [](AVBufferPool* pool) { av_buffer_pool_uninit(&pool); });
+			if (!ptr->pool) {
+				throw std::runtime_error("Failed to create buffer pool.");
+			}
+		}
+	}
+	std::sort(order.begin(), order.end(), [](const level* a, const level* b) {
+		return (static_cast<uint64_t>(a->target.width) * a->target.height)
+			   > (static_cast<uint64_t>(b->target.width) * b->target.height);
+	});
+
+	for (auto iter = order.begin(); iter != order.end(); iter++) {
+		level* lvl = *iter;
+
+		// Scale from the smallest larger level with the same format, as that is the least amount of work.
+		for (auto piter = order.begin(); piter != iter; piter++) {
+			const rendition& parent = (*piter)->target;
+			if ((parent.format != lvl->target.format) || (parent.colorspace != lvl->target.colorspace)
+				|| (parent.full_range != lvl->target.full_range) || (parent.width < lvl->target.width)
+				|| (parent.height < lvl->target.height)) {
+				continue;
+			}
+			lvl->parent = *piter;
+		}
+
+		const rendition& source = lvl->parent ? lvl->parent->target : _input;
+		lvl->scaler.set_source_size(source.width, source.height);
+		lvl->scaler.set_source_format(source.format);
+		lvl->scaler.set_source_color(source.full_range, source.colorspace);
+		lvl->scaler.set_target_size(lvl->target.width, lvl->target.height);
+		lvl->scaler.set_target_format(lvl->target.format);
+		lvl->scaler.set_target_color(lvl->target.full_range, lvl->target.colorspace);
+		bool resize = (source.width != lvl->target.width) || (source.height != lvl->target.height);
+		if (!lvl->scaler.initialize(resize ? SWS_BICUBIC : SWS_POINT)) {
+			throw std::runtime_error("Initializing scaler failed.");
+		}
+
+		if (lvl->parent) {
+			lvl->parent->children.push_back(lvl);
+		} else {
+			_roots.push_back(lvl);
+		}
+
+		D_LOG_DEBUG("%" PRIu32 "x%" PRIu32 " %s from %" PRIu32 "x%" PRIu32 " %s.", lvl->target.width,
+					lvl->target.height, ::streamfx::ffmpeg::tools::get_pixel_format_name(lvl->target.format),
+					source.width, source.height, ::streamfx::ffmpeg::tools::get_pixel_format_name(source.format));
+	}
+}
+
+void encode_group::process(const encoder_frame* frame)
+{
+	for (auto& kv : _levels) {
+		level* lvl = kv.second.get();
+		lvl->valid = false;
+
+		// Encoders may still hold on to the previous frame, in which case it gets a new buffer instead.
+		if (!lvl->frame->buf[0] || !av_frame_is_writable(lvl->frame.get())) {
+			if (!allocate(lvl)) {
+				continue;
+			}
+		}
+		lvl->frame->colorspace  = lvl->target.colorspace;
+		lvl->frame->color_range = lvl->target.full_range ? AVCOL_RANGE_JPEG : AVCOL_RANGE_MPEG;
+	}
+
+	if (_roots.empty()) {
+		return;
+	}
+
+	const uint8_t* const* data     = frame->data;
+	const int*            linesize = reinterpret_cast<const int*>(frame->linesize);
+
+	// Every other branch of the pyramid is handed to the thread pool, while this thread works on the first one.
+	struct state {
+		std::mutex              lock;
+		std::condition_variable cv;
+		std::size_t             pending;
+	};
+	auto sync     = std::make_shared<state>();
+	sync->pending = _roots.size() - 1;
+	for (auto iter = _roots.begin() + 1; iter != _roots.end(); iter++) {
+		level* root = *iter;
+		streamfx::threadpool()->push(
+			[this, root, data, linesize, sync](streamfx::util::threadpool_data_t) {
+				process(root, data, linesize);
+
+				std::unique_lock<std::mutex> lock(sync->lock);
+				sync->pending--;
+				sync->cv.notify_all();
+			},
+			nullptr);
+	}
+	process(_roots.front(), data, linesize);
+
+	std::unique_lock<std::mutex> lock(sync->lock);
+	sync->cv.wait(lock, [&sync]() { return sync->pending == 0; });
+}
+
+void encode_group::process(level* target, const uint8_t* const data[], const int linesize[])
+{
+	if (!target->frame->buf[0]) {
+		return;
+	}
+
+	int32_t res = target->scaler.convert(data, linesize, 0, static_cast<int32_t>(target->scaler.get_source_height()),
+										 target->frame->data, target->frame->linesize);
+	if (res <= 0) {
+		D_LOG_ERROR("Failed to convert frame: %s (%" PRId32 ").",
+					::streamfx::ffmpeg::tools::get_error_description(res), res);
+		return;
+	}
+	target->valid = true;
+
+	for (auto child : target->children) {
+		process(child, target->frame->data, target->frame->linesize);
+	}
+}
+
+bool encode_group::allocate(level* target)
+{
+	// Buffers return to the pool of their level once every encoder released them, so that the steady state doesn't
+	// allocate anything. All planes share one buffer with 32 byte aligned lines.
+	av_frame_unref(target->frame.get());
+	target->frame->width  = static_cast<int>(target->target.width);
+	target->frame->height = static_cast<int>(target->target.height);
+	target->frame->format = target->target.format;
+
+	target->frame->buf[0] = av_buffer_pool_get(target->pool.get());
+	if (!target->frame->buf[0]) {
+		D_LOG_ERROR("Failed to allocate frame.", "");
+		return false;
+	}
+
+	if (int res = av_image_fill_arrays(target->frame->data, target->frame->linesize, target->frame->buf[0]->data,
+									   target->target.format, target->frame->width, target->frame->height, 32);
+		res < 0) {
+		D_LOG_ERROR("Failed to allocate frame: %s (%" PRId32 ").",
+					::streamfx::ffmpeg::tools::get_error_description(res), res);
+		av_frame_unref(target->frame.get());
+		return false;
+	}
+	return true;
+}
+
+std::shared_ptr<encode_group> encode_group::get(video_t* video)
+{
+	static std::mutex                                       lock;
+	static std::map<video_t*, std::weak_ptr<encode_group>> groups;
+
+	std::unique_lock<std::mutex> lk(lock);
+	for (auto iter = groups.begin(); iter != groups.end();) {
+		if (iter->second.expired()) {
+			iter = groups.erase(iter);
+		} else {
+			iter++;
+		}
+	}
+
+	auto& group = groups[video];
+	auto  ptr   = group.lock();
+	if (!ptr) {
+		ptr   = std::make_shared<encode_group>(video);
+		group = ptr;
+	}
+	return ptr;
+}
@@ -0,0 +1,113 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+#include "swscale.hpp"
+
+extern "C" {
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4242 4244 4365)
+#endif
+#include <libavutil/buffer.h>
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+}
+
+namespace streamfx::ffmpeg {
+	struct rendition {
+		uint32_t      width;
+		uint32_t      height;
+		AVPixelFormat format;
+		AVColorSpace  colorspace;
+		bool          full_range;
+
+		bool operator<(const rendition& other) const;
+	};
+
+	/** Converts every frame of a video output once for all encoders that encode it.
+	 *
+	 * Each member names the rendition it needs, and the first member to submit a frame converts it for all of them.
+	 * Smaller renditions are scaled down from the next larger one with the same format instead of the full input, and
+	 * independent branches of that pyramid are converted in parallel. Members receive their own AVFrame, which
+	 * references the shared buffers, so per-frame properties like the picture type can still be changed.
+	 */
+	class encode_group {
+		struct level {
+			rendition                     target;
+			level*                        parent;
+			std::vector<level*>           children;
+			swscale                       scaler;
+			std::shared_ptr<AVBufferPool> pool;
+			int                           pool_size;
+			std::shared_ptr<AVFrame>      frame;
+			bool                          valid;
+		};
+
+		std::mutex                                  _lock;
+		rendition                                   _input;
+		std::map<const void*, rendition>            _members;
+		std::map<rendition, std::unique_ptr<level>> _levels;
+		std::vector<level*>                         _roots;
+
+		const uint8_t*        _current;
+		std::set<const void*> _consumed;
+
+		public:
+		encode_group(video_t* video);
+		~encode_group();
+
+		/// Size and format of the frames members must request from libOBS.
+		const rendition& get_input();
+
+		/// Add a member, or change the rendition of an existing one. Throws if the conversion is impossible.
+		void join(const void* member, const rendition& target);
+
+		void leave(const void* member);
+
+		/** Retrieve the frame for a member, converting the input if no other member has done so yet.
+		 *
+		 * @return New reference to the converted frame, or nullptr if the conversion failed.
+		 */
+		std::shared_ptr<AVFrame> convert(const void* member, const struct encoder_frame* frame);
+
+		private:
+		void rebuild();
+
+		void process(const struct encoder_frame* frame);
+
+		void process(level* target, const uint8_t* const data[], const int linesize[]);
+
+		bool allocate(level* target);
+
+		public: // Per video output
+		static std::shared_ptr<encode_group> get(video_t* video);
+	};
+} // namespace streamfx::ffmpeg
@@ -0,0 +1,222 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "plane-copy.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "plugin.hpp"
+#include "util/util-threadpool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ST_SSE2
+#include <emmintrin.h>
+#endif
+
+// Copies of at least this size bypass the cache.
+#define NONTEMPORAL_THRESHOLD (2 * 1024 * 1024)
+
+// Copies of at least this size are split across the thread pool, in chunks of at least this size.
+#define THREADING_THRESHOLD (4 * 1024 * 1024)
+#define THREADING_CHUNK (1024 * 1024)
+#define THREADING_MAX_WORKERS 4
+
+namespace {
+	std::size_t get_workers()
+	{
+		return std::min<std::size_t>(std::max<std::size_t>(std::thread::hardware_concurrency() / 2, 1),
+									 THREADING_MAX_WORKERS);
+	}
+
+	/// Split 'chunks' pieces of work between the plugin thread pool and the calling thread.
+	void run_parallel(std::size_t chunks, std::function<void(std::size_t)> const& function)
+	{
+		struct state {
+			std::mutex               lock;
+			std::condition_variable  cv;
+			std::size_t              completed;
+			std::atomic<std::size_t> next;
+		};
+		auto sync       = std::make_shared<state>();
+		sync->completed = 0;
+		sync->next      = 0;
+
+		// Whoever comes first takes the next chunk. The pool is shared with long running work, so the calling thread
+		// may well end up doing everything, and only waits for chunks that a helper actually started. Helpers that only
+		// get to run afterwards find nothing left, and never touch 'function' which may be gone by then.
+		auto process = [sync, chunks, &function]() {
+			for (std::size_t chunk = sync->next++; chunk < chunks; chunk = sync->next++) {
+				function(chunk);
+
+				std::unique_lock<std::mutex> lock(sync->lock);
+				if (++sync->completed == chunks) {
+					sync->cv.notify_all();
+				}
+			}
+		};
+
+		auto pool = streamfx::threadpool();
+		for (std::size_t idx = 1; idx < chunks; idx++) {
+			pool->push([process](streamfx::util::threadpool_data_t) { process(); }, nullptr);
+		}
+
+		// The calling thread helps out instead of idling.
+		process();
+
+		std::unique_lock<std::mutex> lock(sync->lock);
+		sync->cv.wait(lock, [&sync, chunks]() { return sync->completed == chunks; });
+	}
+
+	inline void copy_row(uint8_t* dst, const uint8_t* src, std::size_t size, bool nontemporal)
+	{
+#ifdef ST_SSE2
+		if (nontemporal && (size >= 64)) {
+			// Streaming stores need an aligned destination.
+			std::size_t head = (16 - (reinterpret_cast<uintptr_t>(dst) & 15)) & 15;
+			std::memcpy(dst, src, head);
+			dst += head;
+			src += head;
+			size -= head;
+
+			for (; size >= 64; size -= 64, dst += 64, src += 64) {
+				__m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+				__m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+				__m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+				__m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+				_mm_stream_si128(reinterpret_cast<__m128i*>(dst), r0);
+				_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), r1);
+				_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), r2);
+				_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), r3);
+			}
+		}
+#endif
+		std::memcpy(dst, src, size);
+	}
+
+	void copy_rows(uint8_t* dst, std::size_t dst_stride, const uint8_t* src, std::size_t src_stride, std::size_t width,
+				   std::size_t height, bool nontemporal)
+	{
+		if (dst_stride == src_stride) {
+			// Everything in between rows is padding on both sides, so copy it along instead of skipping it.
+			copy_row(dst, src, (height - 1) * src_stride + width, nontemporal);
+		} else {
+			for (std::size_t y = 0; y < height; y++, dst += dst_stride, src += src_stride) {
+				copy_row(dst, src, width, nontemporal);
+			}
+		}
+
+#ifdef ST_SSE2
+		if (nontemporal) {
+			// Make the streamed data visible to whichever thread consumes it next.
+			_mm_sfence();
+		}
+#endif
+	}
+
+	void widen_rows(uint8_t* dst, std::size_t dst_stride, const uint8_t* src, std::size_t src_stride, std::size_t width,
+					std::size_t height, uint8_t depth, bool replicate)
+	{
+		const int shift_up   = depth - 8;
+		const int shift_down = replicate ? (8 - shift_up) : 8;
+
+		for (std::size_t y = 0; y < height; y++, dst += dst_stride, src += src_stride) {
+			uint16_t*      out = reinterpret_cast<uint16_t*>(dst);
+			const uint8_t* in  = src;
+			std::size_t    x   = 0;
+#ifdef ST_SSE2
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i up   = _mm_cvtsi32_si128(shift_up);
+			const __m128i down = _mm_cvtsi32_si128(shift_down);
+			for (; (x + 16) <= width; x += 16) {
+				__m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + x));
+				__m128i lo = _mm_unpacklo_epi8(v, zero);
+				__m128i hi = _mm_unpackhi_epi8(v, zero);
+				lo         = _mm_or_si128(_mm_sll_epi16(lo, up), _mm_srl_epi16(lo, down));
+				hi         = _mm_or_si128(_mm_sll_epi16(hi, up), _mm_srl_epi16(hi, down));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), lo);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x + 8), hi);
+			}
+#endif
+			for (; x < width; x++) {
+				// A shift by 8 drops all bits of the source sample, which is exactly what plain widening wants.
+				out[x] = static_cast<uint16_t>((in[x] << shift_up) | (in[x] >> shift_down));
+			}
+		}
+	}
+} // namespace
+
+void streamfx::ffmpeg::copy_plane(uint8_t* dst, std::size_t dst_stride, const uint8_t* src, std::size_t src_stride,
+								  std::size_t width, std::size_t height)
+{
+	if ((width == 0) || (height == 0)) {
+		return;
+	}
+
+	std::size_t total       = width * height;
+	bool        nontemporal = (total >= NONTEMPORAL_THRESHOLD);
+	if ((total < THREADING_THRESHOLD) || (get_workers() <= 1)) {
+		copy_rows(dst, dst_stride, src, src_stride, width, height, nontemporal);
+		return;
+	}
+
+	std::size_t chunks = std::min(get_workers(), total / THREADING_CHUNK);
+	std::size_t rows   = (height + chunks - 1) / chunks;
+	run_parallel(chunks, [&](std::size_t chunk) {
+		std::size_t y0 = chunk * rows;
+		std::size_t y1 = std::min(height, y0 + rows);
+		if (y0 < y1) {
+			copy_rows(dst + y0 * dst_stride, dst_stride, src + y0 * src_stride, src_stride, width, y1 - y0,
+					  nontemporal);
+		}
+	});
+}
+
+void streamfx::ffmpeg::widen_plane(uint16_t* dst, std::size_t dst_stride, const uint8_t* src, std::size_t src_stride,
+								   std::size_t width, std::size_t height, uint8_t depth, bool replicate)
+{
+	if ((width == 0) || (height == 0)) {
+		return;
+	}
+	if ((depth <= 8) || (depth > 16)) {
+		throw std::invalid_argument("depth");
+	}
+
+	uint8_t*    dst8  = reinterpret_cast<uint8_t*>(dst);
+	std::size_t total = width * height * 2;
+	if ((total < THREADING_THRESHOLD) || (get_workers() <= 1)) {
+		widen_rows(dst8, dst_stride, src, src_stride, width, height, depth, replicate);
+		return;
+	}
+
+	std::size_t chunks = std::min(get_workers(), total / THREADING_CHUNK);
+	std::size_t rows   = (height + chunks - 1) / chunks;
+	run_parallel(chunks, [&](std::size_t chunk) {
+		std::size_t y0 = chunk * rows;
+		std::size_t y1 = std::min(height, y0 + rows);
+		if (y0 < y1) {
+			widen_rows(dst8 + y0 * dst_stride, dst_stride, src + y0 * src_stride, src_stride, width, y1 - y0, depth,
+					   replicate);
+		}
+	});
+}
@@ -0,0 +1,42 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+
+namespace streamfx::ffmpeg {
+	/** Copy 'height' rows of 'width' bytes from one plane into another, each with its own stride.
+	 *
+	 * Planes with identical strides are copied as a single block. Large planes are written with non-temporal stores
+	 * so that the source frame isn't evicted from the cache by a destination the encoder reads much later, and very
+	 * large planes are additionally split into row ranges that are copied in parallel.
+	 */
+	void copy_plane(uint8_t* dst, std::size_t dst_stride, const uint8_t* src, std::size_t src_stride, std::size_t width,
+					std::size_t height);
+
+	/** Widen 'height' rows of 'width' 8-bit samples into little-endian samples of 'depth' bits.
+	 *
+	 * Samples are shifted up, which keeps limited range and chroma values exact. With 'replicate' the top bits are
+	 * repeated into the new low bits instead, so that full range values (and alpha) still reach the new maximum.
+	 */
+	void widen_plane(uint16_t* dst, std::size_t dst_stride, const uint8_t* src, std::size_t src_stride,
+					 std::size_t width, std::size_t height, uint8_t depth, bool replicate);
+} // namespace streamfx::ffmpeg
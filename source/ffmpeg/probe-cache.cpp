@@ -0,0 +1,371 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "probe-cache.hpp"
+#include <cstdlib>
+#include <sstream>
+#include "obs/obs-tools.hpp"
+#include "plugin.hpp"
+#include "util/util-logging.hpp"
+#include "util/util-threadpool.hpp"
+
+extern "C" {
+#pragma warning(push)
+#pragma warning(disable : 4244)
+#include <libavcodec/avcodec.h>
+#include <libavutil/avutil.h>
+#pragma warning(pop)
+}
+
+#if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__) // Windows
+#define ST_WINDOWS
+#else
+#define ST_UNIX
+#endif
+
+#if defined(ST_WINDOWS)
+#include <Windows.h>
+#else
+#include <dlfcn.h>
+#include <fstream>
+#include <iterator>
+#if defined(__linux__)
+#include <link.h>
+#endif
+#endif
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<ffmpeg::probe_cache> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+#define ST_KEY_FINGERPRINT "Fingerprint"
+#define ST_KEY_PROBES "Probes"
+#define ST_KEY_RESULT "Result"
+#define ST_KEY_DRIVER "Driver"
+
+using namespace streamfx::ffmpeg;
+
+static std::string build_fingerprint()
+{
+	// Anything that changes which encoders exist, or how they behave, has to be part of this.
+	std::stringstream sstr;
+	sstr << STREAMFX_VERSION_STRING << ";" << av_version_info() << ";" << avcodec_version() << ";" << avutil_version()
+		 << ";" << std::hex << std::hash<std::string_view>{}(avcodec_configuration());
+	return sstr.str();
+}
+
+#if defined(ST_UNIX)
+static std::filesystem::path find_loaded_library(std::string_view library)
+{
+	// If something already loaded the library, the loader knows exactly which file it picked.
+	std::filesystem::path path;
+#if defined(__linux__)
+	if (void* handle = dlopen(std::string(library).c_str(), RTLD_LAZY | RTLD_NOLOAD); handle) {
+		struct link_map* map = nullptr;
+		if ((dlinfo(handle, RTLD_DI_LINKMAP, &map) == 0) && map && map->l_name && (map->l_name[0] != '\0')) {
+			path = std::filesystem::u8path(map->l_name);
+		}
+		dlclose(handle);
+	}
+#endif
+	return path;
+}
+
+static std::filesystem::path find_cached_library(std::string_view library)
+{
+	// Look the library up in the cache that ldconfig maintains for the loader, which covers every directory the
+	// distribution configured. Only the format glibc has written since 2.x is understood, older caches carry it after
+	// the original format.
+	std::filesystem::path path;
+#if defined(__linux__)
+	std::ifstream file("/etc/ld.so.cache", std::ios::binary);
+	if (!file) {
+		return path;
+	}
+	std::vector<char> data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+	constexpr std::string_view magic       = "glibc-ld.so.cache1.1";
+	constexpr std::size_t      header_size = 48; // Magic, library count, string table size, flags and padding.
+	constexpr std::size_t      entry_size  = 24; // Flags, name and path offsets, OS version and hardware caps.
+	std::string_view           view        = {data.data(), data.size()};
+	std::size_t                base        = view.find(magic);
+	if ((base == std::string_view::npos) || ((view.size() - base) < header_size)) {
+		return path;
+	}
+
+	// Strings are referenced by their offset from the start of the header.
+	auto string_at = [&](uint32_t offset) {
+		std::string_view str = (base + offset < view.size()) ? view.substr(base + offset) : std::string_view();
+		return str.substr(0, str.find('\0'));
+	};
+
+	uint32_t count = 0;
+	std::memcpy(&count, data.data() + base + magic.size(), sizeof(count));
+	for (std::size_t idx = 0; idx < count; idx++) {
+		std::size_t offset = base + header_size + idx * entry_size;
+		if ((offset + entry_size) > view.size()) {
+			break;
+		}
+
+		uint32_t key, value;
+		std::memcpy(&key, data.data() + offset + 4, sizeof(key));
+		std::memcpy(&value, data.data() + offset + 8, sizeof(value));
+		if (string_at(key) == library) {
+			// Drivers update the libraries of every architecture at once, so the first one is as good as any.
+			path = std::filesystem::u8path(string_at(value));
+			break;
+		}
+	}
+#endif
+	return path;
+}
+#endif
+
+static std::string driver_fingerprint(std::string_view library)
+{
+	// Drivers don't share a common way to query their version without loading them, which is exactly what this is
+	// trying to avoid. Size and modification time of the library change with every driver update, so use those.
+	if (library.empty()) {
+		return std::string();
+	}
+
+	// Find the library the same way the loader would.
+	std::vector<std::filesystem::path> paths;
+#if defined(ST_WINDOWS)
+	std::array<wchar_t, MAX_PATH> buffer;
+	if (UINT len = GetSystemDirectoryW(buffer.data(), static_cast<UINT>(buffer.size())); len > 0) {
+		paths.emplace_back(std::filesystem::path(std::wstring(buffer.data(), buffer.data() + len))
+						   / std::filesystem::u8path(library));
+	}
+#else
+	if (auto path = find_loaded_library(library); !path.empty()) {
+		paths.push_back(path);
+	}
+	if (const char* env = getenv("LD_LIBRARY_PATH"); env) {
+		std::stringstream sstr{env};
+		for (std::string path; std::getline(sstr, path, ':');) {
+			if (!path.empty()) {
+				paths.emplace_back(std::filesystem::u8path(path) / std::filesystem::u8path(library));
+			}
+		}
+	}
+	if (auto path = find_cached_library(library); !path.empty()) {
+		paths.push_back(path);
+	}
+	for (auto path : {"/usr/lib64", "/usr/lib", "/lib64", "/lib"}) {
+		paths.emplace_back(std::filesystem::u8path(path) / std::filesystem::u8path(library));
+	}
+#endif
+
+	for (auto& path : paths) {
+		// Symbolic links usually stay the same across updates, the file they point at doesn't.
+		std::error_code ec;
+		auto            file = std::filesystem::canonical(path, ec);
+		if (ec) {
+			continue;
+		}
+		auto size = std::filesystem::file_size(file, ec);
+		if (ec) {
+			continue;
+		}
+		auto time = std::filesystem::last_write_time(file, ec);
+		if (ec) {
+			continue;
+		}
+
+		std::stringstream sstr;
+		sstr << file.u8string() << ";" << size << ";" << time.time_since_epoch().count();
+		return sstr.str();
+	}
+
+	return std::string();
+}
+
+probe_cache::probe_cache() : _lock(), _path(), _fingerprint(), _data(), _entries(), _dirty(false)
+{
+	_path        = streamfx::config_file_path("ffmpeg-probes.json");
+	_fingerprint = build_fingerprint();
+
+	try {
+		if (std::filesystem::exists(_path)) {
+			if (obs_data_t* data = obs_data_create_from_json_file(_path.u8string().c_str()); data) {
+				_data = std::shared_ptr<obs_data_t>(data, obs::obs_data_deleter);
+			}
+		}
+	} catch (...) {
+	}
+
+	// Results from a different FFmpeg build or plugin version can't be trusted.
+	if (_data && (_fingerprint != obs_data_get_string(_data.get(), ST_KEY_FINGERPRINT))) {
+		D_LOG_INFO("FFmpeg or StreamFX changed since the last start, discarding cached probes.", "");
+		_data.reset();
+	}
+	if (!_data) {
+		_data = std::shared_ptr<obs_data_t>(obs_data_create(), obs::obs_data_deleter);
+		obs_data_set_string(_data.get(), ST_KEY_FINGERPRINT, _fingerprint.c_str());
+		_dirty = true;
+	}
+}
+
+probe_cache::~probe_cache()
+{
+	save();
+}
+
+bool probe_cache::probe(std::string_view name, std::string_view library, std::function<bool()> probe)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+
+	// Only probe once per session.
+	std::string key{name};
+	if (auto kv = _entries.find(key); kv != _entries.end()) {
+		return kv->second.result;
+	}
+
+	entry& ent = _entries[key];
+	ent.probe  = probe;
+	ent.driver = driver_fingerprint(library);
+	ent.cached = false;
+
+	// Without a fingerprint, a driver update would go unnoticed, so the result can't be trusted.
+	bool trusted = library.empty() || !ent.driver.empty();
+
+	std::shared_ptr<obs_data_t> probes{obs_data_get_obj(_data.get(), ST_KEY_PROBES), obs::obs_data_deleter};
+	if (probes) {
+		std::shared_ptr<obs_data_t> cached{obs_data_get_obj(probes.get(), key.c_str()), obs::obs_data_deleter};
+		if (trusted && cached && obs_data_has_user_value(cached.get(), ST_KEY_RESULT)
+			&& (ent.driver == obs_data_get_string(cached.get(), ST_KEY_DRIVER))) {
+			ent.result = obs_data_get_bool(cached.get(), ST_KEY_RESULT);
+			ent.cached = true;
+			return ent.result;
+		}
+	} else {
+		probes = std::shared_ptr<obs_data_t>(obs_data_create(), obs::obs_data_deleter);
+		obs_data_set_obj(_data.get(), ST_KEY_PROBES, probes.get());
+	}
+
+	ent.result = probe();
+
+	std::shared_ptr<obs_data_t> result{obs_data_create(), obs::obs_data_deleter};
+	obs_data_set_bool(result.get(), ST_KEY_RESULT, ent.result);
+	obs_data_set_string(result.get(), ST_KEY_DRIVER, ent.driver.c_str());
+	obs_data_set_obj(probes.get(), key.c_str(), result.get());
+	_dirty = true;
+
+	return ent.result;
+}
+
+void probe_cache::refresh()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	for (auto& kv : _entries) {
+		if (!kv.second.cached) {
+			continue;
+		}
+
+		std::weak_ptr<probe_cache> self = weak_from_this();
+		streamfx::threadpool()->push(
+			[self, name = kv.first](streamfx::util::threadpool_data_t) {
+				if (auto cache = self.lock(); cache) {
+					cache->task_refresh(name);
+				}
+			},
+			nullptr);
+	}
+}
+
+void probe_cache::task_refresh(std::string name)
+{
+	std::function<bool()> probe;
+	bool                  result;
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		auto&                        ent = _entries.at(name);
+		probe                            = ent.probe;
+		result                           = ent.result;
+	}
+
+	// Probing is the slow part, so it must not hold the lock.
+	bool actual = probe();
+	if (actual == result) {
+		return;
+	}
+
+	D_LOG_WARNING("Cached result for '%s' is outdated, changes will apply after restarting OBS Studio.", name.c_str());
+
+	std::unique_lock<std::mutex> lock(_lock);
+	auto&                        ent = _entries.at(name);
+	ent.result                       = actual;
+	ent.cached                       = false;
+
+	std::shared_ptr<obs_data_t> probes{obs_data_get_obj(_data.get(), ST_KEY_PROBES), obs::obs_data_deleter};
+	std::shared_ptr<obs_data_t> cached{obs_data_get_obj(probes.get(), name.c_str()), obs::obs_data_deleter};
+	obs_data_set_bool(cached.get(), ST_KEY_RESULT, actual);
+	_dirty = true;
+}
+
+void probe_cache::save()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	if (!_dirty) {
+		return;
+	}
+
+	try {
+		if (_path.has_parent_path()) {
+			std::filesystem::create_directories(_path.parent_path());
+		}
+		if (!obs_data_save_json_safe(_data.get(), _path.u8string().c_str(), ".tmp", ".bk")) {
+			throw std::runtime_error("Unable to write file.");
+		}
+		_dirty = false;
+	} catch (std::exception const& ex) {
+		D_LOG_ERROR("Failed to save probe cache: %s", ex.what());
+	}
+}
+
+static std::shared_ptr<probe_cache> _instance = nullptr;
+
+void probe_cache::initialize()
+{
+	if (!_instance)
+		_instance = std::make_shared<probe_cache>();
+}
+
+void probe_cache::finalize()
+{
+	_instance.reset();
+}
+
+std::shared_ptr<probe_cache> probe_cache::get()
+{
+	return _instance;
+}
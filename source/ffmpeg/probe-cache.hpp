@@ -0,0 +1,78 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include <filesystem>
+#include <functional>
+#include <mutex>
+
+namespace streamfx::ffmpeg {
+	/** Persistent cache for expensive capability probes, such as loading hardware encoder runtimes.
+	 *
+	 * Results are stored next to the plugin configuration and are only trusted if the FFmpeg build and the probed
+	 * driver library are unchanged. Probes whose driver library can't be found always run. Cached results are
+	 * re-validated in the background by refresh(), differences are written back to disk and take effect on the next
+	 * start.
+	 */
+	class probe_cache : public std::enable_shared_from_this<probe_cache> {
+		struct entry {
+			std::function<bool()> probe;
+			std::string           driver;
+			bool                  result;
+			bool                  cached;
+		};
+
+		std::mutex                   _lock;
+		std::filesystem::path        _path;
+		std::string                  _fingerprint;
+		std::shared_ptr<obs_data_t>  _data;
+		std::map<std::string, entry> _entries;
+		bool                         _dirty;
+
+		public:
+		probe_cache();
+		~probe_cache();
+
+		/** Retrieve the result of a probe, running it only if no valid cached result exists.
+		 *
+		 * @param name Unique name of the probe.
+		 * @param library Name of the driver library the result depends on, may be empty.
+		 * @param probe Function performing the actual probe.
+		 */
+		bool probe(std::string_view name, std::string_view library, std::function<bool()> probe);
+
+		/// Re-run all probes that were answered from the cache on the thread pool.
+		void refresh();
+
+		void save();
+
+		private:
+		void task_refresh(std::string name);
+
+		public: // Singleton
+		static void initialize();
+
+		static void finalize();
+
+		static std::shared_ptr<probe_cache> get();
+	};
+} // namespace streamfx::ffmpeg
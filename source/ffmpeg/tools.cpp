@@ -28,6 +28,7 @@ extern "C" {
 #pragma warning(push)
 #pragma warning(disable : 4244)
 #include <libavcodec/avcodec.h>
+#include <libavutil/channel_layout.h>
 #include <libavutil/error.h>
 #include <libavutil/opt.h>
 #include <libavutil/pixdesc.h>
@@ -128,6 +129,57 @@ AVPixelFormat tools::get_least_lossy_format(const AVPixelFormat* haystack, AVPix
 	return avcodec_find_best_pix_fmt_of_list(haystack, needle, 0, &data_loss);
 }
 
+static std::map<audio_format, AVSampleFormat> const obs_to_av_sample_format_map = {
+	{AUDIO_FORMAT_U8BIT, AV_SAMPLE_FMT_U8},          //
+	{AUDIO_FORMAT_16BIT, AV_SAMPLE_FMT_S16},         //
+	{AUDIO_FORMAT_32BIT, AV_SAMPLE_FMT_S32},         //
+	{AUDIO_FORMAT_FLOAT, AV_SAMPLE_FMT_FLT},         //
+	{AUDIO_FORMAT_U8BIT_PLANAR, AV_SAMPLE_FMT_U8P},  //
+	{AUDIO_FORMAT_16BIT_PLANAR, AV_SAMPLE_FMT_S16P}, //
+	{AUDIO_FORMAT_32BIT_PLANAR, AV_SAMPLE_FMT_S32P}, //
+	{AUDIO_FORMAT_FLOAT_PLANAR, AV_SAMPLE_FMT_FLTP}, //
+};
+
+AVSampleFormat tools::obs_audioformat_to_avsampleformat(audio_format v)
+{
+	auto found = obs_to_av_sample_format_map.find(v);
+	if (found != obs_to_av_sample_format_map.end()) {
+		return found->second;
+	}
+	return AV_SAMPLE_FMT_NONE;
+}
+
+audio_format tools::avsampleformat_to_obs_audioformat(AVSampleFormat v)
+{
+	for (const auto& kv : obs_to_av_sample_format_map) {
+		if (kv.second == v)
+			return kv.first;
+	}
+	return AUDIO_FORMAT_UNKNOWN;
+}
+
+uint64_t tools::obs_speakers_to_av_channel_layout(speaker_layout v)
+{
+	switch (v) {
+	case SPEAKERS_MONO:
+		return AV_CH_LAYOUT_MONO;
+	case SPEAKERS_STEREO:
+		return AV_CH_LAYOUT_STEREO;
+	case SPEAKERS_2POINT1:
+		return AV_CH_LAYOUT_2POINT1;
+	case SPEAKERS_4POINT0:
+		return AV_CH_LAYOUT_4POINT0;
+	case SPEAKERS_4POINT1:
+		return AV_CH_LAYOUT_4POINT1;
+	case SPEAKERS_5POINT1:
+		return AV_CH_LAYOUT_5POINT1_BACK;
+	case SPEAKERS_7POINT1:
+		return AV_CH_LAYOUT_7POINT1;
+	default:
+		return 0;
+	}
+}
+
 AVColorRange tools::obs_to_av_color_range(video_range_type v)
 {
 	switch (v) {
@@ -257,6 +309,24 @@ void tools::context_setup_from_obs(const video_output_info* voi, AVCodecContext*
 	context->color_trc       = obs_to_av_color_transfer_characteristics(voi->colorspace);
 }
 
+void tools::context_setup_from_obs(const audio_output_info* aoi, AVCodecContext* context)
+{
+	// Sample Rate
+	context->sample_rate   = static_cast<int>(aoi->samples_per_sec);
+	context->time_base.num = 1;
+	context->time_base.den = context->sample_rate;
+
+	// Channels
+	context->channel_layout = obs_speakers_to_av_channel_layout(aoi->speakers);
+	context->channels       = static_cast<int>(get_audio_channels(aoi->speakers));
+	if (context->channel_layout == 0) {
+		context->channel_layout = static_cast<uint64_t>(av_get_default_channel_layout(context->channels));
+	}
+
+	// Decipher Sample information
+	context->sample_fmt = obs_audioformat_to_avsampleformat(aoi->format);
+}
+
 const char* tools::get_std_compliance_name(int compliance)
 {
 	switch (compliance) {
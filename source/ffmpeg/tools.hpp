@@ -30,6 +30,7 @@ extern "C" {
 #endif
 #include <libavcodec/avcodec.h>
 #include <libavutil/pixfmt.h>
+#include <libavutil/samplefmt.h>
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -47,6 +48,11 @@ namespace streamfx::ffmpeg::tools {
 
 	AVPixelFormat get_least_lossy_format(const AVPixelFormat* haystack, AVPixelFormat needle);
 
+	AVSampleFormat obs_audioformat_to_avsampleformat(audio_format v);
+	audio_format   avsampleformat_to_obs_audioformat(AVSampleFormat v);
+
+	uint64_t obs_speakers_to_av_channel_layout(speaker_layout v);
+
 	AVColorRange                  obs_to_av_color_range(video_range_type v);
 	AVColorSpace                  obs_to_av_color_space(video_colorspace v);
 	AVColorPrimaries              obs_to_av_color_primary(video_colorspace v);
@@ -58,6 +64,8 @@ namespace streamfx::ffmpeg::tools {
 
 	void context_setup_from_obs(const video_output_info* voi, AVCodecContext* context);
 
+	void context_setup_from_obs(const audio_output_info* aoi, AVCodecContext* context);
+
 	const char* get_std_compliance_name(int compliance);
 
 	const char* get_thread_type_name(int thread_type);
@@ -30,6 +30,8 @@
 #include "gfx/blur/gfx-blur-gaussian-linear.hpp"
 #include "gfx/blur/gfx-blur-gaussian.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
+#include "obs/obs-frame-graph.hpp"
 #include "obs/obs-source-tracker.hpp"
 #include "util/util-logging.hpp"
 
@@ -147,10 +149,6 @@ blur_instance::blur_instance(obs_data_t* settings, obs_source_t* self)
 	{
 		auto gctx = streamfx::obs::gs::context();
 
-		// Create RenderTargets
-		this->_source_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-		this->_output_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-
 		// Load Effects
 		{
 			auto file = streamfx::data_file_path("effects/mask.effect").string();
@@ -163,9 +161,16 @@ blur_instance::blur_instance(obs_data_t* settings, obs_source_t* self)
 	}
 
 	update(settings);
+
+	streamfx::obs::frame_graph::get()->add(_self);
 }
 
-blur_instance::~blur_instance() {}
+blur_instance::~blur_instance()
+{
+	if (auto graph = streamfx::obs::frame_graph::get(); graph) {
+		graph->remove(_self);
+	}
+}
 
 bool blur_instance::apply_mask_parameters(streamfx::obs::gs::effect effect, gs_texture_t* original_texture,
 										  gs_texture_t* blurred_texture)
@@ -366,13 +371,18 @@ void blur_instance::video_tick(float)
 	// Load Mask
 	if (_mask.type == mask_type::Image) {
 		if (_mask.image.path_old != _mask.image.path) {
+			_mask.image.loading  = streamfx::obs::gs::texture_cache::get()->load(_mask.image.path);
+			_mask.image.path_old = _mask.image.path;
+		}
+		if (_mask.image.loading.valid()
+			&& (_mask.image.loading.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
 			try {
-				_mask.image.texture  = std::make_shared<streamfx::obs::gs::texture>(_mask.image.path);
-				_mask.image.path_old = _mask.image.path;
+				_mask.image.texture = _mask.image.loading.get();
 			} catch (...) {
 				DLOG_ERROR("<filter-blur> Instance '%s' failed to load image '%s'.", obs_source_get_name(_self),
-						   _mask.image.path.c_str());
+						   _mask.image.path_old.c_str());
 			}
+			_mask.image.loading = {};
 		}
 	} else if (_mask.type == mask_type::Source) {
 		if (_mask.source.name_old != _mask.source.name) {
@@ -387,8 +397,14 @@ void blur_instance::video_tick(float)
 		}
 	}
 
+	// The frame is over, so the render targets go back to the pool until the next one is rendered. Hidden sources
+	// don't render, and so don't hold on to any.
 	_source_rendered = false;
 	_output_rendered = false;
+	_source_texture.reset();
+	_output_texture.reset();
+	_source_rt.reset();
+	_output_rt.reset();
 }
 
 void blur_instance::video_render(gs_effect_t* effect)
@@ -417,44 +433,51 @@ void blur_instance::video_render(gs_effect_t* effect)
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Cache"};
 #endif
 
-			if (obs_source_process_filter_begin(this->_self, GS_RGBA, OBS_ALLOW_DIRECT_RENDERING)) {
-				{
-					auto op = this->_source_rt->render(baseW, baseH);
+			_source_rt = streamfx::obs::gs::rendertarget_pool::get()->acquire(baseW, baseH, GS_RGBA);
 
-					gs_blend_state_push();
-					gs_reset_blend_state();
-					gs_enable_blending(false);
-					gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+			// Take the result of the filter below directly if possible, and only capture it ourselves otherwise.
+			_source_texture = streamfx::obs::frame_graph::get()->capture_input(_self, _source_rt, baseW, baseH);
+			if (!_source_texture) {
+				if (obs_source_process_filter_begin(this->_self, GS_RGBA, OBS_ALLOW_DIRECT_RENDERING)) {
+					{
+						auto op = this->_source_rt->render(baseW, baseH);
 
-					gs_set_cull_mode(GS_NEITHER);
-					gs_enable_color(true, true, true, true);
+						gs_blend_state_push();
+						gs_reset_blend_state();
+						gs_enable_blending(false);
+						gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
 
-					gs_enable_depth_test(false);
-					gs_depth_function(GS_ALWAYS);
+						gs_set_cull_mode(GS_NEITHER);
+						gs_enable_color(true, true, true, true);
 
-					gs_enable_stencil_test(false);
-					gs_enable_stencil_write(false);
-					gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
-					gs_stencil_op(GS_STENCIL_BOTH, GS_KEEP, GS_KEEP, GS_KEEP);
+						gs_enable_depth_test(false);
+						gs_depth_function(GS_ALWAYS);
 
-					// Orthographic Camera and clear RenderTarget.
-					gs_ortho(0, static_cast<float>(baseW), 0, static_cast<float>(baseH), -1., 1.);
-					//gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &black, 0, 0);
+						gs_enable_stencil_test(false);
+						gs_enable_stencil_write(false);
+						gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
+						gs_stencil_op(GS_STENCIL_BOTH, GS_KEEP, GS_KEEP, GS_KEEP);
 
-					// Render
-					obs_source_process_filter_end(this->_self, defaultEffect, baseW, baseH);
+						// Orthographic Camera and clear RenderTarget, which holds whatever its last user left behind.
+						gs_ortho(0, static_cast<float>(baseW), 0, static_cast<float>(baseH), -1., 1.);
+						vec4 blank = {0, 0, 0, 0};
+						gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &blank, 0, 0);
 
-					gs_blend_state_pop();
-				}
+						// Render
+						obs_source_process_filter_end(this->_self, defaultEffect, baseW, baseH);
+
+						gs_blend_state_pop();
+					}
 
-				_source_texture = this->_source_rt->get_texture();
-				if (!_source_texture) {
+					_source_texture = this->_source_rt->get_texture();
+					if (!_source_texture) {
+						obs_source_skip_video_filter(this->_self);
+						return;
+					}
+				} else {
 					obs_source_skip_video_filter(this->_self);
 					return;
 				}
-			} else {
-				obs_source_skip_video_filter(this->_self);
-				return;
 			}
 		}
 
@@ -542,6 +565,8 @@ void blur_instance::video_render(gs_effect_t* effect)
 			apply_mask_parameters(_effect_mask, _source_texture->get_object(), _output_texture->get_object());
 
 			try {
+				_output_rt = streamfx::obs::gs::rendertarget_pool::get()->acquire(baseW, baseH, GS_RGBA);
+
 				auto op = this->_output_rt->render(baseW, baseH);
 				gs_ortho(0, 1, 0, 1, -1, 1);
 
@@ -581,6 +606,11 @@ void blur_instance::video_render(gs_effect_t* effect)
 		gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 		gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
+		// Hand the result over to the filter above instead, if it asked for it.
+		if (streamfx::obs::frame_graph::get()->publish(_self, _output_texture)) {
+			return;
+		}
+
 		gs_effect_t* finalEffect = effect ? effect : defaultEffect;
 		const char*  technique   = "Draw";
 
@@ -28,6 +28,7 @@
 #include "obs/gs/gs-effect.hpp"
 #include "obs/gs/gs-helper.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
+#include "obs/gs/gs-texture-cache.hpp"
 #include "obs/gs/gs-texture.hpp"
 #include "obs/obs-source-factory.hpp"
 
@@ -77,6 +78,7 @@ namespace streamfx::filter::blur {
 				std::string                                 path;
 				std::string                                 path_old;
 				std::shared_ptr<streamfx::obs::gs::texture> texture;
+				streamfx::obs::gs::texture_cache::future_t  loading;
 			} image;
 			struct {
 				std::string                                    name_old;
@@ -21,6 +21,8 @@
 #include "strings.hpp"
 #include <stdexcept>
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
+#include "obs/obs-frame-graph.hpp"
 #include "util/util-logging.hpp"
 
 #ifdef _DEBUG
@@ -120,15 +122,36 @@
 
 using namespace streamfx::filter::color_grade;
 
+// Order of the parameters in the block of the color grade effect.
+enum grade_parameter : std::size_t {
+	GRADE_IMAGE,
+	GRADE_LIFT,
+	GRADE_GAMMA,
+	GRADE_GAIN,
+	GRADE_OFFSET,
+	GRADE_TINT_DETECTION,
+	GRADE_TINT_MODE,
+	GRADE_TINT_EXPONENT,
+	GRADE_TINT_LOW,
+	GRADE_TINT_MID,
+	GRADE_TINT_HIGH,
+	GRADE_CORRECTION,
+};
+
 static constexpr std::string_view HELP_URL = "https://github.com/Xaymar/obs-StreamFX/wiki/Filter-Color-Grade";
 
 // TODO: Figure out a way to merge _lut_rt, _lut_texture, _rt_source, _rt_grad, _tex_source, _tex_grade, _source_updated and _grade_updated.
 // Seriously this is too much GPU space wasted on unused trash.
 
-color_grade_instance::~color_grade_instance() {}
+color_grade_instance::~color_grade_instance()
+{
+	if (auto graph = streamfx::obs::frame_graph::get(); graph) {
+		graph->remove(_self);
+	}
+}
 
 color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self)
-	: obs::source_instance(data, self), _effect(),
+	: obs::source_instance(data, self), _effect(), _params(),
 
 	  _lift(), _gamma(), _gain(), _offset(), _tint_detection(), _tint_luma(), _tint_exponent(), _tint_low(),
 	  _tint_mid(), _tint_hig(), _correction(), _lut_enabled(true), _lut_depth(),
@@ -145,6 +168,9 @@ color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self)
 	} else {
 		try {
 			_effect = streamfx::obs::gs::effect::create(path.u8string());
+			_params = streamfx::obs::gs::effect_parameter_block(
+				_effect, {"image", "pLift", "pGamma", "pGain", "pOffset", "pTintDetection", "pTintMode",
+						  "pTintExponent", "pTintLow", "pTintMid", "pTintHig", "pCorrection"});
 		} catch (std::exception const& ex) {
 			D_LOG_ERROR("Failed to load effect '%s': %s", path.u8string().c_str(), ex.what());
 			throw;
@@ -161,20 +187,14 @@ color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self)
 		_lut_initialized = false;
 	}
 
-	// Allocate render target for rendering.
-	try {
-		allocate_rendertarget(GS_RGBA);
-	} catch (std::exception const& ex) {
-		D_LOG_ERROR("Failed to acquire render target for rendering: %s", ex.what());
-		throw;
-	}
-
 	update(data);
+
+	streamfx::obs::frame_graph::get()->add(_self);
 }
 
-void color_grade_instance::allocate_rendertarget(gs_color_format format)
+void color_grade_instance::allocate_rendertarget(uint32_t width, uint32_t height, gs_color_format format)
 {
-	_cache_rt = std::make_unique<streamfx::obs::gs::rendertarget>(format, GS_ZS_NONE);
+	_cache_rt = streamfx::obs::gs::rendertarget_pool::get()->acquire(width, height, format);
 }
 
 float_t fix_gamma_value(double_t v)
@@ -247,53 +267,17 @@ void color_grade_instance::update(obs_data_t* data)
 
 void color_grade_instance::prepare_effect()
 {
-	if (auto p = _effect.get_parameter("pLift"); p) {
-		p.set_float4(_lift);
-	}
-
-	if (auto p = _effect.get_parameter("pGamma"); p) {
-		p.set_float4(_gamma);
-	}
-
-	if (auto p = _effect.get_parameter("pGain"); p) {
-		p.set_float4(_gain);
-	}
-
-	if (auto p = _effect.get_parameter("pOffset"); p) {
-		p.set_float4(_offset);
-	}
-
-	if (auto p = _effect.get_parameter("pLift"); p) {
-		p.set_float4(_lift);
-	}
-
-	if (auto p = _effect.get_parameter("pTintDetection"); p) {
-		p.set_int(static_cast<int32_t>(_tint_detection));
-	}
-
-	if (auto p = _effect.get_parameter("pTintMode"); p) {
-		p.set_int(static_cast<int32_t>(_tint_luma));
-	}
-
-	if (auto p = _effect.get_parameter("pTintExponent"); p) {
-		p.set_float(_tint_exponent);
-	}
-
-	if (auto p = _effect.get_parameter("pTintLow"); p) {
-		p.set_float3(_tint_low);
-	}
-
-	if (auto p = _effect.get_parameter("pTintMid"); p) {
-		p.set_float3(_tint_mid);
-	}
-
-	if (auto p = _effect.get_parameter("pTintHig"); p) {
-		p.set_float3(_tint_hig);
-	}
-
-	if (auto p = _effect.get_parameter("pCorrection"); p) {
-		p.set_float4(_correction);
-	}
+	_params.set_float4(GRADE_LIFT, _lift);
+	_params.set_float4(GRADE_GAMMA, _gamma);
+	_params.set_float4(GRADE_GAIN, _gain);
+	_params.set_float4(GRADE_OFFSET, _offset);
+	_params.set_int(GRADE_TINT_DETECTION, static_cast<int32_t>(_tint_detection));
+	_params.set_int(GRADE_TINT_MODE, static_cast<int32_t>(_tint_luma));
+	_params.set_float(GRADE_TINT_EXPONENT, _tint_exponent);
+	_params.set_float3(GRADE_TINT_LOW, _tint_low.x, _tint_low.y, _tint_low.z);
+	_params.set_float3(GRADE_TINT_MID, _tint_mid.x, _tint_mid.y, _tint_mid.z);
+	_params.set_float3(GRADE_TINT_HIGH, _tint_hig.x, _tint_hig.y, _tint_hig.z);
+	_params.set_float4(GRADE_CORRECTION, _correction);
 }
 
 void color_grade_instance::rebuild_lut()
@@ -307,19 +291,16 @@ void color_grade_instance::rebuild_lut()
 
 	// Modify the LUT with our color grade.
 	if (lut_texture) {
-		// Check if we have a render target to work with and if it's the correct format.
-		if (!_lut_rt || (lut_texture->get_color_format() != _lut_rt->get_color_format())) {
-			// Create a new render target with new format.
-			_lut_rt = std::make_unique<streamfx::obs::gs::rendertarget>(lut_texture->get_color_format(), GS_ZS_NONE);
-		}
+		// Lease a render target of the right size and format, which is kept until the LUT changes again.
+		_lut_rt = streamfx::obs::gs::rendertarget_pool::get()->acquire(
+			lut_texture->get_width(), lut_texture->get_height(), lut_texture->get_color_format());
 
 		// Prepare our color grade effect.
 		prepare_effect();
 
 		// Assign texture.
-		if (auto p = _effect.get_parameter("image"); p) {
-			p.set_texture(lut_texture);
-		}
+		_params.set_texture(GRADE_IMAGE, lut_texture);
+		_params.flush();
 
 		{ // Begin rendering.
 			auto op = _lut_rt->render(lut_texture->get_width(), lut_texture->get_height());
@@ -354,6 +335,18 @@ void color_grade_instance::video_tick(float)
 {
 	_ccache_fresh = false;
 	_cache_fresh  = false;
+
+	// The frame is over, so the render targets go back to the pool until the next one is rendered. The LUT is kept for
+	// the next frame, but not while nobody can see the source.
+	_ccache_texture.reset();
+	_cache_texture.reset();
+	_ccache_rt.reset();
+	_cache_rt.reset();
+	if (_lut_rt && !obs_source_showing(obs_filter_get_parent(_self))) {
+		_lut_texture.reset();
+		_lut_rt.reset();
+		_lut_dirty = true;
+	}
 }
 
 void color_grade_instance::video_render(gs_effect_t* shader)
@@ -386,49 +379,53 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 		streamfx::obs::gs::debug_marker gdmp{streamfx::obs::gs::debug_color_cache, "Cache '%s'",
 											 obs_source_get_name(target)};
 #endif
-		// If the input cache render target doesn't exist, create it.
+		// If the input cache render target doesn't exist, lease it for this frame.
 		if (!_ccache_rt) {
-			_ccache_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+			_ccache_rt = streamfx::obs::gs::rendertarget_pool::get()->acquire(width, height, GS_RGBA);
 		}
 
-		{
-			auto op = _ccache_rt->render(width, height);
-			gs_ortho(0, static_cast<float_t>(width), 0, static_cast<float_t>(height), 0, 1);
+		// Take the result of the filter below directly if possible, and only capture it ourselves otherwise.
+		_ccache_texture = streamfx::obs::frame_graph::get()->capture_input(_self, _ccache_rt, width, height);
+		if (!_ccache_texture) {
+			{
+				auto op = _ccache_rt->render(width, height);
+				gs_ortho(0, static_cast<float_t>(width), 0, static_cast<float_t>(height), 0, 1);
 
-			// Blank out the input cache.
-			gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &blank, 0., 0);
+				// Blank out the input cache.
+				gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &blank, 0., 0);
 
-			// Begin rendering the actual input source.
-			obs_source_process_filter_begin(_self, GS_RGBA, OBS_ALLOW_DIRECT_RENDERING);
+				// Begin rendering the actual input source.
+				obs_source_process_filter_begin(_self, GS_RGBA, OBS_ALLOW_DIRECT_RENDERING);
 
-			// Enable all colors for rendering.
-			gs_enable_color(true, true, true, true);
+				// Enable all colors for rendering.
+				gs_enable_color(true, true, true, true);
 
-			// Prevent blending with existing content, even if it is cleared.
-			gs_blend_state_push();
-			gs_enable_blending(false);
-			gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+				// Prevent blending with existing content, even if it is cleared.
+				gs_blend_state_push();
+				gs_enable_blending(false);
+				gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
 
-			// Disable depth testing.
-			gs_enable_depth_test(false);
+				// Disable depth testing.
+				gs_enable_depth_test(false);
 
-			// Disable stencil testing.
-			gs_enable_stencil_test(false);
+				// Disable stencil testing.
+				gs_enable_stencil_test(false);
 
-			// Disable culling.
-			gs_set_cull_mode(GS_NEITHER);
+				// Disable culling.
+				gs_set_cull_mode(GS_NEITHER);
 
-			// End rendering the actual input source.
-			obs_source_process_filter_end(_self, obs_get_base_effect(OBS_EFFECT_DEFAULT), width, height);
+				// End rendering the actual input source.
+				obs_source_process_filter_end(_self, obs_get_base_effect(OBS_EFFECT_DEFAULT), width, height);
 
-			// Restore original blend mode.
-			gs_blend_state_pop();
-		}
+				// Restore original blend mode.
+				gs_blend_state_pop();
+			}
 
-		// Try and retrieve the input cache as a texture for later use.
-		_ccache_rt->get_texture(_ccache_texture);
-		if (!_ccache_texture) {
-			throw std::runtime_error("Failed to cache original source.");
+			// Try and retrieve the input cache as a texture for later use.
+			_ccache_rt->get_texture(_ccache_texture);
+			if (!_ccache_texture) {
+				throw std::runtime_error("Failed to cache original source.");
+			}
 		}
 
 		// Mark the input cache as valid.
@@ -449,9 +446,9 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 				_cache_fresh = false;
 			}
 
-			// Reallocate the rendertarget if necessary.
-			if (_cache_rt->get_color_format() != GS_RGBA) {
-				allocate_rendertarget(GS_RGBA);
+			// Lease the render target for this frame if necessary.
+			if (!_cache_rt) {
+				allocate_rendertarget(width, height, GS_RGBA);
 			}
 
 			if (!_cache_fresh) {
@@ -507,9 +504,9 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 #ifdef ENABLE_PROFILING
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Direct Rendering"};
 #endif
-		// Reallocate the rendertarget if necessary.
-		if (_cache_rt->get_color_format() != GS_RGBA) {
-			allocate_rendertarget(GS_RGBA);
+		// Lease the render target for this frame if necessary.
+		if (!_cache_rt) {
+			allocate_rendertarget(width, height, GS_RGBA);
 		}
 
 		{ // Render the source to the cache.
@@ -539,7 +536,8 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 			gs_set_cull_mode(GS_NEITHER);
 
 			// Render the effect.
-			_effect.get_parameter("image").set_texture(_ccache_texture);
+			_params.set_texture(GRADE_IMAGE, _ccache_texture);
+			_params.flush();
 			while (gs_effect_loop(_effect.get_object(), "Draw")) {
 				streamfx::gs_draw_fullscreen_tri();
 			}
@@ -563,6 +561,11 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 #ifdef ENABLE_PROFILING
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache_render, "Draw Cache"};
 #endif
+		// Hand the result over to the filter above instead, if it asked for it.
+		if (streamfx::obs::frame_graph::get()->publish(_self, _cache_texture)) {
+			return;
+		}
+
 		// Revert GPU status to what OBS Studio expects.
 		gs_enable_depth_test(false);
 		gs_enable_color(true, true, true, true);
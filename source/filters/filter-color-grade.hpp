@@ -45,7 +45,8 @@ namespace streamfx::filter::color_grade {
 	};
 
 	class color_grade_instance : public obs::source_instance {
-		streamfx::obs::gs::effect _effect;
+		streamfx::obs::gs::effect                 _effect;
+		streamfx::obs::gs::effect_parameter_block _params;
 
 		// User Configuration
 		vec4                            _lift;
@@ -84,7 +85,7 @@ namespace streamfx::filter::color_grade {
 		color_grade_instance(obs_data_t* data, obs_source_t* self);
 		virtual ~color_grade_instance();
 
-		void allocate_rendertarget(gs_color_format format);
+		void allocate_rendertarget(uint32_t width, uint32_t height, gs_color_format format);
 
 		virtual void load(obs_data_t* data) override;
 		virtual void migrate(obs_data_t* data, uint64_t version) override;
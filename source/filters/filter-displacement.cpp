@@ -85,17 +85,22 @@ void displacement_instance::update(obs_data_t* settings)
 
 	std::string new_file = obs_data_get_string(settings, ST_KEY_FILE);
 	if (new_file != _texture_file) {
+		_texture_load = streamfx::obs::gs::texture_cache::get()->load(new_file);
+		_texture_file = new_file;
+	}
+}
+
+void displacement_instance::video_tick(float_t)
+{
+	if (_texture_load.valid() && (_texture_load.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
 		try {
-			_texture      = std::make_shared<streamfx::obs::gs::texture>(new_file);
-			_texture_file = new_file;
+			_texture = _texture_load.get();
 		} catch (...) {
 			_texture.reset();
 		}
+		_texture_load = {};
 	}
-}
 
-void displacement_instance::video_tick(float_t)
-{
 	_width  = obs_source_get_base_width(_self);
 	_height = obs_source_get_base_height(_self);
 }
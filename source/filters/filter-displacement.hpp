@@ -20,6 +20,7 @@
 #pragma once
 #include "common.hpp"
 #include "obs/gs/gs-effect.hpp"
+#include "obs/gs/gs-texture-cache.hpp"
 #include "obs/obs-source-factory.hpp"
 
 namespace streamfx::filter::displacement {
@@ -29,6 +30,7 @@ namespace streamfx::filter::displacement {
 		// Displacement Map
 		std::shared_ptr<streamfx::obs::gs::texture> _texture;
 		std::string                                 _texture_file;
+		streamfx::obs::gs::texture_cache::future_t  _texture_load;
 		float_t                                     _scale[2];
 		float_t                                     _scale_type;
 
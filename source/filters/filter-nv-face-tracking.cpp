@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <filesystem>
 #include <util/platform.h>
+#include "encoders/encoder-roi.hpp"
 #include "nvidia/cuda/nvidia-cuda-context.hpp"
 #include "obs/gs/gs-helper.hpp"
 #include "obs/obs-tools.hpp"
@@ -90,7 +91,8 @@ face_tracking_instance::face_tracking_instance(obs_data_t* settings, obs_source_
 	{ // Create render target, vertex buffer, and CUDA stream.
 		auto gctx = streamfx::obs::gs::context{};
 		_rt       = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA_UNORM, GS_ZS_NONE);
-		_geometry = std::make_shared<streamfx::obs::gs::vertex_buffer>(uint32_t(4), uint8_t(1));
+		_geometry = std::make_shared<streamfx::obs::gs::vertex_buffer>(
+			uint32_t(4), uint8_t(1), streamfx::obs::gs::vertex_buffer::attributes::Position);
 		auto cctx = _cuda->get_context()->enter();
 		_cuda_stream =
 			std::make_shared<::streamfx::nvidia::cuda::stream>(::streamfx::nvidia::cuda::stream_flags::NON_BLOCKING, 0);
@@ -103,6 +105,8 @@ face_tracking_instance::face_tracking_instance(obs_data_t* settings, obs_source_
 	{ // Set up initial tracking data.
 		_values.center[0] = _values.center[1] = .5;
 		_values.size[0] = _values.size[1] = 1.;
+		_program.visible = false;
+		matrix4_identity(&_program.transform);
 		refresh_region_of_interest();
 	}
 }
@@ -113,6 +117,9 @@ face_tracking_instance::~face_tracking_instance()
 	streamfx::threadpool()->pop(_async_initialize);
 	streamfx::threadpool()->pop(_async_track);
 
+	// Encoders should no longer favor the face.
+	streamfx::encoder::roi_channel::get()->retract(this);
+
 	_ar_loaded.store(false);
 	std::unique_lock<std::mutex> alk{_ar_lock};
 	_ar_library->image_dealloc(&_ar_image_temp);
@@ -399,6 +406,7 @@ void face_tracking_instance::async_track(std::shared_ptr<void> ptr)
 			_values.size[1]     = 1.;
 			_values.velocity[0] = 0;
 			_values.velocity[1] = 0;
+			std::fill(std::begin(_values.face), std::end(_values.face), 0.);
 		} else {
 			// If yes, begin tracking.
 #ifdef ENABLE_PROFILING
@@ -448,6 +456,10 @@ void face_tracking_instance::async_track(std::shared_ptr<void> ptr)
 				_values.velocity[1] *= fps;
 				_values.size[0] = bsx / sx;
 				_values.size[1] = bsy / sy;
+				_values.face[0] = _ar_bboxes.boxes[0].x / sx;
+				_values.face[1] = _ar_bboxes.boxes[0].y / sy;
+				_values.face[2] = (_ar_bboxes.boxes[0].x + _ar_bboxes.boxes[0].width) / sx;
+				_values.face[3] = (_ar_bboxes.boxes[0].y + _ar_bboxes.boxes[0].height) / sy;
 			}
 		}
 
@@ -498,6 +510,64 @@ void face_tracking_instance::refresh_region_of_interest()
 	_filters.size[1]   = streamfx::util::math::kalman1D<double_t>{kalman_q, kalman_r, 1., _values.size[1]};
 }
 
+void face_tracking_instance::publish_region_of_interest()
+{
+	// Encoders only see the canvas, so a face is only of interest when the program output shows us.
+	if (!_program.visible) {
+		return;
+	}
+
+	obs_video_info ovi;
+	if (!obs_get_video_info(&ovi) || !ovi.base_width || !ovi.base_height) {
+		return;
+	}
+
+	// Later filters may still resize the output, so scale to the size the scene item actually sees.
+	obs_source_t* parent = obs_filter_get_parent(_self);
+	float_t       width  = static_cast<float_t>(parent ? obs_source_get_width(parent) : _size.first);
+	float_t       height = static_cast<float_t>(parent ? obs_source_get_height(parent) : _size.second);
+
+	std::vector<streamfx::encoder::region> regions;
+	{
+		std::unique_lock<std::mutex> tlk(_values.lock);
+		if ((_values.face[2] > _values.face[0]) && (_values.face[3] > _values.face[1])) {
+			// Move the face into the zoomed in view that is actually rendered.
+			double_t sx = _filters.size[0].get();
+			double_t sy = _filters.size[1].get();
+			double_t ox = _filters.center[0].get() - sx / 2.;
+			double_t oy = _filters.center[1].get() - sy / 2.;
+			if ((sx > 0.) && (sy > 0.)) {
+				float_t left   = static_cast<float_t>((_values.face[0] - ox) / sx) * width;
+				float_t top    = static_cast<float_t>((_values.face[1] - oy) / sy) * height;
+				float_t right  = static_cast<float_t>((_values.face[2] - ox) / sx) * width;
+				float_t bottom = static_cast<float_t>((_values.face[3] - oy) / sy) * height;
+
+				// Scene items may be rotated, so use the bounding box of all four corners on the canvas.
+				vec3 corners[4];
+				vec3_set(&corners[0], left, top, 0.);
+				vec3_set(&corners[1], right, top, 0.);
+				vec3_set(&corners[2], left, bottom, 0.);
+				vec3_set(&corners[3], right, bottom, 0.);
+				for (auto& corner : corners) {
+					vec3_transform(&corner, &corner, &_program.transform);
+				}
+				vec3 low  = corners[0];
+				vec3 high = corners[0];
+				for (auto& corner : corners) {
+					vec3_min(&low, &low, &corner);
+					vec3_max(&high, &high, &corner);
+				}
+
+				regions.push_back({low.x / ovi.base_width, low.y / ovi.base_height, high.x / ovi.base_width,
+								   high.y / ovi.base_height, 1.f});
+			}
+		}
+	}
+
+	// Keyed by the frame being rendered, so that encoders running behind pick the faces of the frame they encode.
+	streamfx::encoder::roi_channel::get()->publish(this, obs_get_video_frame_time(), regions);
+}
+
 void face_tracking_instance::load(obs_data_t* data)
 {
 	update(data);
@@ -541,6 +611,16 @@ void face_tracking_instance::video_tick(float_t seconds)
 	}
 	refresh_geometry();
 
+	// Find out where the program output shows us, so that rendering can publish the face in canvas space.
+	if (obs_source_t* parent = obs_filter_get_parent(_self); parent != nullptr) {
+		_program.visible = streamfx::obs::tools::source_program_transform(parent, _program.transform);
+	} else {
+		_program.visible = false;
+	}
+	if (!_program.visible) {
+		streamfx::encoder::roi_channel::get()->retract(this);
+	}
+
 	_rt_is_fresh = false;
 }
 
@@ -608,6 +688,9 @@ void face_tracking_instance::video_render(gs_effect_t*)
 		}
 		gs_load_vertexbuffer(nullptr);
 	}
+
+	// Only a filter that is actually rendered has a face on the canvas.
+	publish_region_of_interest();
 }
 
 #ifdef ENABLE_PROFILING
@@ -60,7 +60,12 @@ namespace streamfx::filter::nvidia {
 			double_t   center[2];
 			double_t   size[2];
 			double_t   velocity[2];
+			double_t   face[4]; // Left, Top, Right, Bottom, empty if nothing is tracked.
 		} _values;
+		struct {
+			bool    visible;   // Shown in the program output?
+			matrix4 transform; // Filter output pixels to canvas pixels.
+		} _program;
 
 		// Nvidia CUDA interop
 		std::shared_ptr<::streamfx::nvidia::cuda::obs>    _cuda;
@@ -112,6 +117,8 @@ namespace streamfx::filter::nvidia {
 
 		void refresh_region_of_interest();
 
+		void publish_region_of_interest();
+
 		virtual void load(obs_data_t* data) override;
 
 		virtual void migrate(obs_data_t* data, uint64_t version) override;
@@ -21,6 +21,8 @@
 #include "strings.hpp"
 #include <stdexcept>
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
+#include "obs/obs-frame-graph.hpp"
 #include "util/util-logging.hpp"
 
 #ifdef _DEBUG
@@ -112,6 +114,18 @@
 
 using namespace streamfx::filter::sdf_effects;
 
+// Order of the parameters in the blocks of each consumer pass, the first three are shared by all passes.
+enum consumer_parameter : std::size_t {
+	CONSUMER_SDF_TEXTURE,
+	CONSUMER_SDF_THRESHOLD,
+	CONSUMER_IMAGE_TEXTURE,
+	CONSUMER_COLOR,
+	CONSUMER_VALUE_0,
+	CONSUMER_VALUE_1,
+	CONSUMER_VALUE_2,
+	CONSUMER_VALUE_3,
+};
+
 static constexpr std::string_view HELP_URL = "https://github.com/Xaymar/obs-StreamFX/wiki/Filter-SDF-Effects";
 
 sdf_effects_instance::sdf_effects_instance(obs_data_t* settings, obs_source_t* self)
@@ -122,23 +136,11 @@ sdf_effects_instance::sdf_effects_instance(obs_data_t* settings, obs_source_t* s
 	  _outer_shadow_offset_y(), _inner_glow(false), _inner_glow_color(), _inner_glow_width(), _inner_glow_sharpness(),
 	  _inner_glow_sharpness_inv(), _outer_glow(false), _outer_glow_color(), _outer_glow_width(),
 	  _outer_glow_sharpness(), _outer_glow_sharpness_inv(), _outline(false), _outline_color(), _outline_width(),
-	  _outline_offset(), _outline_sharpness(), _outline_sharpness_inv()
+	  _outline_offset(), _outline_sharpness(), _outline_sharpness_inv(), _outer_shadow_params(), _inner_shadow_params(),
+	  _outer_glow_params(), _inner_glow_params(), _outline_params()
 {
 	{
-		auto gctx        = streamfx::obs::gs::context();
-		vec4 transparent = {0, 0, 0, 0};
-
-		_source_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-		_sdf_write = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA32F, GS_ZS_NONE);
-		_sdf_read  = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA32F, GS_ZS_NONE);
-		_output_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-
-		std::shared_ptr<streamfx::obs::gs::rendertarget> initialize_rts[] = {_source_rt, _sdf_write, _sdf_read,
-																			 _output_rt};
-		for (auto rt : initialize_rts) {
-			auto op = rt->render(1, 1);
-			gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &transparent, 0, 0);
-		}
+		auto gctx = streamfx::obs::gs::context();
 
 		std::pair<const char*, streamfx::obs::gs::effect&> load_arr[] = {
 			{"effects/sdf/sdf-producer.effect", _sdf_producer_effect},
@@ -153,12 +155,36 @@ sdf_effects_instance::sdf_effects_instance(obs_data_t* settings, obs_source_t* s
 							ex.what());
 			}
 		}
+
+		if (_sdf_consumer_effect) {
+			for (auto params : {&_outer_shadow_params, &_inner_shadow_params}) {
+				*params = streamfx::obs::gs::effect_parameter_block(
+					_sdf_consumer_effect, {"pSDFTexture", "pSDFThreshold", "pImageTexture", "pShadowColor",
+										   "pShadowMin", "pShadowMax", "pShadowOffset"});
+			}
+			for (auto params : {&_outer_glow_params, &_inner_glow_params}) {
+				*params = streamfx::obs::gs::effect_parameter_block(
+					_sdf_consumer_effect, {"pSDFTexture", "pSDFThreshold", "pImageTexture", "pGlowColor", "pGlowWidth",
+										   "pGlowSharpness", "pGlowSharpnessInverse"});
+			}
+			_outline_params = streamfx::obs::gs::effect_parameter_block(
+				_sdf_consumer_effect, {"pSDFTexture", "pSDFThreshold", "pImageTexture", "pOutlineColor",
+									   "pOutlineWidth", "pOutlineOffset", "pOutlineSharpness",
+									   "pOutlineSharpnessInverse"});
+		}
 	}
 
 	update(settings);
+
+	streamfx::obs::frame_graph::get()->add(_self);
 }
 
-sdf_effects_instance::~sdf_effects_instance() {}
+sdf_effects_instance::~sdf_effects_instance()
+{
+	if (auto graph = streamfx::obs::frame_graph::get(); graph) {
+		graph->remove(_self);
+	}
+}
 
 void sdf_effects_instance::load(obs_data_t* settings)
 {
@@ -310,6 +336,17 @@ void sdf_effects_instance::video_tick(float_t)
 		_source_rendered = false;
 		_output_rendered = false;
 	}
+
+	// The frame is over, so the render targets go back to the pool until the next one is rendered. The distance field
+	// is needed by the next frame, but not while nobody can see the source.
+	_source_texture.reset();
+	_output_texture.reset();
+	_source_rt.reset();
+	_output_rt.reset();
+	if (!obs_source_showing(obs_filter_get_parent(_self))) {
+		_sdf_texture.reset();
+		_sdf_read.reset();
+	}
 }
 
 void sdf_effects_instance::video_render(gs_effect_t* effect)
@@ -356,23 +393,37 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 				streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Cache"};
 #endif
 
-				auto op = _source_rt->render(baseW, baseH);
-				gs_ortho(0, static_cast<float>(baseW), 0, static_cast<float>(baseH), -1, 1);
-				gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
-
-				if (obs_source_process_filter_begin(_self, GS_RGBA, OBS_ALLOW_DIRECT_RENDERING)) {
-					obs_source_process_filter_end(_self, final_effect, baseW, baseH);
-				} else {
-					throw std::runtime_error("failed to process source");
+				_source_rt = streamfx::obs::gs::rendertarget_pool::get()->acquire(baseW, baseH, GS_RGBA);
+
+				// Take the result of the filter below directly if possible, and only capture it ourselves otherwise.
+				_source_texture = streamfx::obs::frame_graph::get()->capture_input(_self, _source_rt, baseW, baseH);
+				if (!_source_texture) {
+					{
+						auto op = _source_rt->render(baseW, baseH);
+						gs_ortho(0, static_cast<float>(baseW), 0, static_cast<float>(baseH), -1, 1);
+						gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
+
+						if (obs_source_process_filter_begin(_self, GS_RGBA, OBS_ALLOW_DIRECT_RENDERING)) {
+							obs_source_process_filter_end(_self, final_effect, baseW, baseH);
+						} else {
+							throw std::runtime_error("failed to process source");
+						}
+					}
+					_source_rt->get_texture(_source_texture);
 				}
 			}
-			_source_rt->get_texture(_source_texture);
 			if (!_source_texture) {
 				throw std::runtime_error("failed to draw source");
 			}
 
 			// Generate SDF Buffers
 			{
+				// Start from an empty distance field if there is no previous one.
+				if (!_sdf_read) {
+					_sdf_read = streamfx::obs::gs::rendertarget_pool::get()->acquire(1, 1, GS_RGBA32F);
+					auto op   = _sdf_read->render(1, 1);
+					gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
+				}
 				_sdf_read->get_texture(_sdf_texture);
 				if (!_sdf_texture) {
 					throw std::runtime_error("SDF Backbuffer empty");
@@ -399,6 +450,10 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 														"Update Distance Field"};
 #endif
 
+					// The new distance field replaces the previous one, which then goes back to the pool.
+					_sdf_write = streamfx::obs::gs::rendertarget_pool::get()->acquire(uint32_t(sdfW), uint32_t(sdfH),
+																					   GS_RGBA32F);
+
 					auto op = _sdf_write->render(uint32_t(sdfW), uint32_t(sdfH));
 					gs_ortho(0, 1, 0, 1, -1, 1);
 					gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
@@ -413,6 +468,7 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 					}
 				}
 				std::swap(_sdf_read, _sdf_write);
+				_sdf_write.reset();
 				_sdf_read->get_texture(_sdf_texture);
 				if (!_sdf_texture) {
 					throw std::runtime_error("SDF Backbuffer empty");
@@ -457,6 +513,8 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Calculate"};
 #endif
 
+			_output_rt = streamfx::obs::gs::rendertarget_pool::get()->acquire(baseW, baseH, GS_RGBA);
+
 			auto op = _output_rt->render(baseW, baseH);
 			gs_ortho(0, 1, 0, 1, 0, 1);
 
@@ -472,68 +530,54 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 
 			gs_enable_blending(true);
 			gs_blend_function_separate(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA, GS_BLEND_ONE, GS_BLEND_ONE);
-			if (_outer_shadow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pShadowColor").set_float4(_outer_shadow_color);
-				_sdf_consumer_effect.get_parameter("pShadowMin").set_float(_outer_shadow_range_min);
-				_sdf_consumer_effect.get_parameter("pShadowMax").set_float(_outer_shadow_range_max);
-				_sdf_consumer_effect.get_parameter("pShadowOffset")
-					.set_float2(_outer_shadow_offset_x / float_t(baseW), _outer_shadow_offset_y / float_t(baseH));
-				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "ShadowOuter")) {
+
+			// All passes share an effect, each with their own block of parameters.
+			auto draw_pass = [this](streamfx::obs::gs::effect_parameter_block& params, const char* technique) {
+				params.set_texture(CONSUMER_SDF_TEXTURE, _sdf_texture);
+				params.set_float(CONSUMER_SDF_THRESHOLD, _sdf_threshold);
+				params.set_texture(CONSUMER_IMAGE_TEXTURE, _source_texture);
+				params.flush();
+				while (gs_effect_loop(_sdf_consumer_effect.get_object(), technique)) {
 					streamfx::gs_draw_fullscreen_tri();
 				}
+			};
+			if (_outer_shadow) {
+				_outer_shadow_params.set_float4(CONSUMER_COLOR, _outer_shadow_color);
+				_outer_shadow_params.set_float(CONSUMER_VALUE_0, _outer_shadow_range_min);
+				_outer_shadow_params.set_float(CONSUMER_VALUE_1, _outer_shadow_range_max);
+				_outer_shadow_params.set_float2(CONSUMER_VALUE_2, _outer_shadow_offset_x / float_t(baseW),
+												_outer_shadow_offset_y / float_t(baseH));
+				draw_pass(_outer_shadow_params, "ShadowOuter");
 			}
 			if (_inner_shadow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pShadowColor").set_float4(_inner_shadow_color);
-				_sdf_consumer_effect.get_parameter("pShadowMin").set_float(_inner_shadow_range_min);
-				_sdf_consumer_effect.get_parameter("pShadowMax").set_float(_inner_shadow_range_max);
-				_sdf_consumer_effect.get_parameter("pShadowOffset")
-					.set_float2(_inner_shadow_offset_x / float_t(baseW), _inner_shadow_offset_y / float_t(baseH));
-				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "ShadowInner")) {
-					streamfx::gs_draw_fullscreen_tri();
-				}
+				_inner_shadow_params.set_float4(CONSUMER_COLOR, _inner_shadow_color);
+				_inner_shadow_params.set_float(CONSUMER_VALUE_0, _inner_shadow_range_min);
+				_inner_shadow_params.set_float(CONSUMER_VALUE_1, _inner_shadow_range_max);
+				_inner_shadow_params.set_float2(CONSUMER_VALUE_2, _inner_shadow_offset_x / float_t(baseW),
+												_inner_shadow_offset_y / float_t(baseH));
+				draw_pass(_inner_shadow_params, "ShadowInner");
 			}
 			if (_outer_glow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pGlowColor").set_float4(_outer_glow_color);
-				_sdf_consumer_effect.get_parameter("pGlowWidth").set_float(_outer_glow_width);
-				_sdf_consumer_effect.get_parameter("pGlowSharpness").set_float(_outer_glow_sharpness);
-				_sdf_consumer_effect.get_parameter("pGlowSharpnessInverse").set_float(_outer_glow_sharpness_inv);
-				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "GlowOuter")) {
-					streamfx::gs_draw_fullscreen_tri();
-				}
+				_outer_glow_params.set_float4(CONSUMER_COLOR, _outer_glow_color);
+				_outer_glow_params.set_float(CONSUMER_VALUE_0, _outer_glow_width);
+				_outer_glow_params.set_float(CONSUMER_VALUE_1, _outer_glow_sharpness);
+				_outer_glow_params.set_float(CONSUMER_VALUE_2, _outer_glow_sharpness_inv);
+				draw_pass(_outer_glow_params, "GlowOuter");
 			}
 			if (_inner_glow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pGlowColor").set_float4(_inner_glow_color);
-				_sdf_consumer_effect.get_parameter("pGlowWidth").set_float(_inner_glow_width);
-				_sdf_consumer_effect.get_parameter("pGlowSharpness").set_float(_inner_glow_sharpness);
-				_sdf_consumer_effect.get_parameter("pGlowSharpnessInverse").set_float(_inner_glow_sharpness_inv);
-				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "GlowInner")) {
-					streamfx::gs_draw_fullscreen_tri();
-				}
+				_inner_glow_params.set_float4(CONSUMER_COLOR, _inner_glow_color);
+				_inner_glow_params.set_float(CONSUMER_VALUE_0, _inner_glow_width);
+				_inner_glow_params.set_float(CONSUMER_VALUE_1, _inner_glow_sharpness);
+				_inner_glow_params.set_float(CONSUMER_VALUE_2, _inner_glow_sharpness_inv);
+				draw_pass(_inner_glow_params, "GlowInner");
 			}
 			if (_outline) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pOutlineColor").set_float4(_outline_color);
-				_sdf_consumer_effect.get_parameter("pOutlineWidth").set_float(_outline_width);
-				_sdf_consumer_effect.get_parameter("pOutlineOffset").set_float(_outline_offset);
-				_sdf_consumer_effect.get_parameter("pOutlineSharpness").set_float(_outline_sharpness);
-				_sdf_consumer_effect.get_parameter("pOutlineSharpnessInverse").set_float(_outline_sharpness_inv);
-				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "Outline")) {
-					streamfx::gs_draw_fullscreen_tri();
-				}
+				_outline_params.set_float4(CONSUMER_COLOR, _outline_color);
+				_outline_params.set_float(CONSUMER_VALUE_0, _outline_width);
+				_outline_params.set_float(CONSUMER_VALUE_1, _outline_offset);
+				_outline_params.set_float(CONSUMER_VALUE_2, _outline_sharpness);
+				_outline_params.set_float(CONSUMER_VALUE_3, _outline_sharpness_inv);
+				draw_pass(_outline_params, "Outline");
 			}
 		} catch (...) {
 		}
@@ -554,6 +598,11 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_render, "Render"};
 #endif
 
+		// Hand the result over to the filter above instead, if it asked for it.
+		if (streamfx::obs::frame_graph::get()->publish(_self, _output_texture)) {
+			return;
+		}
+
 		gs_eparam_t* ep = gs_effect_get_param_by_name(final_effect, "image");
 		if (ep) {
 			gs_effect_set_texture(ep, _output_texture->get_object());
@@ -80,6 +80,12 @@ namespace streamfx::filter::sdf_effects {
 		float_t _outline_offset;
 		float_t _outline_sharpness;
 		float_t _outline_sharpness_inv;
+		/// Parameters of each pass of the consumer effect.
+		streamfx::obs::gs::effect_parameter_block _outer_shadow_params;
+		streamfx::obs::gs::effect_parameter_block _inner_shadow_params;
+		streamfx::obs::gs::effect_parameter_block _outer_glow_params;
+		streamfx::obs::gs::effect_parameter_block _inner_glow_params;
+		streamfx::obs::gs::effect_parameter_block _outline_params;
 
 		public:
 		sdf_effects_instance(obs_data_t* settings, obs_source_t* self);
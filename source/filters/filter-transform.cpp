@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <stdexcept>
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "util/util-logging.hpp"
 
 #ifdef _DEBUG
@@ -108,9 +109,8 @@ transform_instance::transform_instance(obs_data_t* data, obs_source_t* context)
 	: obs::source_instance(data, context), _cache_rendered(), _mipmap_enabled(), _source_rendered(), _source_size(),
 	  _update_mesh(), _rotation_order(), _camera_orthographic(), _camera_fov()
 {
-	_cache_rt      = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_source_rt     = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_vertex_buffer = std::make_shared<streamfx::obs::gs::vertex_buffer>(uint32_t(4u), uint8_t(1u));
+	_vertex_buffer = std::make_shared<streamfx::obs::gs::vertex_buffer>(
+		uint32_t(4u), uint8_t(1u), streamfx::obs::gs::vertex_buffer::attributes::Position);
 
 	_position = std::make_unique<streamfx::util::vec3a>();
 	_rotation = std::make_unique<streamfx::util::vec3a>();
@@ -258,29 +258,25 @@ void transform_instance::video_tick(float_t)
 
 		/// Generate mesh
 		{
-			auto vtx   = _vertex_buffer->at(0);
-			*vtx.color = 0xFFFFFFFF;
+			auto vtx = _vertex_buffer->at(0);
 			vec4_set(vtx.uv[0], 0, 0, 0, 0);
 			vec3_set(vtx.position, -p_x + _shear->x, -p_y - _shear->y, 0);
 			vec3_transform(vtx.position, vtx.position, &ident);
 		}
 		{
-			auto vtx   = _vertex_buffer->at(1);
-			*vtx.color = 0xFFFFFFFF;
+			auto vtx = _vertex_buffer->at(1);
 			vec4_set(vtx.uv[0], 1, 0, 0, 0);
 			vec3_set(vtx.position, p_x + _shear->x, -p_y + _shear->y, 0);
 			vec3_transform(vtx.position, vtx.position, &ident);
 		}
 		{
-			auto vtx   = _vertex_buffer->at(2);
-			*vtx.color = 0xFFFFFFFF;
+			auto vtx = _vertex_buffer->at(2);
 			vec4_set(vtx.uv[0], 0, 1, 0, 0);
 			vec3_set(vtx.position, -p_x - _shear->x, p_y - _shear->y, 0);
 			vec3_transform(vtx.position, vtx.position, &ident);
 		}
 		{
-			auto vtx   = _vertex_buffer->at(3);
-			*vtx.color = 0xFFFFFFFF;
+			auto vtx = _vertex_buffer->at(3);
 			vec4_set(vtx.uv[0], 1, 1, 0, 0);
 			vec3_set(vtx.position, p_x - _shear->x, p_y + _shear->y, 0);
 			vec3_transform(vtx.position, vtx.position, &ident);
@@ -293,6 +289,16 @@ void transform_instance::video_tick(float_t)
 	_cache_rendered  = false;
 	_mipmap_rendered = false;
 	_source_rendered = false;
+
+	// The frame is over, so the render targets go back to the pool until the next one is rendered. The mipmapped
+	// texture is kept for the next frame, but not while nobody can see the source.
+	_cache_texture.reset();
+	_source_texture.reset();
+	_cache_rt.reset();
+	_source_rt.reset();
+	if (!obs_source_showing(obs_filter_get_parent(_self))) {
+		_mipmap_texture.reset();
+	}
 }
 
 void transform_instance::video_render(gs_effect_t* effect)
@@ -342,6 +348,8 @@ void transform_instance::video_render(gs_effect_t* effect)
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Cache"};
 #endif
 
+		_cache_rt = streamfx::obs::gs::rendertarget_pool::get()->acquire(cache_width, cache_height, GS_RGBA);
+
 		auto op = _cache_rt->render(cache_width, cache_height);
 
 		gs_ortho(0, static_cast<float_t>(base_width), 0, static_cast<float_t>(base_height), -1, 1);
@@ -408,6 +416,10 @@ void transform_instance::video_render(gs_effect_t* effect)
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Transform"};
 #endif
 
+		if (!_source_rt) {
+			_source_rt = streamfx::obs::gs::rendertarget_pool::get()->acquire(base_width, base_height, GS_RGBA);
+		}
+
 		auto op = _source_rt->render(base_width, base_height);
 
 		gs_blend_state_push();
@@ -20,6 +20,7 @@
 #include <memory>
 #include <stdexcept>
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "plugin.hpp"
 
 #ifdef _MSC_VER
@@ -189,8 +190,7 @@ std::shared_ptr<::streamfx::gfx::blur::box_linear_data> streamfx::gfx::blur::box
 streamfx::gfx::blur::box_linear::box_linear()
 	: _data(::streamfx::gfx::blur::box_linear_factory::get().data()), _size(1.), _step_scale({1., 1.})
 {
-	_rendertarget  = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_rendertarget2 = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	_rendertarget = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
 
 streamfx::gfx::blur::box_linear::~box_linear() {}
@@ -253,6 +253,9 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_linear::r
 	float_t width  = float_t(_input_texture->get_width());
 	float_t height = float_t(_input_texture->get_height());
 
+	// The intermediate target is only needed while rendering, so lease it from the shared pool.
+	_rendertarget2 = ::streamfx::obs::gs::rendertarget_pool::get()->acquire(uint32_t(width), uint32_t(height), GS_RGBA);
+
 	gs_set_cull_mode(GS_NEITHER);
 	gs_enable_color(true, true, true, true);
 	gs_enable_depth_test(false);
@@ -305,6 +308,8 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_linear::r
 		}
 	}
 
+	_rendertarget2.reset();
+
 	gs_blend_state_pop();
 
 	return _rendertarget->get_texture();
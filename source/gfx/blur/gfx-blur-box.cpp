@@ -20,6 +20,7 @@
 #include <memory>
 #include <stdexcept>
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "plugin.hpp"
 
 #ifdef _MSC_VER
@@ -194,11 +195,12 @@ std::shared_ptr<::streamfx::gfx::blur::box_data> streamfx::gfx::blur::box_factor
 }
 
 streamfx::gfx::blur::box::box()
-	: _data(::streamfx::gfx::blur::box_factory::get().data()), _size(1.), _step_scale({1., 1.})
+	: _data(::streamfx::gfx::blur::box_factory::get().data()), _size(1.), _step_scale({1., 1.}),
+	  _param_image("pImage"), _param_image_texel("pImageTexel"), _param_step_scale("pStepScale"), _param_size("pSize"),
+	  _param_size_inverse_mul("pSizeInverseMul"), _param_angle("pAngle"), _param_center("pCenter")
 {
-	auto gctx      = streamfx::obs::gs::context();
-	_rendertarget  = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_rendertarget2 = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	auto gctx     = streamfx::obs::gs::context();
+	_rendertarget = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
 
 streamfx::gfx::blur::box::~box() {}
@@ -261,6 +263,9 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box::render()
 	float_t width  = float_t(_input_texture->get_width());
 	float_t height = float_t(_input_texture->get_height());
 
+	// The intermediate target is only needed while rendering, so lease it from the shared pool.
+	_rendertarget2 = ::streamfx::obs::gs::rendertarget_pool::get()->acquire(uint32_t(width), uint32_t(height), GS_RGBA);
+
 	gs_set_cull_mode(GS_NEITHER);
 	gs_enable_color(true, true, true, true);
 	gs_enable_depth_test(false);
@@ -278,11 +283,11 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box::render()
 	streamfx::obs::gs::effect effect = _data->get_effect();
 	if (effect) {
 		// Pass 1
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), 0.f);
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		_param_image(effect).set_texture(_input_texture);
+		_param_image_texel(effect).set_float2(float_t(1.f / width), 0.f);
+		_param_step_scale(effect).set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		_param_size(effect).set_float(float_t(_size));
+		_param_size_inverse_mul(effect).set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
 
 		{
 #ifdef ENABLE_PROFILING
@@ -297,8 +302,8 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box::render()
 		}
 
 		// Pass 2
-		effect.get_parameter("pImage").set_texture(_rendertarget2->get_texture());
-		effect.get_parameter("pImageTexel").set_float2(0.f, float_t(1.f / height));
+		_param_image(effect).set_texture(_rendertarget2->get_texture());
+		_param_image_texel(effect).set_float2(0.f, float_t(1.f / height));
 
 		{
 #ifdef ENABLE_PROFILING
@@ -313,6 +318,8 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box::render()
 		}
 	}
 
+	_rendertarget2.reset();
+
 	gs_blend_state_pop();
 
 	return _rendertarget->get_texture();
@@ -367,12 +374,11 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_direction
 	// One Pass Blur
 	streamfx::obs::gs::effect effect = _data->get_effect();
 	if (effect) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel")
-			.set_float2(float_t(1. / width * cos(_angle)), float_t(1.f / height * sin(_angle)));
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		_param_image(effect).set_texture(_input_texture);
+		_param_image_texel(effect).set_float2(float_t(1. / width * cos(_angle)), float_t(1.f / height * sin(_angle)));
+		_param_step_scale(effect).set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		_param_size(effect).set_float(float_t(_size));
+		_param_size_inverse_mul(effect).set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
 
 		{
 			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
@@ -442,13 +448,13 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_rotationa
 	// One Pass Blur
 	streamfx::obs::gs::effect effect = _data->get_effect();
 	if (effect) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), float_t(1.f / height));
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
-		effect.get_parameter("pAngle").set_float(float_t(_angle / _size));
-		effect.get_parameter("pCenter").set_float2(float_t(_center.first), float_t(_center.second));
+		_param_image(effect).set_texture(_input_texture);
+		_param_image_texel(effect).set_float2(float_t(1.f / width), float_t(1.f / height));
+		_param_step_scale(effect).set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		_param_size(effect).set_float(float_t(_size));
+		_param_size_inverse_mul(effect).set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		_param_angle(effect).set_float(float_t(_angle / _size));
+		_param_center(effect).set_float2(float_t(_center.first), float_t(_center.second));
 
 		{
 			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
@@ -508,12 +514,12 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_zoom::ren
 	// One Pass Blur
 	streamfx::obs::gs::effect effect = _data->get_effect();
 	if (effect) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), float_t(1.f / height));
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
-		effect.get_parameter("pCenter").set_float2(float_t(_center.first), float_t(_center.second));
+		_param_image(effect).set_texture(_input_texture);
+		_param_image_texel(effect).set_float2(float_t(1.f / width), float_t(1.f / height));
+		_param_step_scale(effect).set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		_param_size(effect).set_float(float_t(_size));
+		_param_size_inverse_mul(effect).set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		_param_center(effect).set_float2(float_t(_center.first), float_t(_center.second));
 
 		{
 			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
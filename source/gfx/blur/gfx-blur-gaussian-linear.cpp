@@ -18,6 +18,7 @@
 #include "gfx-blur-gaussian-linear.hpp"
 #include <stdexcept>
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -234,8 +235,7 @@ streamfx::gfx::blur::gaussian_linear::gaussian_linear()
 {
 	auto gctx = streamfx::obs::gs::context();
 
-	_rendertarget  = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_rendertarget2 = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	_rendertarget = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
 
 streamfx::gfx::blur::gaussian_linear::~gaussian_linear() {}
@@ -304,6 +304,16 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 	float_t width  = float_t(_input_texture->get_width());
 	float_t height = float_t(_input_texture->get_height());
 
+	bool horizontal = _step_scale.first > std::numeric_limits<double_t>::epsilon();
+	bool vertical   = _step_scale.second > std::numeric_limits<double_t>::epsilon();
+
+	// The last pass always ends up in our own target, as the result has to outlive this frame. Only a pass before it
+	// needs an intermediate target, which is leased from the shared pool until the end of this function.
+	if (horizontal && vertical) {
+		_rendertarget2 =
+			streamfx::obs::gs::rendertarget_pool::get()->acquire(uint32_t(width), uint32_t(height), GS_RGBA);
+	}
+
 	// Setup
 	gs_set_cull_mode(GS_NEITHER);
 	gs_enable_color(true, true, true, true);
@@ -324,7 +334,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 	effect.get_parameter("pKernel").set_value(kernel.data(), ST_MAX_KERNEL_SIZE);
 
 	// First Pass
-	if (_step_scale.first > std::numeric_limits<double_t>::epsilon()) {
+	if (horizontal) {
 		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), 0.f);
 
 		{
@@ -332,19 +342,19 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Horizontal");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = (vertical ? _rendertarget2 : _rendertarget)->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				streamfx::gs_draw_fullscreen_tri();
 			}
 		}
-
-		std::swap(_rendertarget, _rendertarget2);
-		effect.get_parameter("pImage").set_texture(_rendertarget->get_texture());
 	}
 
 	// Second Pass
-	if (_step_scale.second > std::numeric_limits<double_t>::epsilon()) {
+	if (vertical) {
+		if (horizontal) {
+			effect.get_parameter("pImage").set_texture(_rendertarget2->get_texture());
+		}
 		effect.get_parameter("pImageTexel").set_float2(0.f, float_t(1.f / height));
 
 		{
@@ -352,16 +362,16 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Vertical");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				streamfx::gs_draw_fullscreen_tri();
 			}
 		}
-
-		std::swap(_rendertarget, _rendertarget2);
 	}
 
+	_rendertarget2.reset();
+
 	gs_blend_state_pop();
 
 	return this->get();
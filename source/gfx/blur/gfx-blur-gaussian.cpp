@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <stdexcept>
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "plugin.hpp"
 
 #ifdef _MSC_VER
@@ -259,11 +260,12 @@ std::shared_ptr<::streamfx::gfx::blur::gaussian_data> streamfx::gfx::blur::gauss
 }
 
 streamfx::gfx::blur::gaussian::gaussian()
-	: _data(::streamfx::gfx::blur::gaussian_factory::get().data()), _size(1.), _step_scale({1., 1.})
+	: _data(::streamfx::gfx::blur::gaussian_factory::get().data()), _size(1.), _step_scale({1., 1.}),
+	  _param_image("pImage"), _param_image_texel("pImageTexel"), _param_step_scale("pStepScale"), _param_size("pSize"),
+	  _param_angle("pAngle"), _param_center("pCenter"), _param_kernel("pKernel")
 {
-	auto gctx      = streamfx::obs::gs::context();
-	_rendertarget  = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_rendertarget2 = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	auto gctx     = streamfx::obs::gs::context();
+	_rendertarget = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
 
 streamfx::gfx::blur::gaussian::~gaussian() {}
@@ -332,6 +334,16 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian::ren
 	float_t width  = float_t(_input_texture->get_width());
 	float_t height = float_t(_input_texture->get_height());
 
+	bool horizontal = _step_scale.first > std::numeric_limits<double_t>::epsilon();
+	bool vertical   = _step_scale.second > std::numeric_limits<double_t>::epsilon();
+
+	// The last pass always ends up in our own target, as the result has to outlive this frame. Only a pass before it
+	// needs an intermediate target, which is leased from the shared pool until the end of this function.
+	if (horizontal && vertical) {
+		_rendertarget2 =
+			streamfx::obs::gs::rendertarget_pool::get()->acquire(uint32_t(width), uint32_t(height), GS_RGBA);
+	}
+
 	// Setup
 	gs_set_cull_mode(GS_NEITHER);
 	gs_enable_color(true, true, true, true);
@@ -346,50 +358,48 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian::ren
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	_param_step_scale(effect).set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	_param_size(effect).set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
+	_param_kernel(effect).set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	// First Pass
-	if (_step_scale.first > std::numeric_limits<double_t>::epsilon()) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), 0.f);
+	if (horizontal) {
+		_param_image(effect).set_texture(_input_texture);
+		_param_image_texel(effect).set_float2(float_t(1.f / width), 0.f);
 
 		{
 #ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Horizontal");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = (vertical ? _rendertarget2 : _rendertarget)->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				streamfx::gs_draw_fullscreen_tri();
 			}
 		}
-
-		std::swap(_rendertarget, _rendertarget2);
 	}
 
 	// Second Pass
-	if (_step_scale.second > std::numeric_limits<double_t>::epsilon()) {
-		effect.get_parameter("pImage").set_texture(_rendertarget->get_texture());
-		effect.get_parameter("pImageTexel").set_float2(0.f, float_t(1.f / height));
+	if (vertical) {
+		_param_image(effect).set_texture(horizontal ? _rendertarget2->get_texture() : _input_texture);
+		_param_image_texel(effect).set_float2(0.f, float_t(1.f / height));
 
 		{
 #ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Vertical");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				streamfx::gs_draw_fullscreen_tri();
 			}
 		}
-
-		std::swap(_rendertarget, _rendertarget2);
 	}
 
+	_rendertarget2.reset();
+
 	gs_blend_state_pop();
 
 	return this->get();
@@ -452,12 +462,12 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_dire
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel")
+	_param_image(effect).set_texture(_input_texture);
+	_param_image_texel(effect)
 		.set_float2(float_t(1.f / width * cos(m_angle)), float_t(1.f / height * sin(m_angle)));
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	_param_step_scale(effect).set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	_param_size(effect).set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
+	_param_kernel(effect).set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	{
 		auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
@@ -510,13 +520,13 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_rota
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), float_t(1.f / height));
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
-	effect.get_parameter("pAngle").set_float(float_t(m_angle / _size));
-	effect.get_parameter("pCenter").set_float2(float_t(m_center.first), float_t(m_center.second));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	_param_image(effect).set_texture(_input_texture);
+	_param_image_texel(effect).set_float2(float_t(1.f / width), float_t(1.f / height));
+	_param_step_scale(effect).set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	_param_size(effect).set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
+	_param_angle(effect).set_float(float_t(m_angle / _size));
+	_param_center(effect).set_float2(float_t(m_center.first), float_t(m_center.second));
+	_param_kernel(effect).set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	// First Pass
 	{
@@ -591,12 +601,12 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_zoom
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), float_t(1.f / height));
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size));
-	effect.get_parameter("pCenter").set_float2(float_t(m_center.first), float_t(m_center.second));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	_param_image(effect).set_texture(_input_texture);
+	_param_image_texel(effect).set_float2(float_t(1.f / width), float_t(1.f / height));
+	_param_step_scale(effect).set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	_param_size(effect).set_float(float_t(_size));
+	_param_center(effect).set_float2(float_t(m_center.first), float_t(m_center.second));
+	_param_kernel(effect).set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	// First Pass
 	{
@@ -92,6 +92,15 @@ namespace streamfx::gfx {
 			std::shared_ptr<::streamfx::obs::gs::texture>      _input_texture;
 			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget;
 
+			// Parameters, resolved once per effect.
+			::streamfx::obs::gs::effect_parameter_ref          _param_image;
+			::streamfx::obs::gs::effect_parameter_ref          _param_image_texel;
+			::streamfx::obs::gs::effect_parameter_ref          _param_step_scale;
+			::streamfx::obs::gs::effect_parameter_ref          _param_size;
+			::streamfx::obs::gs::effect_parameter_ref          _param_angle;
+			::streamfx::obs::gs::effect_parameter_ref          _param_center;
+			::streamfx::obs::gs::effect_parameter_ref          _param_kernel;
+
 			private:
 			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget2;
 
@@ -22,45 +22,56 @@
 
 #include "obs/gs/gs-helper.hpp"
 
+// Order of the parameters in the block of the consumer effect.
+enum lut_consumer_parameter : std::size_t {
+	LUT_CONSUMER_PARAMS_0,
+	LUT_CONSUMER_PARAMS_1,
+	LUT_CONSUMER_LUT,
+	LUT_CONSUMER_IMAGE,
+};
+
 streamfx::gfx::lut::consumer::consumer()
 {
 	_data = streamfx::gfx::lut::data::instance();
 	if (!_data->consumer_effect())
 		throw std::runtime_error("Unable to get LUT consumer effect.");
+
+	// The effect is shared by all consumers, which is fine as blocks check what the effect holds.
+	_params = streamfx::obs::gs::effect_parameter_block(*_data->consumer_effect(),
+														{"lut_params_0", "lut_params_1", "lut", "image"});
 }
 
 streamfx::gfx::lut::consumer::~consumer() {}
 
-std::shared_ptr<streamfx::obs::gs::effect>
-	streamfx::gfx::lut::consumer::prepare(streamfx::gfx::lut::color_depth             depth,
+void streamfx::gfx::lut::consumer::update(streamfx::gfx::lut::color_depth             depth,
 										  std::shared_ptr<streamfx::obs::gs::texture> lut)
 {
-	auto gctx = streamfx::obs::gs::context();
-
-	auto effect = _data->consumer_effect();
-
 	int32_t idepth         = static_cast<int32_t>(depth);
 	int32_t size           = static_cast<int32_t>(pow(2l, idepth));
 	int32_t grid_size      = static_cast<int32_t>(pow(2l, (idepth / 2)));
 	int32_t container_size = static_cast<int32_t>(pow(2l, (idepth + (idepth / 2))));
 
-	if (streamfx::obs::gs::effect_parameter efp = effect->get_parameter("lut_params_0"); efp) {
-		efp.set_int4(size, grid_size, container_size, 0l);
-	}
+	_params.set_int4(LUT_CONSUMER_PARAMS_0, size, grid_size, container_size, 0l);
 
-	if (streamfx::obs::gs::effect_parameter efp = effect->get_parameter("lut_params_1"); efp) {
-		float inverse_size           = 1.f / static_cast<float>(size);
-		float inverse_z_size         = 1.f / static_cast<float>(grid_size);
-		float inverse_container_size = 1.f / static_cast<float>(container_size);
-		float half_texel             = inverse_container_size / 2.f;
-		efp.set_float4(inverse_size, inverse_z_size, inverse_container_size, half_texel);
-	}
+	float inverse_size           = 1.f / static_cast<float>(size);
+	float inverse_z_size         = 1.f / static_cast<float>(grid_size);
+	float inverse_container_size = 1.f / static_cast<float>(container_size);
+	float half_texel             = inverse_container_size / 2.f;
+	_params.set_float4(LUT_CONSUMER_PARAMS_1, inverse_size, inverse_z_size, inverse_container_size, half_texel);
 
-	if (streamfx::obs::gs::effect_parameter efp = effect->get_parameter("lut"); efp) {
-		efp.set_texture(lut);
-	}
+	_params.set_texture(LUT_CONSUMER_LUT, lut);
+}
+
+std::shared_ptr<streamfx::obs::gs::effect>
+	streamfx::gfx::lut::consumer::prepare(streamfx::gfx::lut::color_depth             depth,
+										  std::shared_ptr<streamfx::obs::gs::texture> lut)
+{
+	auto gctx = streamfx::obs::gs::context();
+
+	update(depth, lut);
+	_params.flush();
 
-	return effect;
+	return _data->consumer_effect();
 }
 
 void streamfx::gfx::lut::consumer::consume(streamfx::gfx::lut::color_depth             depth,
@@ -69,14 +80,12 @@ void streamfx::gfx::lut::consumer::consume(streamfx::gfx::lut::color_depth
 {
 	auto gctx = streamfx::obs::gs::context();
 
-	auto effect = prepare(depth, lut);
-
-	if (streamfx::obs::gs::effect_parameter efp = effect->get_parameter("image"); efp) {
-		efp.set_texture(texture->get_object());
-	}
+	update(depth, lut);
+	_params.set_texture(LUT_CONSUMER_IMAGE, texture);
+	_params.flush();
 
 	// Draw a simple quad.
-	while (gs_effect_loop(effect->get_object(), "Draw")) {
+	while (gs_effect_loop(_data->consumer_effect()->get_object(), "Draw")) {
 		gs_draw_sprite(nullptr, 0, 1, 1);
 	}
 }
@@ -28,6 +28,9 @@
 namespace streamfx::gfx::lut {
 	class consumer {
 		std::shared_ptr<streamfx::gfx::lut::data> _data;
+		streamfx::obs::gs::effect_parameter_block _params;
+
+		void update(streamfx::gfx::lut::color_depth depth, std::shared_ptr<streamfx::obs::gs::texture> lut);
 
 		public:
 		consumer();
@@ -45,6 +45,8 @@ streamfx::gfx::lut::producer::producer()
 	_data = streamfx::gfx::lut::data::instance();
 	if (!_data->producer_effect())
 		throw std::runtime_error("Unable to get LUT producer effect.");
+
+	_params = streamfx::obs::gs::effect_parameter_block(*_data->producer_effect(), {"lut_params_0"});
 }
 
 streamfx::gfx::lut::producer::~producer() {}
@@ -74,9 +76,8 @@ std::shared_ptr<streamfx::obs::gs::texture> streamfx::gfx::lut::producer::produc
 		gs_enable_stencil_write(false);
 		gs_ortho(0, 1, 0, 1, 0, 1);
 
-		if (streamfx::obs::gs::effect_parameter efp = effect->get_parameter("lut_params_0"); efp) {
-			efp.set_int4(size, grid_size, container_size, 0l);
-		}
+		_params.set_int4(0, size, grid_size, container_size, 0l);
+		_params.flush();
 
 		while (gs_effect_loop(effect->get_object(), "Draw")) {
 			streamfx::gs_draw_fullscreen_tri();
@@ -29,6 +29,7 @@ namespace streamfx::gfx::lut {
 	class producer {
 		std::shared_ptr<streamfx::gfx::lut::data>        _data;
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _rt;
+		streamfx::obs::gs::effect_parameter_block        _params;
 
 		public:
 		producer();
@@ -47,6 +47,19 @@ streamfx::gfx::shader::shader::shader(obs_source_t* self, shader_mode mode)
 
 	  _shader(), _shader_file(), _shader_tech("Draw"), _shader_file_mt(), _shader_file_sz(), _shader_file_tick(0),
 
+	  _param_time("Time", streamfx::obs::gs::effect_parameter::type::Float4),
+	  _param_view_size("ViewSize", streamfx::obs::gs::effect_parameter::type::Float4),
+	  _param_random("Random", streamfx::obs::gs::effect_parameter::type::Matrix),
+	  _param_random_seed("RandomSeed", streamfx::obs::gs::effect_parameter::type::Integer),
+	  _param_transition_time("TransitionTime", streamfx::obs::gs::effect_parameter::type::Float),
+	  _param_transition_size("TransitionSize", streamfx::obs::gs::effect_parameter::type::Integer2),
+	  _param_input_a{{"InputA", streamfx::obs::gs::effect_parameter::type::Texture},
+					 {"image", streamfx::obs::gs::effect_parameter::type::Texture},
+					 {"tex_a", streamfx::obs::gs::effect_parameter::type::Texture}},
+	  _param_input_b{{"InputB", streamfx::obs::gs::effect_parameter::type::Texture},
+					 {"image2", streamfx::obs::gs::effect_parameter::type::Texture},
+					 {"tex_b", streamfx::obs::gs::effect_parameter::type::Texture}},
+
 	  _width_type(size_type::Percent), _width_value(1.0), _height_type(size_type::Percent), _height_value(1.0),
 
 	  _have_current_params(false), _time(0), _time_loop(0), _loops(0), _random(), _random_seed(0),
@@ -479,34 +492,25 @@ void streamfx::gfx::shader::shader::prepare_render()
 	}
 
 	// float4 Time: (Time in Seconds), (Time in Current Second), (Time in Seconds only), (Random Value)
-	if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter("Time"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Float4) {
-			el.set_float4(
-				_time, _time_loop, static_cast<float_t>(_loops),
-				static_cast<float_t>(static_cast<double_t>(_random()) / static_cast<double_t>(_random.max())));
-		}
+	if (auto& el = _param_time(_shader); el != nullptr) {
+		el.set_float4(_time, _time_loop, static_cast<float_t>(_loops),
+					  static_cast<float_t>(static_cast<double_t>(_random()) / static_cast<double_t>(_random.max())));
 	}
 
 	// float4 ViewSize: (Width), (Height), (1.0 / Width), (1.0 / Height)
-	if (auto el = _shader.get_parameter("ViewSize"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Float4) {
-			el.set_float4(static_cast<float_t>(width()), static_cast<float_t>(height()),
-						  1.0f / static_cast<float_t>(width()), 1.0f / static_cast<float_t>(height()));
-		}
+	if (auto& el = _param_view_size(_shader); el != nullptr) {
+		el.set_float4(static_cast<float_t>(width()), static_cast<float_t>(height()),
+					  1.0f / static_cast<float_t>(width()), 1.0f / static_cast<float_t>(height()));
 	}
 
 	// float4x4 Random: float4[Per-Instance Random], float4[Per-Activation Random], float4x2[Per-Frame Random]
-	if (auto el = _shader.get_parameter("Random"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Matrix) {
-			el.set_value(_random_values, 16);
-		}
+	if (auto& el = _param_random(_shader); el != nullptr) {
+		el.set_value(_random_values, 16);
 	}
 
 	// int32 RandomSeed: Seed used for random generation
-	if (auto el = _shader.get_parameter("RandomSeed"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Integer) {
-			el.set_int(_random_seed);
-		}
+	if (auto& el = _param_random_seed(_shader); el != nullptr) {
+		el.set_int(_random_seed);
 	}
 
 	return;
@@ -558,17 +562,10 @@ void streamfx::gfx::shader::shader::set_input_a(std::shared_ptr<streamfx::obs::g
 	if (!_shader)
 		return;
 
-	std::string_view params[] = {
-		"InputA",
-		"image",
-		"tex_a",
-	};
-	for (auto& name : params) {
-		if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter(name.data()); el != nullptr) {
-			if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Texture) {
-				el.set_texture(tex);
-				break;
-			}
+	for (auto& param : _param_input_a) {
+		if (auto& el = param(_shader); el != nullptr) {
+			el.set_texture(tex);
+			break;
 		}
 	}
 }
@@ -578,17 +575,10 @@ void streamfx::gfx::shader::shader::set_input_b(std::shared_ptr<streamfx::obs::g
 	if (!_shader)
 		return;
 
-	std::string_view params[] = {
-		"InputB",
-		"image2",
-		"tex_b",
-	};
-	for (auto& name : params) {
-		if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter(name.data()); el != nullptr) {
-			if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Texture) {
-				el.set_texture(tex);
-				break;
-			}
+	for (auto& param : _param_input_b) {
+		if (auto& el = param(_shader); el != nullptr) {
+			el.set_texture(tex);
+			break;
 		}
 	}
 }
@@ -598,10 +588,8 @@ void streamfx::gfx::shader::shader::set_transition_time(float_t t)
 	if (!_shader)
 		return;
 
-	if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter("TransitionTime"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Float) {
-			el.set_float(t);
-		}
+	if (auto& el = _param_transition_time(_shader); el != nullptr) {
+		el.set_float(t);
 	}
 }
 
@@ -609,10 +597,8 @@ void streamfx::gfx::shader::shader::set_transition_size(uint32_t w, uint32_t h)
 {
 	if (!_shader)
 		return;
-	if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter("TransitionSize"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Integer2) {
-			el.set_int2(static_cast<int32_t>(w), static_cast<int32_t>(h));
-		}
+	if (auto& el = _param_transition_size(_shader); el != nullptr) {
+		el.set_int2(static_cast<int32_t>(w), static_cast<int32_t>(h));
 	}
 }
 
@@ -58,6 +58,16 @@ namespace streamfx::gfx {
 			float_t                         _shader_file_tick;
 			shader_param_map_t              _shader_params;
 
+			// Built-in Parameters
+			streamfx::obs::gs::effect_parameter_ref _param_time;
+			streamfx::obs::gs::effect_parameter_ref _param_view_size;
+			streamfx::obs::gs::effect_parameter_ref _param_random;
+			streamfx::obs::gs::effect_parameter_ref _param_random_seed;
+			streamfx::obs::gs::effect_parameter_ref _param_transition_time;
+			streamfx::obs::gs::effect_parameter_ref _param_transition_size;
+			streamfx::obs::gs::effect_parameter_ref _param_input_a[3];
+			streamfx::obs::gs::effect_parameter_ref _param_input_b[3];
+
 			// Options
 			size_type _width_type;
 			double_t  _width_value;
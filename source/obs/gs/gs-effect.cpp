@@ -18,8 +18,11 @@
  */
 
 #include "gs-effect.hpp"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
+#include <typeinfo>
 #include <vector>
 #include "obs/gs/gs-helper.hpp"
 
@@ -56,6 +59,16 @@ streamfx::obs::gs::effect::effect(const std::string& code, const std::string& na
 	}
 
 	reset(effect, [](gs_effect_t* ptr) { gs_effect_destroy(ptr); });
+
+	// Parameter names live as long as the effect, so the index can point at them directly.
+	_parameters = std::make_shared<std::vector<std::pair<std::string_view, gs_eparam_t*>>>();
+	_parameters->reserve(effect->params.num);
+	for (std::size_t idx = 0; idx < effect->params.num; idx++) {
+		auto ptr = effect->params.array + idx;
+		_parameters->emplace_back(ptr->name, ptr);
+	}
+	std::sort(_parameters->begin(), _parameters->end(),
+			  [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
 }
 
 streamfx::obs::gs::effect::effect(std::filesystem::path file) : effect(load_file_as_code(file), file.u8string()) {}
@@ -113,11 +126,20 @@ streamfx::obs::gs::effect_parameter streamfx::obs::gs::effect::get_parameter(std
 	return streamfx::obs::gs::effect_parameter(get()->params.array + idx, *this);
 }
 
-streamfx::obs::gs::effect_parameter streamfx::obs::gs::effect::get_parameter(const std::string& name)
+streamfx::obs::gs::effect_parameter streamfx::obs::gs::effect::get_parameter(std::string_view name)
 {
+	if (_parameters) {
+		auto iter = std::lower_bound(_parameters->begin(), _parameters->end(), name,
+									 [](const auto& lhs, std::string_view rhs) { return lhs.first < rhs; });
+		if ((iter != _parameters->end()) && (iter->first == name)) {
+			return streamfx::obs::gs::effect_parameter(iter->second, *this);
+		}
+		return nullptr;
+	}
+
 	for (std::size_t idx = 0; idx < count_parameters(); idx++) {
 		auto ptr = get()->params.array + idx;
-		if (strcmp(ptr->name, name.c_str()) == 0) {
+		if (name == ptr->name) {
 			return streamfx::obs::gs::effect_parameter(ptr, *this);
 		}
 	}
@@ -125,17 +147,212 @@ streamfx::obs::gs::effect_parameter streamfx::obs::gs::effect::get_parameter(con
 	return nullptr;
 }
 
-bool streamfx::obs::gs::effect::has_parameter(const std::string& name)
+bool streamfx::obs::gs::effect::has_parameter(std::string_view name)
 {
 	if (get_parameter(name))
 		return true;
 	return false;
 }
 
-bool streamfx::obs::gs::effect::has_parameter(const std::string& name, effect_parameter::type type)
+bool streamfx::obs::gs::effect::has_parameter(std::string_view name, effect_parameter::type type)
 {
 	auto eprm = get_parameter(name);
 	if (eprm)
 		return eprm.get_type() == type;
 	return false;
 }
+
+streamfx::obs::gs::effect_parameter_ref::effect_parameter_ref(std::string_view name, effect_parameter::type type)
+	: _name(name), _type(type), _effect(nullptr), _effect_weak(), _parameter()
+{}
+
+streamfx::obs::gs::effect_parameter_ref::~effect_parameter_ref() {}
+
+streamfx::obs::gs::effect_parameter& streamfx::obs::gs::effect_parameter_ref::operator()(effect& effect)
+{
+	// The address alone could belong to a new effect once the old one is gone, so also check that it still exists.
+	if ((_effect != effect.get()) || _effect_weak.expired()) {
+		_effect      = effect.get();
+		_effect_weak = effect;
+		_parameter   = _effect ? effect.get_parameter(_name) : effect_parameter();
+		if (_parameter && (_type != effect_parameter::type::Invalid) && (_parameter.get_type() != _type)) {
+			_parameter = effect_parameter();
+		}
+	}
+	return _parameter;
+}
+
+streamfx::obs::gs::effect_parameter_block::effect_parameter_block() : _fields() {}
+
+streamfx::obs::gs::effect_parameter_block::effect_parameter_block(effect&                                 effect,
+																  std::initializer_list<std::string_view> names)
+	: _fields()
+{
+	_fields.resize(names.size());
+	auto iter = names.begin();
+	for (auto& field : _fields) {
+		field.parameter       = effect.get_parameter(*(iter++));
+		field.type            = field.parameter ? field.parameter.get_type() : effect_parameter::type::Invalid;
+		field.size            = 0;
+		field.texture         = nullptr;
+		field.flushed_size    = 0;
+		field.flushed_texture = nullptr;
+	}
+}
+
+streamfx::obs::gs::effect_parameter_block::~effect_parameter_block() {}
+
+std::size_t streamfx::obs::gs::effect_parameter_block::size()
+{
+	return _fields.size();
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_bool(std::size_t idx, bool v)
+{
+	// libobs stores booleans as integers.
+	int32_t value = v ? 1 : 0;
+	record(idx, effect_parameter::type::Boolean, &value, sizeof(value));
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_float(std::size_t idx, float_t x)
+{
+	record(idx, effect_parameter::type::Float, &x, sizeof(x));
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_float2(std::size_t idx, float_t x, float_t y)
+{
+	float_t value[] = {x, y};
+	record(idx, effect_parameter::type::Float2, value, sizeof(value));
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_float3(std::size_t idx, float_t x, float_t y, float_t z)
+{
+	float_t value[] = {x, y, z};
+	record(idx, effect_parameter::type::Float3, value, sizeof(value));
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_float4(std::size_t idx, float_t x, float_t y, float_t z, float_t w)
+{
+	float_t value[] = {x, y, z, w};
+	record(idx, effect_parameter::type::Float4, value, sizeof(value));
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_float4(std::size_t idx, vec4 const& v)
+{
+	set_float4(idx, v.x, v.y, v.z, v.w);
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_int(std::size_t idx, int32_t x)
+{
+	record(idx, effect_parameter::type::Integer, &x, sizeof(x));
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_int2(std::size_t idx, int32_t x, int32_t y)
+{
+	int32_t value[] = {x, y};
+	record(idx, effect_parameter::type::Integer2, value, sizeof(value));
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_int3(std::size_t idx, int32_t x, int32_t y, int32_t z)
+{
+	int32_t value[] = {x, y, z};
+	record(idx, effect_parameter::type::Integer3, value, sizeof(value));
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_int4(std::size_t idx, int32_t x, int32_t y, int32_t z, int32_t w)
+{
+	int32_t value[] = {x, y, z, w};
+	record(idx, effect_parameter::type::Integer4, value, sizeof(value));
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_matrix(std::size_t idx, matrix4 const& v)
+{
+	record(idx, effect_parameter::type::Matrix, &v, sizeof(v));
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_texture(std::size_t                                 idx,
+															std::shared_ptr<streamfx::obs::gs::texture> v)
+{
+	set_texture(idx, v ? v->get_object() : nullptr);
+}
+
+void streamfx::obs::gs::effect_parameter_block::set_texture(std::size_t idx, gs_texture_t* v)
+{
+	auto& field = _fields.at(idx);
+	if (!field.parameter) {
+		return;
+	}
+	if (field.type != effect_parameter::type::Texture) {
+		throw std::bad_cast();
+	}
+	field.texture = v;
+	field.size    = sizeof(gs_texture_t*);
+}
+
+std::size_t streamfx::obs::gs::effect_parameter_block::flush()
+{
+	std::size_t written = 0;
+	for (auto& field : _fields) {
+		if (!field.parameter || (field.size == 0)) {
+			continue;
+		}
+
+		bool is_texture = (field.type == effect_parameter::type::Texture);
+		bool changed    = (field.flushed_size != field.size);
+		if (is_texture) {
+			changed |= (field.flushed_texture != field.texture);
+		} else {
+			changed |= (memcmp(field.flushed_value, field.value, field.size) != 0);
+		}
+		if (!changed && holds_flushed(field)) {
+			continue;
+		}
+
+		if (is_texture) {
+			gs_effect_set_texture(field.parameter.get(), field.texture);
+			field.flushed_texture = field.texture;
+		} else {
+			gs_effect_set_val(field.parameter.get(), field.value, field.size);
+			memcpy(field.flushed_value, field.value, field.size);
+		}
+		field.flushed_size = field.size;
+		written++;
+	}
+	return written;
+}
+
+bool streamfx::obs::gs::effect_parameter_block::holds_flushed(field& entry)
+{
+	// Once a technique ends libobs holds no value at all, and would draw with the default instead. This is the usual
+	// case, as blocks are flushed right before drawing.
+	std::size_t size = entry.parameter.get_value_size_in_bytes();
+	if (size == 0) {
+		return false;
+	}
+
+	// Otherwise someone else may have written to the effect since, such as another block sharing it.
+	std::shared_ptr<void> value{gs_effect_get_val(entry.parameter.get()), bfree};
+	if (!value) {
+		return false;
+	}
+	if (entry.type == effect_parameter::type::Texture) {
+		// Depending on the libobs version, the texture may be followed by further state.
+		return (size >= sizeof(gs_texture_t*))
+			   && (memcmp(value.get(), &entry.flushed_texture, sizeof(gs_texture_t*)) == 0);
+	}
+	return (size == entry.flushed_size) && (memcmp(value.get(), entry.flushed_value, size) == 0);
+}
+
+void streamfx::obs::gs::effect_parameter_block::record(std::size_t idx, effect_parameter::type type, const void* data,
+													   std::size_t size)
+{
+	auto& field = _fields.at(idx);
+	if (!field.parameter) {
+		return;
+	}
+	if (field.type != type) {
+		throw std::bad_cast();
+	}
+	memcpy(field.value, data, size);
+	field.size = size;
+}
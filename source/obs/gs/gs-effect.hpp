@@ -20,12 +20,18 @@
 #pragma once
 #include "common.hpp"
 #include <filesystem>
+#include <initializer_list>
 #include <list>
+#include <string_view>
+#include <vector>
 #include "gs-effect-parameter.hpp"
 #include "gs-effect-technique.hpp"
 
 namespace streamfx::obs::gs {
 	class effect : public std::shared_ptr<gs_effect_t> {
+		// Parameters sorted by name, built once when the effect is loaded.
+		std::shared_ptr<std::vector<std::pair<std::string_view, gs_eparam_t*>>> _parameters;
+
 		public:
 		effect(){};
 		effect(const std::string& code, const std::string& name);
@@ -39,9 +45,9 @@ namespace streamfx::obs::gs {
 
 		std::size_t                         count_parameters();
 		streamfx::obs::gs::effect_parameter get_parameter(std::size_t idx);
-		streamfx::obs::gs::effect_parameter get_parameter(const std::string& name);
-		bool                                has_parameter(const std::string& name);
-		bool                                has_parameter(const std::string& name, effect_parameter::type type);
+		streamfx::obs::gs::effect_parameter get_parameter(std::string_view name);
+		bool                                has_parameter(std::string_view name);
+		bool                                has_parameter(std::string_view name, effect_parameter::type type);
 
 		public /* Legacy Support */:
 		inline gs_effect_t* get_object()
@@ -59,4 +65,80 @@ namespace streamfx::obs::gs {
 			return streamfx::obs::gs::effect(code, name);
 		};
 	};
+
+	/** Effect parameter that is looked up by name once, instead of every time it is used.
+	 *
+	 * The lookup is only repeated when used with a different effect, such as after a reload. Parameters which don't
+	 * exist, or which are not of the expected type, resolve to a null parameter.
+	 */
+	class effect_parameter_ref {
+		std::string                         _name;
+		effect_parameter::type              _type;
+		gs_effect_t*                        _effect;
+		std::weak_ptr<gs_effect_t>          _effect_weak;
+		streamfx::obs::gs::effect_parameter _parameter;
+
+		public:
+		effect_parameter_ref(std::string_view name, effect_parameter::type type = effect_parameter::type::Invalid);
+		~effect_parameter_ref();
+
+		streamfx::obs::gs::effect_parameter& operator()(streamfx::obs::gs::effect& effect);
+	};
+
+	/** CPU-side copy of a set of effect parameters, which only calls into libobs for values that actually changed.
+	 *
+	 * Values are recorded by index, in the order the names were given, and written by flush() right before the effect
+	 * is drawn with. Changes are detected against the last value this block flushed, and a field is written again if
+	 * the effect no longer holds that value. libobs forgets all values of an effect once a technique ends, so after a
+	 * draw every field is written again, and only repeated flushes in between are skipped. Several blocks (or other
+	 * code) may share the same effect. Parameters that the effect doesn't have are silently ignored.
+	 */
+	class effect_parameter_block {
+		struct field {
+			streamfx::obs::gs::effect_parameter parameter;
+			effect_parameter::type              type;
+			std::size_t                         size;
+			uint8_t                             value[sizeof(matrix4)];
+			gs_texture_t*                       texture;
+			std::size_t                         flushed_size;
+			uint8_t                             flushed_value[sizeof(matrix4)];
+			gs_texture_t*                       flushed_texture;
+		};
+
+		std::vector<field> _fields;
+
+		public:
+		effect_parameter_block();
+		effect_parameter_block(streamfx::obs::gs::effect& effect, std::initializer_list<std::string_view> names);
+		~effect_parameter_block();
+
+		std::size_t size();
+
+		void set_bool(std::size_t idx, bool v);
+
+		void set_float(std::size_t idx, float_t x);
+		void set_float2(std::size_t idx, float_t x, float_t y);
+		void set_float3(std::size_t idx, float_t x, float_t y, float_t z);
+		void set_float4(std::size_t idx, float_t x, float_t y, float_t z, float_t w);
+		void set_float4(std::size_t idx, vec4 const& v);
+
+		void set_int(std::size_t idx, int32_t x);
+		void set_int2(std::size_t idx, int32_t x, int32_t y);
+		void set_int3(std::size_t idx, int32_t x, int32_t y, int32_t z);
+		void set_int4(std::size_t idx, int32_t x, int32_t y, int32_t z, int32_t w);
+
+		void set_matrix(std::size_t idx, matrix4 const& v);
+
+		void set_texture(std::size_t idx, std::shared_ptr<streamfx::obs::gs::texture> v);
+		void set_texture(std::size_t idx, gs_texture_t* v);
+
+		/// Write all recorded values that changed or that the effect forgot, returns how many parameters were written.
+		std::size_t flush();
+
+		private:
+		void record(std::size_t idx, effect_parameter::type type, const void* data, std::size_t size);
+
+		/// Does the effect still hold what the field last flushed?
+		bool holds_flushed(field& entry);
+	};
 } // namespace streamfx::obs::gs
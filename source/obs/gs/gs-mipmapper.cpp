@@ -34,43 +34,91 @@
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
+#else
+#include <dlfcn.h>
 #endif
 
+// OpenGL is loaded by libobs, not by us, so the few functions needed are looked up at runtime instead.
+#define ST_GL_TEXTURE_2D 0x0DE1
+#define ST_GL_TEXTURE_BINDING_2D 0x8069
+
+#ifdef _WIN32
+#define ST_GLAPI __stdcall
+#else
+#define ST_GLAPI
+#endif
+
+namespace {
+	struct opengl_functions {
+		typedef void(ST_GLAPI* glBindTexture_t)(uint32_t target, uint32_t texture);
+		typedef void(ST_GLAPI* glGetIntegerv_t)(uint32_t pname, int32_t* data);
+		typedef void(ST_GLAPI* glGenerateMipmap_t)(uint32_t target);
+
+		glBindTexture_t    glBindTexture    = nullptr;
+		glGetIntegerv_t    glGetIntegerv    = nullptr;
+		glGenerateMipmap_t glGenerateMipmap = nullptr;
+
+		opengl_functions()
+		{
+#ifdef _WIN32
+			typedef PROC(WINAPI * wglGetProcAddress_t)(LPCSTR);
+
+			HMODULE opengl32 = GetModuleHandleW(L"opengl32.dll");
+			if (!opengl32)
+				return;
+
+			// Core 1.1 functions are exported directly, everything newer has to go through the context.
+			auto wglGetProcAddress =
+				reinterpret_cast<wglGetProcAddress_t>(GetProcAddress(opengl32, "wglGetProcAddress"));
+			glBindTexture    = reinterpret_cast<glBindTexture_t>(GetProcAddress(opengl32, "glBindTexture"));
+			glGetIntegerv    = reinterpret_cast<glGetIntegerv_t>(GetProcAddress(opengl32, "glGetIntegerv"));
+			glGenerateMipmap = wglGetProcAddress
+								   ? reinterpret_cast<glGenerateMipmap_t>(wglGetProcAddress("glGenerateMipmap"))
+								   : nullptr;
+#else
+			glBindTexture    = reinterpret_cast<glBindTexture_t>(dlsym(RTLD_DEFAULT, "glBindTexture"));
+			glGetIntegerv    = reinterpret_cast<glGetIntegerv_t>(dlsym(RTLD_DEFAULT, "glGetIntegerv"));
+			glGenerateMipmap = reinterpret_cast<glGenerateMipmap_t>(dlsym(RTLD_DEFAULT, "glGenerateMipmap"));
+#endif
+		}
+
+		bool available()
+		{
+			return glBindTexture && glGetIntegerv && glGenerateMipmap;
+		}
+	};
+
+	/** Build all mip levels of the target in place, which only OpenGL allows.
+	 *
+	 * Returns false if the necessary functions could not be found, in which case only level 0 has been copied.
+	 */
+	bool opengl_rebuild(gs_texture_t* source, gs_texture_t* target)
+	{
+		// Only valid with the graphics context held, as Windows hands out functions per context.
+		static opengl_functions gl;
+
+		gs_copy_texture_region(target, 0, 0, source, 0, 0, 0, 0);
+		if (!gl.available())
+			return false;
+
+		// libobs tracks which textures it has bound itself, so the binding has to be restored afterwards.
+		int32_t previous = 0;
+		gl.glGetIntegerv(ST_GL_TEXTURE_BINDING_2D, &previous);
+		gl.glBindTexture(ST_GL_TEXTURE_2D, *reinterpret_cast<uint32_t*>(gs_texture_get_obj(target)));
+		gl.glGenerateMipmap(ST_GL_TEXTURE_2D);
+		gl.glBindTexture(ST_GL_TEXTURE_2D, static_cast<uint32_t>(previous));
+		return true;
+	}
+} // namespace
+
 streamfx::obs::gs::mipmapper::~mipmapper()
 {
-	_vb.reset();
 	_rt.reset();
 	_effect.reset();
 }
 
 streamfx::obs::gs::mipmapper::mipmapper()
 {
-	_vb = std::make_unique<streamfx::obs::gs::vertex_buffer>(uint32_t(3u), uint8_t(1u));
-
-	{
-		auto vtx        = _vb->at(0);
-		vtx.position->x = 0;
-		vtx.position->y = 0;
-		vtx.uv[0]->x    = 0;
-		vtx.uv[0]->y    = 0;
-	}
-	{
-		auto vtx        = _vb->at(1);
-		vtx.position->x = 0.;
-		vtx.position->y = 2.;
-		vtx.uv[0]->x    = 0.;
-		vtx.uv[0]->y    = 2.;
-	}
-	{
-		auto vtx        = _vb->at(2);
-		vtx.position->x = 2.;
-		vtx.position->y = 0.;
-		vtx.uv[0]->x    = 2.;
-		vtx.uv[0]->y    = 0.;
-	}
-
-	_vb->update();
-
 	_effect = streamfx::obs::gs::effect::create(streamfx::data_file_path("effects/mipgen.effect").u8string());
 }
 
@@ -81,7 +129,7 @@ void streamfx::obs::gs::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::te
 		if (!source || !target)
 			return; // Do nothing if source or target are missing.
 
-		if (!_vb || !_effect)
+		if (!_effect)
 			return; // Do nothing if the necessary data failed to load.
 
 		// Ensure texture sizes match
@@ -103,6 +151,23 @@ void streamfx::obs::gs::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::te
 	// Get a unique lock on the graphics context.
 	auto gctx = streamfx::obs::gs::context();
 
+	// OpenGL can render straight into the mip levels of the target, so skip the render target entirely.
+	if ((gs_get_device_type() == GS_DEVICE_OPENGL)
+		&& (source->get_type() == streamfx::obs::gs::texture::type::Normal)) {
+#ifdef ENABLE_PROFILING
+		auto cctr = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "In-Place");
+#endif
+
+		if (!opengl_rebuild(source->get_object(), target->get_object())) {
+			static bool warned = false;
+			if (!warned) {
+				DLOG_WARNING("<gs::mipmapper> OpenGL functions are unavailable, mip maps will not be generated.");
+				warned = true;
+			}
+		}
+		return;
+	}
+
 	// Do we need to recreate the render target for a different format?
 	if ((!_rt) || (source->get_color_format() != _rt->get_color_format())) {
 		_rt = std::make_unique<streamfx::obs::gs::rendertarget>(source->get_color_format(), GS_ZS_NONE);
@@ -121,9 +186,6 @@ void streamfx::obs::gs::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::te
 		d3d_device->GetImmediateContext(&d3d_context);
 	}
 #endif
-	if (gs_get_device_type() == GS_DEVICE_OPENGL) {
-		// FixMe! Implement OpenGL
-	}
 
 	// Use different methods for different types of textures.
 	if (source->get_type() == streamfx::obs::gs::texture::type::Normal) {
@@ -150,9 +212,6 @@ void streamfx::obs::gs::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::te
 					d3d_context->CopySubresourceRegion(d3d_target, 0, 0, 0, 0, d3d_source, 0, nullptr);
 				}
 #endif
-				if (gs_get_device_type() == GS_DEVICE_OPENGL) {
-					// FixMe! Implement OpenGL
-				}
 			}
 
 			// Do we even need to do anything here?
@@ -172,8 +231,6 @@ void streamfx::obs::gs::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::te
 				float_t  iheight = 1.f / static_cast<float_t>(cheight);
 
 				// Set up rendering state.
-				gs_load_vertexbuffer(_vb->update(false));
-				gs_load_indexbuffer(nullptr);
 				gs_blend_state_push();
 				gs_reset_blend_state();
 				gs_enable_blending(false);
@@ -195,7 +252,7 @@ void streamfx::obs::gs::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::te
 					_effect.get_parameter("imageTexel").set_float2(iwidth, iheight);
 					_effect.get_parameter("level").set_int(int32_t(mip - 1));
 					while (gs_effect_loop(_effect.get_object(), "Draw")) {
-						gs_draw(gs_draw_mode::GS_TRIS, 0, _vb->size());
+						streamfx::gs_draw_fullscreen_tri();
 					}
 				} catch (...) {
 				}
@@ -216,9 +273,6 @@ void streamfx::obs::gs::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::te
 					d3d_context->CopySubresourceRegion(d3d_target, level, 0, 0, 0, rtt, 0, &box);
 				}
 #endif
-				if (gs_get_device_type() == GS_DEVICE_OPENGL) {
-					// FixMe! Implement OpenGL
-				}
 			}
 
 			break;
@@ -22,7 +22,6 @@
 #include "gs-effect.hpp"
 #include "gs-rendertarget.hpp"
 #include "gs-texture.hpp"
-#include "gs-vertexbuffer.hpp"
 
 /* gs::mipmapper is an attempt at adding dynamic mip-map generation to a software
  *  which only supports static mip-maps. It is effectively an incredibly bad hack
@@ -30,17 +29,17 @@
  *
  * Needless to say, dynamic mip-map generation costs a lot of GPU time, especially
  *  when things need to be synchronized. In the ideal case we would just render 
- *  straight to the mip level, but this is not possible in DirectX 11 and OpenGL.
+ *  straight to the mip level, which OpenGL allows and does for us with
+ *  glGenerateMipmap, but DirectX 11 does not.
  * 
- * So instead we render to a render target and copy from there to the actual
+ * So on DirectX 11 we render to a render target and copy from there to the actual
  *  resource. Super wasteful, but what else can we actually do?
  */
 
 namespace streamfx::obs::gs {
 	class mipmapper {
-		std::unique_ptr<streamfx::obs::gs::vertex_buffer> _vb;
-		std::unique_ptr<streamfx::obs::gs::rendertarget>  _rt;
-		streamfx::obs::gs::effect                         _effect;
+		std::unique_ptr<streamfx::obs::gs::rendertarget> _rt;
+		streamfx::obs::gs::effect                        _effect;
 
 		public:
 		~mipmapper();
@@ -0,0 +1,152 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2017 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "gs-readback.hpp"
+#include <stdexcept>
+#include "obs/gs/gs-helper.hpp"
+#include "plugin.hpp"
+#include "util/util-logging.hpp"
+#include "util/util-threadpool.hpp"
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<gs::readback> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+streamfx::obs::gs::readback::~readback()
+{
+	auto gctx = streamfx::obs::gs::context();
+	for (auto& entry : _slots) {
+		if (entry.surface) {
+			gs_stagesurface_destroy(entry.surface);
+		}
+	}
+}
+
+streamfx::obs::gs::readback::readback(std::size_t buffers, callback_t callback)
+	: _slots(), _index(0), _callback(callback)
+{
+	if (buffers == 0) {
+		throw std::invalid_argument("buffers");
+	}
+	if (!_callback) {
+		throw std::invalid_argument("callback");
+	}
+
+	_slots.resize(buffers, slot{nullptr, 0, 0, GS_UNKNOWN, 0, false});
+}
+
+void streamfx::obs::gs::readback::stage(std::shared_ptr<streamfx::obs::gs::texture> texture, uint64_t timestamp)
+{
+	if (!texture || (texture->get_type() != streamfx::obs::gs::texture::type::Normal)) {
+		throw std::invalid_argument("texture");
+	}
+
+	auto gctx = streamfx::obs::gs::context();
+
+	uint32_t        width  = texture->get_width();
+	uint32_t        height = texture->get_height();
+	gs_color_format format = texture->get_color_format();
+
+	// Staging surfaces must match the texture exactly, so they follow any change in size or format.
+	auto& entry = _slots[_index];
+	if (!entry.surface || (entry.width != width) || (entry.height != height) || (entry.format != format)) {
+		if (entry.surface) {
+			gs_stagesurface_destroy(entry.surface);
+		}
+		entry.surface = gs_stagesurface_create(width, height, format);
+		if (!entry.surface) {
+			throw std::runtime_error("Failed to create staging surface.");
+		}
+		entry.width  = width;
+		entry.height = height;
+		entry.format = format;
+	}
+
+	gs_stage_texture(entry.surface, texture->get_object());
+	entry.timestamp = timestamp;
+	entry.staged    = true;
+
+	// The next slot to stage into holds the oldest copy, which has to be collected before it is reused.
+	_index = (_index + 1) % _slots.size();
+	if (_slots[_index].staged) {
+		map(_slots[_index]);
+	}
+}
+
+void streamfx::obs::gs::readback::flush()
+{
+	auto gctx = streamfx::obs::gs::context();
+
+	// Oldest first, so that frames are handed out in the order they were staged.
+	for (std::size_t idx = 0; idx < _slots.size(); idx++) {
+		auto& entry = _slots[(_index + idx) % _slots.size()];
+		if (entry.staged) {
+			map(entry);
+		}
+	}
+}
+
+std::size_t streamfx::obs::gs::readback::get_latency()
+{
+	return _slots.size() - 1;
+}
+
+void streamfx::obs::gs::readback::map(slot& entry)
+{
+	entry.staged = false;
+
+	uint8_t* data     = nullptr;
+	uint32_t linesize = 0;
+	if (!gs_stagesurface_map(entry.surface, &data, &linesize)) {
+		D_LOG_WARNING("Failed to map staging surface, frame at %" PRIu64 " is lost.", entry.timestamp);
+		return;
+	}
+
+	// The surface has to be unmapped before the next stage, so the data is copied out instead of being handed over.
+	auto result = std::make_shared<frame>();
+	try {
+		result->data.assign(data, data + static_cast<std::size_t>(linesize) * entry.height);
+	} catch (...) {
+		gs_stagesurface_unmap(entry.surface);
+		throw;
+	}
+	gs_stagesurface_unmap(entry.surface);
+
+	result->linesize  = linesize;
+	result->width     = entry.width;
+	result->height    = entry.height;
+	result->format    = entry.format;
+	result->timestamp = entry.timestamp;
+
+	streamfx::threadpool()->push(
+		[callback = _callback](streamfx::util::threadpool_data_t ptr) {
+			callback(std::static_pointer_cast<frame>(ptr));
+		},
+		result);
+}
@@ -0,0 +1,96 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2017 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include "common.hpp"
+#include <functional>
+#include <vector>
+#include "gs-texture.hpp"
+
+namespace streamfx::obs::gs {
+	/** Copies textures back to the CPU without waiting for the GPU.
+	 *
+	 * Each call to stage() queues a copy of a texture into one of several staging surfaces, and maps the surface that
+	 * was staged the longest time ago. With N buffers, a texture staged on frame F is mapped on frame F+N-1, by which
+	 * time the GPU has long finished the copy, so the map does not stall. A single buffer maps the same frame right
+	 * away, which always waits for the GPU.
+	 *
+	 * Mapped data is copied out right away and handed to the callback on the thread pool, so the callback must not
+	 * touch the graphics context. Callbacks for consecutive frames may run concurrently and out of order, use the
+	 * timestamp to order them if needed.
+	 */
+	class readback {
+		public:
+		struct frame {
+			std::vector<uint8_t> data;
+			uint32_t             linesize;
+			uint32_t             width;
+			uint32_t             height;
+			gs_color_format      format;
+			uint64_t             timestamp;
+		};
+
+		typedef std::function<void(std::shared_ptr<frame>)> callback_t;
+
+		private:
+		struct slot {
+			gs_stagesurf_t* surface;
+			uint32_t        width;
+			uint32_t        height;
+			gs_color_format format;
+			uint64_t        timestamp;
+			bool            staged;
+		};
+
+		std::vector<slot> _slots;
+		std::size_t       _index; // Slot to stage into next, which is also the oldest staged one.
+		callback_t        _callback;
+
+		public:
+		~readback();
+
+		/** Create a readback with the given number of staging surfaces.
+		 *
+		 * @param buffers Number of staging surfaces, which is also the latency in frames plus one.
+		 * @param callback Function called on the thread pool with each frame read back.
+		 */
+		readback(std::size_t buffers, callback_t callback);
+
+		/** Queue a copy of a texture, and map the oldest copy that is still queued.
+		 *
+		 * Must be called from the graphics thread. The texture may change size and format between calls.
+		 *
+		 * @param texture 2D texture to copy.
+		 * @param timestamp Passed back with the data, usually the timestamp of the frame the texture belongs to.
+		 */
+		void stage(std::shared_ptr<streamfx::obs::gs::texture> texture, uint64_t timestamp);
+
+		/** Map all copies that are still queued, waiting for the GPU if needed.
+		 *
+		 * Must be called from the graphics thread.
+		 */
+		void flush();
+
+		/// Number of frames between staging a texture and receiving its data.
+		std::size_t get_latency();
+
+		private:
+		void map(slot& entry);
+	};
+} // namespace streamfx::obs::gs
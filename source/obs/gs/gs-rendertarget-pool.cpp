@@ -0,0 +1,217 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2017 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "gs-rendertarget-pool.hpp"
+#include <algorithm>
+#include <vector>
+#include "obs/gs/gs-helper.hpp"
+#include "util/util-logging.hpp"
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<gs::rendertarget_pool> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+// Idle targets are destroyed after this many nanoseconds.
+#define ST_IDLE_TIMEOUT 2000000000ull
+
+// Default amount of memory idle targets may hold on to.
+#define ST_DEFAULT_BUDGET (256ull * 1024ull * 1024ull)
+
+#define ST_MEBIBYTE (1024. * 1024.)
+
+static std::shared_ptr<streamfx::obs::gs::rendertarget_pool> rendertarget_pool_instance;
+
+static std::size_t estimate_size(uint32_t width, uint32_t height, gs_color_format color_format,
+								 gs_zstencil_format zstencil_format)
+{
+	std::size_t bits = gs_get_format_bpp(color_format);
+	switch (zstencil_format) {
+	case GS_Z16:
+		bits += 16;
+		break;
+	case GS_Z24_S8:
+	case GS_Z32F:
+		bits += 32;
+		break;
+	case GS_Z32F_S8X24:
+		bits += 64;
+		break;
+	default:
+		break;
+	}
+	return (static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * bits) / 8;
+}
+
+streamfx::obs::gs::rendertarget_pool::rendertarget_pool()
+	: _lock(), _free(), _free_size(0), _leased_size(0), _peak_size(0), _budget(ST_DEFAULT_BUDGET)
+{
+	obs_add_tick_callback(&rendertarget_pool::tick, this);
+}
+
+streamfx::obs::gs::rendertarget_pool::~rendertarget_pool()
+{
+	obs_remove_tick_callback(&rendertarget_pool::tick, this);
+
+	D_LOG_INFO("Peak memory usage was %.1f MiB, %.1f MiB still leased on shutdown.", _peak_size / ST_MEBIBYTE,
+			   _leased_size / ST_MEBIBYTE);
+
+	auto gctx = streamfx::obs::gs::context();
+	_free.clear();
+}
+
+std::shared_ptr<streamfx::obs::gs::rendertarget>
+	streamfx::obs::gs::rendertarget_pool::acquire(uint32_t width, uint32_t height, gs_color_format color_format,
+												  gs_zstencil_format zstencil_format)
+{
+	entry lease;
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		auto found = std::find_if(_free.begin(), _free.end(), [&](const entry& v) {
+			return (v.width == width) && (v.height == height) && (v.color_format == color_format)
+				   && (v.zstencil_format == zstencil_format);
+		});
+		if (found != _free.end()) {
+			lease = std::move(*found);
+			_free.erase(found);
+			_free_size -= lease.size;
+		} else {
+			lease.width           = width;
+			lease.height          = height;
+			lease.color_format    = color_format;
+			lease.zstencil_format = zstencil_format;
+			lease.size            = estimate_size(width, height, color_format, zstencil_format);
+		}
+		_leased_size += lease.size;
+		_peak_size = std::max(_peak_size, _leased_size + _free_size);
+	}
+
+	if (!lease.target) {
+		try {
+			lease.target = std::make_shared<streamfx::obs::gs::rendertarget>(color_format, zstencil_format);
+		} catch (...) {
+			std::unique_lock<std::mutex> lock(_lock);
+			_leased_size -= lease.size;
+			throw;
+		}
+	}
+
+	// Hand out an aliasing pointer, so that dropping the last reference returns the target instead of destroying it.
+	auto target = lease.target.get();
+	auto holder = std::make_shared<entry>(std::move(lease));
+	auto pool   = std::weak_ptr<rendertarget_pool>(shared_from_this());
+	return std::shared_ptr<streamfx::obs::gs::rendertarget>(target, [holder, pool](streamfx::obs::gs::rendertarget*) {
+		if (auto self = pool.lock(); self) {
+			self->release(std::move(*holder));
+		} else {
+			auto gctx = streamfx::obs::gs::context();
+			holder->target.reset();
+		}
+	});
+}
+
+std::size_t streamfx::obs::gs::rendertarget_pool::get_resident_size()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	return _leased_size + _free_size;
+}
+
+std::size_t streamfx::obs::gs::rendertarget_pool::get_leased_size()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	return _leased_size;
+}
+
+std::size_t streamfx::obs::gs::rendertarget_pool::get_peak_size()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	return _peak_size;
+}
+
+void streamfx::obs::gs::rendertarget_pool::set_budget(std::size_t size)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	_budget = size;
+}
+
+void streamfx::obs::gs::rendertarget_pool::release(entry&& target)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	target.released = os_gettime_ns();
+	_leased_size -= target.size;
+	_free_size += target.size;
+	_free.push_front(std::move(target));
+}
+
+void streamfx::obs::gs::rendertarget_pool::evict(uint64_t now)
+{
+	std::vector<entry> evicted;
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		// The list is ordered by release time, so everything to evict sits at the back.
+		while (!_free.empty()
+			   && ((_free_size > _budget) || ((now - _free.back().released) >= ST_IDLE_TIMEOUT))) {
+			_free_size -= _free.back().size;
+			evicted.push_back(std::move(_free.back()));
+			_free.pop_back();
+		}
+		if (evicted.empty()) {
+			return;
+		}
+		D_LOG_DEBUG("Evicted %zu render target(s), %.1f MiB resident, %.1f MiB peak.", evicted.size(),
+					(_leased_size + _free_size) / ST_MEBIBYTE, _peak_size / ST_MEBIBYTE);
+	}
+
+	// Destroy them outside of the lock, as this has to wait for the graphics context.
+	auto gctx = streamfx::obs::gs::context();
+	evicted.clear();
+}
+
+void streamfx::obs::gs::rendertarget_pool::tick(void* ptr, float) noexcept
+try {
+	reinterpret_cast<rendertarget_pool*>(ptr)->evict(os_gettime_ns());
+} catch (const std::exception& ex) {
+	DLOG_ERROR("Unexpected exception in function '%s': %s", __FUNCTION_NAME__, ex.what());
+} catch (...) {
+	DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+}
+
+void streamfx::obs::gs::rendertarget_pool::initialize()
+{
+	rendertarget_pool_instance = std::make_shared<streamfx::obs::gs::rendertarget_pool>();
+}
+
+void streamfx::obs::gs::rendertarget_pool::finalize()
+{
+	rendertarget_pool_instance.reset();
+}
+
+std::shared_ptr<streamfx::obs::gs::rendertarget_pool> streamfx::obs::gs::rendertarget_pool::get()
+{
+	return rendertarget_pool_instance;
+}
@@ -0,0 +1,94 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2017 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include "common.hpp"
+#include <list>
+#include <mutex>
+#include "gs-rendertarget.hpp"
+
+namespace streamfx::obs::gs {
+	/** Pool of render targets, shared by everything that doesn't need to own one for its entire lifetime.
+	 *
+	 * A lease is a normal render target handed out by acquire(), which returns to the pool as soon as the last
+	 * reference to it is dropped. Released targets are reused by the next request of the same size and format, and
+	 * are destroyed once they have been idle for a while, or least recently used first if the idle targets exceed the
+	 * memory budget. A lease should only ever be rendered to at the size it was acquired with.
+	 *
+	 * Intermediate targets are dropped as soon as the pass that needed them is done. Filters lease their caches when
+	 * they first render in a frame and drop them in video_tick, so hidden sources hold on to nothing. What has to
+	 * carry over to the next frame is kept until the source is no longer showing.
+	 */
+	class rendertarget_pool : public std::enable_shared_from_this<rendertarget_pool> {
+		struct entry {
+			std::shared_ptr<streamfx::obs::gs::rendertarget> target;
+			uint32_t                                         width;
+			uint32_t                                         height;
+			gs_color_format                                  color_format;
+			gs_zstencil_format                               zstencil_format;
+			std::size_t                                      size;
+			uint64_t                                         released;
+		};
+
+		std::mutex       _lock;
+		std::list<entry> _free; // Most recently released first.
+		std::size_t      _free_size;
+		std::size_t      _leased_size;
+		std::size_t      _peak_size;
+		std::size_t      _budget;
+
+		public:
+		rendertarget_pool();
+		~rendertarget_pool();
+
+		/** Lease a render target of the given size and format.
+		 *
+		 * The returned target may have been used by someone else before, so its content is undefined.
+		 */
+		std::shared_ptr<streamfx::obs::gs::rendertarget> acquire(uint32_t width, uint32_t height,
+																 gs_color_format    color_format,
+																 gs_zstencil_format zstencil_format = GS_ZS_NONE);
+
+		/// Estimated video memory held by leased and idle targets, in bytes.
+		std::size_t get_resident_size();
+
+		/// Estimated video memory held by leased targets, in bytes.
+		std::size_t get_leased_size();
+
+		/// Highest resident size seen so far, in bytes.
+		std::size_t get_peak_size();
+
+		/// Set how much memory idle targets may hold on to before the least recently used ones are destroyed.
+		void set_budget(std::size_t size);
+
+		private:
+		void release(entry&& target);
+
+		void evict(uint64_t now);
+
+		static void tick(void* ptr, float seconds) noexcept;
+
+		public: // Singleton
+		static void initialize();
+
+		static void finalize();
+
+		static std::shared_ptr<streamfx::obs::gs::rendertarget_pool> get();
+	};
+} // namespace streamfx::obs::gs
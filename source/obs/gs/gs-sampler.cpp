@@ -18,7 +18,73 @@
  */
 
 #include "gs-sampler.hpp"
+#include <map>
+#include <mutex>
 #include <stdexcept>
+#include <tuple>
+#include "obs/gs/gs-helper.hpp"
+
+// Sampler states shared by all samplers with equivalent settings.
+typedef std::tuple<gs_sample_filter, gs_address_mode, gs_address_mode, gs_address_mode, int, uint32_t> sampler_key_t;
+
+static std::mutex                                                sampler_states_lock;
+static std::map<sampler_key_t, std::weak_ptr<gs_sampler_state>> sampler_states;
+
+static std::shared_ptr<gs_sampler_state> acquire_sampler_state(gs_sampler_info const& info)
+{
+	// Settings that have no effect are left out of the key, so that they don't prevent sharing.
+	bool anisotropic = (info.filter == GS_FILTER_ANISOTROPIC);
+	bool bordered    = (info.address_u == GS_ADDRESS_BORDER) || (info.address_v == GS_ADDRESS_BORDER)
+					|| (info.address_w == GS_ADDRESS_BORDER);
+
+	sampler_key_t key{info.filter, info.address_u, info.address_v, info.address_w,
+					  anisotropic ? info.max_anisotropy : 1, bordered ? info.border_color : 0};
+
+	{
+		std::unique_lock<std::mutex> lock(sampler_states_lock);
+		if (auto kv = sampler_states.find(key); kv != sampler_states.end()) {
+			if (auto state = kv->second.lock(); state) {
+				return state;
+			}
+		}
+	}
+
+	// Creation has to enter the graphics context, which must never happen while holding the lock.
+	gs_sampler_state* object = nullptr;
+	{
+		auto gctx = streamfx::obs::gs::context();
+		object    = gs_samplerstate_create(&info);
+	}
+	if (!object) {
+		throw std::runtime_error("Failed to create sampler state.");
+	}
+	auto state = std::shared_ptr<gs_sampler_state>(object, [](gs_sampler_state* v) {
+		auto gctx = streamfx::obs::gs::context();
+		gs_samplerstate_destroy(v);
+	});
+
+	std::shared_ptr<gs_sampler_state> existing;
+	{
+		std::unique_lock<std::mutex> lock(sampler_states_lock);
+		auto&                        entry = sampler_states[key];
+		existing                           = entry.lock();
+		if (!existing) {
+			entry = state;
+		}
+
+		// Drop entries of states that are gone, so the map only ever holds what is in use.
+		for (auto kv = sampler_states.begin(); kv != sampler_states.end();) {
+			if (kv->second.expired()) {
+				kv = sampler_states.erase(kv);
+			} else {
+				kv++;
+			}
+		}
+	}
+
+	// Someone else created an equivalent state in the meantime, ours is destroyed once the lock is released.
+	return existing ? existing : state;
+}
 
 streamfx::obs::gs::sampler::sampler()
 {
@@ -29,8 +95,7 @@ streamfx::obs::gs::sampler::sampler()
 
 streamfx::obs::gs::sampler::~sampler()
 {
-	if (_sampler_state)
-		gs_samplerstate_destroy(_sampler_state);
+	_sampler_state.reset();
 }
 
 void streamfx::obs::gs::sampler::set_filter(gs_sample_filter v)
@@ -121,15 +186,26 @@ uint8_t streamfx::obs::gs::sampler::get_border_color(bool r, bool g, bool b, boo
 
 gs_sampler_state* streamfx::obs::gs::sampler::refresh()
 {
-	gs_samplerstate_destroy(_sampler_state);
-	_sampler_state = gs_samplerstate_create(&_sampler_info);
+	_sampler_state = acquire_sampler_state(_sampler_info);
 	_dirty         = false;
-	return _sampler_state;
+	return _sampler_state.get();
 }
 
 gs_sampler_state* streamfx::obs::gs::sampler::get_object()
 {
 	if (_dirty)
 		return refresh();
-	return _sampler_state;
+	return _sampler_state.get();
+}
+
+std::size_t streamfx::obs::gs::sampler::get_live_count()
+{
+	std::unique_lock<std::mutex> lock(sampler_states_lock);
+	std::size_t                  count = 0;
+	for (auto& kv : sampler_states) {
+		if (!kv.second.expired()) {
+			count++;
+		}
+	}
+	return count;
 }
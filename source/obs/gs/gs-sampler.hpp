@@ -50,9 +50,16 @@ namespace streamfx::obs::gs {
 
 		gs_sampler_state* get_object();
 
+		/** Number of distinct sampler states currently alive.
+		 *
+		 * Sampler states are immutable and shared between all samplers with equivalent settings, so this is usually
+		 * far lower than the number of sampler objects.
+		 */
+		static std::size_t get_live_count();
+
 		private:
-		bool              _dirty;
-		gs_sampler_info   _sampler_info;
-		gs_sampler_state* _sampler_state;
+		bool                              _dirty;
+		gs_sampler_info                   _sampler_info;
+		std::shared_ptr<gs_sampler_state> _sampler_state;
 	};
 } // namespace streamfx::obs::gs
@@ -0,0 +1,214 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2017 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "gs-texture-cache.hpp"
+#include <filesystem>
+#include <fstream>
+#include "plugin.hpp"
+#include "util/util-logging.hpp"
+#include "util/util-threadpool.hpp"
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<gs::texture_cache> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+static std::shared_ptr<streamfx::obs::gs::texture_cache> texture_cache_instance;
+
+static uint64_t hash_file(std::string const& file)
+{
+	std::ifstream stream(std::filesystem::u8path(file), std::ios::binary);
+	if (!stream) {
+		throw std::ios_base::failure(file);
+	}
+
+	// 64-bit FNV-1a, collisions between the few images a scene uses are not a concern.
+	uint64_t             hash = 0xCBF29CE484222325ull;
+	std::vector<uint8_t> buffer(64 * 1024);
+	while (stream) {
+		stream.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+		for (std::streamsize idx = 0, end = stream.gcount(); idx < end; idx++) {
+			hash = (hash ^ buffer[static_cast<std::size_t>(idx)]) * 0x100000001B3ull;
+		}
+	}
+	if (stream.bad()) {
+		throw std::ios_base::failure(file);
+	}
+	return hash;
+}
+
+streamfx::obs::gs::texture_cache::texture_cache() : _lock(), _textures(), _pending()
+{
+	obs_add_tick_callback(&texture_cache::tick, this);
+}
+
+streamfx::obs::gs::texture_cache::~texture_cache()
+{
+	obs_remove_tick_callback(&texture_cache::tick, this);
+}
+
+streamfx::obs::gs::texture_cache::future_t streamfx::obs::gs::texture_cache::load(std::string const& file)
+{
+	auto     promise = std::make_shared<promise_t>();
+	future_t future  = promise->get_future().share();
+
+	// Anything still queued when the cache goes away is dropped, which breaks the promise.
+	std::weak_ptr<texture_cache> self = weak_from_this();
+	streamfx::threadpool()->push(
+		[self, file, promise](streamfx::util::threadpool_data_t) {
+			if (auto cache = self.lock(); cache) {
+				cache->task_load(file, promise);
+			}
+		},
+		nullptr);
+
+	return future;
+}
+
+void streamfx::obs::gs::texture_cache::task_load(std::string file, std::shared_ptr<promise_t> promise)
+{
+	uint64_t hash;
+	try {
+		hash = hash_file(file);
+	} catch (...) {
+		promise->set_exception(std::current_exception());
+		return;
+	}
+
+	{ // Share an existing texture or decode, unless someone else is already decoding the same content.
+		std::unique_lock<std::mutex> lock(_lock);
+		if (auto kv = _textures.find(hash); kv != _textures.end()) {
+			if (auto texture = kv->second.lock(); texture) {
+				promise->set_value(texture);
+				return;
+			}
+			_textures.erase(kv);
+		}
+
+		if (auto kv = _pending.find(hash); kv != _pending.end()) {
+			kv->second.waiters.push_back(promise);
+			return;
+		}
+		_pending.emplace(hash, pending{{promise}, nullptr, GS_UNKNOWN, 0, 0});
+	}
+
+	try {
+		// Decoding is the slow part, so it must not hold the lock.
+		gs_color_format format = GS_UNKNOWN;
+		uint32_t        width  = 0;
+		uint32_t        height = 0;
+		uint8_t*        raw    = gs_create_texture_file_data(file.c_str(), &format, &width, &height);
+		if (!raw) {
+			throw std::runtime_error("Failed to decode texture.");
+		}
+		std::shared_ptr<uint8_t> data{raw, [](uint8_t* v) { bfree(v); }};
+
+		std::unique_lock<std::mutex> lock(_lock);
+		auto&                        entry = _pending.at(hash);
+		entry.data                         = data;
+		entry.format                       = format;
+		entry.width                        = width;
+		entry.height                       = height;
+	} catch (...) {
+		D_LOG_WARNING("Failed to load texture from '%s'.", file.c_str());
+		fail(hash, std::current_exception());
+	}
+}
+
+void streamfx::obs::gs::texture_cache::fail(uint64_t hash, std::exception_ptr error)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	if (auto kv = _pending.find(hash); kv != _pending.end()) {
+		for (auto& waiter : kv->second.waiters) {
+			waiter->set_exception(error);
+		}
+		_pending.erase(kv);
+	}
+}
+
+void streamfx::obs::gs::texture_cache::upload()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+
+	for (auto kv = _pending.begin(); kv != _pending.end();) {
+		if (!kv->second.data) {
+			kv++;
+			continue;
+		}
+
+		try {
+			const uint8_t* data = kv->second.data.get();
+
+			auto texture = std::make_shared<streamfx::obs::gs::texture>(kv->second.width, kv->second.height,
+																		kv->second.format, 1, &data,
+																		streamfx::obs::gs::texture::flags::None);
+			_textures[kv->first] = texture;
+			for (auto& waiter : kv->second.waiters) {
+				waiter->set_value(texture);
+			}
+		} catch (...) {
+			for (auto& waiter : kv->second.waiters) {
+				waiter->set_exception(std::current_exception());
+			}
+		}
+		kv = _pending.erase(kv);
+	}
+
+	// Forget about textures nobody uses anymore.
+	for (auto kv = _textures.begin(); kv != _textures.end();) {
+		if (kv->second.expired()) {
+			kv = _textures.erase(kv);
+		} else {
+			kv++;
+		}
+	}
+}
+
+void streamfx::obs::gs::texture_cache::tick(void* ptr, float) noexcept
+try {
+	reinterpret_cast<texture_cache*>(ptr)->upload();
+} catch (const std::exception& ex) {
+	DLOG_ERROR("Unexpected exception in function '%s': %s", __FUNCTION_NAME__, ex.what());
+} catch (...) {
+	DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+}
+
+void streamfx::obs::gs::texture_cache::initialize()
+{
+	texture_cache_instance = std::make_shared<streamfx::obs::gs::texture_cache>();
+}
+
+void streamfx::obs::gs::texture_cache::finalize()
+{
+	texture_cache_instance.reset();
+}
+
+std::shared_ptr<streamfx::obs::gs::texture_cache> streamfx::obs::gs::texture_cache::get()
+{
+	return texture_cache_instance;
+}
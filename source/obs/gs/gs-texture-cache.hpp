@@ -0,0 +1,83 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2017 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include "common.hpp"
+#include <future>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "gs-texture.hpp"
+
+namespace streamfx::obs::gs {
+	/** Loads textures from files in the background and shares them between everyone using the same image.
+	 *
+	 * Files are read and decoded on the thread pool, and uploaded on the next tick of the graphics thread, so neither
+	 * the graphics thread nor the caller ever waits for the disk or the decoder. Textures are keyed by a hash of the
+	 * file content, so an image used by many filters is decoded and uploaded only once. A texture stays cached for as
+	 * long as anyone still holds a reference to it.
+	 */
+	class texture_cache : public std::enable_shared_from_this<texture_cache> {
+		public:
+		typedef std::shared_future<std::shared_ptr<streamfx::obs::gs::texture>> future_t;
+
+		private:
+		typedef std::promise<std::shared_ptr<streamfx::obs::gs::texture>> promise_t;
+
+		struct pending {
+			std::vector<std::shared_ptr<promise_t>> waiters;
+			std::shared_ptr<uint8_t>                data; // Decoded image, nullptr while still decoding.
+			gs_color_format                         format;
+			uint32_t                                width;
+			uint32_t                                height;
+		};
+
+		std::mutex                                                     _lock;
+		std::map<uint64_t, std::weak_ptr<streamfx::obs::gs::texture>> _textures;
+		std::map<uint64_t, pending>                                    _pending;
+
+		public:
+		texture_cache();
+		~texture_cache();
+
+		/** Load a texture from a file without blocking.
+		 *
+		 * The returned future becomes ready once the texture is uploaded, or holds the exception that prevented it
+		 * from loading. Check it with wait_for() and a zero timeout, waiting on it from the graphics thread would
+		 * never finish as the upload happens there.
+		 */
+		future_t load(std::string const& file);
+
+		private:
+		void task_load(std::string file, std::shared_ptr<promise_t> promise);
+
+		void fail(uint64_t hash, std::exception_ptr error);
+
+		void upload();
+
+		static void tick(void* ptr, float seconds) noexcept;
+
+		public: // Singleton
+		static void initialize();
+
+		static void finalize();
+
+		static std::shared_ptr<streamfx::obs::gs::texture_cache> get();
+	};
+} // namespace streamfx::obs::gs
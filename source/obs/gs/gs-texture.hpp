@@ -86,7 +86,8 @@ namespace streamfx::obs::gs {
 		* Creates a new #GS::Texture from a file located on disk. If the
 		* file can not be found, accessed or read, a #Plugin::file_not_found_error
 		* will be thrown. If there is an error reading the file, a
-		* #Plugin::io_error will be thrown.
+		* #Plugin::io_error will be thrown. This blocks until the file is
+		* decoded and uploaded, use #texture_cache to load in the background.
 		*
 		* \param file File to create the texture from.
 		*/
@@ -18,10 +18,11 @@
  */
 
 #include "gs-vertexbuffer.hpp"
+#include <cstring>
 #include <stdexcept>
 #include "obs/gs/gs-helper.hpp"
 
-void streamfx::obs::gs::vertex_buffer::initialize(uint32_t capacity, uint8_t layers)
+void streamfx::obs::gs::vertex_buffer::initialize(uint32_t capacity, uint8_t layers, attributes attribs)
 {
 	finalize();
 
@@ -31,21 +32,27 @@ void streamfx::obs::gs::vertex_buffer::initialize(uint32_t capacity, uint8_t lay
 	if (layers > MAXIMUM_UVW_LAYERS) {
 		throw std::out_of_range("layers");
 	}
+	_capacity   = capacity;
+	_layers     = layers;
+	_attributes = attribs | attributes::Position;
+
+	// Allocate cleared memory for each attribute in use, the rest stays nullptr and is ignored by libobs.
+	auto allocate = [this](attributes attribute, std::size_t element) {
+		void* ptr = nullptr;
+		if (has(_attributes, attribute)) {
+			ptr = streamfx::util::malloc_aligned(16, element * _capacity);
+			memset(ptr, 0, element * _capacity);
+		}
+		return ptr;
+	};
 
-	// Allocate memory for data.
-	_data          = std::make_shared<decltype(_data)::element_type>();
-	_data->num     = _capacity;
-	_data->num_tex = _layers;
-	_data->points = _positions = static_cast<vec3*>(streamfx::util::malloc_aligned(16, sizeof(vec3) * _capacity));
-	_data->normals = _normals = static_cast<vec3*>(streamfx::util::malloc_aligned(16, sizeof(vec3) * _capacity));
-	_data->tangents = _tangents = static_cast<vec3*>(streamfx::util::malloc_aligned(16, sizeof(vec3) * _capacity));
-	_data->colors = _colors = static_cast<uint32_t*>(streamfx::util::malloc_aligned(16, sizeof(uint32_t) * _capacity));
-
-	// Clear the allocated memory of any data.
-	memset(_positions, 0, sizeof(vec3) * _capacity);
-	memset(_normals, 0, sizeof(vec3) * _capacity);
-	memset(_tangents, 0, sizeof(vec3) * _capacity);
-	memset(_colors, 0, sizeof(uint32_t) * _capacity);
+	_data           = std::make_shared<decltype(_data)::element_type>();
+	_data->num      = _capacity;
+	_data->num_tex  = _layers;
+	_data->points   = _positions = static_cast<vec3*>(allocate(attributes::Position, sizeof(vec3)));
+	_data->normals  = _normals = static_cast<vec3*>(allocate(attributes::Normal, sizeof(vec3)));
+	_data->tangents = _tangents = static_cast<vec3*>(allocate(attributes::Tangent, sizeof(vec3)));
+	_data->colors   = _colors = static_cast<uint32_t*>(allocate(attributes::Color, sizeof(uint32_t)));
 
 	if (_layers == 0) {
 		_data->tvarray = nullptr;
@@ -81,6 +88,9 @@ void streamfx::obs::gs::vertex_buffer::initialize(uint32_t capacity, uint8_t lay
 	if (!_buffer) {
 		throw std::runtime_error("Failed to create vertex buffer.");
 	}
+
+	// The GPU buffer was created from the cleared memory, so the copy of what it holds starts out cleared too.
+	_uploaded.assign(get_stride() * _capacity, 0);
 }
 
 void streamfx::obs::gs::vertex_buffer::finalize()
@@ -91,12 +101,20 @@ void streamfx::obs::gs::vertex_buffer::finalize()
 	streamfx::util::free_aligned(_tangents);
 	streamfx::util::free_aligned(_colors);
 	streamfx::util::free_aligned(_uv_layers);
-	for (std::size_t n = 0; n < _layers; n++) {
+	for (std::size_t n = 0; n < MAXIMUM_UVW_LAYERS; n++) {
 		streamfx::util::free_aligned(_uvs[n]);
+		_uvs[n] = nullptr;
 	}
+	_positions = nullptr;
+	_normals   = nullptr;
+	_tangents  = nullptr;
+	_colors    = nullptr;
+	_uv_layers = nullptr;
 
 	_buffer.reset();
 	_data.reset();
+	_uploaded.clear();
+	_uploaded.shrink_to_fit();
 }
 
 streamfx::obs::gs::vertex_buffer::~vertex_buffer()
@@ -104,8 +122,8 @@ streamfx::obs::gs::vertex_buffer::~vertex_buffer()
 	finalize();
 }
 
-streamfx::obs::gs::vertex_buffer::vertex_buffer(uint32_t size, uint8_t layers)
-	: _capacity(size), _size(size), _layers(layers),
+streamfx::obs::gs::vertex_buffer::vertex_buffer(uint32_t size, uint8_t layers, attributes attribs)
+	: _capacity(size), _size(size), _layers(layers), _attributes(attribs),
 
 	  _buffer(nullptr), _data(nullptr),
 
@@ -113,11 +131,11 @@ streamfx::obs::gs::vertex_buffer::vertex_buffer(uint32_t size, uint8_t layers)
 
 	  _obs_data(nullptr)
 {
-	initialize(_size, _layers);
+	initialize(_size, _layers, _attributes);
 }
 
 streamfx::obs::gs::vertex_buffer::vertex_buffer(gs_vertbuffer_t* vb)
-	: _capacity(0), _size(0), _layers(0),
+	: _capacity(0), _size(0), _layers(0), _attributes(attributes::Position),
 
 	  _buffer(nullptr), _data(nullptr),
 
@@ -130,7 +148,15 @@ streamfx::obs::gs::vertex_buffer::vertex_buffer(gs_vertbuffer_t* vb)
 	if (!vbd)
 		throw std::runtime_error("vertex buffer with no data");
 
-	initialize(static_cast<uint32_t>(vbd->num), static_cast<uint8_t>(vbd->num_tex));
+	attributes attribs = attributes::Position;
+	if (vbd->normals)
+		attribs = attribs | attributes::Normal;
+	if (vbd->tangents)
+		attribs = attribs | attributes::Tangent;
+	if (vbd->colors)
+		attribs = attribs | attributes::Color;
+	initialize(static_cast<uint32_t>(vbd->num), static_cast<uint8_t>(vbd->num_tex), attribs);
+	_size = _capacity;
 
 	if (_positions && vbd->points)
 		memcpy(_positions, vbd->points, vbd->num * sizeof(vec3));
@@ -149,7 +175,7 @@ streamfx::obs::gs::vertex_buffer::vertex_buffer(gs_vertbuffer_t* vb)
 					for (std::size_t idx = 0; idx < _capacity; idx++) {
 						float* mem = reinterpret_cast<float*>(vbd->tvarray[n].array) + (idx * vbd->tvarray[n].width);
 						memset(&_uvs[n][idx], 0, sizeof(vec4));
-						memcpy(&_uvs[n][idx], mem, vbd->tvarray[n].width);
+						memcpy(&_uvs[n][idx], mem, sizeof(float) * vbd->tvarray[n].width);
 					}
 				}
 			}
@@ -158,12 +184,15 @@ streamfx::obs::gs::vertex_buffer::vertex_buffer(gs_vertbuffer_t* vb)
 }
 
 streamfx::obs::gs::vertex_buffer::vertex_buffer(vertex_buffer const& other)
-	: vertex_buffer(other._capacity, other._layers)
+	: vertex_buffer(other._capacity, other._layers, other._attributes)
 { // Copy Constructor
 	memcpy(_positions, other._positions, _capacity * sizeof(vec3));
-	memcpy(_normals, other._normals, _capacity * sizeof(vec3));
-	memcpy(_tangents, other._tangents, _capacity * sizeof(vec3));
-	memcpy(_colors, other._colors, _capacity * sizeof(vec3));
+	if (_normals)
+		memcpy(_normals, other._normals, _capacity * sizeof(vec3));
+	if (_tangents)
+		memcpy(_tangents, other._tangents, _capacity * sizeof(vec3));
+	if (_colors)
+		memcpy(_colors, other._colors, _capacity * sizeof(uint32_t));
 	for (std::size_t n = 0; n < other._layers; n++) {
 		memcpy(_uvs[n], other._uvs[n], _capacity * sizeof(vec4));
 	}
@@ -171,15 +200,17 @@ streamfx::obs::gs::vertex_buffer::vertex_buffer(vertex_buffer const& other)
 
 void streamfx::obs::gs::vertex_buffer::operator=(vertex_buffer const& other)
 { // Copy operator
-	initialize(other._capacity, other._layers);
+	initialize(other._capacity, other._layers, other._attributes);
 	_size = other._size;
 
 	// Copy actual data over.
 	memcpy(_positions, other._positions, other._capacity * sizeof(vec3));
-	memcpy(_normals, other._normals, other._capacity * sizeof(vec3));
-	memcpy(_tangents, other._tangents, other._capacity * sizeof(vec3));
-	memcpy(_colors, other._colors, other._capacity * sizeof(uint32_t));
-	memcpy(_uv_layers, other._uv_layers, sizeof(gs_tvertarray));
+	if (_normals)
+		memcpy(_normals, other._normals, other._capacity * sizeof(vec3));
+	if (_tangents)
+		memcpy(_tangents, other._tangents, other._capacity * sizeof(vec3));
+	if (_colors)
+		memcpy(_colors, other._colors, other._capacity * sizeof(uint32_t));
 	for (std::size_t n = 0; n < other._layers; n++) {
 		memcpy(_uvs[n], other._uvs[n], _capacity * sizeof(vec4));
 	}
@@ -187,40 +218,44 @@ void streamfx::obs::gs::vertex_buffer::operator=(vertex_buffer const& other)
 
 streamfx::obs::gs::vertex_buffer::vertex_buffer(vertex_buffer const&& other) noexcept
 { // Move Constructor
-	_capacity  = other._capacity;
-	_size      = other._size;
-	_layers    = other._layers;
-	_buffer    = other._buffer;
-	_data      = other._data;
-	_positions = other._positions;
-	_normals   = other._normals;
-	_tangents  = other._tangents;
-	_colors    = other._colors;
-	_uv_layers = other._uv_layers;
+	_capacity   = other._capacity;
+	_size       = other._size;
+	_layers     = other._layers;
+	_attributes = other._attributes;
+	_buffer     = other._buffer;
+	_data       = other._data;
+	_positions  = other._positions;
+	_normals    = other._normals;
+	_tangents   = other._tangents;
+	_colors     = other._colors;
+	_uv_layers  = other._uv_layers;
 	for (std::size_t n = 0; n < MAXIMUM_UVW_LAYERS; n++) {
 		_uvs[n] = other._uvs[n];
 	}
 	_obs_data = other._obs_data;
+	_uploaded = other._uploaded;
 }
 
 void streamfx::obs::gs::vertex_buffer::operator=(vertex_buffer const&& other)
 { // Move Assignment
 	finalize();
 
-	_capacity  = other._capacity;
-	_size      = other._size;
-	_layers    = other._layers;
-	_buffer    = other._buffer;
-	_data      = other._data;
-	_positions = other._positions;
-	_normals   = other._normals;
-	_tangents  = other._tangents;
-	_colors    = other._colors;
-	_uv_layers = other._uv_layers;
+	_capacity   = other._capacity;
+	_size       = other._size;
+	_layers     = other._layers;
+	_attributes = other._attributes;
+	_buffer     = other._buffer;
+	_data       = other._data;
+	_positions  = other._positions;
+	_normals    = other._normals;
+	_tangents   = other._tangents;
+	_colors     = other._colors;
+	_uv_layers  = other._uv_layers;
 	for (std::size_t n = 0; n < MAXIMUM_UVW_LAYERS; n++) {
 		_uvs[n] = other._uvs[n];
 	}
 	_obs_data = other._obs_data;
+	_uploaded = other._uploaded;
 }
 
 void streamfx::obs::gs::vertex_buffer::resize(uint32_t size)
@@ -228,6 +263,10 @@ void streamfx::obs::gs::vertex_buffer::resize(uint32_t size)
 	if (size > _capacity) {
 		throw std::out_of_range("size larger than capacity");
 	}
+	if (size > _size) {
+		// Vertices past the old size were never compared, so send everything once.
+		_uploaded.clear();
+	}
 	_size = size;
 }
 
@@ -252,7 +291,8 @@ const streamfx::obs::gs::vertex streamfx::obs::gs::vertex_buffer::at(uint32_t id
 		throw std::out_of_range("idx out of range");
 	}
 
-	streamfx::obs::gs::vertex vtx(&_positions[idx], &_normals[idx], &_tangents[idx], &_colors[idx], nullptr);
+	streamfx::obs::gs::vertex vtx(&_positions[idx], _normals ? &_normals[idx] : nullptr,
+								  _tangents ? &_tangents[idx] : nullptr, _colors ? &_colors[idx] : nullptr, nullptr);
 	for (std::size_t n = 0; n < _layers; n++) {
 		vtx.uv[n] = &_uvs[n][idx];
 	}
@@ -274,6 +314,11 @@ uint8_t streamfx::obs::gs::vertex_buffer::get_uv_layers()
 	return _layers;
 }
 
+streamfx::obs::gs::vertex_buffer::attributes streamfx::obs::gs::vertex_buffer::get_attributes()
+{
+	return _attributes;
+}
+
 vec3* streamfx::obs::gs::vertex_buffer::get_positions()
 {
 	return _positions;
@@ -302,12 +347,56 @@ vec4* streamfx::obs::gs::vertex_buffer::get_uv_layer(uint8_t idx)
 	return _uvs[idx];
 }
 
+std::size_t streamfx::obs::gs::vertex_buffer::get_stride()
+{
+	std::size_t stride = sizeof(vec3) + sizeof(vec4) * _layers;
+	stride += (_normals ? sizeof(vec3) : 0) + (_tangents ? sizeof(vec3) : 0) + (_colors ? sizeof(uint32_t) : 0);
+	return stride;
+}
+
 gs_vertbuffer_t* streamfx::obs::gs::vertex_buffer::update(bool refreshGPU)
 {
 	if (refreshGPU) {
-		auto gctx = streamfx::obs::gs::context();
-		gs_vertexbuffer_flush_direct(_buffer.get(), _data.get());
-		_obs_data = gs_vertexbuffer_get_data(_buffer.get());
+		// If the copy no longer matches the layout or was dropped, everything has to be sent once.
+		std::size_t size  = get_stride() * _capacity;
+		bool        force = false;
+		if (_uploaded.size() != size) {
+			force = true;
+			_uploaded.assign(size, 0);
+		}
+
+		// Only point libobs at data that differs from what it has, everything else stays nullptr and is skipped.
+		uint8_t* uploaded = _uploaded.data();
+
+		auto changed = [&uploaded, force, this](const void* data, std::size_t element) {
+			std::size_t length = element * _size;
+			bool        result = force || (memcmp(uploaded, data, length) != 0);
+			if (result) {
+				memcpy(uploaded, data, length);
+			}
+			uploaded += element * _capacity;
+			return result;
+		};
+
+		gs_vb_data flush = {};
+		flush.num        = _size;
+		flush.points     = changed(_positions, sizeof(vec3)) ? _positions : nullptr;
+		flush.normals    = (_normals && changed(_normals, sizeof(vec3))) ? _normals : nullptr;
+		flush.tangents   = (_tangents && changed(_tangents, sizeof(vec3))) ? _tangents : nullptr;
+		flush.colors     = (_colors && changed(_colors, sizeof(uint32_t))) ? _colors : nullptr;
+		for (uint8_t n = 0; n < _layers; n++) {
+			// libobs uploads uv layers in order, so everything up to the last changed one has to be sent.
+			if (changed(_uvs[n], sizeof(vec4))) {
+				flush.num_tex = static_cast<size_t>(n) + 1;
+			}
+		}
+		flush.tvarray = flush.num_tex ? _uv_layers : nullptr;
+
+		if (flush.points || flush.normals || flush.tangents || flush.colors || flush.num_tex) {
+			auto gctx = streamfx::obs::gs::context();
+			gs_vertexbuffer_flush_direct(_buffer.get(), &flush);
+			_obs_data = gs_vertexbuffer_get_data(_buffer.get());
+		}
 	}
 	return _buffer.get();
 }
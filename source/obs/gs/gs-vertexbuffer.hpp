@@ -19,14 +19,31 @@
 
 #pragma once
 #include "common.hpp"
+#include <vector>
 #include "gs-limits.hpp"
 #include "gs-vertex.hpp"
 
 namespace streamfx::obs::gs {
 	class vertex_buffer {
-		uint32_t _capacity;
-		uint32_t _size;
-		uint8_t  _layers;
+		public:
+		/*!
+		* \brief Vertex attributes to allocate storage for, in addition to the uv layers.
+		* Positions are always present. Attributes that are left out use neither CPU memory nor upload bandwidth.
+		*/
+		enum class attributes : uint8_t {
+			None     = 0,
+			Position = 1 << 0,
+			Normal   = 1 << 1,
+			Tangent  = 1 << 2,
+			Color    = 1 << 3,
+			All      = Position | Normal | Tangent | Color,
+		};
+
+		private:
+		uint32_t   _capacity;
+		uint32_t   _size;
+		uint8_t    _layers;
+		attributes _attributes;
 
 		// OBS GS Data
 		std::shared_ptr<gs_vertbuffer_t> _buffer;
@@ -43,9 +60,15 @@ namespace streamfx::obs::gs {
 		// OBS compatability
 		gs_vb_data* _obs_data;
 
-		void initialize(uint32_t capacity, uint8_t layers);
+		// Copy of the data last sent to the GPU, so that unchanged data isn't sent again.
+		std::vector<uint8_t> _uploaded;
+
+		void initialize(uint32_t capacity, uint8_t layers, attributes attribs);
 		void finalize();
 
+		// Bytes per vertex across all attributes in use.
+		std::size_t get_stride();
+
 		public:
 		virtual ~vertex_buffer();
 
@@ -67,7 +90,16 @@ namespace streamfx::obs::gs {
 		* \param vertices Number of vertices to store.
 		* \param layers Number of uv layers to store.
 		*/
-		vertex_buffer(uint32_t vertices, uint8_t layers);
+		vertex_buffer(uint32_t vertices, uint8_t layers) : vertex_buffer(vertices, layers, attributes::All) {}
+
+		/*!
+		* \brief Create a Vertex Buffer with a specific number of Vertices, uv layers and attributes.
+		*
+		* \param vertices Number of vertices to store.
+		* \param layers Number of uv layers to store.
+		* \param attribs Attributes to store, positions are always stored.
+		*/
+		vertex_buffer(uint32_t vertices, uint8_t layers, attributes attribs);
 
 		/*!
 		* \brief Create a copy of a Vertex Buffer
@@ -129,6 +161,8 @@ namespace streamfx::obs::gs {
 
 		uint8_t get_uv_layers();
 
+		attributes get_attributes();
+
 		/*!
 		* \brief Directly access the positions buffer
 		* Returns the internal memory that is assigned to hold all vertex positions.
@@ -139,7 +173,8 @@ namespace streamfx::obs::gs {
 
 		/*!
 		* \brief Directly access the normals buffer
-		* Returns the internal memory that is assigned to hold all vertex normals.
+		* Returns the internal memory that is assigned to hold all vertex normals, or nullptr if the buffer was created
+		*  without them.
 		*
 		* \return A <vec3*> that points at the first vertex's normal.
 		*/
@@ -147,7 +182,8 @@ namespace streamfx::obs::gs {
 
 		/*!
 		* \brief Directly access the tangents buffer
-		* Returns the internal memory that is assigned to hold all vertex tangents.
+		* Returns the internal memory that is assigned to hold all vertex tangents, or nullptr if the buffer was created
+		*  without them.
 		*
 		* \return A <vec3*> that points at the first vertex's tangent.
 		*/
@@ -155,7 +191,8 @@ namespace streamfx::obs::gs {
 
 		/*!
 		* \brief Directly access the colors buffer
-		* Returns the internal memory that is assigned to hold all vertex colors.
+		* Returns the internal memory that is assigned to hold all vertex colors, or nullptr if the buffer was created
+		*  without them.
 		*
 		* \return A <uint32_t*> that points at the first vertex's color.
 		*/
@@ -171,6 +208,17 @@ namespace streamfx::obs::gs {
 
 		gs_vertbuffer_t* update();
 
+		/*!
+		* \brief Retrieve the GPU vertex buffer, optionally sending changed data to it first.
+		* Only the used range of vertices and only the attributes that changed since the last upload are sent, which
+		*  keeps frequently changing small meshes cheap. Dynamic buffers are renamed by the driver on every upload, so
+		*  this never has to wait for the GPU to finish reading the previous contents.
+		*
+		* \param refreshGPU Send changed data to the GPU.
+		* \return The GPU vertex buffer.
+		*/
 		gs_vertbuffer_t* update(bool refreshGPU);
 	};
 } // namespace streamfx::obs::gs
+
+P_ENABLE_BITMASK_OPERATORS(streamfx::obs::gs::vertex_buffer::attributes)
@@ -254,7 +254,7 @@ namespace streamfx::obs {
 							bool* received_packet) noexcept
 		try {
 			if (data)
-				return reinterpret_cast<encoder_instance*>(data)->encode_video(frame, packet, received_packet);
+				return reinterpret_cast<encoder_instance*>(data)->encode(frame, packet, received_packet);
 			return false;
 		} catch (const std::exception& ex) {
 			DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
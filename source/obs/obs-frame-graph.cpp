@@ -0,0 +1,142 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2021 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "obs-frame-graph.hpp"
+#include "obs/gs/gs-helper.hpp"
+
+static std::shared_ptr<streamfx::obs::frame_graph> frame_graph_instance;
+
+namespace {
+	// Withdraws a request once the filter below has rendered, even if it threw.
+	class request_guard {
+		bool& _requested;
+
+		public:
+		request_guard(bool& requested) : _requested(requested)
+		{
+			_requested = true;
+		}
+		~request_guard()
+		{
+			_requested = false;
+		}
+	};
+
+	class blend_state_guard {
+		public:
+		blend_state_guard()
+		{
+			gs_blend_state_push();
+		}
+		~blend_state_guard()
+		{
+			gs_blend_state_pop();
+		}
+	};
+} // namespace
+
+void streamfx::obs::frame_graph::initialize()
+{
+	frame_graph_instance = std::make_shared<streamfx::obs::frame_graph>();
+}
+
+void streamfx::obs::frame_graph::finalize()
+{
+	frame_graph_instance.reset();
+}
+
+std::shared_ptr<streamfx::obs::frame_graph> streamfx::obs::frame_graph::get()
+{
+	return frame_graph_instance;
+}
+
+streamfx::obs::frame_graph::frame_graph() : _nodes(), _lock() {}
+
+streamfx::obs::frame_graph::~frame_graph() {}
+
+void streamfx::obs::frame_graph::add(obs_source_t* filter)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	_nodes.emplace(filter, std::make_shared<node>(node{false, nullptr}));
+}
+
+void streamfx::obs::frame_graph::remove(obs_source_t* filter)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	_nodes.erase(filter);
+}
+
+std::shared_ptr<streamfx::obs::gs::texture>
+	streamfx::obs::frame_graph::capture_input(obs_source_t* filter,
+											  std::shared_ptr<streamfx::obs::gs::rendertarget> rt, uint32_t width,
+											  uint32_t height)
+{
+	obs_source_t*         target = obs_filter_get_target(filter);
+	std::shared_ptr<node> producer;
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		if (auto found = _nodes.find(target); found != _nodes.end()) {
+			producer = found->second;
+		}
+	}
+	if (!target || !producer) {
+		return nullptr;
+	}
+
+	// The filter below may still decide to draw, for example if it is disabled or has nothing to work with, so a
+	// render target has to be active either way. Drawing it directly skips the private texture of libobs.
+	producer->output.reset();
+	{
+		request_guard request(producer->requested);
+		auto          op = rt->render(width, height);
+		gs_ortho(0, static_cast<float_t>(width), 0, static_cast<float_t>(height), -1., 1.);
+
+		// A target that doesn't cover every pixel would otherwise leave the previous frame behind.
+		vec4 blank = {0, 0, 0, 0};
+		gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &blank, 0., 0);
+
+		blend_state_guard blend_state;
+		gs_reset_blend_state();
+		gs_enable_blending(false);
+		gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+		gs_enable_color(true, true, true, true);
+		gs_enable_depth_test(false);
+		gs_enable_stencil_test(false);
+		gs_set_cull_mode(GS_NEITHER);
+
+		obs_source_video_render(target);
+	}
+
+	if (producer->output) {
+		return std::move(producer->output);
+	}
+	return rt->get_texture();
+}
+
+bool streamfx::obs::frame_graph::publish(obs_source_t* filter, std::shared_ptr<streamfx::obs::gs::texture> texture)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	auto                         found = _nodes.find(filter);
+	if ((found == _nodes.end()) || !found->second->requested) {
+		return false;
+	}
+
+	found->second->output = std::move(texture);
+	return true;
+}
@@ -0,0 +1,81 @@
+/*
+ * Modern effects for a modern Streamer
+ * Copyright (C) 2021 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include "common.hpp"
+#include <map>
+#include <mutex>
+#include "obs/gs/gs-rendertarget.hpp"
+#include "obs/gs/gs-texture.hpp"
+
+namespace streamfx::obs {
+	/** Links consecutive StreamFX filters on a source, so that their intermediate results aren't copied around.
+	 *
+	 * Normally a filter captures its input through obs_source_process_filter_begin/end, which has libobs render the
+	 * filter below into a private texture, only to draw that texture again into the filter's own cache. When the
+	 * filter below is a StreamFX filter, it already holds its result in a texture, so the filter above can take that
+	 * texture as its input instead. Filters that can hand over their result register themselves with add(), consumers
+	 * capture their input with capture_input() and producers check publish() before drawing their result.
+	 *
+	 * This is deliberately only a hand-over between adjacent filters, not a render graph. Filters don't declare their
+	 * passes, nothing is fused, and the transient render targets inside a filter are shared through
+	 * gs::rendertarget_pool instead of being aliased here. What it saves is the copy of each intermediate result into
+	 * the next filter's cache, so a chain like Color Grade, Blur and SDF Effects copies its input only once.
+	 */
+	class frame_graph {
+		struct node {
+			bool                                        requested;
+			std::shared_ptr<streamfx::obs::gs::texture> output;
+		};
+
+		std::map<obs_source_t*, std::shared_ptr<node>> _nodes;
+		std::mutex                                     _lock;
+
+		public: // Singleton
+		static void                                        initialize();
+		static void                                        finalize();
+		static std::shared_ptr<streamfx::obs::frame_graph> get();
+
+		public:
+		frame_graph();
+		~frame_graph();
+
+		public:
+		/// Register a filter which is able to hand over its result with publish().
+		void add(obs_source_t* filter);
+
+		void remove(obs_source_t* filter);
+
+		/** Capture the input of a filter, skipping redundant copies if the filter below is registered.
+		 *
+		 * Returns nullptr if the filter below isn't registered, in which case the input has to be captured through
+		 * obs_source_process_filter_begin/end as usual. Otherwise returns either the result of the filter below, or the
+		 * content of the given render target if that filter decided to draw instead.
+		 */
+		std::shared_ptr<streamfx::obs::gs::texture>
+			capture_input(obs_source_t* filter, std::shared_ptr<streamfx::obs::gs::rendertarget> rt, uint32_t width,
+						  uint32_t height);
+
+		/** Hand over the result of a filter to the filter above it.
+		 *
+		 * Returns true if the filter above asked for it, in which case the result must not be drawn.
+		 */
+		bool publish(obs_source_t* filter, std::shared_ptr<streamfx::obs::gs::texture> texture);
+	};
+} // namespace streamfx::obs
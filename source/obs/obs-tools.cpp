@@ -19,6 +19,7 @@
 
 #include "obs-tools.hpp"
 #include <map>
+#include <set>
 #include <stdexcept>
 #include "plugin.hpp"
 
@@ -82,6 +83,89 @@ bool streamfx::obs::tools::scene_contains_source(obs_scene_t* scene, obs_source_
 	return sd.found;
 }
 
+struct spt_searchdata {
+	obs_source_t*           source;
+	matrix4                 parent;
+	matrix4                 transform;
+	bool                    found = false;
+	std::set<obs_source_t*> visited;
+};
+
+static bool spt_enum_items_cb(obs_scene_t*, obs_sceneitem_t* item, void* searchdata) noexcept
+try {
+	spt_searchdata& sd = *reinterpret_cast<spt_searchdata*>(searchdata);
+	if (!obs_sceneitem_visible(item)) {
+		return true;
+	}
+
+	// The draw transform maps the cropped source onto the parent, so remove the crop first.
+	obs_sceneitem_crop crop;
+	obs_sceneitem_get_crop(item, &crop);
+	matrix4 uncrop;
+	matrix4_identity(&uncrop);
+	uncrop.t.x = -static_cast<float>(crop.left);
+	uncrop.t.y = -static_cast<float>(crop.top);
+
+	matrix4 draw, local, global;
+	obs_sceneitem_get_draw_transform(item, &draw);
+	matrix4_mul(&local, &uncrop, &draw);
+	matrix4_mul(&global, &local, &sd.parent);
+
+	obs_source_t* source = obs_sceneitem_get_source(item);
+	if (source == sd.source) {
+		sd.transform = global;
+		sd.found     = true;
+		return false;
+	}
+
+	// Items of groups and nested scenes are positioned relative to the group or scene.
+	obs_scene_t* nested = obs_scene_from_source(source);
+	if (!nested) {
+		nested = obs_group_from_source(source);
+	}
+	if (nested && sd.visited.insert(source).second) {
+		matrix4 parent = sd.parent;
+		sd.parent      = global;
+		obs_scene_enum_items(nested, spt_enum_items_cb, &sd);
+		sd.parent = parent;
+	}
+	return !sd.found;
+} catch (...) {
+	DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+	return false;
+}
+
+bool streamfx::obs::tools::source_program_transform(obs_source_t* source, matrix4& transform)
+{
+	// The program is usually shown through a transition, which knows what it is currently showing.
+	std::shared_ptr<obs_source_t> program{obs_get_output_source(0), obs_source_deleter};
+	if (program && (obs_source_get_type(program.get()) == OBS_SOURCE_TYPE_TRANSITION)) {
+		program = {obs_transition_get_active_source(program.get()), obs_source_deleter};
+	}
+	if (!program) {
+		return false;
+	}
+
+	if (program.get() == source) {
+		matrix4_identity(&transform);
+		return true;
+	}
+
+	obs_scene_t* scene = obs_scene_from_source(program.get());
+	if (!scene) {
+		return false;
+	}
+
+	spt_searchdata sd;
+	sd.source = source;
+	matrix4_identity(&sd.parent);
+	obs_scene_enum_items(scene, spt_enum_items_cb, &sd);
+	if (sd.found) {
+		transform = sd.transform;
+	}
+	return sd.found;
+}
+
 extern "C" {
 struct _hack_obs_properties;
 
@@ -24,6 +24,14 @@ namespace streamfx::obs {
 	namespace tools {
 		bool scene_contains_source(obs_scene_t* scene, obs_source_t* source);
 
+		/** Find where the program output shows a source, as a transform from its pixels to pixels of the canvas.
+		 *
+		 * Follows nested scenes and groups, and uses the first visible scene item that shows the source.
+		 *
+		 * @return false if the program output does not show the source.
+		 */
+		bool source_program_transform(obs_source_t* source, matrix4& transform);
+
 		bool obs_properties_remove_by_name(obs_properties_t* props, const char* name);
 
 		class child_source {
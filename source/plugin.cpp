@@ -21,7 +21,10 @@
 #include <fstream>
 #include <stdexcept>
 #include "configuration.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
+#include "obs/gs/gs-texture-cache.hpp"
 #include "obs/gs/gs-vertexbuffer.hpp"
+#include "obs/obs-frame-graph.hpp"
 #include "obs/obs-source-tracker.hpp"
 
 #ifdef ENABLE_NVIDIA_CUDA
@@ -102,6 +105,9 @@ try {
 	// Initialize Source Tracker
 	streamfx::obs::source_tracker::initialize();
 
+	// Initialize Frame Graph
+	streamfx::obs::frame_graph::initialize();
+
 #ifdef ENABLE_NVIDIA_CUDA
 	// Initialize CUDA if features requested it.
 	std::shared_ptr<::streamfx::nvidia::cuda::obs> cuda;
@@ -114,6 +120,9 @@ try {
 
 	// GS Stuff
 	{
+		streamfx::obs::gs::rendertarget_pool::initialize();
+		streamfx::obs::gs::texture_cache::initialize();
+
 		_gs_fstri_vb = std::make_shared<streamfx::obs::gs::vertex_buffer>(uint32_t(3), uint8_t(1));
 		{
 			auto vtx = _gs_fstri_vb->at(0);
@@ -283,8 +292,13 @@ try {
 	// GS Stuff
 	{
 		_gs_fstri_vb.reset();
+		streamfx::obs::gs::texture_cache::finalize();
+		streamfx::obs::gs::rendertarget_pool::finalize();
 	}
 
+	// Finalize Frame Graph
+	streamfx::obs::frame_graph::finalize();
+
 	// Finalize Source Tracker
 	streamfx::obs::source_tracker::finalize();
 
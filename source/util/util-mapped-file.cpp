@@ -0,0 +1,173 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "util-mapped-file.hpp"
+#include <stdexcept>
+#include "util-platform.hpp"
+
+#if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__) // Windows
+#define ST_WINDOWS
+#else
+#define ST_UNIX
+#endif
+
+#if defined(ST_WINDOWS)
+#include <Windows.h>
+#elif defined(ST_UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+streamfx::util::mapped_file::mapped_file(std::filesystem::path file, size_t size)
+	: _path(file), _size(size), _data(nullptr)
+{
+#if defined(ST_WINDOWS)
+	_mapping = nullptr;
+	file     = ::streamfx::util::platform::utf8_to_native(file);
+	_file    = CreateFileW(file.wstring().c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+						CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (_file == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("Failed to create file.");
+	}
+#elif defined(ST_UNIX)
+	_file = open(file.u8string().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (_file == -1) {
+		throw std::runtime_error("Failed to create file.");
+	}
+#endif
+
+	try {
+		resize(size);
+	} catch (...) {
+#if defined(ST_WINDOWS)
+		CloseHandle(_file);
+#elif defined(ST_UNIX)
+		close(_file);
+#endif
+		throw;
+	}
+}
+
+streamfx::util::mapped_file::~mapped_file()
+{
+	unmap();
+#if defined(ST_WINDOWS)
+	CloseHandle(_file);
+#elif defined(ST_UNIX)
+	close(_file);
+#endif
+}
+
+std::filesystem::path streamfx::util::mapped_file::path()
+{
+	return _path;
+}
+
+void* streamfx::util::mapped_file::data()
+{
+	return _data;
+}
+
+size_t streamfx::util::mapped_file::size()
+{
+	return _size;
+}
+
+void streamfx::util::mapped_file::resize(size_t size)
+{
+	unmap();
+
+	// Change the size of the file on disk, then map the entire file again.
+#if defined(ST_WINDOWS)
+	LARGE_INTEGER position;
+	position.QuadPart = static_cast<LONGLONG>(size);
+	if (!SetFilePointerEx(_file, position, nullptr, FILE_BEGIN) || !SetEndOfFile(_file)) {
+		throw std::runtime_error("Failed to resize file.");
+	}
+#elif defined(ST_UNIX)
+	if (ftruncate(_file, static_cast<off_t>(size)) != 0) {
+		throw std::runtime_error("Failed to resize file.");
+	}
+#endif
+	_size = size;
+
+	map();
+}
+
+void streamfx::util::mapped_file::flush()
+{
+	if (!_data) {
+		return;
+	}
+
+#if defined(ST_WINDOWS)
+	FlushViewOfFile(_data, _size);
+#elif defined(ST_UNIX)
+	msync(_data, _size, MS_ASYNC);
+#endif
+}
+
+void streamfx::util::mapped_file::map()
+{
+	// Empty files can't be mapped.
+	if (_size == 0) {
+		return;
+	}
+
+#if defined(ST_WINDOWS)
+	_mapping = CreateFileMappingW(_file, nullptr, PAGE_READWRITE, static_cast<DWORD>(uint64_t(_size) >> 32),
+								  static_cast<DWORD>(_size & 0xFFFFFFFF), nullptr);
+	if (!_mapping) {
+		throw std::runtime_error("Failed to create file mapping.");
+	}
+
+	_data = MapViewOfFile(_mapping, FILE_MAP_ALL_ACCESS, 0, 0, _size);
+	if (!_data) {
+		CloseHandle(_mapping);
+		_mapping = nullptr;
+		throw std::runtime_error("Failed to map file.");
+	}
+#elif defined(ST_UNIX)
+	_data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _file, 0);
+	if (_data == MAP_FAILED) {
+		_data = nullptr;
+		throw std::runtime_error("Failed to map file.");
+	}
+#endif
+}
+
+void streamfx::util::mapped_file::unmap()
+{
+#if defined(ST_WINDOWS)
+	if (_data) {
+		UnmapViewOfFile(_data);
+	}
+	if (_mapping) {
+		CloseHandle(_mapping);
+		_mapping = nullptr;
+	}
+#elif defined(ST_UNIX)
+	if (_data) {
+		munmap(_data, _size);
+	}
+#endif
+	_data = nullptr;
+}
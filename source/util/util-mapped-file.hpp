@@ -0,0 +1,66 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <cstddef>
+#include <filesystem>
+
+namespace streamfx::util {
+	/** Read-write memory mapping of a file on disk.
+	 *
+	 * The file is created (or truncated) on construction, and the mapping always spans the entire file. Growing or
+	 * shrinking the file through resize() invalidates any pointer previously returned by data().
+	 */
+	class mapped_file {
+		std::filesystem::path _path;
+		size_t                _size;
+		void*                 _data;
+
+#if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__)
+		void* _file;
+		void* _mapping;
+#else
+		int _file;
+#endif
+
+		public:
+		mapped_file(std::filesystem::path file, size_t size);
+		~mapped_file();
+
+		// Copying a mapping makes no sense.
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		std::filesystem::path path();
+
+		void* data();
+
+		size_t size();
+
+		void resize(size_t size);
+
+		void flush();
+
+		private:
+		void map();
+
+		void unmap();
+	};
+} // namespace streamfx::util
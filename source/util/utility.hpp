@@ -19,7 +19,9 @@
 
 #pragma once
 #include <cinttypes>
+#include <cmath>
 #include <cstddef>
+#include <limits>
 #include <string>
 #include <type_traits>
 #include <vector>
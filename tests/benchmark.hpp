@@ -0,0 +1,133 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace streamfx::tests::benchmark {
+	/** Parse '--iterations <n>' from the command line.
+	 *
+	 * 'ctest' runs every benchmark with a small iteration count, so that they are at least known to work.
+	 */
+	inline std::size_t iterations(int argc, const char* argv[], std::size_t fallback)
+	{
+		for (int idx = 1; (idx + 1) < argc; idx++) {
+			if (std::strcmp(argv[idx], "--iterations") == 0) {
+				return std::max<std::size_t>(std::strtoull(argv[idx + 1], nullptr, 10), 1);
+			}
+		}
+		return fallback;
+	}
+
+	/// Collects per-iteration timings in nanoseconds.
+	class samples {
+		std::vector<double> _values;
+
+		public:
+		void add(double value)
+		{
+			_values.push_back(value);
+		}
+
+		template<typename Rep, typename Period>
+		void add(std::chrono::duration<Rep, Period> value)
+		{
+			add(std::chrono::duration<double, std::nano>(value).count());
+		}
+
+		std::size_t size() const
+		{
+			return _values.size();
+		}
+
+		double total() const
+		{
+			double sum = 0;
+			for (double value : _values) {
+				sum += value;
+			}
+			return sum;
+		}
+
+		double mean() const
+		{
+			return _values.empty() ? 0. : total() / static_cast<double>(_values.size());
+		}
+
+		/// Nearest-rank percentile, 'p' in [0, 100].
+		double percentile(double p) const
+		{
+			if (_values.empty()) {
+				return 0.;
+			}
+
+			std::vector<double> sorted = _values;
+			std::sort(sorted.begin(), sorted.end());
+			std::size_t rank = static_cast<std::size_t>((p / 100.) * static_cast<double>(sorted.size() - 1) + .5);
+			return sorted[std::min(rank, sorted.size() - 1)];
+		}
+	};
+
+	/// Measures wall and process CPU time, the latter including all threads of the process.
+	class stopwatch {
+		std::chrono::high_resolution_clock::time_point _wall;
+		std::clock_t                                   _cpu;
+
+		public:
+		stopwatch() : _wall(std::chrono::high_resolution_clock::now()), _cpu(std::clock()) {}
+
+		double wall_ns() const
+		{
+			return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - _wall).count();
+		}
+
+		double cpu_ns() const
+		{
+			return static_cast<double>(std::clock() - _cpu) * (1e9 / static_cast<double>(CLOCKS_PER_SEC));
+		}
+	};
+
+	/** Print one result line.
+	 *
+	 * @param items Number of items (frames, packets, ...) processed in 'wall_ns', reported as a rate per second.
+	 * @param bytes Number of bytes processed in 'wall_ns', reported as throughput if not zero.
+	 */
+	inline void report(const std::string& name, const samples& latency, double wall_ns, double cpu_ns,
+					   std::size_t items, std::size_t bytes = 0)
+	{
+		double seconds = wall_ns / 1e9;
+		std::printf("%-48s %10.1f/s  p50 %10.1f us  p95 %10.1f us  p99 %10.1f us  max %10.1f us  cpu %6.1f%%",
+					name.c_str(), static_cast<double>(items) / seconds, latency.percentile(50) / 1e3,
+					latency.percentile(95) / 1e3, latency.percentile(99) / 1e3, latency.percentile(100) / 1e3,
+					(cpu_ns / wall_ns) * 100.);
+		if (bytes != 0) {
+			std::printf("  %9.1f MiB/s", static_cast<double>(bytes) / seconds / (1024. * 1024.));
+		}
+		std::printf("\n");
+	}
+} // namespace streamfx::tests::benchmark
@@ -0,0 +1,188 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Scans large synthetic IDR packets the way the encoders do on every packet, and compares the start code search to
+// the plain byte loop it replaced.
+
+#include "benchmark.hpp"
+#include <functional>
+#include <random>
+#include "encoders/codecs/av1.hpp"
+#include "encoders/codecs/bitstream.hpp"
+#include "encoders/codecs/h264.hpp"
+#include "encoders/codecs/hevc.hpp"
+
+using namespace streamfx::encoder::codec;
+using namespace streamfx::tests;
+
+namespace {
+	// Random slice data with emulation prevention applied, so it never contains a start code.
+	void append_payload(std::vector<uint8_t>& data, std::mt19937& rng, size_t size)
+	{
+		size_t zeros = 0;
+		for (size_t idx = 0; idx < size; idx++) {
+			// Zero bytes are far more common in real slices than in uniformly random data.
+			uint8_t byte = (rng() % 8 == 0) ? 0x00 : static_cast<uint8_t>(rng());
+			if ((zeros >= 2) && (byte <= 0x03)) {
+				data.push_back(0x03);
+				zeros = 0;
+			}
+			data.push_back(byte);
+			zeros = (byte == 0x00) ? zeros + 1 : 0;
+		}
+		if (data.back() == 0x00) {
+			data.push_back(0x80); // rbsp_stop_one_bit
+		}
+	}
+
+	std::vector<uint8_t> make_annexb(bool hevc, size_t size, size_t slices)
+	{
+		std::mt19937         rng(size);
+		std::vector<uint8_t> data;
+		auto                 nal = [&](std::vector<uint8_t> header, size_t payload) {
+			data.insert(data.end(), {0x00, 0x00, 0x00, 0x01});
+			data.insert(data.end(), header.begin(), header.end());
+			append_payload(data, rng, payload);
+		};
+
+		if (hevc) {
+			nal({0x46, 0x01}, 1);   // AUD
+			nal({0x40, 0x01}, 20);  // VPS
+			nal({0x42, 0x01}, 40);  // SPS
+			nal({0x44, 0x01}, 8);   // PPS
+			nal({0x4E, 0x01}, 600); // Prefix SEI
+			for (size_t idx = 0; idx < slices; idx++) {
+				nal({0x26, 0x01}, size / slices); // IDR_W_RADL
+			}
+		} else {
+			nal({0x09}, 1);   // AUD
+			nal({0x67}, 40);  // SPS
+			nal({0x68}, 8);   // PPS
+			nal({0x06}, 600); // SEI
+			for (size_t idx = 0; idx < slices; idx++) {
+				nal({0x65}, size / slices); // IDR
+			}
+		}
+		return data;
+	}
+
+	std::vector<uint8_t> make_av1(size_t size)
+	{
+		std::mt19937         rng(size);
+		std::vector<uint8_t> data = {
+			0x12, 0x00,                                                       // Temporal Delimiter
+			0x0A, 0x09, 0x00, 0x00, 0x00, 0x01, 0x9F, 0xF8, 0x04, 0xF0, 0x00, // Sequence Header
+		};
+
+		// Frame OBU, Key Frame with show_frame set.
+		data.push_back(0x32);
+		for (size_t value = size; value > 0; value >>= 7) {
+			data.push_back(static_cast<uint8_t>((value & 0x7F) | ((value > 0x7F) ? 0x80 : 0x00)));
+		}
+		data.push_back(0x10);
+		for (size_t idx = 1; idx < size; idx++) {
+			data.push_back(static_cast<uint8_t>(rng()));
+		}
+		return data;
+	}
+
+	size_t find_all_reference(const std::vector<uint8_t>& data)
+	{
+		size_t count = 0;
+		for (size_t idx = 0; (idx + 3) <= data.size(); idx++) {
+			if ((data[idx] == 0x00) && (data[idx + 1] == 0x00) && (data[idx + 2] == 0x01)) {
+				count++;
+			}
+		}
+		return count;
+	}
+
+	size_t find_all(const std::vector<uint8_t>& data)
+	{
+		size_t         count = 0;
+		const uint8_t* end   = data.data() + data.size();
+		for (const uint8_t* ptr = bitstream::find_start_code(data.data(), end); ptr < end;
+			 ptr                = bitstream::find_start_code(ptr + 3, end)) {
+			count++;
+		}
+		return count;
+	}
+
+	volatile size_t sink;
+
+	void run(const std::string& name, const std::vector<uint8_t>& data, size_t iterations,
+			 const std::function<size_t()>& function)
+	{
+		benchmark::samples   latency;
+		benchmark::stopwatch total;
+		for (size_t idx = 0; idx < iterations; idx++) {
+			benchmark::stopwatch sw;
+			sink = function();
+			latency.add(sw.wall_ns());
+		}
+		benchmark::report(name, latency, total.wall_ns(), total.cpu_ns(), iterations, data.size() * iterations);
+	}
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+	size_t iterations = benchmark::iterations(argc, argv, 200);
+
+	for (size_t size : {size_t(256) << 10, size_t(4) << 20}) {
+		std::string suffix = " (" + std::to_string(size >> 10) + " KiB)";
+		auto        h264   = make_annexb(false, size, 4);
+		auto        hevc   = make_annexb(true, size, 4);
+		auto        av1    = make_av1(size);
+
+		if (find_all(h264) != find_all_reference(h264)) {
+			std::fprintf(stderr, "find_start_code disagrees with the reference.\n");
+			return 1;
+		}
+
+		run("byte loop" + suffix, h264, iterations, [&]() { return find_all_reference(h264); });
+		run("find_start_code" + suffix, h264, iterations, [&]() { return find_all(h264); });
+		run("h264::extract_header_sei" + suffix, h264, iterations, [&]() {
+			std::vector<uint8_t> header, sei;
+			h264::extract_header_sei(h264.data(), h264.size(), header, sei);
+			return header.size() + sei.size();
+		});
+		run("h264::get_packet_priority" + suffix, h264, iterations,
+			[&]() { return static_cast<size_t>(h264::get_packet_priority(h264.data(), h264.size())); });
+		run("hevc::extract_header_sei" + suffix, hevc, iterations, [&]() {
+			std::vector<uint8_t> header, sei;
+			hevc::extract_header_sei(hevc.data(), hevc.size(), header, sei);
+			return header.size() + sei.size();
+		});
+		run("hevc::get_packet_priority" + suffix, hevc, iterations, [&]() {
+			uint8_t max_temporal_id = 0;
+			return static_cast<size_t>(hevc::get_packet_priority(hevc.data(), hevc.size(), max_temporal_id));
+		});
+		run("av1::extract_sequence_header" + suffix, av1, iterations, [&]() {
+			std::vector<uint8_t> header;
+			return static_cast<size_t>(av1::extract_sequence_header(av1.data(), av1.size(), header));
+		});
+		run("av1::get_packet_priority" + suffix, av1, iterations, [&]() {
+			av1::sequence_header header;
+			return static_cast<size_t>(av1::get_packet_priority(av1.data(), av1.size(), header));
+		});
+	}
+
+	return 0;
+}
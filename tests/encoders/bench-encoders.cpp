@@ -0,0 +1,602 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The encoders themselves, created and driven through the libobs stand-in the way OBS Studio would: settings go in
+// through obs_data_t, frames through the 'encode' callback, in the format that 'get_video_info' and 'get_audio_info'
+// ask for. Reports the rate, the time spent in each call, the CPU time and how many frames packets lag behind, for
+// each codec and set of settings. Only needs a CPU: libx264, ProRes, libaom, AAC and Opus.
+//
+// Video is a synthetic moving pattern at 1080p60, or the first frames of a Y4M file given with '--input <file>'.
+// Encoders that aren't available, because FFmpeg was built without them or libaom isn't installed, are skipped.
+
+#include "benchmark.hpp"
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include "shim.hpp"
+
+#ifdef ST_BENCH_FFMPEG
+#include "encoders/codecs/prores.hpp"
+#include "encoders/encoder-ffmpeg.hpp"
+#endif
+
+#ifdef ST_BENCH_AOM
+#include "encoders/encoder-aom-av1.hpp"
+#endif
+
+using namespace streamfx;
+using namespace streamfx::tests;
+
+namespace {
+	/// One frame in any of the planar formats libobs hands to encoders.
+	struct image {
+		video_format         format = VIDEO_FORMAT_NONE;
+		uint32_t             width  = 0;
+		uint32_t             height = 0;
+		std::vector<uint8_t> planes[MAX_AV_PLANES];
+		uint32_t             linesize[MAX_AV_PLANES] = {};
+	};
+
+	/// Where a component lives in a format: plane, offset and step within a row, and chroma subsampling.
+	struct component {
+		int      plane;
+		uint32_t offset;
+		uint32_t step;
+		uint32_t shift_x;
+		uint32_t shift_y;
+	};
+
+	/// Y, U, V and A of a format, or false if it isn't one that is supported here.
+	bool components(video_format format, component (&out)[4], std::size_t& count)
+	{
+		switch (format) {
+		case VIDEO_FORMAT_Y800:
+			out[0] = {0, 0, 1, 0, 0};
+			count  = 1;
+			return true;
+		case VIDEO_FORMAT_I420:
+		case VIDEO_FORMAT_I40A:
+			out[0] = {0, 0, 1, 0, 0};
+			out[1] = {1, 0, 1, 1, 1};
+			out[2] = {2, 0, 1, 1, 1};
+			out[3] = {3, 0, 1, 0, 0};
+			count  = (format == VIDEO_FORMAT_I40A) ? 4 : 3;
+			return true;
+		case VIDEO_FORMAT_NV12:
+			out[0] = {0, 0, 1, 0, 0};
+			out[1] = {1, 0, 2, 1, 1};
+			out[2] = {1, 1, 2, 1, 1};
+			count  = 3;
+			return true;
+		case VIDEO_FORMAT_I422:
+		case VIDEO_FORMAT_I42A:
+			out[0] = {0, 0, 1, 0, 0};
+			out[1] = {1, 0, 1, 1, 0};
+			out[2] = {2, 0, 1, 1, 0};
+			out[3] = {3, 0, 1, 0, 0};
+			count  = (format == VIDEO_FORMAT_I42A) ? 4 : 3;
+			return true;
+		case VIDEO_FORMAT_I444:
+		case VIDEO_FORMAT_YUVA:
+			out[0] = {0, 0, 1, 0, 0};
+			out[1] = {1, 0, 1, 0, 0};
+			out[2] = {2, 0, 1, 0, 0};
+			out[3] = {3, 0, 1, 0, 0};
+			count  = (format == VIDEO_FORMAT_YUVA) ? 4 : 3;
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	image make_image(video_format format, uint32_t width, uint32_t height)
+	{
+		component   comps[4];
+		std::size_t count = 0;
+		if (!components(format, comps, count)) {
+			throw std::runtime_error("Unsupported video format.");
+		}
+
+		image img;
+		img.format = format;
+		img.width  = width;
+		img.height = height;
+		for (std::size_t idx = 0; idx < count; idx++) {
+			auto&    comp   = comps[idx];
+			uint32_t stride = ((width + (1u << comp.shift_x) - 1) >> comp.shift_x) * comp.step;
+			uint32_t rows   = (height + (1u << comp.shift_y) - 1) >> comp.shift_y;
+			img.linesize[comp.plane] = (stride + 31) & ~31u;
+			img.planes[comp.plane].resize(static_cast<std::size_t>(img.linesize[comp.plane]) * rows);
+		}
+		return img;
+	}
+
+	/// Nearest neighbour conversion between planar formats, standing in for the conversion libobs does. Alpha is
+	/// opaque if the source has none.
+	image convert(const image& source, video_format format)
+	{
+		image       target = make_image(format, source.width, source.height);
+		component   src[4], dst[4];
+		std::size_t src_count = 0, dst_count = 0;
+		components(source.format, src, src_count);
+		components(format, dst, dst_count);
+
+		for (std::size_t idx = 0; idx < dst_count; idx++) {
+			auto&    to     = dst[idx];
+			uint32_t width  = (target.width + (1u << to.shift_x) - 1) >> to.shift_x;
+			uint32_t height = (target.height + (1u << to.shift_y) - 1) >> to.shift_y;
+			for (uint32_t y = 0; y < height; y++) {
+				uint8_t* out = target.planes[to.plane].data() + static_cast<std::size_t>(y) * target.linesize[to.plane];
+				if (idx >= src_count) {
+					uint8_t fill = (idx == 3) ? 255 : 128;
+					for (uint32_t x = 0; x < width; x++) {
+						out[to.offset + x * to.step] = fill;
+					}
+					continue;
+				}
+
+				auto&          from = src[idx];
+				uint32_t       sy   = std::min((y << to.shift_y) >> from.shift_y, (source.height - 1) >> from.shift_y);
+				const uint8_t* in   = source.planes[from.plane].data()
+									+ static_cast<std::size_t>(sy) * source.linesize[from.plane];
+				for (uint32_t x = 0; x < width; x++) {
+					uint32_t sx = std::min((x << to.shift_x) >> from.shift_x, (source.width - 1) >> from.shift_x);
+					out[to.offset + x * to.step] = in[from.offset + sx * from.step];
+				}
+			}
+		}
+		return target;
+	}
+
+	/// A gradient with a box moving across it, roughly like a scrolling screen capture.
+	image make_pattern(uint32_t width, uint32_t height, std::size_t index)
+	{
+		image    img    = make_image(VIDEO_FORMAT_YUVA, width, height);
+		uint32_t box_x  = static_cast<uint32_t>((index * 16) % width);
+		uint32_t box_y  = static_cast<uint32_t>((index * 9) % height);
+		uint32_t box_sz = std::max(height / 4, 1u);
+		for (uint32_t y = 0; y < height; y++) {
+			for (uint32_t x = 0; x < width; x++) {
+				bool        in_box = ((x - box_x) < box_sz) && ((y - box_y) < box_sz);
+				std::size_t at     = static_cast<std::size_t>(y) * img.linesize[0] + x;
+				img.planes[0][at]  = in_box ? 235 : static_cast<uint8_t>((x + y + index * 4) & 0xFF);
+				img.planes[1][at]  = in_box ? 90 : static_cast<uint8_t>(((x >> 3) + index) & 0xFF);
+				img.planes[2][at]  = in_box ? 240 : static_cast<uint8_t>(((y >> 3) + index * 2) & 0xFF);
+				img.planes[3][at]  = static_cast<uint8_t>(255 - ((x >> 4) & 0x3F));
+			}
+		}
+		return img;
+	}
+
+	struct input {
+		uint32_t           width   = 1920;
+		uint32_t           height  = 1080;
+		uint32_t           fps_num = 60;
+		uint32_t           fps_den = 1;
+		std::vector<image> frames;
+	};
+
+	/// Read up to 'limit' frames of an 8-bit 4:2:0, 4:2:2, 4:4:4 or monochrome Y4M file.
+	input read_y4m(const char* path, std::size_t limit)
+	{
+		std::ifstream file(path, std::ios::binary);
+		std::string   header;
+		if (!std::getline(file, header) || (header.compare(0, 10, "YUV4MPEG2 ") != 0)) {
+			throw std::runtime_error("Not a Y4M file.");
+		}
+
+		input        in;
+		video_format format = VIDEO_FORMAT_I420;
+		std::size_t  pos    = 9;
+		while (pos < header.size()) {
+			std::size_t end = header.find(' ', pos + 1);
+			std::string tag = header.substr(pos + 1, end - pos - 1);
+			pos             = end;
+			if (tag.empty()) {
+				continue;
+			}
+			switch (tag[0]) {
+			case 'W':
+				in.width = static_cast<uint32_t>(std::stoul(tag.substr(1)));
+				break;
+			case 'H':
+				in.height = static_cast<uint32_t>(std::stoul(tag.substr(1)));
+				break;
+			case 'F':
+				in.fps_num = static_cast<uint32_t>(std::stoul(tag.substr(1)));
+				in.fps_den = static_cast<uint32_t>(std::stoul(tag.substr(tag.find(':') + 1)));
+				break;
+			case 'C':
+				if (tag.compare(1, 3, "420") == 0) {
+					format = VIDEO_FORMAT_I420;
+				} else if (tag == "C422") {
+					format = VIDEO_FORMAT_I422;
+				} else if (tag == "C444") {
+					format = VIDEO_FORMAT_I444;
+				} else if (tag == "Cmono") {
+					format = VIDEO_FORMAT_Y800;
+				} else {
+					throw std::runtime_error("Only 8-bit Y4M files are supported.");
+				}
+				break;
+			}
+		}
+
+		component   comps[4];
+		std::size_t count = 0;
+		components(format, comps, count);
+		while (in.frames.size() < limit) {
+			std::string marker;
+			if (!std::getline(file, marker) || (marker.compare(0, 5, "FRAME") != 0)) {
+				break;
+			}
+
+			image img = make_image(format, in.width, in.height);
+			for (std::size_t idx = 0; idx < count; idx++) {
+				auto&    comp  = comps[idx];
+				uint32_t width = (in.width + (1u << comp.shift_x) - 1) >> comp.shift_x;
+				uint32_t rows  = (in.height + (1u << comp.shift_y) - 1) >> comp.shift_y;
+				for (uint32_t y = 0; y < rows; y++) {
+					file.read(reinterpret_cast<char*>(img.planes[comp.plane].data())
+								  + static_cast<std::size_t>(y) * img.linesize[comp.plane],
+							  width);
+				}
+			}
+			if (!file) {
+				break;
+			}
+			in.frames.push_back(std::move(img));
+		}
+		if (in.frames.empty()) {
+			throw std::runtime_error("Y4M file contains no frames.");
+		}
+		return in;
+	}
+
+	struct video_case {
+		const char*                       id;
+		const char*                       name;
+		video_format                      format; // Of the video output, as set in OBS Studio.
+		std::function<void(obs_data_t*)> setup;
+	};
+
+	struct audio_case {
+		const char*                       id;
+		const char*                       name;
+		std::function<void(obs_data_t*)> setup;
+	};
+
+	/// Create the encoder, or print why not and return nullptr.
+	obs_encoder_t* create(const char* id, const char* name, const std::function<void(obs_data_t*)>& setup,
+						  video_t* video, audio_t* audio)
+	{
+		auto types = shim::encoder_types();
+		if (std::find(types.begin(), types.end(), id) == types.end()) {
+			std::printf("%-48s skipped, '%s' is not available\n", name, id);
+			return nullptr;
+		}
+
+		obs_data_t* settings = obs_data_create();
+		setup(settings);
+		obs_encoder_t* encoder = shim::create_encoder(id, settings, video, audio);
+		obs_data_release(settings);
+		if (!encoder) {
+			std::printf("%-48s failed, '%s' refused the settings\n", name, id);
+		}
+		return encoder;
+	}
+
+	/// Encode 'iterations' frames and report the rate, the time per call and how far packets lag behind.
+	/// @return false if the encoder failed.
+	bool encode(const video_case& test, const input& in, std::size_t iterations)
+	{
+		video_output_info ovi = {};
+		ovi.name              = test.name;
+		ovi.format            = test.format;
+		ovi.fps_num           = in.fps_num;
+		ovi.fps_den           = in.fps_den;
+		ovi.width             = in.width;
+		ovi.height            = in.height;
+		ovi.colorspace        = VIDEO_CS_709;
+		ovi.range             = VIDEO_RANGE_PARTIAL;
+		video_t* video        = shim::create_video(ovi);
+
+		obs_encoder_t* encoder = create(test.id, test.name, test.setup, video, nullptr);
+		if (!encoder) {
+			shim::destroy_video(video);
+			return true;
+		}
+		const obs_encoder_info* info = shim::encoder_info(encoder);
+		void*                   data = shim::encoder_data(encoder);
+
+		// libobs converts into whatever the encoder asks for, which isn't part of what is measured here.
+		video_scale_info vsi = {ovi.format, ovi.width, ovi.height, ovi.range, ovi.colorspace};
+		if (info->get_video_info) {
+			info->get_video_info(data, &vsi);
+		}
+		component          comps[4];
+		std::size_t        count = 0;
+		std::vector<image> frames;
+		if (components(vsi.format, comps, count)) {
+			for (auto& frame : in.frames) {
+				frames.push_back(convert(frame, vsi.format));
+			}
+		}
+
+		bool ok = !frames.empty();
+		if (!ok) {
+			std::printf("%-48s failed, '%s' asks for an unsupported format\n", test.name, test.id);
+		}
+
+		std::size_t          packets = 0;
+		std::size_t          bytes   = 0;
+		benchmark::samples   latency;
+		benchmark::samples   delay;
+		benchmark::stopwatch total;
+		for (std::size_t idx = 0; ok && (idx < iterations); idx++) {
+			const image&  img   = frames[idx % frames.size()];
+			encoder_frame frame = {};
+			for (std::size_t plane = 0; plane < MAX_AV_PLANES; plane++) {
+				frame.data[plane]     = img.planes[plane].empty() ? nullptr
+																  : const_cast<uint8_t*>(img.planes[plane].data());
+				frame.linesize[plane] = img.linesize[plane];
+			}
+			frame.frames = 1;
+			frame.pts    = static_cast<int64_t>(idx);
+
+			encoder_packet       packet   = {};
+			bool                 received = false;
+			benchmark::stopwatch sw;
+			ok = info->encode(data, &frame, &packet, &received);
+			latency.add(sw.wall_ns());
+			if (ok && received) {
+				packets++;
+				bytes += packet.size;
+				delay.add(static_cast<double>(frame.pts - packet.pts)); // Frames held back by the encoder.
+			}
+		}
+		double wall_ns = total.wall_ns();
+		double cpu_ns  = total.cpu_ns();
+
+		if (ok) {
+			double seconds = static_cast<double>(iterations) * in.fps_den / in.fps_num;
+			benchmark::report(test.name, latency, wall_ns, cpu_ns, iterations, bytes);
+			std::printf("%-48s %zu packets, delay p50 %.0f max %.0f frames, %.1f kbit/s\n", "", packets,
+						delay.percentile(50), delay.percentile(100), static_cast<double>(bytes) * 8. / 1000. / seconds);
+		} else if (!frames.empty()) {
+			std::printf("%-48s failed, '%s' returned an error\n", test.name, test.id);
+		}
+
+		shim::destroy_encoder(encoder);
+		shim::destroy_video(video);
+		return ok;
+	}
+
+	/// Encode 'iterations' frames of 8-channel sine waves at 48 kHz.
+	bool encode(const audio_case& test, std::size_t iterations)
+	{
+		audio_output_info oai = {};
+		oai.name              = test.name;
+		oai.samples_per_sec   = 48000;
+		oai.format            = AUDIO_FORMAT_FLOAT_PLANAR;
+		oai.speakers          = SPEAKERS_7POINT1;
+		audio_t* audio        = shim::create_audio(oai);
+
+		obs_encoder_t* encoder = create(test.id, test.name, test.setup, nullptr, audio);
+		if (!encoder) {
+			shim::destroy_audio(audio);
+			return true;
+		}
+		const obs_encoder_info* info = shim::encoder_info(encoder);
+		void*                   data = shim::encoder_data(encoder);
+
+		audio_convert_info aci = {oai.samples_per_sec, oai.format, oai.speakers};
+		if (info->get_audio_info) {
+			info->get_audio_info(data, &aci);
+		}
+		std::size_t channels = get_audio_channels(aci.speakers);
+		std::size_t samples  = info->get_frame_size ? info->get_frame_size(data) : 1024;
+		std::size_t width    = get_audio_bytes_per_channel(aci.format);
+		bool        planar   = is_audio_planar(aci.format);
+
+		// One frame per channel, each a different tone.
+		std::vector<std::vector<uint8_t>> buffers(planar ? channels : 1);
+		for (auto& buffer : buffers) {
+			buffer.resize(samples * width * (planar ? 1 : channels));
+		}
+		for (std::size_t sample = 0; sample < samples; sample++) {
+			for (std::size_t channel = 0; channel < channels; channel++) {
+				double   value = std::sin(static_cast<double>(sample) * (0.01 + 0.005 * static_cast<double>(channel)));
+				uint8_t* out   = planar ? buffers[channel].data() + sample * width
+										: buffers[0].data() + (sample * channels + channel) * width;
+				switch (aci.format) {
+				case AUDIO_FORMAT_FLOAT:
+				case AUDIO_FORMAT_FLOAT_PLANAR: {
+					float v = static_cast<float>(value * 0.5);
+					std::memcpy(out, &v, sizeof(v));
+					break;
+				}
+				case AUDIO_FORMAT_32BIT:
+				case AUDIO_FORMAT_32BIT_PLANAR: {
+					int32_t v = static_cast<int32_t>(value * 1073741823.);
+					std::memcpy(out, &v, sizeof(v));
+					break;
+				}
+				case AUDIO_FORMAT_16BIT:
+				case AUDIO_FORMAT_16BIT_PLANAR: {
+					int16_t v = static_cast<int16_t>(value * 16383.);
+					std::memcpy(out, &v, sizeof(v));
+					break;
+				}
+				default:
+					*out = static_cast<uint8_t>(128 + value * 63.);
+					break;
+				}
+			}
+		}
+
+		bool                 ok      = true;
+		std::size_t          packets = 0;
+		std::size_t          bytes   = 0;
+		benchmark::samples   latency;
+		benchmark::stopwatch total;
+		for (std::size_t idx = 0; ok && (idx < iterations); idx++) {
+			encoder_frame frame = {};
+			for (std::size_t plane = 0; plane < buffers.size(); plane++) {
+				frame.data[plane]     = buffers[plane].data();
+				frame.linesize[plane] = static_cast<uint32_t>(buffers[plane].size());
+			}
+			frame.frames = static_cast<uint32_t>(samples);
+			frame.pts    = static_cast<int64_t>(idx * samples);
+
+			encoder_packet       packet   = {};
+			bool                 received = false;
+			benchmark::stopwatch sw;
+			ok = info->encode(data, &frame, &packet, &received);
+			latency.add(sw.wall_ns());
+			if (ok && received) {
+				packets++;
+				bytes += packet.size;
+			}
+		}
+		double wall_ns = total.wall_ns();
+		double cpu_ns  = total.cpu_ns();
+
+		if (ok) {
+			// CPU time relative to how long the audio lasts, 100% would be one core busy all the time.
+			double duration_ns = static_cast<double>(iterations * samples) * 1e9 / aci.samples_per_sec;
+			benchmark::report(test.name, latency, wall_ns, cpu_ns, iterations, bytes);
+			std::printf("%-48s %zu packets, %.0fx real-time, cpu %.2f%% of real-time\n", "", packets,
+						duration_ns / wall_ns, (cpu_ns / duration_ns) * 100.);
+		} else {
+			std::printf("%-48s failed, '%s' returned an error\n", test.name, test.id);
+		}
+
+		shim::destroy_encoder(encoder);
+		shim::destroy_audio(audio);
+		return ok;
+	}
+
+	const char* argument(int argc, const char* argv[], const char* name)
+	{
+		for (int idx = 1; (idx + 1) < argc; idx++) {
+			if (std::strcmp(argv[idx], name) == 0) {
+				return argv[idx + 1];
+			}
+		}
+		return nullptr;
+	}
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+	std::size_t iterations = benchmark::iterations(argc, argv, 300);
+	shim::set_recording(false);
+
+	input in;
+	if (const char* path = argument(argc, argv, "--input"); path) {
+		try {
+			in = read_y4m(path, 60);
+		} catch (const std::exception& ex) {
+			std::fprintf(stderr, "Failed to read '%s': %s\n", path, ex.what());
+			return 1;
+		}
+	} else {
+		for (std::size_t idx = 0; idx < 8; idx++) {
+			in.frames.push_back(make_pattern(in.width, in.height, idx));
+		}
+	}
+
+	std::vector<video_case> videos;
+	std::vector<audio_case> audios;
+
+#ifdef ST_BENCH_FFMPEG
+	encoder::ffmpeg::ffmpeg_manager::initialize();
+
+	videos.push_back({"streamfx-libx264", "libx264 veryfast zerolatency", VIDEO_FORMAT_NV12, [](obs_data_t* settings) {
+						  obs_data_set_string(settings, "FFmpeg.CustomSettings",
+											  "-preset=veryfast -tune=zerolatency -b=6000000");
+					  }});
+	videos.push_back({"streamfx-libx264", "libx264 medium", VIDEO_FORMAT_NV12, [](obs_data_t* settings) {
+						  obs_data_set_string(settings, "FFmpeg.CustomSettings", "-preset=medium -b=6000000");
+					  }});
+	videos.push_back({"streamfx-prores_aw", "prores_aw 422 HQ", VIDEO_FORMAT_I422, [](obs_data_t* settings) {
+						  obs_data_set_int(settings, "Codec.ProRes.Profile",
+										   static_cast<long long>(encoder::codec::prores::profile::APCH));
+					  }});
+	videos.push_back({"streamfx-prores_aw", "prores_aw 4444 with alpha", VIDEO_FORMAT_YUVA, [](obs_data_t* settings) {
+						  obs_data_set_int(settings, "Codec.ProRes.Profile",
+										   static_cast<long long>(encoder::codec::prores::profile::AP4H));
+						  obs_data_set_bool(settings, "Codec.ProRes.Alpha", true);
+					  }});
+
+	audios.push_back({"streamfx-aac", "aac 7.1 48 kHz", [](obs_data_t* settings) {
+						  obs_data_set_string(settings, "FFmpeg.CustomSettings", "-b=512000");
+					  }});
+	audios.push_back({"streamfx-libopus", "libopus 7.1 48 kHz", [](obs_data_t* settings) {
+						  obs_data_set_string(settings, "FFmpeg.CustomSettings", "-b=512000");
+					  }});
+#endif
+
+#ifdef ST_BENCH_AOM
+	encoder::aom::av1::aom_av1_factory::initialize();
+
+	videos.push_back({"streamfx-aom-av1", "aom-av1 real-time screen content", VIDEO_FORMAT_I420,
+					  [](obs_data_t* settings) {
+						  using encoder::aom::av1::encoder_mode;
+						  obs_data_set_int(settings, "Encoder.Mode",
+										   static_cast<long long>(encoder_mode::REALTIME_SCREEN_CONTENT));
+					  }});
+	videos.push_back({"streamfx-aom-av1", "aom-av1 real-time cpu 9", VIDEO_FORMAT_I420, [](obs_data_t* settings) {
+						  obs_data_set_int(settings, "Encoder.Usage", AOM_USAGE_REALTIME);
+						  obs_data_set_int(settings, "Encoder.CPUUsage", 9);
+						  obs_data_set_int(settings, "RateControl.Mode", AOM_CBR);
+					  }});
+	videos.push_back({"streamfx-aom-av1", "aom-av1 good quality cpu 6", VIDEO_FORMAT_I420, [](obs_data_t* settings) {
+						  obs_data_set_int(settings, "Encoder.Usage", AOM_USAGE_GOOD_QUALITY);
+						  obs_data_set_int(settings, "Encoder.CPUUsage", 6);
+						  obs_data_set_int(settings, "RateControl.Mode", AOM_VBR);
+					  }});
+#endif
+
+	// Nothing to measure if neither FFmpeg nor libaom registered anything.
+	bool available = !shim::encoder_types().empty();
+	bool ok        = true;
+	for (std::size_t idx = 0; available && (idx < videos.size()); idx++) {
+		ok &= encode(videos[idx], in, iterations);
+	}
+	for (std::size_t idx = 0; available && (idx < audios.size()); idx++) {
+		ok &= encode(audios[idx], iterations);
+	}
+
+#ifdef ST_BENCH_AOM
+	encoder::aom::av1::aom_av1_factory::finalize();
+#endif
+#ifdef ST_BENCH_FFMPEG
+	encoder::ffmpeg::ffmpeg_manager::finalize();
+#endif
+
+	if (!available) {
+		std::fprintf(stderr, "No encoders are available.\n");
+		return 77;
+	}
+	return ok ? 0 : 1;
+}
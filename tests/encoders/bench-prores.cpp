@@ -0,0 +1,235 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Apple ProRes through FFmpeg's 'prores_aw' at 1080p and 4K, from one thread up to one per core, with threading set up
+// the way the FFmpeg encoder does it. For 4444 with alpha, the input conversion is measured as well: from what libobs
+// delivers (8-bit yuva444p) to what the encoder takes (yuva444p10), through swscale and through widen_plane.
+
+#include "benchmark.hpp"
+#include <thread>
+#include "encoders/codecs/prores.hpp"
+#include "ffmpeg/plane-copy.hpp"
+#include "ffmpeg/swscale.hpp"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/frame.h>
+#include <libavutil/pixdesc.h>
+}
+
+using namespace streamfx;
+using namespace streamfx::tests;
+using namespace streamfx::encoder::codec;
+
+namespace {
+	struct resolution {
+		const char* name;
+		int         width;
+		int         height;
+	};
+
+	struct variant {
+		const char*     name;
+		prores::profile profile;
+		AVPixelFormat   format;
+	};
+
+	const resolution resolutions[] = {
+		{"1080p", 1920, 1080},
+		{"4K", 3840, 2160},
+	};
+
+	const variant variants[] = {
+		{"422 HQ", prores::profile::APCH, AV_PIX_FMT_YUV422P10},
+		{"4444 with alpha", prores::profile::AP4H, AV_PIX_FMT_YUVA444P10},
+	};
+
+	std::shared_ptr<AVFrame> make_frame(int width, int height, AVPixelFormat format)
+	{
+		std::shared_ptr<AVFrame> frame(av_frame_alloc(), [](AVFrame* frame) { av_frame_free(&frame); });
+		frame->width  = width;
+		frame->height = height;
+		frame->format = format;
+		if (av_frame_get_buffer(frame.get(), 32) < 0) {
+			throw std::runtime_error("Failed to allocate frame.");
+		}
+		return frame;
+	}
+
+	// A moving gradient, so that the encoder has some detail to work with.
+	void fill_frame(AVFrame* frame, std::size_t index)
+	{
+		const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+		for (int plane = 0; plane < desc->nb_components; plane++) {
+			bool is_chroma = (plane == 1) || (plane == 2);
+			int  width     = is_chroma ? AV_CEIL_RSHIFT(frame->width, desc->log2_chroma_w) : frame->width;
+			int  height    = is_chroma ? AV_CEIL_RSHIFT(frame->height, desc->log2_chroma_h) : frame->height;
+			for (int y = 0; y < height; y++) {
+				uint8_t* row = frame->data[plane] + static_cast<std::ptrdiff_t>(y) * frame->linesize[plane];
+				for (int x = 0; x < width; x++) {
+					int value = (x + y + static_cast<int>(index) * 4 + plane * 64) & 0xFF;
+					if (desc->comp[plane].depth > 8) {
+						reinterpret_cast<uint16_t*>(row)[x] = static_cast<uint16_t>(value << 2);
+					} else {
+						row[x] = static_cast<uint8_t>(value);
+					}
+				}
+			}
+		}
+	}
+
+	/// Encode 'iterations' frames and report the rate, and the time spent in each send/receive round trip.
+	bool encode(const AVCodec* codec, const resolution& res, const variant& var, int threads, std::size_t iterations)
+	{
+		AVCodecContext* context = avcodec_alloc_context3(codec);
+		context->width          = res.width;
+		context->height         = res.height;
+		context->pix_fmt        = var.format;
+		context->time_base      = {1, 60};
+		context->framerate      = {60, 1};
+		context->profile        = static_cast<int>(var.profile);
+		context->thread_type    = 0;
+		if (codec->capabilities & AV_CODEC_CAP_FRAME_THREADS) {
+			context->thread_type |= FF_THREAD_FRAME;
+		}
+		if (codec->capabilities & AV_CODEC_CAP_SLICE_THREADS) {
+			context->thread_type |= FF_THREAD_SLICE;
+		}
+		context->thread_count = threads;
+		if (avcodec_open2(context, codec, nullptr) < 0) {
+			avcodec_free_context(&context);
+			return false;
+		}
+
+		// A handful of different frames, so that the encoder doesn't see the exact same input over and over.
+		std::vector<std::shared_ptr<AVFrame>> frames;
+		for (std::size_t idx = 0; idx < 8; idx++) {
+			frames.push_back(make_frame(res.width, res.height, var.format));
+			fill_frame(frames.back().get(), idx);
+		}
+
+		AVPacket*            packet = av_packet_alloc();
+		std::size_t          bytes  = 0;
+		benchmark::samples   latency;
+		benchmark::stopwatch total;
+		for (std::size_t idx = 0; idx <= iterations; idx++) {
+			benchmark::stopwatch sw;
+			AVFrame*             frame = nullptr;
+			if (idx < iterations) {
+				frame      = frames[idx % frames.size()].get();
+				frame->pts = static_cast<int64_t>(idx);
+			}
+			avcodec_send_frame(context, frame); // nullptr flushes the encoder after the last frame.
+			while (avcodec_receive_packet(context, packet) == 0) {
+				bytes += static_cast<std::size_t>(packet->size);
+				av_packet_unref(packet);
+			}
+			if (frame) {
+				latency.add(sw.wall_ns());
+			}
+		}
+
+		char name[128];
+		std::snprintf(name, sizeof(name), "%s %s, %d thread%s", res.name, var.name, threads, threads > 1 ? "s" : "");
+		benchmark::report(name, latency, total.wall_ns(), total.cpu_ns(), iterations, bytes);
+
+		av_packet_free(&packet);
+		avcodec_free_context(&context);
+		return true;
+	}
+
+	void convert(const resolution& res, std::size_t iterations)
+	{
+		auto source = make_frame(res.width, res.height, AV_PIX_FMT_YUVA444P);
+		auto target = make_frame(res.width, res.height, AV_PIX_FMT_YUVA444P10);
+		fill_frame(source.get(), 0);
+		std::size_t bytes = static_cast<std::size_t>(res.width) * static_cast<std::size_t>(res.height) * 4;
+
+		// What the encoder sets up for a conversion that doesn't widen.
+		ffmpeg::swscale scaler;
+		scaler.set_source_size(static_cast<uint32_t>(res.width), static_cast<uint32_t>(res.height));
+		scaler.set_source_format(AV_PIX_FMT_YUVA444P);
+		scaler.set_source_color(false, AVCOL_SPC_BT709);
+		scaler.set_target_size(static_cast<uint32_t>(res.width), static_cast<uint32_t>(res.height));
+		scaler.set_target_format(AV_PIX_FMT_YUVA444P10);
+		scaler.set_target_color(false, AVCOL_SPC_BT709);
+		if (scaler.initialize(SWS_POINT)) {
+			benchmark::samples   latency;
+			benchmark::stopwatch total;
+			for (std::size_t idx = 0; idx < iterations; idx++) {
+				benchmark::stopwatch sw;
+				scaler.convert(source->data, source->linesize, 0, res.height, target->data, target->linesize);
+				latency.add(sw.wall_ns());
+			}
+			benchmark::report(std::string(res.name) + " yuva444p to yuva444p10, swscale", latency, total.wall_ns(),
+							  total.cpu_ns(), iterations, bytes);
+		}
+
+		benchmark::samples   latency;
+		benchmark::stopwatch total;
+		for (std::size_t idx = 0; idx < iterations; idx++) {
+			benchmark::stopwatch sw;
+			for (int plane = 0; plane < 4; plane++) {
+				// Alpha is always full range, so it is replicated into the low bits like the encoder does.
+				ffmpeg::widen_plane(reinterpret_cast<uint16_t*>(target->data[plane]),
+									static_cast<std::size_t>(target->linesize[plane]), source->data[plane],
+									static_cast<std::size_t>(source->linesize[plane]),
+									static_cast<std::size_t>(res.width), static_cast<std::size_t>(res.height), 10,
+									plane == 3);
+			}
+			latency.add(sw.wall_ns());
+		}
+		benchmark::report(std::string(res.name) + " yuva444p to yuva444p10, widen_plane", latency, total.wall_ns(),
+						  total.cpu_ns(), iterations, bytes);
+	}
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+	std::size_t iterations = benchmark::iterations(argc, argv, 120);
+
+	const AVCodec* codec = avcodec_find_encoder_by_name("prores_aw");
+	if (!codec) {
+		std::fprintf(stderr, "FFmpeg was built without the 'prores_aw' encoder.\n");
+		return 77;
+	}
+
+	// One thread, then doubling up to one per core.
+	std::vector<int> thread_counts;
+	int              cores = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+	for (int threads = 1; threads < cores; threads *= 2) {
+		thread_counts.push_back(threads);
+	}
+	thread_counts.push_back(cores);
+
+	for (auto& res : resolutions) {
+		convert(res, iterations);
+		for (auto& var : variants) {
+			for (int threads : thread_counts) {
+				if (!encode(codec, res, var, threads, iterations)) {
+					std::fprintf(stderr, "Failed to open 'prores_aw' for %s %s.\n", res.name, var.name);
+					return 1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
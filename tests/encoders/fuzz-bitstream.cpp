@@ -0,0 +1,176 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdio>
+#include <cstdlib>
+#include "encoders/codecs/av1.hpp"
+#include "encoders/codecs/bitstream.hpp"
+#include "encoders/codecs/h264.hpp"
+#include "encoders/codecs/hevc.hpp"
+
+using namespace streamfx::encoder::codec;
+
+#define ST_FUZZ_CHECK(EXPRESSION)                                                               \
+	do {                                                                                        \
+		if (!(EXPRESSION)) {                                                                    \
+			std::fprintf(stderr, "%s:%d: Check failed: %s\n", __FILE__, __LINE__, #EXPRESSION); \
+			std::abort();                                                                       \
+		}                                                                                       \
+	} while (false)
+
+namespace {
+	const uint8_t* reference_find_start_code(const uint8_t* ptr, const uint8_t* end)
+	{
+		for (; (end - ptr) >= 3; ptr++) {
+			if ((ptr[0] == 0x00) && (ptr[1] == 0x00) && (ptr[2] == 0x01)) {
+				return ptr;
+			}
+		}
+		return end;
+	}
+
+	void fuzz_annexb(const uint8_t* data, size_t size)
+	{
+		const uint8_t* end = data + size;
+
+		// Every start code must be found, in order, and nothing else.
+		std::vector<const uint8_t*> start_codes;
+		for (const uint8_t* ptr = data;;) {
+			const uint8_t* found = bitstream::find_start_code(ptr, end);
+			ST_FUZZ_CHECK(found == reference_find_start_code(ptr, end));
+			if (found == end) {
+				break;
+			}
+			start_codes.push_back(found);
+			ptr = found + 1;
+		}
+
+		// The reader must return the payload between start codes, minus trailing zero bytes, and skip empty ones.
+		bitstream::annexb_reader reader{data, size};
+		bitstream::nal_unit      nal;
+		for (size_t idx = 0; idx < start_codes.size(); idx++) {
+			const uint8_t* payload = start_codes[idx] + 3;
+			const uint8_t* tail    = (idx + 1 < start_codes.size()) ? start_codes[idx + 1] : end;
+			while ((tail > payload) && (tail[-1] == 0x00)) {
+				tail--;
+			}
+			if (tail <= payload) {
+				continue;
+			}
+
+			const uint8_t* lower      = (idx == 0) ? data : start_codes[idx - 1] + 3;
+			const uint8_t* start_code = start_codes[idx];
+			if ((start_code > lower) && (start_code[-1] == 0x00)) {
+				start_code--;
+			}
+
+			ST_FUZZ_CHECK(reader.next(nal));
+			ST_FUZZ_CHECK(nal.start_code == start_code);
+			ST_FUZZ_CHECK(nal.data == payload);
+			ST_FUZZ_CHECK(nal.end() == tail);
+		}
+		ST_FUZZ_CHECK(!reader.next(nal));
+	}
+
+	void fuzz_obu(const uint8_t* data, size_t size)
+	{
+		const uint8_t*        end = data + size;
+		const uint8_t*        ptr = data;
+		bitstream::obu_reader reader{data, size};
+		for (bitstream::obu unit; reader.next(unit);) {
+			ST_FUZZ_CHECK(unit.header == ptr);
+			ST_FUZZ_CHECK(unit.type == ((unit.header[0] >> 3) & 0x0F));
+			ST_FUZZ_CHECK((unit.data > unit.header) && (unit.end() <= end));
+			ptr = unit.end();
+		}
+	}
+
+	void fuzz_bit_reader(const uint8_t* data, size_t size)
+	{
+		// Use the first byte to pick the read widths, and the rest as the data to read.
+		if (size < 1) {
+			return;
+		}
+		uint8_t pattern = data[0];
+		data++;
+		size--;
+
+		bitstream::bit_reader br{data, size};
+		size_t                position = 0;
+		for (size_t idx = 0; idx < 64; idx++) {
+			uint8_t  bits     = static_cast<uint8_t>(((pattern >> (idx & 7)) * 7 + idx) % 33);
+			uint32_t value    = br.read(bits);
+			uint32_t expected = 0;
+			for (uint8_t bit = 0; bit < bits; bit++, position++) {
+				uint32_t set = ((position >> 3) < size) ? ((data[position >> 3] >> (7 - (position & 7))) & 1) : 0;
+				expected     = (expected << 1) | set;
+			}
+			ST_FUZZ_CHECK(value == expected);
+			ST_FUZZ_CHECK(br.overrun() == (position > (size << 3)));
+		}
+
+		bitstream::bit_reader uvlc{data, size};
+		while (!uvlc.overrun()) {
+			uvlc.read_uvlc();
+		}
+	}
+
+	void fuzz_codecs(const uint8_t* data, size_t size)
+	{
+		{
+			std::vector<uint8_t> header, sei;
+			h264::extract_header_sei(data, size, header, sei);
+			ST_FUZZ_CHECK((header.size() + sei.size()) <= size);
+			ST_FUZZ_CHECK((h264::hash_header(data, size) == 0) || !header.empty());
+			int priority = h264::get_packet_priority(data, size);
+			ST_FUZZ_CHECK((priority >= -1) && (priority <= 3));
+		}
+		{
+			std::vector<uint8_t> header, sei;
+			hevc::extract_header_sei(data, size, header, sei);
+			ST_FUZZ_CHECK((header.size() + sei.size()) <= size);
+			ST_FUZZ_CHECK((hevc::hash_header(data, size) == 0) || !header.empty());
+
+			uint8_t max_temporal_id = std::numeric_limits<uint8_t>::max();
+			int     priority        = hevc::get_packet_priority(data, size, max_temporal_id);
+			ST_FUZZ_CHECK((priority >= -1) && (priority <= 3));
+		}
+		{
+			std::vector<uint8_t> header;
+			if (av1::extract_sequence_header(data, size, header)) {
+				ST_FUZZ_CHECK(!header.empty() && (header.size() <= size));
+			}
+
+			av1::sequence_header sequence;
+			av1::parse_sequence_header(data, size, sequence);
+			int priority = av1::get_packet_priority(data, size, sequence);
+			ST_FUZZ_CHECK((priority >= -1) && (priority <= 3));
+		}
+	}
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	fuzz_annexb(data, size);
+	fuzz_obu(data, size);
+	fuzz_bit_reader(data, size);
+	fuzz_codecs(data, size);
+	return 0;
+}
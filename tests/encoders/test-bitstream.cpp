@@ -0,0 +1,429 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include <random>
+#include "encoders/codecs/av1.hpp"
+#include "encoders/codecs/bitstream.hpp"
+#include "encoders/codecs/h264.hpp"
+#include "encoders/codecs/hevc.hpp"
+
+extern "C" {
+#include <obs-avc.h>
+}
+
+using namespace streamfx::encoder::codec;
+
+namespace {
+	const uint8_t* reference_find_start_code(const uint8_t* ptr, const uint8_t* end)
+	{
+		for (; (end - ptr) >= 3; ptr++) {
+			if ((ptr[0] == 0x00) && (ptr[1] == 0x00) && (ptr[2] == 0x01)) {
+				return ptr;
+			}
+		}
+		return end;
+	}
+
+	std::vector<uint8_t> hevc_nal(uint8_t type, uint8_t temporal_id, std::vector<uint8_t> payload = {0xAF})
+	{
+		payload.insert(payload.begin(), {0x00, 0x00, 0x00, 0x01, static_cast<uint8_t>(type << 1),
+										 static_cast<uint8_t>(temporal_id + 1)});
+		return payload;
+	}
+
+	std::vector<uint8_t> operator+(std::vector<uint8_t> a, const std::vector<uint8_t>& b)
+	{
+		a.insert(a.end(), b.begin(), b.end());
+		return a;
+	}
+
+	class bit_writer {
+		std::vector<uint8_t> _data;
+		size_t               _bit = 0;
+
+		public:
+		bit_writer& put(uint32_t value, uint8_t bits)
+		{
+			for (uint8_t idx = bits; idx > 0; idx--, _bit++) {
+				if ((_bit >> 3) >= _data.size()) {
+					_data.push_back(0);
+				}
+				_data[_bit >> 3] |= static_cast<uint8_t>(((value >> (idx - 1)) & 1) << (7 - (_bit & 7)));
+			}
+			return *this;
+		}
+
+		std::vector<uint8_t> finish()
+		{
+			return _data;
+		}
+	};
+
+	std::vector<uint8_t> av1_obu(av1::obu_type type, std::vector<uint8_t> payload, uint8_t temporal_id = 0)
+	{
+		std::vector<uint8_t> obu = {static_cast<uint8_t>((static_cast<uint8_t>(type) << 3) | 0x02)};
+		if (temporal_id != 0) {
+			obu[0] |= 0x04;
+			obu.push_back(static_cast<uint8_t>(temporal_id << 5));
+		}
+		obu.push_back(static_cast<uint8_t>(payload.size())); // Always less than 128 bytes here.
+		return obu + payload;
+	}
+
+	std::vector<uint8_t> av1_sequence_header()
+	{
+		// Profile 0, one operating point, 16x16, order hints with 7 bits, screen content tools chosen per frame.
+		return bit_writer()
+			.put(0, 3)  // seq_profile
+			.put(0, 1)  // still_picture
+			.put(0, 1)  // reduced_still_picture_header
+			.put(0, 1)  // timing_info_present_flag
+			.put(0, 1)  // initial_display_delay_present_flag
+			.put(0, 5)  // operating_points_cnt_minus_1
+			.put(0, 12) // operating_point_idc[0]
+			.put(0, 5)  // seq_level_idx[0]
+			.put(3, 4)  // frame_width_bits_minus_1
+			.put(3, 4)  // frame_height_bits_minus_1
+			.put(15, 4) // max_frame_width_minus_1
+			.put(15, 4) // max_frame_height_minus_1
+			.put(0, 1)  // frame_id_numbers_present_flag
+			.put(0, 3)  // use_128x128_superblock, enable_filter_intra, enable_intra_edge_filter
+			.put(0, 4)  // enable_interintra_compound, enable_masked_compound, enable_warped_motion, enable_dual_filter
+			.put(1, 1)  // enable_order_hint
+			.put(0, 2)  // enable_jnt_comp, enable_ref_frame_mvs
+			.put(1, 1)  // seq_choose_screen_content_tools
+			.put(1, 1)  // seq_choose_integer_mv
+			.put(6, 3)  // order_hint_bits_minus_1
+			.put(0, 8)  // Remainder, not parsed.
+			.finish();
+	}
+
+	std::vector<uint8_t> av1_frame_header(uint8_t frame_type, bool show_frame, uint8_t refresh_frame_flags)
+	{
+		bool       key_shown = (frame_type == 0) && show_frame;
+		bit_writer bw;
+		bw.put(0, 1);          // show_existing_frame
+		bw.put(frame_type, 2); // frame_type
+		bw.put(show_frame, 1); // show_frame
+		if (!show_frame) {
+			bw.put(1, 1); // showable_frame
+		}
+		if (!key_shown) {
+			bw.put(0, 1); // error_resilient_mode
+		}
+		bw.put(0, 1); // disable_cdf_update
+		bw.put(0, 1); // allow_screen_content_tools
+		bw.put(0, 1); // frame_size_override_flag
+		bw.put(0, 7); // order_hint
+		if (frame_type == 1) {
+			bw.put(0, 3); // primary_ref_frame
+		}
+		if (!key_shown) {
+			bw.put(refresh_frame_flags, 8);
+		}
+		return bw.put(0, 8).finish();
+	}
+} // namespace
+
+ST_TEST(find_start_code_short)
+{
+	const uint8_t data[] = {0x00, 0x00, 0x01};
+	ST_CHECK(bitstream::find_start_code(data, data) == data);
+	ST_CHECK(bitstream::find_start_code(data, data + 2) == data + 2);
+	ST_CHECK(bitstream::find_start_code(data, data + 3) == data);
+	ST_CHECK(bitstream::find_start_code(data + 1, data + 3) == data + 3);
+}
+
+ST_TEST(find_start_code_every_offset)
+{
+	// Covers both the vectorized loop and the tail, including start codes that straddle a 16 byte block.
+	for (size_t size = 3; size <= 80; size++) {
+		for (size_t pos = 0; (pos + 3) <= size; pos++) {
+			std::vector<uint8_t> data(size, 0xFF);
+			data[pos]     = 0x00;
+			data[pos + 1] = 0x00;
+			data[pos + 2] = 0x01;
+			ST_CHECK(bitstream::find_start_code(data.data(), data.data() + size) == data.data() + pos);
+		}
+	}
+}
+
+ST_TEST(find_start_code_near_misses)
+{
+	std::vector<uint8_t> data(64, 0x00);
+	data[20] = 0x02;
+	data[40] = 0x03;
+	ST_CHECK(bitstream::find_start_code(data.data(), data.data() + data.size()) == data.data() + data.size());
+
+	// '00 00 00 01' contains a start code at offset 1.
+	data[62] = 0x01;
+	ST_CHECK(bitstream::find_start_code(data.data(), data.data() + data.size()) == data.data() + 60);
+}
+
+ST_TEST(find_start_code_matches_reference)
+{
+	std::mt19937 rng(1);
+	for (size_t iteration = 0; iteration < 2000; iteration++) {
+		std::vector<uint8_t> data(rng() % 300);
+		for (auto& byte : data) {
+			byte = static_cast<uint8_t>((rng() % 4 == 0) ? (rng() % 3) : 0);
+		}
+
+		const uint8_t* end = data.data() + data.size();
+		for (const uint8_t* ptr = data.data(); ptr < end; ptr++) {
+			ST_CHECK(bitstream::find_start_code(ptr, end) == reference_find_start_code(ptr, end));
+		}
+	}
+}
+
+ST_TEST(read_leb128)
+{
+	uint64_t value;
+	{
+		const uint8_t  data[] = {0x00};
+		const uint8_t* ptr    = data;
+		ST_CHECK(bitstream::read_leb128(ptr, data + sizeof(data), value) && (value == 0) && (ptr == data + 1));
+	}
+	{
+		const uint8_t  data[] = {0xE5, 0x8E, 0x26, 0xFF};
+		const uint8_t* ptr    = data;
+		ST_CHECK(bitstream::read_leb128(ptr, data + sizeof(data), value) && (value == 624485) && (ptr == data + 3));
+	}
+	{ // Truncated.
+		const uint8_t  data[] = {0x80, 0x80};
+		const uint8_t* ptr    = data;
+		ST_CHECK(!bitstream::read_leb128(ptr, data + sizeof(data), value));
+	}
+	{ // More than 8 bytes.
+		const uint8_t  data[] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01};
+		const uint8_t* ptr    = data;
+		ST_CHECK(!bitstream::read_leb128(ptr, data + sizeof(data), value));
+	}
+}
+
+ST_TEST(hash)
+{
+	const uint8_t data[] = {'a', 'b', 'c', 'd'};
+	ST_CHECK(bitstream::hash(data, 0) == 0xCBF29CE484222325ull);
+	ST_CHECK(bitstream::hash(data, 1) == 0xAF63DC4C8601EC8Cull);
+	ST_CHECK(bitstream::hash(data + 2, 2, bitstream::hash(data, 2)) == bitstream::hash(data, 4));
+}
+
+ST_TEST(bit_reader)
+{
+	const uint8_t         data[] = {0b10110000, 0b11010101};
+	bitstream::bit_reader br{data, sizeof(data)};
+	ST_CHECK(br.read_bit());
+	ST_CHECK(br.read(3) == 0b011);
+	ST_CHECK(br.read_uvlc() == 0b1111 + 0b1010); // 4 leading zeros, the marker bit, then 4 bits of value.
+	ST_CHECK(!br.overrun());
+	ST_CHECK(br.read(3) == 0b101);
+	ST_CHECK(!br.overrun());
+	ST_CHECK(br.read(8) == 0);
+	ST_CHECK(br.overrun());
+}
+
+ST_TEST(bit_reader_uvlc_limit)
+{
+	const uint8_t         data[8] = {};
+	bitstream::bit_reader br{data, sizeof(data)};
+	ST_CHECK(br.read_uvlc() == 0);
+}
+
+ST_TEST(annexb_reader)
+{
+	std::vector<uint8_t> data = {
+		0x00, 0x00, 0x00, 0x01, 0x09, 0xF0,             // 4 byte start code
+		0x00, 0x00, 0x01, 0x67, 0x64, 0x00, 0x00,       // 3 byte start code, trailing zeros
+		0x00, 0x00, 0x01,                               // Empty
+		0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x00, 0x00, // Trailing zero_byte and padding
+	};
+
+	bitstream::annexb_reader reader{data.data(), data.size()};
+	bitstream::nal_unit      nal;
+	ST_CHECK(reader.next(nal));
+	ST_CHECK((nal.start_code == data.data()) && (nal.data == data.data() + 4) && (nal.size == 2));
+	ST_CHECK(reader.next(nal));
+	ST_CHECK((nal.start_code == data.data() + 6) && (nal.data == data.data() + 9) && (nal.size == 2));
+	ST_CHECK(reader.next(nal));
+	ST_CHECK((nal.start_code == data.data() + 16) && (nal.data == data.data() + 20) && (nal.size == 2));
+	ST_CHECK(!reader.next(nal));
+}
+
+ST_TEST(annexb_reader_no_start_code)
+{
+	const uint8_t            data[] = {0x12, 0x34, 0x00, 0x00};
+	bitstream::annexb_reader reader{data, sizeof(data)};
+	bitstream::nal_unit      nal;
+	ST_CHECK(!reader.next(nal));
+}
+
+ST_TEST(obu_reader)
+{
+	const uint8_t data[] = {
+		0x12, 0x00,                   // Temporal Delimiter, empty
+		0x1A, 0x02, 0xAA, 0xBB,       // Frame Header, size 2
+		0x36, 0x48, 0x01, 0xCC,       // Frame with extension (temporal_id 2, spatial_id 1), size 1
+		0x78, 0xDD, 0xEE,             // Padding without size field, extends to the end
+	};
+
+	bitstream::obu_reader reader{data, sizeof(data)};
+	bitstream::obu        unit;
+	ST_CHECK(reader.next(unit));
+	ST_CHECK((unit.type == 2) && (unit.header == data) && (unit.size == 0));
+	ST_CHECK(reader.next(unit));
+	ST_CHECK((unit.type == 3) && (unit.data == data + 4) && (unit.size == 2));
+	ST_CHECK(reader.next(unit));
+	ST_CHECK((unit.type == 6) && (unit.temporal_id == 2) && (unit.spatial_id == 1) && (unit.data == data + 9));
+	ST_CHECK(reader.next(unit));
+	ST_CHECK((unit.type == 15) && (unit.data == data + 11) && (unit.size == 2));
+	ST_CHECK(!reader.next(unit));
+}
+
+ST_TEST(obu_reader_malformed)
+{
+	{ // obu_forbidden_bit
+		const uint8_t         data[] = {0x92, 0x00};
+		bitstream::obu_reader reader{data, sizeof(data)};
+		bitstream::obu        unit;
+		ST_CHECK(!reader.next(unit));
+	}
+	{ // Size larger than the remaining data.
+		const uint8_t         data[] = {0x32, 0x05, 0x00};
+		bitstream::obu_reader reader{data, sizeof(data)};
+		bitstream::obu        unit;
+		ST_CHECK(!reader.next(unit));
+		ST_CHECK(!reader.next(unit));
+	}
+}
+
+ST_TEST(h264_header_and_priority)
+{
+	std::vector<uint8_t> data = {
+		0x00, 0x00, 0x00, 0x01, 0x67, 0x42, // SPS
+		0x00, 0x00, 0x00, 0x01, 0x68, 0xCE, // PPS
+		0x00, 0x00, 0x01, 0x06, 0x05,       // SEI
+		0x00, 0x00, 0x01, 0x65, 0x88,       // IDR, nal_ref_idc 3
+	};
+
+	std::vector<uint8_t> header, sei;
+	h264::extract_header_sei(data.data(), data.size(), header, sei);
+	ST_CHECK(header == std::vector<uint8_t>(data.begin(), data.begin() + 12));
+	ST_CHECK(sei == std::vector<uint8_t>(data.begin() + 12, data.begin() + 17));
+	uint64_t hash = bitstream::hash(data.data() + 10, 2, bitstream::hash(data.data() + 4, 2));
+	ST_CHECK(h264::hash_header(data.data(), data.size()) == hash);
+	ST_CHECK(h264::get_packet_priority(data.data(), data.size()) == OBS_NAL_PRIORITY_HIGHEST);
+
+	const uint8_t slice[] = {0x00, 0x00, 0x01, 0x01, 0x9A};
+	ST_CHECK(h264::get_packet_priority(slice, sizeof(slice)) == OBS_NAL_PRIORITY_DISPOSABLE);
+	ST_CHECK(h264::get_packet_priority(data.data(), 12) == -1);
+	ST_CHECK(h264::hash_header(slice, sizeof(slice)) == 0);
+}
+
+ST_TEST(hevc_header)
+{
+	auto data = hevc_nal(32, 0) + hevc_nal(33, 0) + hevc_nal(34, 0) + hevc_nal(39, 0) + hevc_nal(19, 0);
+
+	std::vector<uint8_t> header, sei;
+	hevc::extract_header_sei(data.data(), data.size(), header, sei);
+	ST_CHECK(header == std::vector<uint8_t>(data.begin(), data.begin() + 21));
+	ST_CHECK(sei == std::vector<uint8_t>(data.begin() + 21, data.begin() + 28));
+	ST_CHECK(hevc::hash_header(data.data(), data.size()) != 0);
+	ST_CHECK(hevc::hash_header(data.data() + 21, data.size() - 21) == 0);
+}
+
+ST_TEST(hevc_priority)
+{
+	uint8_t max_temporal_id = std::numeric_limits<uint8_t>::max();
+
+	// IRAP pictures always have the highest priority.
+	auto idr = hevc_nal(19, 0);
+	ST_CHECK(hevc::get_packet_priority(idr.data(), idr.size(), max_temporal_id) == OBS_NAL_PRIORITY_HIGHEST);
+
+	// Without knowing the number of sub-layers, nothing is disposable.
+	auto trail_n = hevc_nal(0, 0);
+	ST_CHECK(hevc::get_packet_priority(trail_n.data(), trail_n.size(), max_temporal_id) == OBS_NAL_PRIORITY_HIGH);
+
+	// SPS with sps_max_sub_layers_minus1 = 2.
+	auto sps = hevc_nal(33, 0, {0x04});
+	ST_CHECK(hevc::get_packet_priority(sps.data(), sps.size(), max_temporal_id) == -1);
+	ST_CHECK(max_temporal_id == 2);
+
+	// Sub-layer non-reference pictures below the highest layer may still be referenced by higher layers.
+	ST_CHECK(hevc::get_packet_priority(trail_n.data(), trail_n.size(), max_temporal_id) == OBS_NAL_PRIORITY_HIGH);
+	auto tsa_n = hevc_nal(2, 1);
+	ST_CHECK(hevc::get_packet_priority(tsa_n.data(), tsa_n.size(), max_temporal_id) == OBS_NAL_PRIORITY_LOW);
+	auto trail_n2 = hevc_nal(0, 2);
+	ST_CHECK(hevc::get_packet_priority(trail_n2.data(), trail_n2.size(), max_temporal_id)
+			 == OBS_NAL_PRIORITY_DISPOSABLE);
+	auto trail_r2 = hevc_nal(1, 2);
+	ST_CHECK(hevc::get_packet_priority(trail_r2.data(), trail_r2.size(), max_temporal_id) == OBS_NAL_PRIORITY_LOW);
+}
+
+ST_TEST(hevc_priority_invalid_temporal_id)
+{
+	// nuh_temporal_id_plus1 = 0 is forbidden, and must not be mistaken for the unknown highest layer.
+	uint8_t              max_temporal_id = std::numeric_limits<uint8_t>::max();
+	std::vector<uint8_t> data            = {0x00, 0x00, 0x01, 0x00, 0x00, 0xAF};
+	ST_CHECK(hevc::get_packet_priority(data.data(), data.size(), max_temporal_id) != OBS_NAL_PRIORITY_DISPOSABLE);
+}
+
+ST_TEST(av1_sequence_header)
+{
+	auto seq = av1_sequence_header();
+
+	av1::sequence_header header;
+	ST_CHECK(av1::parse_sequence_header(seq.data(), seq.size(), header));
+	ST_CHECK(header.valid && !header.reduced_still_picture_header && (header.operating_points == 1));
+	ST_CHECK((header.order_hint_bits == 7) && (header.seq_force_screen_content_tools == 2));
+	ST_CHECK(!av1::parse_sequence_header(seq.data(), 2, header));
+
+	std::vector<uint8_t> extracted;
+	auto data = av1_obu(av1::obu_type::TEMPORAL_DELIMITER, {}) + av1_obu(av1::obu_type::SEQUENCE_HEADER, seq);
+	ST_CHECK(av1::extract_sequence_header(data.data(), data.size(), extracted));
+	ST_CHECK(extracted == std::vector<uint8_t>(data.begin() + 2, data.end()));
+}
+
+ST_TEST(av1_priority)
+{
+	av1::sequence_header header;
+	auto                 key = av1_obu(av1::obu_type::FRAME, av1_frame_header(0, true, 0));
+
+	// Frame Headers can't be parsed without a Sequence Header.
+	ST_CHECK(av1::get_packet_priority(key.data(), key.size(), header) == -1);
+
+	auto data = av1_obu(av1::obu_type::SEQUENCE_HEADER, av1_sequence_header()) + key;
+	ST_CHECK(av1::get_packet_priority(data.data(), data.size(), header) == OBS_NAL_PRIORITY_HIGHEST);
+	ST_CHECK(header.valid);
+
+	auto disposable = av1_obu(av1::obu_type::FRAME, av1_frame_header(1, true, 0x00));
+	ST_CHECK(av1::get_packet_priority(disposable.data(), disposable.size(), header) == OBS_NAL_PRIORITY_DISPOSABLE);
+
+	auto reference = av1_obu(av1::obu_type::FRAME, av1_frame_header(1, true, 0x01));
+	ST_CHECK(av1::get_packet_priority(reference.data(), reference.size(), header) == OBS_NAL_PRIORITY_HIGH);
+
+	auto layer = av1_obu(av1::obu_type::FRAME, av1_frame_header(1, false, 0x02), 1);
+	ST_CHECK(av1::get_packet_priority(layer.data(), layer.size(), header) == OBS_NAL_PRIORITY_LOW);
+
+	// show_existing_frame
+	auto existing = av1_obu(av1::obu_type::FRAME_HEADER, {0x80});
+	ST_CHECK(av1::get_packet_priority(existing.data(), existing.size(), header) == OBS_NAL_PRIORITY_DISPOSABLE);
+}
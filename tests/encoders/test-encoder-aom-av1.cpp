@@ -0,0 +1,245 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The AOM AV1 encoder with the real libaom, on the CPU. Skipped if libaom can't be loaded.
+
+#include "tests.hpp"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include "encoders/encoder-aom-av1.hpp"
+#include "encoders/encoder-roi.hpp"
+#include "shim.hpp"
+
+extern "C" {
+#include <util/platform.h>
+}
+
+using namespace streamfx;
+using namespace streamfx::tests;
+using namespace streamfx::encoder::aom::av1;
+
+namespace {
+	constexpr uint32_t width  = 640;
+	constexpr uint32_t height = 360;
+	constexpr int64_t  frames = 60;
+
+	/// Loads libaom for the duration of a test.
+	struct factory {
+		factory()
+		{
+			aom_av1_factory::initialize();
+			if (!aom_av1_factory::get()) {
+				ST_SKIP("libaom is not available.");
+			}
+		}
+
+		~factory()
+		{
+			aom_av1_factory::finalize();
+		}
+	};
+
+	/// An I420 frame that looks like a scrolling page of text, the content Real-Time Screen Content is meant for.
+	struct screen {
+		std::vector<uint8_t> luma   = std::vector<uint8_t>(width * height);
+		std::vector<uint8_t> chroma = std::vector<uint8_t>(width * height / 2, 128);
+
+		void draw(int64_t index)
+		{
+			for (uint32_t y = 0; y < height; y++) {
+				uint32_t line = (y + static_cast<uint32_t>(index) * 2) % 24;
+				for (uint32_t x = 0; x < width; x++) {
+					bool glyph          = (line < 12) && (((x / 7) * 31 + y / 24) % 5 != 0) && ((x % 7) < 5);
+					luma[y * width + x] = glyph ? 16 : 235;
+				}
+			}
+		}
+
+		encoder_frame frame(int64_t pts)
+		{
+			encoder_frame frame = {};
+			frame.data[0]       = luma.data();
+			frame.data[1]       = chroma.data();
+			frame.data[2]       = chroma.data() + width * height / 4;
+			frame.linesize[0]   = width;
+			frame.linesize[1]   = width / 2;
+			frame.linesize[2]   = width / 2;
+			frame.frames        = 1;
+			frame.pts           = pts;
+			return frame;
+		}
+	};
+
+	video_t* create_video()
+	{
+		video_output_info ovi = {};
+		ovi.format            = VIDEO_FORMAT_I420;
+		ovi.fps_num           = 60;
+		ovi.fps_den           = 1;
+		ovi.width             = width;
+		ovi.height            = height;
+		ovi.colorspace        = VIDEO_CS_709;
+		ovi.range             = VIDEO_RANGE_PARTIAL;
+		return shim::create_video(ovi);
+	}
+
+	/** Encode 'frames' frames in Real-Time Screen Content mode and check that every packet leaves the encoder within
+	 * one frame of the frame it encodes, on top of the settings applied by 'setup'.
+	 */
+	void check_latency(void (*setup)(obs_data_t* settings))
+	{
+		factory guard;
+
+		video_t*    video    = create_video();
+		obs_data_t* settings = obs_data_create();
+		obs_data_set_int(settings, "Encoder.Mode", static_cast<long long>(encoder_mode::REALTIME_SCREEN_CONTENT));
+		setup(settings);
+		obs_encoder_t* encoder = shim::create_encoder("streamfx-aom-av1", settings, video, nullptr);
+		obs_data_release(settings);
+
+		bool    created  = (encoder != nullptr);
+		bool    encoded  = true;
+		bool    keyframe = false;
+		int64_t delay    = 0;
+		int64_t packets  = 0;
+		if (created) {
+			const obs_encoder_info* info = shim::encoder_info(encoder);
+			void*                   data = shim::encoder_data(encoder);
+
+			screen image;
+			for (int64_t pts = 0; encoded && (pts < frames); pts++) {
+				image.draw(pts);
+				encoder_frame  frame    = image.frame(pts);
+				encoder_packet packet   = {};
+				bool           received = false;
+				encoded                 = info->encode(data, &frame, &packet, &received);
+				if (received) {
+					keyframe |= (packets == 0) && packet.keyframe;
+					delay = std::max(delay, pts - packet.pts);
+					packets++;
+				} else {
+					delay = std::max<int64_t>(delay, pts + 1 - packets);
+				}
+			}
+			shim::destroy_encoder(encoder);
+		}
+		shim::destroy_video(video);
+
+		ST_CHECK(created);
+		ST_CHECK(encoded);
+		ST_CHECK(keyframe);
+		ST_CHECK(delay <= 1);
+		ST_CHECK(packets >= frames - 1);
+	}
+
+	/** Encode the same frame over and over at a fixed quality, with the given regions published for every frame.
+	 *
+	 * @return The size of every packet, or nothing if libaom refused the regions.
+	 */
+	std::vector<size_t> encode_static(const std::vector<encoder::region>& regions)
+	{
+		video_t*    video    = create_video();
+		obs_data_t* settings = obs_data_create();
+		obs_data_set_int(settings, "Encoder.CPUUsage", 9);
+		obs_data_set_int(settings, "RateControl.Mode", AOM_Q);
+		obs_data_set_int(settings, "RateControl.Limits.Quality", 40);
+		obs_encoder_t* encoder = shim::create_encoder("streamfx-aom-av1", settings, video, nullptr);
+		obs_data_release(settings);
+
+		std::vector<size_t> sizes;
+		if (encoder) {
+			const obs_encoder_info* info = shim::encoder_info(encoder);
+			void*                   data = shim::encoder_data(encoder);
+
+			screen image;
+			image.draw(0);
+			for (int64_t pts = 0; pts < 30; pts++) {
+				// Render the frame at 60 fps first, so that the encoder finds the regions published for it.
+				uint64_t time = 1000000000ull + static_cast<uint64_t>(pts) * 1000000000ull / 60;
+				shim::set_video_frame_time(time);
+				encoder::roi_channel::get()->publish(&sizes, time, regions);
+
+				encoder_frame  frame    = image.frame(pts);
+				encoder_packet packet   = {};
+				bool           received = false;
+				ST_CHECK(info->encode(data, &frame, &packet, &received));
+				if (received) {
+					sizes.push_back(packet.size);
+				}
+			}
+			shim::destroy_encoder(encoder);
+		}
+		encoder::roi_channel::get()->retract(&sizes);
+		shim::set_video_frame_time(0);
+		shim::destroy_video(video);
+		ST_CHECK(encoder != nullptr);
+
+		for (auto& call : shim::calls()) {
+			if ((call.function == "blog")
+				&& (call.argument.find("Regions of Interest are not supported") != std::string::npos)) {
+				sizes.clear();
+			}
+		}
+		return sizes;
+	}
+} // namespace
+
+ST_TEST(aom_av1_realtime_screen_content_latency)
+{
+	check_latency([](obs_data_t*) {});
+}
+
+ST_TEST(aom_av1_realtime_screen_content_ignores_latency_settings)
+{
+	// Settings that add frames of latency in the custom mode, which Real-Time Screen Content overrides.
+	check_latency([](obs_data_t* settings) {
+		obs_data_set_int(settings, "Encoder.Usage", AOM_USAGE_GOOD_QUALITY);
+		obs_data_set_int(settings, "RateControl.Mode", AOM_VBR);
+		obs_data_set_int(settings, "RateControl.LookAhead", 35);
+	});
+}
+
+ST_TEST(aom_av1_synthetic_region_of_interest)
+{
+	factory guard;
+	shim::clear_calls();
+
+	// A region with full weight over the whole frame lowers the quantizer everywhere, so the frames get bigger.
+	std::vector<size_t> plain    = encode_static({});
+	std::vector<size_t> favored = encode_static({{0.f, 0.f, 1.f, 1.f, 1.f}});
+	if (favored.empty() && !plain.empty()) {
+		ST_SKIP("This libaom does not support Regions of Interest.");
+	}
+	ST_CHECK(!plain.empty() && !favored.empty());
+	if (plain.empty() || favored.empty()) {
+		return;
+	}
+	ST_CHECK(std::accumulate(favored.begin(), favored.end(), size_t(0))
+			 > std::accumulate(plain.begin(), plain.end(), size_t(0)));
+
+	// The picture never changes, so the frames after the key frame must still be predicted from it. Were the region
+	// forced to intra, each of them would cost about as much as the key frame.
+	ST_CHECK(favored.size() > 1);
+	if (favored.size() > 1) {
+		size_t inter = *std::max_element(favored.begin() + 1, favored.end());
+		ST_CHECK(inter * 4 < favored.front());
+	}
+}
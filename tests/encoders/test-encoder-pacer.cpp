@@ -0,0 +1,130 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include "encoders/encoder-pacer.hpp"
+
+using namespace streamfx::encoder;
+using namespace std::chrono_literals;
+
+namespace {
+	// At 30 fps the budget is 33.3ms and the window 30 frames.
+	constexpr std::size_t window = 30;
+
+	pacer_event submit_many(pacer& p, std::size_t count, std::chrono::nanoseconds duration)
+	{
+		pacer_event last = pacer_event::NONE;
+		for (std::size_t idx = 0; idx < count; idx++) {
+			if (auto event = p.submit(duration); event != pacer_event::NONE) {
+				last = event;
+			}
+		}
+		return last;
+	}
+} // namespace
+
+ST_TEST(pacer_invalid)
+{
+	ST_CHECK_THROWS(pacer(0, 1, {0}));
+	ST_CHECK_THROWS(pacer(30, 0, {0}));
+	ST_CHECK_THROWS(pacer(30, 1, {}));
+}
+
+ST_TEST(pacer_budget)
+{
+	pacer p{60000, 1001, {0}};
+	ST_CHECK(p.get_budget() == 16683333ns);
+}
+
+ST_TEST(pacer_waits_for_full_window)
+{
+	pacer p{30, 1, {0, 1}};
+	ST_CHECK(submit_many(p, window - 1, 100ms) == pacer_event::NONE);
+	ST_CHECK(p.submit(100ms) == pacer_event::DOWNGRADED);
+	ST_CHECK((p.get_step() == 1) && (p.get() == 1));
+}
+
+ST_TEST(pacer_downgrades_then_overloads_once)
+{
+	pacer p{30, 1, {8, 9, 10}};
+	ST_CHECK(submit_many(p, window, 40ms) == pacer_event::DOWNGRADED);
+	ST_CHECK(submit_many(p, window, 40ms) == pacer_event::DOWNGRADED);
+	ST_CHECK(p.get() == 10);
+	ST_CHECK(submit_many(p, window, 40ms) == pacer_event::OVERLOADED);
+	ST_CHECK(submit_many(p, window * 4, 40ms) == pacer_event::NONE);
+	ST_CHECK(p.is_overloaded() && (p.count_downgrades() == 2) && (p.count_overloads() == 1));
+
+	ST_CHECK(submit_many(p, window, 5ms) == pacer_event::RECOVERED);
+	ST_CHECK(!p.is_overloaded());
+}
+
+ST_TEST(pacer_ignores_middle_band)
+{
+	// Between half and 90% of the budget nothing changes in either direction.
+	pacer p{30, 1, {0, 1}};
+	ST_CHECK(submit_many(p, window, 40ms) == pacer_event::DOWNGRADED);
+	ST_CHECK(submit_many(p, window * 10, 25ms) == pacer_event::NONE);
+	ST_CHECK(p.get_step() == 1);
+}
+
+ST_TEST(pacer_delays_upgrade)
+{
+	pacer p{30, 1, {0, 1}};
+	ST_CHECK(submit_many(p, window, 40ms) == pacer_event::DOWNGRADED);
+
+	// The window has to fill again, then four windows worth of calm evaluations are needed.
+	ST_CHECK(submit_many(p, window + window * 4 - 2, 5ms) == pacer_event::NONE);
+	ST_CHECK(p.submit(5ms) == pacer_event::UPGRADED);
+	ST_CHECK((p.get_step() == 0) && (p.count_upgrades() == 1));
+}
+
+ST_TEST(pacer_spike_restarts_upgrade_delay)
+{
+	pacer p{30, 1, {0, 1}};
+	ST_CHECK(submit_many(p, window, 40ms) == pacer_event::DOWNGRADED);
+	ST_CHECK(submit_many(p, window * 3, 5ms) == pacer_event::NONE);
+
+	// Enough slow frames to push the 95th percentile into the middle band.
+	ST_CHECK(submit_many(p, 2, 25ms) == pacer_event::NONE);
+	ST_CHECK(submit_many(p, window * 3, 5ms) == pacer_event::NONE);
+	ST_CHECK(p.get_step() == 1);
+}
+
+ST_TEST(pacer_upgrade_to_slow_step_is_undone_within_a_window)
+{
+	// The configured step is too slow, the next one is fast. The pacer must keep probing the slow step, but each
+	// attempt may only cost a single window of frames before it steps down again.
+	pacer       p{30, 1, {0, 1}};
+	std::size_t slow_run = 0;
+	std::size_t probes   = 0;
+	for (std::size_t frame = 0; frame < 3000; frame++) {
+		bool slow = (p.get_step() == 0);
+		slow_run  = slow ? slow_run + 1 : 0;
+		ST_CHECK(slow_run <= window);
+
+		if (p.submit(slow ? 40ms : 5ms) == pacer_event::UPGRADED) {
+			probes++;
+		}
+	}
+	ST_CHECK(probes > 0);
+
+	// One downgrade for the initial step, one per probe, except for a probe that is still running.
+	ST_CHECK((p.count_downgrades() == probes) || (p.count_downgrades() == (probes + 1)));
+}
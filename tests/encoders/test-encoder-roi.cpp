@@ -0,0 +1,181 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include <algorithm>
+#include "encoders/encoder-roi.hpp"
+#include "shim.hpp"
+
+using namespace streamfx::encoder;
+using namespace streamfx::tests;
+
+namespace {
+	constexpr uint64_t ms = 1000000ull;
+
+	bool contains(const std::vector<region>& regions, const region& value)
+	{
+		return std::find(regions.begin(), regions.end(), value) != regions.end();
+	}
+} // namespace
+
+// Every test uses its own channel, the process-wide one would leak publications between tests.
+
+ST_TEST(roi_channel_publish_and_query)
+{
+	roi_channel channel;
+	int         publisher;
+	channel.publish(&publisher, 1000 * ms, {{.25f, .25f, .75f, .75f, 1.f}});
+
+	auto regions = channel.query(1000 * ms);
+	ST_CHECK(regions.size() == 1);
+	ST_CHECK(contains(regions, {.25f, .25f, .75f, .75f, 1.f}));
+}
+
+ST_TEST(roi_channel_clamps_regions)
+{
+	roi_channel channel;
+	int         publisher;
+	channel.publish(&publisher, 1000 * ms, {{-.5f, -1.f, 1.5f, .5f, 4.f}, {.5f, .5f, 2.f, 2.f, -3.f}});
+
+	auto regions = channel.query(1000 * ms);
+	ST_CHECK(regions.size() == 2);
+	ST_CHECK(contains(regions, {0.f, 0.f, 1.f, .5f, 1.f}));
+	ST_CHECK(contains(regions, {.5f, .5f, 1.f, 1.f, -1.f}));
+}
+
+ST_TEST(roi_channel_drops_empty_regions)
+{
+	roi_channel channel;
+	int         publisher;
+	channel.publish(&publisher, 1000 * ms,
+					{
+						{.5f, .5f, .5f, .75f, 1.f},  // No width.
+						{.5f, .75f, .75f, .5f, 1.f}, // Upside down.
+						{1.5f, 0.f, 2.f, 1.f, 1.f},  // Entirely outside of the canvas.
+						{0.f, 0.f, 1.f, 1.f, 0.f},   // No change in importance.
+					});
+	ST_CHECK(channel.query(1000 * ms).empty());
+}
+
+ST_TEST(roi_channel_replaces_and_retracts)
+{
+	roi_channel channel;
+	int         publisher;
+	channel.publish(&publisher, 1000 * ms, {{0.f, 0.f, .5f, .5f, 1.f}, {.5f, .5f, 1.f, 1.f, 1.f}});
+	channel.publish(&publisher, 1010 * ms, {{.25f, .25f, .5f, .5f, .5f}});
+
+	auto regions = channel.query(1010 * ms);
+	ST_CHECK(regions.size() == 1);
+	ST_CHECK(contains(regions, {.25f, .25f, .5f, .5f, .5f}));
+
+	channel.retract(&publisher);
+	ST_CHECK(channel.query(1010 * ms).empty());
+
+	// Retracting something that was never published is harmless.
+	channel.retract(&channel);
+}
+
+ST_TEST(roi_channel_merges_publishers)
+{
+	roi_channel channel;
+	int         first, second;
+	channel.publish(&first, 1000 * ms, {{0.f, 0.f, .5f, .5f, 1.f}});
+	channel.publish(&second, 1000 * ms, {{.5f, .5f, 1.f, 1.f, -.5f}});
+
+	auto regions = channel.query(1000 * ms);
+	ST_CHECK(regions.size() == 2);
+	ST_CHECK(contains(regions, {0.f, 0.f, .5f, .5f, 1.f}));
+	ST_CHECK(contains(regions, {.5f, .5f, 1.f, 1.f, -.5f}));
+
+	channel.retract(&first);
+	regions = channel.query(1000 * ms);
+	ST_CHECK((regions.size() == 1) && contains(regions, {.5f, .5f, 1.f, 1.f, -.5f}));
+}
+
+ST_TEST(roi_channel_drops_stale_publications)
+{
+	roi_channel channel;
+	int         stale, fresh;
+	channel.publish(&stale, 1000 * ms, {{0.f, 0.f, .5f, .5f, 1.f}});
+	channel.publish(&fresh, 1200 * ms, {{.5f, .5f, 1.f, 1.f, 1.f}});
+
+	// A publisher which stopped rendering a quarter of a second ago no longer counts.
+	ST_CHECK(channel.query(1250 * ms).size() == 2);
+	auto regions = channel.query(1300 * ms);
+	ST_CHECK((regions.size() == 1) && contains(regions, {.5f, .5f, 1.f, 1.f, 1.f}));
+
+	// Asking about an earlier frame again finds what was valid back then.
+	regions = channel.query(1000 * ms);
+	ST_CHECK((regions.size() == 1) && contains(regions, {0.f, 0.f, .5f, .5f, 1.f}));
+}
+
+ST_TEST(roi_channel_picks_the_frames_own_publication)
+{
+	roi_channel channel;
+	int         publisher;
+	channel.publish(&publisher, 1000 * ms, {{0.f, 0.f, .25f, .25f, 1.f}});
+	channel.publish(&publisher, 1016 * ms, {{.25f, .25f, .5f, .5f, 1.f}});
+	channel.publish(&publisher, 1033 * ms, {{.5f, .5f, .75f, .75f, 1.f}});
+
+	// Encoders run behind rendering, so every frame must get the faces that were found in it, not the newest ones.
+	auto regions = channel.query(1000 * ms);
+	ST_CHECK((regions.size() == 1) && contains(regions, {0.f, 0.f, .25f, .25f, 1.f}));
+	regions = channel.query(1016 * ms);
+	ST_CHECK((regions.size() == 1) && contains(regions, {.25f, .25f, .5f, .5f, 1.f}));
+	regions = channel.query(1033 * ms);
+	ST_CHECK((regions.size() == 1) && contains(regions, {.5f, .5f, .75f, .75f, 1.f}));
+
+	// A frame the publisher skipped gets the publication before it.
+	regions = channel.query(1020 * ms);
+	ST_CHECK((regions.size() == 1) && contains(regions, {.25f, .25f, .5f, .5f, 1.f}));
+
+	// Nothing was published for frames before the first publication.
+	ST_CHECK(channel.query(990 * ms).empty());
+}
+
+ST_TEST(roi_channel_forgets_old_history)
+{
+	roi_channel channel;
+	int         publisher;
+	channel.publish(&publisher, 1000 * ms, {{0.f, 0.f, .25f, .25f, 1.f}});
+	channel.publish(&publisher, 1100 * ms, {{.25f, .25f, .5f, .5f, 1.f}});
+	channel.publish(&publisher, 3000 * ms, {{.5f, .5f, .75f, .75f, 1.f}});
+
+	// Only the last publication before the history cut off is kept.
+	ST_CHECK(channel.query(1050 * ms).empty());
+	auto regions = channel.query(1200 * ms);
+	ST_CHECK((regions.size() == 1) && contains(regions, {.25f, .25f, .5f, .5f, 1.f}));
+}
+
+ST_TEST(roi_clock_maps_pts_to_video_time)
+{
+	// The first frame anchors the clock on the last rendered frame.
+	shim::set_video_frame_time(5000 * ms);
+	roi_clock clock;
+	ST_CHECK(clock.get(120, 60) == 5000 * ms);
+
+	// Later frames follow their pts, no matter when they arrive.
+	shim::set_video_frame_time(9000 * ms);
+	ST_CHECK(clock.get(180, 60) == 6000 * ms);
+	ST_CHECK(clock.get(181, 60) == 6000 * ms + 16666666ull);
+	ST_CHECK(clock.get(0, 60) == 3000 * ms);
+
+	shim::set_video_frame_time(0);
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Handing frames from one thread to another through the queue in locked and in lock-free mode, with as many frames in
+// flight as an encoder with a small delay has. Then the pattern of the FFmpeg encoder's frame pool, one pop and push
+// per frame, and the same with the resolution switching back and forth, which is served from the buckets.
+
+#include "benchmark.hpp"
+#include <atomic>
+#include <cinttypes>
+#include <thread>
+#include "ffmpeg/avframe-queue.hpp"
+
+using namespace streamfx;
+using namespace streamfx::tests;
+
+namespace {
+	int64_t now_ns()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				   std::chrono::steady_clock::now().time_since_epoch())
+			.count();
+	}
+
+	void handoff(const std::string& name, bool spsc, std::size_t iterations)
+	{
+		constexpr std::size_t depth = 8;
+
+		ffmpeg::avframe_queue                 queue(spsc, depth);
+		std::vector<std::shared_ptr<AVFrame>> frames;
+		for (std::size_t idx = 0; idx < depth; idx++) {
+			frames.emplace_back(av_frame_alloc(), [](AVFrame* frame) { av_frame_free(&frame); });
+		}
+
+		benchmark::samples       latency;
+		benchmark::stopwatch     total;
+		std::atomic<std::size_t> consumed{0};
+		std::thread              producer([&]() {
+			for (std::size_t idx = 0; idx < iterations; idx++) {
+				while ((idx - consumed.load(std::memory_order_acquire)) >= depth) {
+					std::this_thread::yield();
+				}
+				auto& frame = frames[idx % depth];
+				frame->pts  = now_ns();
+				queue.push(frame);
+			}
+		});
+
+		for (std::size_t idx = 0; idx < iterations;) {
+			auto frame = queue.pop_only();
+			if (!frame) {
+				std::this_thread::yield();
+				continue;
+			}
+			latency.add(static_cast<double>(now_ns() - frame->pts));
+			frame.reset();
+			consumed.store(++idx, std::memory_order_release);
+		}
+		producer.join();
+
+		benchmark::report(name, latency, total.wall_ns(), total.cpu_ns(), iterations);
+	}
+
+	void pool(const std::string& name, bool spsc, std::size_t iterations, std::size_t switch_interval)
+	{
+		ffmpeg::avframe_queue queue(spsc, 32);
+		queue.set_resolution(1920, 1080);
+		queue.set_pixel_format(AV_PIX_FMT_NV12);
+		queue.push(queue.pop()); // Allocate the first frame outside of the measurement.
+
+		benchmark::samples   latency;
+		benchmark::stopwatch total;
+		for (std::size_t idx = 1; idx <= iterations; idx++) {
+			benchmark::stopwatch sw;
+			if ((switch_interval != 0) && ((idx % switch_interval) == 0)) {
+				bool large = queue.get_width() == 1920;
+				queue.set_resolution(large ? 1280 : 1920, large ? 720 : 1080);
+			}
+			queue.push(queue.pop());
+			latency.add(sw.wall_ns());
+		}
+		benchmark::report(name, latency, total.wall_ns(), total.cpu_ns(), iterations);
+
+		auto stats = queue.get_statistics();
+		std::printf("%-48s hits %" PRIu64 ", recycled %" PRIu64 ", allocated %" PRIu64 ", released %" PRIu64 "\n", "",
+					stats.hits, stats.recycled, stats.misses, stats.dropped);
+	}
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+	std::size_t iterations = benchmark::iterations(argc, argv, 200000);
+
+	handoff("handoff, locked", false, iterations);
+	handoff("handoff, lock-free", true, iterations);
+
+	pool("pool, locked", false, iterations, 0);
+	pool("pool, lock-free", true, iterations, 0);
+	pool("pool, lock-free, resolution switch every 60", true, iterations, 60);
+
+	return 0;
+}
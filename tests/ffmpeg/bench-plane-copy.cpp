@@ -0,0 +1,113 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Copying and widening the luma plane of 1080p and 4K frames, as the encoder input paths do for every frame. The
+// reference is the copy the FFmpeg encoder used before: one memcpy if the strides match, one per row otherwise.
+// Widening is compared against a plain loop over all samples.
+
+#include "benchmark.hpp"
+#include <cstdint>
+#include <functional>
+#include "ffmpeg/plane-copy.hpp"
+
+using namespace streamfx;
+using namespace streamfx::tests;
+
+namespace {
+	struct plane {
+		const char* name;
+		std::size_t width;
+		std::size_t height;
+		std::size_t src_stride;
+		std::size_t dst_stride;
+	};
+
+	const plane planes[] = {
+		{"1080p", 1920, 1080, 1920, 1920},
+		{"1080p padded", 1920, 1080, 1984, 2048},
+		{"4K", 3840, 2160, 3840, 3840},
+		{"4K padded", 3840, 2160, 3904, 4096},
+	};
+
+	void copy_reference(uint8_t* dst, std::size_t dst_stride, const uint8_t* src, std::size_t src_stride,
+						std::size_t width, std::size_t height)
+	{
+		if (dst_stride == src_stride) {
+			std::memcpy(dst, src, src_stride * height);
+			return;
+		}
+		for (std::size_t y = 0; y < height; y++, dst += dst_stride, src += src_stride) {
+			std::memcpy(dst, src, width);
+		}
+	}
+
+	void widen_reference(uint16_t* dst, std::size_t dst_stride, const uint8_t* src, std::size_t src_stride,
+						 std::size_t width, std::size_t height)
+	{
+		for (std::size_t y = 0; y < height; y++) {
+			uint16_t*      out = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(dst) + y * dst_stride);
+			const uint8_t* in  = src + y * src_stride;
+			for (std::size_t x = 0; x < width; x++) {
+				out[x] = static_cast<uint16_t>(in[x] << 2);
+			}
+		}
+	}
+
+	void run(const std::string& name, std::size_t iterations, std::size_t bytes, const std::function<void()>& work)
+	{
+		work(); // Touch all memory once, so that page faults aren't counted.
+
+		benchmark::samples   latency;
+		benchmark::stopwatch total;
+		for (std::size_t idx = 0; idx < iterations; idx++) {
+			benchmark::stopwatch sw;
+			work();
+			latency.add(sw.wall_ns());
+		}
+		benchmark::report(name, latency, total.wall_ns(), total.cpu_ns(), iterations, bytes * iterations);
+	}
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+	std::size_t iterations = benchmark::iterations(argc, argv, 500);
+
+	for (auto& p : planes) {
+		std::vector<uint8_t>  src(p.src_stride * p.height, 0x80);
+		std::vector<uint8_t>  dst(p.dst_stride * p.height);
+		std::vector<uint16_t> wide(p.dst_stride * p.height);
+		std::string           name = p.name;
+
+		run("copy " + name + ", memcpy", iterations, p.width * p.height, [&]() {
+			copy_reference(dst.data(), p.dst_stride, src.data(), p.src_stride, p.width, p.height);
+		});
+		run("copy " + name + ", copy_plane", iterations, p.width * p.height, [&]() {
+			ffmpeg::copy_plane(dst.data(), p.dst_stride, src.data(), p.src_stride, p.width, p.height);
+		});
+		run("widen " + name + " to 10-bit, loop", iterations, p.width * p.height * 2, [&]() {
+			widen_reference(wide.data(), p.dst_stride * 2, src.data(), p.src_stride, p.width, p.height);
+		});
+		run("widen " + name + " to 10-bit, widen_plane", iterations, p.width * p.height * 2, [&]() {
+			ffmpeg::widen_plane(wide.data(), p.dst_stride * 2, src.data(), p.src_stride, p.width, p.height, 10, false);
+		});
+	}
+
+	return 0;
+}
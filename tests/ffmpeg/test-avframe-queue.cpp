@@ -0,0 +1,194 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include <atomic>
+#include <thread>
+#include "ffmpeg/avframe-queue.hpp"
+
+using namespace streamfx;
+
+namespace {
+	void expect_statistics(ffmpeg::avframe_queue& queue, uint64_t hits, uint64_t recycled, uint64_t misses,
+						   uint64_t dropped)
+	{
+		auto stats = queue.get_statistics();
+		ST_CHECK(stats.hits == hits);
+		ST_CHECK(stats.recycled == recycled);
+		ST_CHECK(stats.misses == misses);
+		ST_CHECK(stats.dropped == dropped);
+	}
+
+	void check_frame(const std::shared_ptr<AVFrame>& frame, int width, int height, AVPixelFormat format)
+	{
+		ST_CHECK(frame);
+		ST_CHECK(frame->width == width);
+		ST_CHECK(frame->height == height);
+		ST_CHECK(frame->format == format);
+		ST_CHECK(frame->data[0] != nullptr);
+	}
+} // namespace
+
+ST_TEST(reuse)
+{
+	for (bool spsc : {false, true}) {
+		ffmpeg::avframe_queue queue(spsc, 4);
+		queue.set_resolution(64, 32);
+		queue.set_pixel_format(AV_PIX_FMT_YUV420P);
+
+		auto frame = queue.pop();
+		check_frame(frame, 64, 32, AV_PIX_FMT_YUV420P);
+		expect_statistics(queue, 0, 0, 1, 0);
+
+		queue.push(frame);
+		ST_CHECK(queue.size() == 1);
+		ST_CHECK(queue.pop() == frame);
+		ST_CHECK(queue.empty());
+		expect_statistics(queue, 1, 0, 1, 0);
+
+		// pop_only() never allocates.
+		ST_CHECK(queue.pop_only() == nullptr);
+		expect_statistics(queue, 1, 0, 1, 0);
+	}
+}
+
+ST_TEST(buckets)
+{
+	for (bool spsc : {false, true}) {
+		ffmpeg::avframe_queue queue(spsc, 4);
+		queue.set_resolution(64, 32);
+		queue.set_pixel_format(AV_PIX_FMT_YUV420P);
+		auto small = queue.pop();
+
+		// A frame of the old size goes into a bucket, and a new one is allocated.
+		queue.push(small);
+		queue.set_resolution(128, 64);
+		auto large = queue.pop();
+		check_frame(large, 128, 64, AV_PIX_FMT_YUV420P);
+		ST_CHECK(queue.empty());
+		expect_statistics(queue, 0, 0, 2, 0);
+
+		// Switching back takes the frame out of its bucket again, instead of allocating another one.
+		queue.push(large);
+		queue.set_resolution(64, 32);
+		ST_CHECK(queue.pop() == small);
+		expect_statistics(queue, 0, 1, 2, 0);
+
+		// The same goes for the format.
+		queue.push(small);
+		queue.set_pixel_format(AV_PIX_FMT_NV12);
+		auto nv12 = queue.pop();
+		check_frame(nv12, 64, 32, AV_PIX_FMT_NV12);
+		queue.push(nv12);
+		queue.set_pixel_format(AV_PIX_FMT_YUV420P);
+		ST_CHECK(queue.pop() == small);
+		queue.set_resolution(128, 64);
+		ST_CHECK(queue.pop() == large);
+		expect_statistics(queue, 0, 3, 3, 0);
+
+		// clear() releases the buckets as well.
+		queue.push(small);
+		queue.pop(); // Moves 'small' into a bucket.
+		queue.clear();
+		queue.set_resolution(64, 32);
+		ST_CHECK(queue.pop() != small);
+	}
+}
+
+ST_TEST(bucket_capacity)
+{
+	ffmpeg::avframe_queue queue(false);
+	queue.set_resolution(16, 16);
+	queue.set_pixel_format(AV_PIX_FMT_GRAY8);
+	queue.precache(20);
+	ST_CHECK(queue.size() == 20);
+
+	// Only eight mismatched frames are kept per size and format, the rest is released.
+	queue.set_resolution(32, 32);
+	queue.pop();
+	ST_CHECK(queue.empty());
+	expect_statistics(queue, 0, 0, 21, 12);
+
+	queue.set_resolution(16, 16);
+	for (std::size_t idx = 0; idx < 9; idx++) {
+		queue.pop();
+	}
+	expect_statistics(queue, 0, 8, 22, 12);
+}
+
+ST_TEST(spsc_capacity)
+{
+	// The ring rounds up to a power of two, and releases frames once full instead of growing.
+	ffmpeg::avframe_queue queue(true, 5);
+	queue.set_resolution(16, 16);
+	queue.set_pixel_format(AV_PIX_FMT_GRAY8);
+	queue.precache(9);
+	ST_CHECK(queue.size() == 8);
+	expect_statistics(queue, 0, 0, 9, 1);
+
+	for (std::size_t idx = 0; idx < 8; idx++) {
+		ST_CHECK(queue.pop_only() != nullptr);
+	}
+	ST_CHECK(queue.pop_only() == nullptr);
+	expect_statistics(queue, 8, 0, 9, 1);
+}
+
+ST_TEST(spsc_handoff)
+{
+	// One thread pushes, another pops, and every frame arrives exactly once and in order.
+	constexpr std::size_t capacity = 16;
+	constexpr int64_t     count    = 200000;
+
+	ffmpeg::avframe_queue                 queue(true, capacity);
+	std::vector<std::shared_ptr<AVFrame>> frames;
+	for (std::size_t idx = 0; idx < capacity; idx++) {
+		frames.emplace_back(av_frame_alloc(), [](AVFrame* frame) { av_frame_free(&frame); });
+	}
+
+	std::atomic<int64_t> consumed{0};
+	std::thread          producer([&]() {
+		for (int64_t idx = 0; idx < count; idx++) {
+			// A frame is only handed out again once the consumer is done with it.
+			while ((idx - consumed.load(std::memory_order_acquire)) >= static_cast<int64_t>(capacity)) {
+				std::this_thread::yield();
+			}
+			auto& frame = frames[static_cast<std::size_t>(idx) % capacity];
+			frame->pts  = idx;
+			queue.push(frame);
+		}
+	});
+
+	bool in_order = true;
+	for (int64_t idx = 0; idx < count;) {
+		auto frame = queue.pop_only();
+		if (!frame) {
+			std::this_thread::yield();
+			continue;
+		}
+		in_order &= (frame->pts == idx);
+		frame.reset();
+		consumed.store(++idx, std::memory_order_release);
+	}
+	producer.join();
+
+	ST_CHECK(in_order);
+	ST_CHECK(queue.empty());
+	expect_statistics(queue, static_cast<uint64_t>(count), 0, 0, 0);
+}
@@ -0,0 +1,186 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <thread>
+#include <vector>
+#include "ffmpeg/plane-copy.hpp"
+#include "plugin.hpp"
+#include "util/util-threadpool.hpp"
+
+using namespace streamfx;
+
+namespace {
+	struct layout {
+		std::size_t width;
+		std::size_t height;
+		std::size_t src_stride;
+		std::size_t dst_stride;
+	};
+
+	// Small and odd sizes, then large enough to stream past the cache, and large enough to be split across threads.
+	const std::vector<layout> layouts = {
+		{1, 1, 1, 1},
+		{7, 3, 7, 7},
+		{7, 3, 16, 9},
+		{100, 50, 128, 100},
+		{1920, 1080, 1920, 1920},
+		{1920, 1080, 2048, 1984},
+		{3840, 2160, 3840, 3840},
+		{3840, 2160, 3904, 4096},
+	};
+
+	uint8_t pattern(std::size_t x, std::size_t y)
+	{
+		return static_cast<uint8_t>(x * 7 + y * 13);
+	}
+
+	std::vector<uint8_t> make_source(const layout& l)
+	{
+		std::vector<uint8_t> src(l.src_stride * l.height);
+		for (std::size_t y = 0; y < l.height; y++) {
+			for (std::size_t x = 0; x < l.src_stride; x++) {
+				src[y * l.src_stride + x] = pattern(x, y);
+			}
+		}
+		return src;
+	}
+} // namespace
+
+ST_TEST(copy_plane_layouts)
+{
+	for (auto& l : layouts) {
+		std::vector<uint8_t> src = make_source(l);
+
+		// Offset by a few bytes, so that the destination is not aligned for streaming stores.
+		for (std::size_t offset : {0, 3}) {
+			std::vector<uint8_t> dst(l.dst_stride * l.height + offset, 0xEE);
+			ffmpeg::copy_plane(dst.data() + offset, l.dst_stride, src.data(), l.src_stride, l.width, l.height);
+
+			bool valid = true;
+			for (std::size_t y = 0; y < l.height; y++) {
+				const uint8_t* row = dst.data() + offset + y * l.dst_stride;
+				for (std::size_t x = 0; x < l.width; x++) {
+					valid = valid && (row[x] == pattern(x, y));
+				}
+
+				// Padding is only copied along when both planes share the stride.
+				for (std::size_t x = l.width; (l.src_stride != l.dst_stride) && (x < l.dst_stride); x++) {
+					valid = valid && (row[x] == 0xEE);
+				}
+			}
+			ST_CHECK(valid);
+			ST_CHECK((offset == 0) || (dst[0] == 0xEE));
+		}
+	}
+}
+
+ST_TEST(copy_plane_busy_pool)
+{
+	// Occupy every worker of the pool, like long running jobs of other filters do.
+	std::promise<void>       release;
+	std::shared_future<void> released = release.get_future().share();
+	for (std::size_t idx = 0; idx < std::max(std::thread::hardware_concurrency(), 1u) * 4; idx++) {
+		streamfx::threadpool()->push([released](streamfx::util::threadpool_data_t) { released.wait(); }, nullptr);
+	}
+
+	// The copy is large enough to be split, yet must not wait for the pool to get around to its helpers.
+	layout               l   = {3840, 2160, 3840, 3840};
+	std::vector<uint8_t> src = make_source(l);
+	std::vector<uint8_t> dst(l.dst_stride * l.height);
+	auto copy = std::async(std::launch::async, [&]() {
+		ffmpeg::copy_plane(dst.data(), l.dst_stride, src.data(), l.src_stride, l.width, l.height);
+	});
+
+	bool finished = (copy.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+	release.set_value();
+	copy.wait();
+
+	ST_CHECK(finished);
+	ST_CHECK(dst == src);
+}
+
+ST_TEST(copy_plane_empty)
+{
+	uint8_t dst = 0xEE;
+	uint8_t src = 0x11;
+	ffmpeg::copy_plane(&dst, 1, &src, 1, 0, 1);
+	ffmpeg::copy_plane(&dst, 1, &src, 1, 1, 0);
+	ST_CHECK(dst == 0xEE);
+}
+
+ST_TEST(widen_plane_layouts)
+{
+	for (auto& l : layouts) {
+		std::vector<uint8_t> src = make_source(l);
+
+		for (uint8_t depth : {10, 16}) {
+			for (bool replicate : {false, true}) {
+				std::vector<uint16_t> dst(l.dst_stride * l.height, 0xEEEE);
+				ffmpeg::widen_plane(dst.data(), l.dst_stride * 2, src.data(), l.src_stride, l.width, l.height, depth,
+									replicate);
+
+				bool valid = true;
+				for (std::size_t y = 0; y < l.height; y++) {
+					for (std::size_t x = 0; x < l.width; x++) {
+						uint16_t v    = pattern(x, y);
+						uint16_t high = static_cast<uint16_t>(v << (depth - 8));
+						uint16_t low  = replicate ? static_cast<uint16_t>(v >> (16 - depth)) : 0;
+						valid         = valid && (dst[y * l.dst_stride + x] == (high | low));
+					}
+					for (std::size_t x = l.width; x < l.dst_stride; x++) {
+						valid = valid && (dst[y * l.dst_stride + x] == 0xEEEE);
+					}
+				}
+				ST_CHECK(valid);
+			}
+		}
+	}
+}
+
+ST_TEST(widen_plane_range)
+{
+	// Every depth, with the 16 samples the vector path handles at once and a tail.
+	std::vector<uint8_t> src(33);
+	for (std::size_t x = 0; x < src.size(); x++) {
+		src[x] = (x % 2) ? 255 : 16;
+	}
+
+	for (uint8_t depth = 9; depth <= 16; depth++) {
+		std::vector<uint16_t> plain(src.size());
+		std::vector<uint16_t> full(src.size());
+		ffmpeg::widen_plane(plain.data(), plain.size() * 2, src.data(), src.size(), src.size(), 1, depth, false);
+		ffmpeg::widen_plane(full.data(), full.size() * 2, src.data(), src.size(), src.size(), 1, depth, true);
+		for (std::size_t x = 0; x < src.size(); x++) {
+			// Limited range black stays exact, full range white reaches the new maximum only when replicated.
+			uint16_t maximum = static_cast<uint16_t>((1u << depth) - 1);
+			ST_CHECK(plain[x] == ((x % 2) ? (255u << (depth - 8)) : (16u << (depth - 8))));
+			ST_CHECK(full[x] == ((x % 2) ? maximum : ((16u << (depth - 8)) | (16u >> (16 - depth)))));
+		}
+	}
+
+	uint16_t dst = 0;
+	uint8_t  one = 1;
+	ST_CHECK_THROWS(ffmpeg::widen_plane(&dst, 2, &one, 1, 1, 1, 8, false));
+	ST_CHECK_THROWS(ffmpeg::widen_plane(&dst, 2, &one, 1, 1, 1, 17, false));
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include "ffmpeg/probe-cache.hpp"
+#include "plugin.hpp"
+
+using namespace streamfx;
+
+namespace {
+	constexpr const char* driver = "libstreamfx-test-driver.so";
+
+	void update_driver(const std::filesystem::path& path, const char* version)
+	{
+		std::ofstream file(path / driver, std::ios::binary | std::ios::trunc);
+		file << "driver " << version;
+	}
+
+	/// Forget everything saved so far, and put a fresh driver library where the loader would look for it.
+	std::filesystem::path reset()
+	{
+		std::filesystem::remove(streamfx::config_file_path("ffmpeg-probes.json"));
+
+		auto path = std::filesystem::temp_directory_path() / "streamfx-tests" / "drivers";
+		std::filesystem::create_directories(path);
+		setenv("LD_LIBRARY_PATH", path.u8string().c_str(), 1);
+		update_driver(path, "1.0");
+		return path;
+	}
+
+	/// Run a probe on a new cache, as if OBS Studio had just started, and save the cache afterwards.
+	bool probe(std::string_view library, bool result, int& calls)
+	{
+		auto cache = std::make_shared<ffmpeg::probe_cache>();
+		bool value = cache->probe("test", library, [result, &calls]() {
+			calls++;
+			return result;
+		});
+		cache->save();
+		return value;
+	}
+} // namespace
+
+ST_TEST(probe_cache_hit)
+{
+	reset();
+
+	int calls = 0;
+	ST_CHECK(probe(driver, true, calls) == true);
+	ST_CHECK(calls == 1);
+
+	// The second start answers from the cache, even though the probe would now disagree.
+	ST_CHECK(probe(driver, false, calls) == true);
+	ST_CHECK(calls == 1);
+}
+
+ST_TEST(probe_cache_driver_update)
+{
+	auto path = reset();
+
+	int calls = 0;
+	ST_CHECK(probe(driver, true, calls) == true);
+	update_driver(path, "1.1-hotfix");
+	ST_CHECK(probe(driver, false, calls) == false);
+	ST_CHECK(calls == 2);
+
+	// The new result is cached for the new driver.
+	ST_CHECK(probe(driver, true, calls) == false);
+	ST_CHECK(calls == 2);
+}
+
+ST_TEST(probe_cache_missing_driver)
+{
+	reset();
+
+	// Without a fingerprint, an update couldn't be told apart from no update, so the probe runs every time.
+	int calls = 0;
+	ST_CHECK(probe("libstreamfx-missing-driver.so", true, calls) == true);
+	ST_CHECK(probe("libstreamfx-missing-driver.so", false, calls) == false);
+	ST_CHECK(calls == 2);
+}
+
+ST_TEST(probe_cache_loaded_driver)
+{
+	reset();
+
+#if defined(__linux__)
+	// Outside of LD_LIBRARY_PATH, found where the loader found it.
+	int calls = 0;
+	ST_CHECK(probe("libc.so.6", true, calls) == true);
+	ST_CHECK(probe("libc.so.6", false, calls) == true);
+	ST_CHECK(calls == 1);
+#else
+	ST_SKIP("Only Linux can look up loaded libraries.");
+#endif
+}
+
+ST_TEST(probe_cache_refresh)
+{
+	reset();
+
+	int calls = 0;
+	ST_CHECK(probe(driver, true, calls) == true);
+
+	// The cached result is used right away, the refreshed one on the next start.
+	auto cache = std::make_shared<ffmpeg::probe_cache>();
+	ST_CHECK(cache->probe("test", driver, []() { return false; }) == true);
+	cache->refresh();
+
+	auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	bool value   = true;
+	while (value && (std::chrono::steady_clock::now() < timeout)) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		cache->save();
+		value = probe(driver, true, calls);
+	}
+	ST_CHECK(value == false);
+	ST_CHECK(calls == 1);
+}
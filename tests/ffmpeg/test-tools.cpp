@@ -0,0 +1,110 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include "ffmpeg/tools.hpp"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/samplefmt.h>
+}
+
+using namespace streamfx;
+
+namespace {
+	const audio_format audio_formats[] = {
+		AUDIO_FORMAT_U8BIT,        AUDIO_FORMAT_16BIT,        AUDIO_FORMAT_32BIT,        AUDIO_FORMAT_FLOAT,
+		AUDIO_FORMAT_U8BIT_PLANAR, AUDIO_FORMAT_16BIT_PLANAR, AUDIO_FORMAT_32BIT_PLANAR, AUDIO_FORMAT_FLOAT_PLANAR,
+	};
+
+	// Channel order of libobs, which FFmpeg has to agree with as samples are passed through unchanged.
+	const std::pair<speaker_layout, uint64_t> speaker_layouts[] = {
+		{SPEAKERS_MONO, AV_CH_FRONT_CENTER},
+		{SPEAKERS_STEREO, AV_CH_FRONT_LEFT | AV_CH_FRONT_RIGHT},
+		{SPEAKERS_2POINT1, AV_CH_FRONT_LEFT | AV_CH_FRONT_RIGHT | AV_CH_LOW_FREQUENCY},
+		{SPEAKERS_4POINT0, AV_CH_FRONT_LEFT | AV_CH_FRONT_RIGHT | AV_CH_FRONT_CENTER | AV_CH_BACK_CENTER},
+		{SPEAKERS_4POINT1,
+		 AV_CH_FRONT_LEFT | AV_CH_FRONT_RIGHT | AV_CH_FRONT_CENTER | AV_CH_LOW_FREQUENCY | AV_CH_BACK_CENTER},
+		{SPEAKERS_5POINT1, AV_CH_FRONT_LEFT | AV_CH_FRONT_RIGHT | AV_CH_FRONT_CENTER | AV_CH_LOW_FREQUENCY
+							   | AV_CH_BACK_LEFT | AV_CH_BACK_RIGHT},
+		{SPEAKERS_7POINT1, AV_CH_FRONT_LEFT | AV_CH_FRONT_RIGHT | AV_CH_FRONT_CENTER | AV_CH_LOW_FREQUENCY
+							   | AV_CH_BACK_LEFT | AV_CH_BACK_RIGHT | AV_CH_SIDE_LEFT | AV_CH_SIDE_RIGHT},
+	};
+
+	uint32_t count_channels(uint64_t layout)
+	{
+		uint32_t count = 0;
+		for (; layout != 0; layout &= layout - 1) {
+			count++;
+		}
+		return count;
+	}
+} // namespace
+
+ST_TEST(audio_format)
+{
+	for (audio_format format : audio_formats) {
+		AVSampleFormat sample_fmt = ffmpeg::tools::obs_audioformat_to_avsampleformat(format);
+		ST_CHECK(sample_fmt != AV_SAMPLE_FMT_NONE);
+		ST_CHECK(ffmpeg::tools::avsampleformat_to_obs_audioformat(sample_fmt) == format);
+
+		// libobs hands over the samples as they are, so the layout in memory has to match exactly.
+		ST_CHECK((av_sample_fmt_is_planar(sample_fmt) != 0) == is_audio_planar(format));
+		ST_CHECK(static_cast<size_t>(av_get_bytes_per_sample(sample_fmt)) == get_audio_bytes_per_channel(format));
+	}
+
+	ST_CHECK(ffmpeg::tools::obs_audioformat_to_avsampleformat(AUDIO_FORMAT_UNKNOWN) == AV_SAMPLE_FMT_NONE);
+	ST_CHECK(ffmpeg::tools::avsampleformat_to_obs_audioformat(AV_SAMPLE_FMT_NONE) == AUDIO_FORMAT_UNKNOWN);
+	ST_CHECK(ffmpeg::tools::avsampleformat_to_obs_audioformat(AV_SAMPLE_FMT_DBL) == AUDIO_FORMAT_UNKNOWN);
+	ST_CHECK(ffmpeg::tools::avsampleformat_to_obs_audioformat(AV_SAMPLE_FMT_DBLP) == AUDIO_FORMAT_UNKNOWN);
+	ST_CHECK(ffmpeg::tools::avsampleformat_to_obs_audioformat(AV_SAMPLE_FMT_S64) == AUDIO_FORMAT_UNKNOWN);
+}
+
+ST_TEST(speaker_layout)
+{
+	for (auto& [speakers, layout] : speaker_layouts) {
+		ST_CHECK(ffmpeg::tools::obs_speakers_to_av_channel_layout(speakers) == layout);
+		ST_CHECK(count_channels(layout) == get_audio_channels(speakers));
+	}
+
+	ST_CHECK(ffmpeg::tools::obs_speakers_to_av_channel_layout(SPEAKERS_UNKNOWN) == 0);
+}
+
+ST_TEST(context_setup_audio)
+{
+	for (audio_format format : audio_formats) {
+		for (auto& [speakers, layout] : speaker_layouts) {
+			for (uint32_t rate : {44100u, 48000u}) {
+				audio_output_info aoi = {"test", rate, format, speakers};
+				AVCodecContext*   ctx = avcodec_alloc_context3(nullptr);
+				ffmpeg::tools::context_setup_from_obs(&aoi, ctx);
+
+				bool okay = (ctx->sample_rate == static_cast<int>(rate)) && (ctx->time_base.num == 1)
+							&& (ctx->time_base.den == static_cast<int>(rate))
+							&& (ctx->sample_fmt == ffmpeg::tools::obs_audioformat_to_avsampleformat(format))
+							&& (ctx->channel_layout == layout)
+							&& (ctx->channels == static_cast<int>(get_audio_channels(speakers)));
+				avcodec_free_context(&ctx);
+				ST_CHECK(okay);
+			}
+		}
+	}
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Stand-in for libFuzzer, which only exists for Clang. Runs the target on every file given on the command line, and
+// then on random inputs that are biased towards zero and one bytes so that start codes and small headers are common.
+
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+	std::vector<uint8_t> current;
+
+	void on_crash(int sig)
+	{
+		// Keep the input around so that the failure can be reproduced by passing the file back in.
+		if (FILE* file = std::fopen("fuzz-crash.bin", "wb"); file) {
+			std::fwrite(current.data(), 1, current.size(), file);
+			std::fclose(file);
+			std::fprintf(stderr, "Input written to 'fuzz-crash.bin'.\n");
+		}
+		std::signal(sig, SIG_DFL);
+		std::raise(sig);
+	}
+
+	uint64_t option(int argc, const char* argv[], const char* name, uint64_t fallback)
+	{
+		for (int idx = 1; (idx + 1) < argc; idx++) {
+			if (std::strcmp(argv[idx], name) == 0) {
+				return std::strtoull(argv[idx + 1], nullptr, 10);
+			}
+		}
+		return fallback;
+	}
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+	uint64_t iterations = option(argc, argv, "--iterations", 100000);
+	uint64_t seed       = option(argc, argv, "--seed", 0x5354524541D46658ull);
+	uint64_t max_size   = option(argc, argv, "--max-size", 4096);
+
+	std::signal(SIGABRT, on_crash);
+	std::signal(SIGSEGV, on_crash);
+
+	for (int idx = 1; idx < argc; idx++) {
+		if (std::strncmp(argv[idx], "--", 2) == 0) {
+			idx++;
+			continue;
+		}
+
+		std::ifstream file(argv[idx], std::ios::binary);
+		current.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		LLVMFuzzerTestOneInput(current.data(), current.size());
+	}
+
+	std::mt19937_64 rng(seed);
+	for (uint64_t iteration = 0; iteration < iterations; iteration++) {
+		current.resize(static_cast<size_t>(rng() % (max_size + 1)));
+		for (auto& byte : current) {
+			uint64_t value = rng();
+			switch (value & 0x0F) {
+			case 0:
+			case 1:
+			case 2:
+			case 3:
+			case 4:
+			case 5:
+				byte = 0x00;
+				break;
+			case 6:
+			case 7:
+				byte = 0x01;
+				break;
+			default:
+				byte = static_cast<uint8_t>(value >> 8);
+				break;
+			}
+		}
+
+		// Copy into an exactly sized allocation, so that the sanitizers catch any read past the end.
+		std::vector<uint8_t> input(current.begin(), current.end());
+		LLVMFuzzerTestOneInput(input.data(), input.size());
+	}
+
+	std::printf("%llu inputs passed.\n", static_cast<unsigned long long>(iterations));
+	return 0;
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include "gfx/lut/gfx-lut-consumer.hpp"
+#include "gfx/lut/gfx-lut-producer.hpp"
+#include "shim.hpp"
+
+using namespace streamfx::gfx::lut;
+using namespace streamfx::obs;
+namespace shim = streamfx::tests::shim;
+
+ST_TEST(lut_effects_load)
+{
+	auto data = data::instance();
+	ST_CHECK(data->producer_effect());
+	ST_CHECK(data->consumer_effect());
+	ST_CHECK(data->consumer_effect()->has_parameter("lut_params_0", gs::effect_parameter::type::Integer4));
+	ST_CHECK(data->consumer_effect()->has_parameter("lut_params_1", gs::effect_parameter::type::Float4));
+}
+
+ST_TEST(lut_producer_writes_every_draw)
+{
+	producer lut_producer;
+
+	shim::clear_calls();
+	auto lut = lut_producer.produce(color_depth::_6);
+	ST_CHECK(lut && (lut->get_width() == 512) && (lut->get_height() == 512));
+	ST_CHECK(shim::count_calls("gs_effect_set_val", "lut_params_0") == 1);
+	ST_CHECK(shim::count_calls("gs_effect_loop", "Draw") == 1);
+
+	// Drawing made the effect forget the parameters, so they have to be written again.
+	shim::clear_calls();
+	lut_producer.produce(color_depth::_6);
+	ST_CHECK(shim::count_calls("gs_effect_set_val", "lut_params_0") == 1);
+	ST_CHECK(shim::count_calls("gs_effect_loop", "Draw") == 1);
+
+	shim::clear_calls();
+	lut = lut_producer.produce(color_depth::_4);
+	ST_CHECK(lut && (lut->get_width() == 64));
+	ST_CHECK(shim::count_calls("gs_effect_set_val", "lut_params_0") == 1);
+}
+
+ST_TEST(lut_consumer_writes_every_draw)
+{
+	consumer lut_consumer;
+	auto     lut   = std::make_shared<gs::texture>(512, 512, GS_RGBA, 1, nullptr, gs::texture::flags::None);
+	auto     image = std::make_shared<gs::texture>(64, 64, GS_RGBA, 1, nullptr, gs::texture::flags::None);
+
+	for (std::size_t frame = 0; frame < 2; frame++) {
+		shim::clear_calls();
+		lut_consumer.consume(color_depth::_6, lut, image);
+		ST_CHECK(shim::count_calls("gs_effect_set_val") == 2);
+		ST_CHECK(shim::count_calls("gs_effect_set_texture", "lut") == 1);
+		ST_CHECK(shim::count_calls("gs_effect_set_texture", "image") == 1);
+		ST_CHECK(shim::count_calls("gs_draw_sprite") == 1);
+	}
+
+	// Preparing again without drawing in between writes nothing.
+	shim::clear_calls();
+	auto effect = lut_consumer.prepare(color_depth::_6, lut);
+	lut_consumer.prepare(color_depth::_6, lut);
+	ST_CHECK(shim::count_calls("gs_effect_set_val") == 2);
+
+	int32_t size = 0, grid_size = 0, container_size = 0, unused = 0;
+	effect->get_parameter("lut_params_0").get_int4(size, grid_size, container_size, unused);
+	ST_CHECK((size == 64) && (grid_size == 8) && (container_size == 512));
+}
+
+ST_TEST(lut_consumers_share_effect)
+{
+	consumer first;
+	consumer second;
+	auto     lut = std::make_shared<gs::texture>(512, 512, GS_RGBA, 1, nullptr, gs::texture::flags::None);
+
+	first.prepare(color_depth::_6, lut);
+	second.prepare(color_depth::_8, lut);
+
+	// The shared effect now holds the parameters for 8 bit, so the first consumer must write its own again.
+	shim::clear_calls();
+	first.prepare(color_depth::_6, lut);
+	ST_CHECK(shim::count_calls("gs_effect_set_val") == 2);
+
+	int32_t size = 0, grid_size = 0, container_size = 0, unused = 0;
+	auto    effect = data::instance()->consumer_effect();
+	effect->get_parameter("lut_params_0").get_int4(size, grid_size, container_size, unused);
+	ST_CHECK(size == 64);
+}
@@ -0,0 +1,208 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// A scene of ten blur filters, each drawing two passes per frame, and what it costs to find their effect parameters:
+// by scanning all parameters with strcmp as before the index, through the index, or resolved once by reference. The
+// parameter block also resolves once. libobs forgets all values when a technique ends, so the block writes every value
+// again for the second pass, where the others only set the two that differ and leave the rest at their defaults.
+
+#include "benchmark.hpp"
+#include <functional>
+#include "obs/gs/gs-effect.hpp"
+#include "shim.hpp"
+
+extern "C" {
+#include <graphics/effect.h>
+}
+
+using namespace streamfx::obs;
+using namespace streamfx::tests;
+namespace shim = streamfx::tests::shim;
+
+namespace {
+	constexpr std::size_t filters = 10;
+
+	// The parameters of 'blur/box.effect', which is what most blur filters use.
+	constexpr const char* effect_code = R"(
+		uniform float4x4 ViewProj;
+		uniform texture2d pImage;
+		uniform float2 pImageTexel;
+		uniform float2 pStepScale;
+		uniform float pSize;
+		uniform float pSizeInverseMul;
+		uniform float pAngle;
+		uniform float2 pCenter;
+		uniform texture2d pMaskInputA;
+		uniform texture2d pMaskInputB;
+		uniform float4 pMaskColor;
+		uniform float pMaskMultiplier;
+		technique Horizontal { pass { pixel_shader = PSBlur(vtx); } }
+		technique Vertical { pass { pixel_shader = PSBlur(vtx); } }
+	)";
+
+	std::size_t string_compares = 0;
+
+	// How 'gs::effect::get_parameter' looked up parameters before the index.
+	gs::effect_parameter scan(gs::effect& effect, const std::string& name)
+	{
+		for (std::size_t idx = 0; idx < effect->params.num; idx++) {
+			auto ptr = effect->params.array + idx;
+			string_compares++;
+			if (strcmp(ptr->name, name.c_str()) == 0) {
+				return gs::effect_parameter(ptr, effect);
+			}
+		}
+		return nullptr;
+	}
+
+	struct filter {
+		gs::effect                   effect;
+		std::shared_ptr<gs::texture> texture;
+		gs::effect_parameter_ref     image;
+		gs::effect_parameter_ref     image_texel;
+		gs::effect_parameter_ref     step_scale;
+		gs::effect_parameter_ref     size;
+		gs::effect_parameter_ref     size_inverse_mul;
+		gs::effect_parameter_block   block;
+
+		filter()
+			: effect(effect_code, "blur"),
+			  texture(std::make_shared<gs::texture>(64, 64, GS_RGBA, 1, nullptr, gs::texture::flags::None)),
+			  image("pImage"), image_texel("pImageTexel"), step_scale("pStepScale"), size("pSize"),
+			  size_inverse_mul("pSizeInverseMul"),
+			  block(effect, {"pImage", "pImageTexel", "pStepScale", "pSize", "pSizeInverseMul"})
+		{}
+	};
+
+	// Each pass sets five parameters, the second one only two, as the box blur does.
+	std::size_t frame_scan(std::vector<filter>& scene)
+	{
+		for (auto& f : scene) {
+			scan(f.effect, "pImage").set_texture(f.texture);
+			scan(f.effect, "pImageTexel").set_float2(1.f / 64.f, 0.f);
+			scan(f.effect, "pStepScale").set_float2(1.f, 1.f);
+			scan(f.effect, "pSize").set_float(5.f);
+			scan(f.effect, "pSizeInverseMul").set_float(1.f / 11.f);
+			while (gs_effect_loop(f.effect.get_object(), "Horizontal")) {
+			}
+			scan(f.effect, "pImage").set_texture(f.texture);
+			scan(f.effect, "pImageTexel").set_float2(0.f, 1.f / 64.f);
+			while (gs_effect_loop(f.effect.get_object(), "Vertical")) {
+			}
+		}
+		return scene.size() * 7;
+	}
+
+	std::size_t frame_index(std::vector<filter>& scene)
+	{
+		for (auto& f : scene) {
+			f.effect.get_parameter("pImage").set_texture(f.texture);
+			f.effect.get_parameter("pImageTexel").set_float2(1.f / 64.f, 0.f);
+			f.effect.get_parameter("pStepScale").set_float2(1.f, 1.f);
+			f.effect.get_parameter("pSize").set_float(5.f);
+			f.effect.get_parameter("pSizeInverseMul").set_float(1.f / 11.f);
+			while (gs_effect_loop(f.effect.get_object(), "Horizontal")) {
+			}
+			f.effect.get_parameter("pImage").set_texture(f.texture);
+			f.effect.get_parameter("pImageTexel").set_float2(0.f, 1.f / 64.f);
+			while (gs_effect_loop(f.effect.get_object(), "Vertical")) {
+			}
+		}
+		return scene.size() * 7;
+	}
+
+	std::size_t frame_ref(std::vector<filter>& scene)
+	{
+		for (auto& f : scene) {
+			f.image(f.effect).set_texture(f.texture);
+			f.image_texel(f.effect).set_float2(1.f / 64.f, 0.f);
+			f.step_scale(f.effect).set_float2(1.f, 1.f);
+			f.size(f.effect).set_float(5.f);
+			f.size_inverse_mul(f.effect).set_float(1.f / 11.f);
+			while (gs_effect_loop(f.effect.get_object(), "Horizontal")) {
+			}
+			f.image(f.effect).set_texture(f.texture);
+			f.image_texel(f.effect).set_float2(0.f, 1.f / 64.f);
+			while (gs_effect_loop(f.effect.get_object(), "Vertical")) {
+			}
+		}
+		return scene.size() * 7;
+	}
+
+	std::size_t frame_block(std::vector<filter>& scene)
+	{
+		std::size_t writes = 0;
+		for (auto& f : scene) {
+			f.block.set_texture(0, f.texture);
+			f.block.set_float2(1, 1.f / 64.f, 0.f);
+			f.block.set_float2(2, 1.f, 1.f);
+			f.block.set_float(3, 5.f);
+			f.block.set_float(4, 1.f / 11.f);
+			writes += f.block.flush();
+			while (gs_effect_loop(f.effect.get_object(), "Horizontal")) {
+			}
+			f.block.set_texture(0, f.texture);
+			f.block.set_float2(1, 0.f, 1.f / 64.f);
+			writes += f.block.flush();
+			while (gs_effect_loop(f.effect.get_object(), "Vertical")) {
+			}
+		}
+		return writes;
+	}
+
+	void run(const std::string& name, std::size_t lookups, std::vector<filter>& scene, std::size_t iterations,
+			 const std::function<std::size_t(std::vector<filter>&)>& frame)
+	{
+		string_compares    = 0;
+		std::size_t writes = 0;
+
+		benchmark::samples   latency;
+		benchmark::stopwatch total;
+		for (std::size_t idx = 0; idx < iterations; idx++) {
+			benchmark::stopwatch sw;
+			writes += frame(scene);
+			latency.add(sw.wall_ns());
+		}
+		benchmark::report(name, latency, total.wall_ns(), total.cpu_ns(), iterations);
+		std::printf("%-48s %10zu lookups/frame  %zu writes/frame", "", lookups, writes / iterations);
+		if (string_compares != 0) {
+			std::printf("  %zu strcmp/frame", string_compares / iterations);
+		}
+		std::printf("\n");
+	}
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+	std::size_t iterations = benchmark::iterations(argc, argv, 100000);
+
+	std::vector<filter> scene(filters);
+	shim::set_recording(false);
+
+	// Parameter references resolve on their first use, which the warm up takes care of.
+	frame_ref(scene);
+
+	run("strcmp scan (10 filters)", filters * 7, scene, iterations, frame_scan);
+	run("sorted index (10 filters)", filters * 7, scene, iterations, frame_index);
+	run("effect_parameter_ref (10 filters)", 0, scene, iterations, frame_ref);
+	run("effect_parameter_block (10 filters)", 0, scene, iterations, frame_block);
+
+	return 0;
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The mip mapped cache of the Transform filter for a 1080p source, which is 2048x2048 with 11 levels, on a real OpenGL
+// driver. Compares the cache without mip maps, gs::mipmapper generating them in place, and the render and copy per
+// level that Direct3D 11 still needs, done here with a linear blit to an intermediate target and a copy per level.
+
+#include "benchmark.hpp"
+#include <functional>
+#include "obs/gs/gs-mipmapper.hpp"
+#include "obs/gs/gs-rendertarget.hpp"
+#include "shim.hpp"
+
+extern "C" {
+#include <graphics/vec4.h>
+}
+
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+using namespace streamfx::obs;
+using namespace streamfx::tests;
+namespace shim = streamfx::tests::shim;
+
+namespace {
+	constexpr uint32_t size   = 2048;
+	constexpr uint32_t levels = 11; // As the Transform filter asks for, the last one is 2x2.
+
+	GLuint gl_name(const std::shared_ptr<gs::texture>& texture)
+	{
+		return *static_cast<uint32_t*>(gs_texture_get_obj(texture->get_object()));
+	}
+
+	struct scene {
+		gs::rendertarget             cache;
+		std::shared_ptr<gs::texture> cache_texture;
+		std::shared_ptr<gs::texture> target;
+		std::shared_ptr<gs::texture> intermediate;
+		gs::mipmapper                mipmapper;
+		GLuint                       framebuffers[2];
+
+		scene()
+			: cache(GS_RGBA, GS_ZS_NONE),
+			  target(std::make_shared<gs::texture>(size, size, GS_RGBA, levels, nullptr, gs::texture::flags::None)),
+			  intermediate(std::make_shared<gs::texture>(size, size, GS_RGBA, 1, nullptr, gs::texture::flags::None)),
+			  mipmapper(), framebuffers()
+		{
+			glGenFramebuffers(2, framebuffers);
+		}
+
+		~scene()
+		{
+			glDeleteFramebuffers(2, framebuffers);
+		}
+
+		// What the Transform filter draws into its cache, here only a clear to a different color every frame.
+		void render_cache(std::size_t frame)
+		{
+			{
+				auto op    = cache.render(size, size);
+				vec4 color = {};
+				vec4_set(&color, static_cast<float>(frame % 256) / 255.f, .5f, .25f, 1.f);
+				gs_clear(GS_CLEAR_COLOR, &color, 0, 0);
+			}
+			cache.get_texture(cache_texture);
+		}
+
+		// Render each level from the one above into an intermediate target, then copy it into place.
+		void render_and_copy()
+		{
+			gs_copy_texture_region(target->get_object(), 0, 0, cache_texture->get_object(), 0, 0, 0, 0);
+			for (uint32_t mip = 1; mip < levels; mip++) {
+				GLint width  = std::max<GLint>(size >> mip, 1);
+				GLint height = std::max<GLint>(size >> mip, 1);
+
+				glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffers[0]);
+				glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gl_name(target),
+									   static_cast<GLint>(mip - 1));
+				glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffers[1]);
+				glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gl_name(intermediate),
+									   0);
+				glBlitFramebuffer(0, 0, width * 2, height * 2, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+				glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+				glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+
+				glCopyImageSubData(gl_name(intermediate), GL_TEXTURE_2D, 0, 0, 0, 0, gl_name(target), GL_TEXTURE_2D,
+								   static_cast<GLint>(mip), 0, 0, 0, width, height, 1);
+			}
+		}
+
+		// The last level must hold the color of the whole frame.
+		bool check(std::size_t frame)
+		{
+			uint8_t pixel[4] = {};
+			glBindTexture(GL_TEXTURE_2D, gl_name(target));
+			glGetTexImage(GL_TEXTURE_2D, static_cast<GLint>(levels - 1), GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+			glBindTexture(GL_TEXTURE_2D, 0);
+			return (pixel[0] == (frame % 256)) && (pixel[1] >= 127) && (pixel[1] <= 128);
+		}
+	};
+
+	bool run(const std::string& name, scene& s, std::size_t iterations, const std::function<void()>& mipmap = nullptr)
+	{
+		benchmark::samples   latency;
+		benchmark::stopwatch total;
+		for (std::size_t idx = 0; idx < iterations; idx++) {
+			benchmark::stopwatch sw;
+			s.render_cache(idx);
+			if (mipmap) {
+				mipmap();
+			}
+			glFinish();
+			latency.add(sw.wall_ns());
+		}
+		benchmark::report(name, latency, total.wall_ns(), total.cpu_ns(), iterations);
+
+		bool valid = !mipmap || s.check(iterations - 1);
+		if (!valid) {
+			std::printf("%-48s mip maps have the wrong content\n", "");
+		}
+		return valid;
+	}
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+	std::size_t iterations = benchmark::iterations(argc, argv, 100);
+
+	if (!shim::enable_opengl()) {
+		std::printf("OpenGL is not available, skipped.\n");
+		return 77;
+	}
+	shim::set_recording(false);
+
+	scene s;
+	bool  success = true;
+	success &= run("transform cache 2048x2048, no mip maps", s, iterations);
+	success &= run("transform cache 2048x2048, in place", s, iterations,
+				   [&s]() { s.mipmapper.rebuild(s.cache_texture, s.target); });
+	success &= run("transform cache 2048x2048, render and copy", s, iterations, [&s]() { s.render_and_copy(); });
+	return success ? 0 : 1;
+}
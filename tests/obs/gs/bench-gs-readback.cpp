@@ -0,0 +1,131 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Reading 1080p frames back to the CPU with one, two and three staging surfaces, on a real OpenGL driver. With one
+// surface every map waits for the copy that was just queued, more surfaces trade frames of latency for not waiting.
+// Reports the time stage() takes on the graphics thread, and how long frames take to arrive at the callback.
+
+#include "benchmark.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include "obs/gs/gs-readback.hpp"
+#include "obs/gs/gs-rendertarget.hpp"
+#include "shim.hpp"
+
+extern "C" {
+#include <graphics/vec4.h>
+}
+
+using namespace streamfx::obs;
+using namespace streamfx::tests;
+namespace shim = streamfx::tests::shim;
+
+namespace {
+	constexpr uint32_t width  = 1920;
+	constexpr uint32_t height = 1080;
+
+	// The frame number, as the color of the whole frame.
+	vec4 frame_color(std::size_t frame)
+	{
+		vec4 color;
+		vec4_set(&color, static_cast<float>(frame % 256) / 255.f, static_cast<float>((frame / 256) % 256) / 255.f,
+				 0.f, 1.f);
+		return color;
+	}
+
+	bool matches(const gs::readback::frame& frame)
+	{
+		return (frame.data.size() >= 4) && (frame.data[0] == (frame.timestamp % 256))
+			   && (frame.data[1] == ((frame.timestamp / 256) % 256));
+	}
+
+	bool run(const std::string& name, std::size_t buffers, std::size_t iterations)
+	{
+		using clock = std::chrono::steady_clock;
+
+		std::vector<clock::time_point> staged(iterations);
+		benchmark::samples             delivery;
+		std::size_t                    delivered = 0;
+		std::size_t                    wrong     = 0;
+		std::mutex                     lock;
+		std::condition_variable        cv;
+
+		auto callback = [&](std::shared_ptr<gs::readback::frame> frame) {
+			auto                         now = clock::now();
+			std::unique_lock<std::mutex> ul(lock);
+			delivery.add(now - staged[frame->timestamp]);
+			wrong += matches(*frame) ? 0 : 1;
+			delivered++;
+			cv.notify_all();
+		};
+
+		gs::readback     rb(buffers, callback);
+		gs::rendertarget rt(GS_RGBA, GS_ZS_NONE);
+
+		benchmark::samples   latency;
+		benchmark::stopwatch total;
+		for (std::size_t idx = 0; idx < iterations; idx++) {
+			{
+				auto op    = rt.render(width, height);
+				vec4 color = frame_color(idx);
+				gs_clear(GS_CLEAR_COLOR, &color, 0, 0);
+			}
+
+			staged[idx] = clock::now();
+			benchmark::stopwatch sw;
+			rb.stage(rt.get_texture(), idx);
+			latency.add(sw.wall_ns());
+		}
+		rb.flush();
+		{
+			std::unique_lock<std::mutex> ul(lock);
+			cv.wait(ul, [&]() { return delivered == iterations; });
+		}
+		benchmark::report(name, latency, total.wall_ns(), total.cpu_ns(), iterations,
+						  static_cast<std::size_t>(width) * height * 4 * iterations);
+
+		std::unique_lock<std::mutex> ul(lock);
+		std::printf("%-48s %10zu frames of latency  delivery p50 %10.1f us  p95 %10.1f us  p99 %10.1f us\n", "",
+					rb.get_latency(), delivery.percentile(50) / 1e3, delivery.percentile(95) / 1e3,
+					delivery.percentile(99) / 1e3);
+		if (wrong != 0) {
+			std::printf("%-48s %10zu frames had the wrong content\n", "", wrong);
+		}
+		return wrong == 0;
+	}
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+	std::size_t iterations = benchmark::iterations(argc, argv, 300);
+
+	if (!shim::enable_opengl()) {
+		std::printf("OpenGL is not available, skipped.\n");
+		return 77;
+	}
+	shim::set_recording(false);
+
+	bool success = true;
+	success &= run("readback 1080p RGBA, 1 buffer", 1, iterations);
+	success &= run("readback 1080p RGBA, 2 buffers", 2, iterations);
+	success &= run("readback 1080p RGBA, 3 buffers", 3, iterations);
+	return success ? 0 : 1;
+}
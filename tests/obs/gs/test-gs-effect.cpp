@@ -0,0 +1,316 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include "obs/gs/gs-effect.hpp"
+#include "shim.hpp"
+
+extern "C" {
+#include <graphics/effect.h>
+}
+
+using namespace streamfx::obs;
+namespace shim = streamfx::tests::shim;
+
+namespace {
+	constexpr const char* effect_code = R"(
+		uniform float4x4 ViewProj;
+		uniform texture2d pImage;
+		uniform float2 pImageTexel;
+		uniform float2 pStepScale = {1., 1.};
+		uniform float pSize = 5.0;
+		uniform int pMode <string name = "Mode"; int minimum = 0;> = 2;
+		uniform bool pEnabled;
+		uniform float3 pTint;
+		uniform float4 pColor;
+
+		technique Draw {
+			pass {
+				vertex_shader = VSDefault(vtx);
+				pixel_shader  = PSDraw(vtx);
+			}
+		}
+	)";
+
+	// The same parameters in a different order, as after a reload of a changed file.
+	constexpr const char* effect_code_reordered = R"(
+		uniform float pSize;
+		uniform texture2d pImage;
+		technique Draw { pass { pixel_shader = PSDraw(vtx); } }
+	)";
+
+	gs_eparam_t* raw_parameter(gs::effect& effect, const char* name)
+	{
+		for (std::size_t idx = 0; idx < effect->params.num; idx++) {
+			if (std::strcmp(effect->params.array[idx].name, name) == 0) {
+				return effect->params.array + idx;
+			}
+		}
+		return nullptr;
+	}
+} // namespace
+
+ST_TEST(effect_invalid)
+{
+	ST_CHECK_THROWS(gs::effect("uniform float pSize;", "invalid"));
+}
+
+ST_TEST(effect_parameter_index)
+{
+	gs::effect effect(effect_code, "test");
+	ST_CHECK(effect.count_parameters() == 9);
+
+	// Every parameter is found, no matter where it ended up in the sorted index.
+	for (std::size_t idx = 0; idx < effect.count_parameters(); idx++) {
+		auto* raw = effect->params.array + idx;
+		ST_CHECK(effect.get_parameter(raw->name).get() == raw);
+	}
+
+	ST_CHECK(!effect.get_parameter("pMissing"));
+	ST_CHECK(!effect.get_parameter(""));
+	ST_CHECK(!effect.get_parameter("pSiz"));
+	ST_CHECK(!effect.get_parameter("pSizeX"));
+	ST_CHECK(effect.has_parameter("pMode"));
+	ST_CHECK(effect.has_parameter("pMode", gs::effect_parameter::type::Integer));
+	ST_CHECK(!effect.has_parameter("pMode", gs::effect_parameter::type::Float));
+}
+
+ST_TEST(effect_parameter_index_string_view)
+{
+	gs::effect effect(effect_code, "test");
+
+	// Names that aren't terminated where the view ends must still match exactly.
+	std::string_view name("pSizeInverse", 5);
+	ST_CHECK(effect.get_parameter(name).get() == raw_parameter(effect, "pSize"));
+}
+
+ST_TEST(effect_parameter_values)
+{
+	gs::effect effect(effect_code, "test");
+
+	int32_t mode = 0;
+	effect.get_parameter("pMode").get_default_int(mode);
+	ST_CHECK(mode == 2);
+	ST_CHECK(effect.get_parameter("pMode").has_annotation("minimum", gs::effect_parameter::type::Integer));
+	ST_CHECK(effect.get_parameter("pMode").has_annotation("name", gs::effect_parameter::type::String));
+
+	float_t size = 0;
+	effect.get_parameter("pSize").set_float(3.f);
+	effect.get_parameter("pSize").get_float(size);
+	ST_CHECK(size == 3.f);
+	ST_CHECK_THROWS(effect.get_parameter("pSize").set_int(3));
+}
+
+ST_TEST(effect_parameter_ref_resolves_once)
+{
+	gs::effect               effect(effect_code, "test");
+	gs::effect_parameter_ref size("pSize");
+
+	gs_eparam_t* raw = raw_parameter(effect, "pSize");
+	ST_CHECK(size(effect).get() == raw);
+
+	// With the name changed, any lookup by name fails. The reference must keep what it resolved before.
+	raw->name[0] = 'x';
+	ST_CHECK(!effect.get_parameter("pSize"));
+	ST_CHECK(size(effect).get() == raw);
+	raw->name[0] = 'p';
+}
+
+ST_TEST(effect_parameter_ref_reload)
+{
+	gs::effect               effect(effect_code, "test");
+	gs::effect_parameter_ref size("pSize");
+	ST_CHECK(size(effect).get() == raw_parameter(effect, "pSize"));
+
+	effect = gs::effect(effect_code_reordered, "test");
+	ST_CHECK(size(effect).get() == raw_parameter(effect, "pSize"));
+
+	gs::effect other(effect_code, "other");
+	ST_CHECK(size(other).get() == raw_parameter(other, "pSize"));
+}
+
+ST_TEST(effect_parameter_ref_owns_name)
+{
+	gs::effect effect(effect_code, "test");
+
+	// Built from a name that is gone before the first lookup.
+	gs::effect_parameter_ref size(std::string("pS") + "ize");
+	ST_CHECK(size(effect).get() == raw_parameter(effect, "pSize"));
+}
+
+ST_TEST(effect_parameter_ref_type)
+{
+	gs::effect               effect(effect_code, "test");
+	gs::effect_parameter_ref size_float("pSize", gs::effect_parameter::type::Float);
+	gs::effect_parameter_ref size_int("pSize", gs::effect_parameter::type::Integer);
+	gs::effect_parameter_ref missing("pMissing");
+	gs::effect               empty;
+
+	ST_CHECK(size_float(effect));
+	ST_CHECK(!size_int(effect));
+	ST_CHECK(!missing(effect));
+	ST_CHECK(!size_float(empty));
+}
+
+ST_TEST(effect_parameter_block_flush)
+{
+	gs::effect                 effect(effect_code, "test");
+	gs::effect_parameter_block block(effect, {"pSize", "pStepScale", "pMode", "pColor"});
+	ST_CHECK(block.size() == 4);
+
+	// Only fields that were given a value are written.
+	block.set_float(0, 2.f);
+	block.set_float2(1, 1.f, .5f);
+	block.set_int(2, 1);
+
+	shim::clear_calls();
+	ST_CHECK(block.flush() == 3);
+	ST_CHECK(shim::count_calls("gs_effect_set_val") == 3);
+	ST_CHECK(shim::count_calls("gs_effect_set_val", "pColor") == 0);
+
+	float_t size = 0;
+	effect.get_parameter("pSize").get_float(size);
+	ST_CHECK(size == 2.f);
+	int32_t mode = 0;
+	effect.get_parameter("pMode").get_int(mode);
+	ST_CHECK(mode == 1);
+}
+
+ST_TEST(effect_parameter_block_unchanged)
+{
+	gs::effect                 effect(effect_code, "test");
+	gs::effect_parameter_block block(effect, {"pSize", "pStepScale", "pTint"});
+
+	block.set_float(0, 2.f);
+	block.set_float2(1, 1.f, .5f);
+	block.set_float3(2, .1f, .2f, .3f);
+	ST_CHECK(block.flush() == 3);
+
+	// The same values again before drawing write nothing.
+	shim::clear_calls();
+	for (std::size_t repeat = 0; repeat < 10; repeat++) {
+		block.set_float(0, 2.f);
+		block.set_float2(1, 1.f, .5f);
+		block.set_float3(2, .1f, .2f, .3f);
+		ST_CHECK(block.flush() == 0);
+	}
+	ST_CHECK(shim::calls().empty());
+
+	block.set_float2(1, 1.f, .25f);
+	ST_CHECK(block.flush() == 1);
+	ST_CHECK(shim::count_calls("gs_effect_set_val", "pStepScale") == 1);
+}
+
+ST_TEST(effect_parameter_block_after_draw)
+{
+	gs::effect                 effect(effect_code, "test");
+	gs::effect_parameter_block block(effect, {"pSize", "pStepScale", "pImage"});
+	auto tex = std::make_shared<gs::texture>(4, 4, GS_RGBA, 1, nullptr, gs::texture::flags::None);
+
+	block.set_float(0, 2.f);
+	block.set_float2(1, 1.f, .5f);
+	block.set_texture(2, tex);
+	ST_CHECK(block.flush() == 3);
+	while (gs_effect_loop(effect.get_object(), "Draw")) {
+	}
+
+	// Ending the technique made the effect forget everything, so the next frame has to write all values again even
+	// though none of them changed. Otherwise it would draw with the defaults.
+	ST_CHECK(effect.get_parameter("pSize").get_value_size_in_bytes() == 0);
+	block.set_float(0, 2.f);
+	block.set_float2(1, 1.f, .5f);
+	block.set_texture(2, tex);
+	ST_CHECK(block.flush() == 3);
+
+	float_t size = 0;
+	effect.get_parameter("pSize").get_float(size);
+	ST_CHECK(size == 2.f);
+}
+
+ST_TEST(effect_parameter_block_shared_effect)
+{
+	gs::effect                 effect(effect_code, "test");
+	gs::effect_parameter_block first(effect, {"pSize", "pColor"});
+	gs::effect_parameter_block second(effect, {"pSize"});
+
+	first.set_float(0, 1.f);
+	first.set_float4(1, 1.f, 0.f, 0.f, 1.f);
+	ST_CHECK(first.flush() == 2);
+
+	second.set_float(0, 2.f);
+	ST_CHECK(second.flush() == 1);
+
+	// The effect no longer holds what 'first' wrote, so it has to write again even though its values didn't change.
+	ST_CHECK(first.flush() == 1);
+
+	// The same applies to changes made without a block.
+	effect.get_parameter("pSize").set_float(3.f);
+	ST_CHECK(first.flush() == 1);
+}
+
+ST_TEST(effect_parameter_block_types)
+{
+	gs::effect                 effect(effect_code, "test");
+	gs::effect_parameter_block block(effect, {"pSize", "pEnabled", "ViewProj", "pMissing"});
+
+	ST_CHECK_THROWS(block.set_int(0, 1));
+	ST_CHECK_THROWS(block.set_float2(0, 1.f, 1.f));
+	ST_CHECK_THROWS(block.set_float(1, 1.f));
+	ST_CHECK_THROWS(block.set_float(4, 1.f));
+
+	// Parameters the effect doesn't have are ignored, no matter the type.
+	block.set_float(3, 1.f);
+	block.set_int4(3, 1, 2, 3, 4);
+
+	// Booleans are stored as 32-bit integers by libobs.
+	block.set_bool(1, true);
+
+	matrix4 identity = {};
+	identity.x.x = identity.y.y = identity.z.z = identity.t.w = 1.f;
+	block.set_matrix(2, identity);
+
+	ST_CHECK(block.flush() == 2);
+	ST_CHECK(effect.get_parameter("pEnabled").get_value_size_in_bytes() == sizeof(int32_t));
+	ST_CHECK(effect.get_parameter("ViewProj").get_value_size_in_bytes() == sizeof(matrix4));
+	ST_CHECK(block.flush() == 0);
+}
+
+ST_TEST(effect_parameter_block_textures)
+{
+	gs::effect                 effect(effect_code, "test");
+	gs::effect_parameter_block block(effect, {"pImage"});
+	auto tex = std::make_shared<gs::texture>(4, 4, GS_RGBA, 1, nullptr, gs::texture::flags::None);
+
+	ST_CHECK_THROWS(block.set_float(0, 1.f));
+
+	block.set_texture(0, tex);
+	shim::clear_calls();
+	ST_CHECK(block.flush() == 1);
+	ST_CHECK(block.flush() == 0);
+	ST_CHECK(shim::count_calls("gs_effect_set_texture", "pImage") == 1);
+
+	// A different texture, or one set by someone else, is handed over again.
+	auto other = std::make_shared<gs::texture>(4, 4, GS_RGBA, 1, nullptr, gs::texture::flags::None);
+	block.set_texture(0, other);
+	ST_CHECK(block.flush() == 1);
+	effect.get_parameter("pImage").set_texture(tex);
+	ST_CHECK(block.flush() == 1);
+	ST_CHECK(block.flush() == 0);
+}
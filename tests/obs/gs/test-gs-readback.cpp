@@ -0,0 +1,140 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "obs/gs/gs-readback.hpp"
+#include "shim.hpp"
+
+using namespace streamfx::obs;
+namespace shim = streamfx::tests::shim;
+
+namespace {
+	// Frames arrive on the thread pool, in any order.
+	struct collector {
+		std::mutex                                               lock;
+		std::condition_variable                                  cv;
+		std::map<uint64_t, std::shared_ptr<gs::readback::frame>> frames;
+
+		gs::readback::callback_t callback()
+		{
+			return [this](std::shared_ptr<gs::readback::frame> frame) {
+				std::unique_lock<std::mutex> ul(lock);
+				frames.emplace(frame->timestamp, frame);
+				cv.notify_all();
+			};
+		}
+
+		bool wait(std::size_t count)
+		{
+			std::unique_lock<std::mutex> ul(lock);
+			return cv.wait_for(ul, std::chrono::seconds(5), [this, count]() { return frames.size() >= count; });
+		}
+	};
+
+	// A texture with every byte set to 'value'.
+	std::shared_ptr<gs::texture> make_texture(uint32_t size, uint8_t value)
+	{
+		std::vector<uint8_t> data(size * size * 4, value);
+		const uint8_t*       mip = data.data();
+		return std::make_shared<gs::texture>(size, size, GS_RGBA, 1, &mip, gs::texture::flags::None);
+	}
+
+	bool filled(const gs::readback::frame& frame, uint8_t value)
+	{
+		for (uint8_t byte : frame.data) {
+			if (byte != value) {
+				return false;
+			}
+		}
+		return !frame.data.empty();
+	}
+} // namespace
+
+ST_TEST(readback_invalid)
+{
+	collector frames;
+	ST_CHECK_THROWS(gs::readback(0, frames.callback()));
+	ST_CHECK_THROWS(gs::readback(2, nullptr));
+
+	gs::readback rb(2, frames.callback());
+	ST_CHECK_THROWS(rb.stage(nullptr, 0));
+}
+
+ST_TEST(readback_latency)
+{
+	constexpr std::size_t count = 10;
+
+	std::vector<std::shared_ptr<gs::texture>> textures;
+	for (std::size_t idx = 0; idx < count; idx++) {
+		textures.push_back(make_texture(4, static_cast<uint8_t>(idx + 1)));
+	}
+
+	for (std::size_t buffers = 1; buffers <= 4; buffers++) {
+		collector    frames;
+		gs::readback rb(buffers, frames.callback());
+		ST_CHECK(rb.get_latency() == buffers - 1);
+
+		// A frame is only mapped once 'buffers - 1' newer ones were staged after it.
+		shim::clear_calls();
+		for (std::size_t idx = 0; idx < count; idx++) {
+			rb.stage(textures[idx], idx);
+			std::size_t expected = (idx + 1 >= buffers) ? (idx + 2 - buffers) : 0;
+			ST_CHECK(shim::count_calls("gs_stagesurface_map") == expected);
+			ST_CHECK(shim::count_calls("gs_stagesurface_unmap") == expected);
+		}
+		ST_CHECK(shim::count_calls("gs_stagesurface_map") == count + 1 - buffers);
+
+		rb.flush();
+		ST_CHECK(shim::count_calls("gs_stagesurface_map") == count);
+		ST_CHECK(frames.wait(count));
+		for (std::size_t idx = 0; idx < count; idx++) {
+			auto& frame = frames.frames.at(idx);
+			ST_CHECK((frame->width == 4) && (frame->height == 4) && (frame->linesize == 16));
+			ST_CHECK(filled(*frame, static_cast<uint8_t>(idx + 1)));
+		}
+
+		// Nothing is left to flush.
+		shim::clear_calls();
+		rb.flush();
+		ST_CHECK(shim::count_calls("gs_stagesurface_map") == 0);
+	}
+}
+
+ST_TEST(readback_resize)
+{
+	collector    frames;
+	gs::readback rb(2, frames.callback());
+
+	// Each slot follows the size of what is staged into it.
+	rb.stage(make_texture(4, 1), 0);
+	rb.stage(make_texture(8, 2), 1);
+	rb.stage(make_texture(4, 3), 2);
+	rb.flush();
+	ST_CHECK(frames.wait(3));
+	ST_CHECK((frames.frames.at(0)->width == 4) && filled(*frames.frames.at(0), 1));
+	ST_CHECK((frames.frames.at(1)->width == 8) && (frames.frames.at(1)->linesize == 32));
+	ST_CHECK(filled(*frames.frames.at(1), 2));
+	ST_CHECK((frames.frames.at(2)->width == 4) && filled(*frames.frames.at(2), 3));
+}
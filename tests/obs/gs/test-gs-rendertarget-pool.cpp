@@ -0,0 +1,112 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
+#include "shim.hpp"
+
+using namespace streamfx::obs;
+namespace shim = streamfx::tests::shim;
+
+// Every test uses its own pool, the process-wide one would share idle targets between tests.
+
+ST_TEST(rendertarget_pool_reuses_released_targets)
+{
+	auto pool = std::make_shared<gs::rendertarget_pool>();
+	shim::clear_calls();
+
+	auto lease = pool->acquire(16, 16, GS_RGBA);
+	lease.reset();
+	ST_CHECK(shim::count_calls("gs_texrender_create") == 1);
+	ST_CHECK(shim::count_calls("gs_texrender_destroy") == 0);
+
+	// Same size and format gets the released target back, anything else a new one.
+	lease = pool->acquire(16, 16, GS_RGBA);
+	ST_CHECK(shim::count_calls("gs_texrender_create") == 1);
+	auto other = pool->acquire(16, 16, GS_RGBA32F);
+	auto third = pool->acquire(16, 8, GS_RGBA);
+	ST_CHECK(shim::count_calls("gs_texrender_create") == 3);
+}
+
+ST_TEST(rendertarget_pool_tracks_resident_and_peak_size)
+{
+	auto pool = std::make_shared<gs::rendertarget_pool>();
+
+	// 16x16 RGBA is 1 KiB, 32x32 RGBA is 4 KiB and 16x16 RGBA with a 24 bit depth and 8 bit stencil buffer is 2 KiB.
+	auto first  = pool->acquire(16, 16, GS_RGBA);
+	auto second = pool->acquire(32, 32, GS_RGBA);
+	ST_CHECK(pool->get_leased_size() == 5120);
+	ST_CHECK(pool->get_resident_size() == 5120);
+	ST_CHECK(pool->get_peak_size() == 5120);
+
+	// Released targets stay resident until they are evicted.
+	second.reset();
+	ST_CHECK(pool->get_leased_size() == 1024);
+	ST_CHECK(pool->get_resident_size() == 5120);
+
+	// Reusing an idle target doesn't add to the peak, a new one only does once it exceeds it.
+	second = pool->acquire(32, 32, GS_RGBA);
+	ST_CHECK(pool->get_peak_size() == 5120);
+	auto third = pool->acquire(16, 16, GS_RGBA, GS_Z24_S8);
+	ST_CHECK(pool->get_resident_size() == 7168);
+	ST_CHECK(pool->get_peak_size() == 7168);
+
+	// Eviction lowers the resident size, but not the peak.
+	first.reset();
+	second.reset();
+	third.reset();
+	pool->set_budget(0);
+	shim::tick(0.);
+	ST_CHECK(pool->get_leased_size() == 0);
+	ST_CHECK(pool->get_resident_size() == 0);
+	ST_CHECK(pool->get_peak_size() == 7168);
+}
+
+ST_TEST(rendertarget_pool_evicts_least_recently_used)
+{
+	auto pool = std::make_shared<gs::rendertarget_pool>();
+	shim::clear_calls();
+
+	// 1 KiB, 512 bytes and 256 bytes, released from oldest to newest.
+	auto oldest = pool->acquire(16, 16, GS_RGBA);
+	auto older  = pool->acquire(16, 8, GS_RGBA);
+	auto newest = pool->acquire(8, 8, GS_RGBA);
+	oldest.reset();
+	older.reset();
+	newest.reset();
+	ST_CHECK(pool->get_resident_size() == 1792);
+
+	// Nothing is evicted while the idle targets fit into the budget.
+	pool->set_budget(1792);
+	shim::tick(0.);
+	ST_CHECK(shim::count_calls("gs_texrender_destroy") == 0);
+
+	// Over budget, the least recently used targets go first, and only as many as needed.
+	pool->set_budget(768);
+	shim::tick(0.);
+	ST_CHECK(shim::count_calls("gs_texrender_destroy") == 1);
+	ST_CHECK(pool->get_resident_size() == 768);
+
+	older  = pool->acquire(16, 8, GS_RGBA);
+	newest = pool->acquire(8, 8, GS_RGBA);
+	ST_CHECK(shim::count_calls("gs_texrender_create") == 3);
+	oldest = pool->acquire(16, 16, GS_RGBA);
+	ST_CHECK(shim::count_calls("gs_texrender_create") == 4);
+}
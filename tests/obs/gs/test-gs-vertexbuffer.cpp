@@ -0,0 +1,320 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "obs/gs/gs-vertexbuffer.hpp"
+#include "shim.hpp"
+
+extern "C" {
+#include "util/bmem.h"
+}
+
+using namespace streamfx::obs;
+namespace shim = streamfx::tests::shim;
+
+using attributes = gs::vertex_buffer::attributes;
+
+namespace {
+	constexpr uint32_t vertices = 16;
+
+	// Run 'fn(attributes, layers)' for every combination of the optional attributes and number of uv layers.
+	template<typename T>
+	void for_each_layout(T fn)
+	{
+		for (uint8_t mask = 0; mask < 8; mask++) {
+			attributes attribs = attributes::None;
+			attribs            = (mask & 1) ? (attribs | attributes::Normal) : attribs;
+			attribs            = (mask & 2) ? (attribs | attributes::Tangent) : attribs;
+			attribs            = (mask & 4) ? (attribs | attributes::Color) : attribs;
+			for (uint8_t layers = 0; layers <= gs::MAXIMUM_UVW_LAYERS; layers++) {
+				fn(attribs, layers);
+			}
+		}
+	}
+
+	// The streams the shim reports for a layout, in upload order.
+	std::string streams(attributes attribs, uint8_t layers)
+	{
+		std::string result = "points";
+		result += has(attribs, attributes::Normal) ? ",normals" : "";
+		result += has(attribs, attributes::Tangent) ? ",tangents" : "";
+		result += has(attribs, attributes::Color) ? ",colors" : "";
+		for (uint8_t n = 0; n < layers; n++) {
+			result += ",uv" + std::to_string(n);
+		}
+		return result;
+	}
+
+	bool aligned(const void* ptr)
+	{
+		return (reinterpret_cast<uintptr_t>(ptr) % 16) == 0;
+	}
+
+	// Give every element of every attribute a value that depends on 'seed', attribute and position.
+	void fill(gs::vertex_buffer& vb, float seed)
+	{
+		for (uint32_t idx = 0; idx < vb.size(); idx++) {
+			float value = seed + static_cast<float>(idx);
+			vec3_set(&vb.get_positions()[idx], value, value + 1.f, value + 2.f);
+			if (vb.get_normals()) {
+				vec3_set(&vb.get_normals()[idx], -value, 0.f, 1.f);
+			}
+			if (vb.get_tangents()) {
+				vec3_set(&vb.get_tangents()[idx], 1.f, -value, 0.f);
+			}
+			if (vb.get_colors()) {
+				vb.get_colors()[idx] = static_cast<uint32_t>(value) * 0x01010101u;
+			}
+			for (uint8_t n = 0; n < vb.get_uv_layers(); n++) {
+				vec4_set(&vb.get_uv_layer(n)[idx], value, static_cast<float>(n), 0.f, 1.f);
+			}
+		}
+	}
+
+	// Compare what the GPU holds for a stream with CPU memory.
+	bool uploaded(gs::vertex_buffer& vb, const char* stream, const void* data, std::size_t element)
+	{
+		auto gpu = shim::vertex_buffer_stream(vb.update(false), stream);
+		return gpu && (gpu->size() == element * vb.capacity())
+			   && (std::memcmp(gpu->data(), data, element * vb.size()) == 0);
+	}
+
+	bool uploaded(gs::vertex_buffer& vb)
+	{
+		bool result = uploaded(vb, "points", vb.get_positions(), sizeof(vec3));
+		if (vb.get_normals()) {
+			result = result && uploaded(vb, "normals", vb.get_normals(), sizeof(vec3));
+		}
+		if (vb.get_tangents()) {
+			result = result && uploaded(vb, "tangents", vb.get_tangents(), sizeof(vec3));
+		}
+		if (vb.get_colors()) {
+			result = result && uploaded(vb, "colors", vb.get_colors(), sizeof(uint32_t));
+		}
+		for (uint8_t n = 0; n < vb.get_uv_layers(); n++) {
+			result = result && uploaded(vb, ("uv" + std::to_string(n)).c_str(), vb.get_uv_layer(n), sizeof(vec4));
+		}
+		return result;
+	}
+
+	bool same(gs::vertex_buffer& a, gs::vertex_buffer& b)
+	{
+		bool result = (a.get_attributes() == b.get_attributes()) && (a.get_uv_layers() == b.get_uv_layers())
+					  && (a.size() == b.size())
+					  && (std::memcmp(a.get_positions(), b.get_positions(), sizeof(vec3) * a.size()) == 0);
+		if (result && a.get_normals()) {
+			result = std::memcmp(a.get_normals(), b.get_normals(), sizeof(vec3) * a.size()) == 0;
+		}
+		if (result && a.get_tangents()) {
+			result = std::memcmp(a.get_tangents(), b.get_tangents(), sizeof(vec3) * a.size()) == 0;
+		}
+		if (result && a.get_colors()) {
+			result = std::memcmp(a.get_colors(), b.get_colors(), sizeof(uint32_t) * a.size()) == 0;
+		}
+		for (uint8_t n = 0; result && (n < a.get_uv_layers()); n++) {
+			result = std::memcmp(a.get_uv_layer(n), b.get_uv_layer(n), sizeof(vec4) * a.size()) == 0;
+		}
+		return result;
+	}
+} // namespace
+
+ST_TEST(vertexbuffer_limits)
+{
+	ST_CHECK_THROWS(gs::vertex_buffer(gs::MAXIMUM_VERTICES + 1, 0, attributes::None));
+	ST_CHECK_THROWS(gs::vertex_buffer(vertices, gs::MAXIMUM_UVW_LAYERS + 1, attributes::None));
+
+	gs::vertex_buffer vb(vertices, 1, attributes::None);
+	ST_CHECK_THROWS(vb.at(vertices));
+	ST_CHECK_THROWS(vb.get_uv_layer(1));
+	ST_CHECK_THROWS(vb.resize(vertices + 1));
+}
+
+ST_TEST(vertexbuffer_layout)
+{
+	for_each_layout([](attributes attribs, uint8_t layers) {
+		shim::clear_calls();
+		gs::vertex_buffer vb(vertices, layers, attribs);
+		ST_CHECK(vb.get_attributes() == (attribs | attributes::Position));
+		ST_CHECK(vb.get_uv_layers() == layers);
+		ST_CHECK((vb.size() == vertices) && (vb.capacity() == vertices));
+
+		// Attributes in use are aligned for libobs, the others are not allocated at all.
+		ST_CHECK(vb.get_positions() && aligned(vb.get_positions()));
+		ST_CHECK(has(attribs, attributes::Normal) == (vb.get_normals() != nullptr));
+		ST_CHECK(has(attribs, attributes::Tangent) == (vb.get_tangents() != nullptr));
+		ST_CHECK(has(attribs, attributes::Color) == (vb.get_colors() != nullptr));
+		ST_CHECK(aligned(vb.get_normals()) && aligned(vb.get_tangents()) && aligned(vb.get_colors()));
+		for (uint8_t n = 0; n < layers; n++) {
+			ST_CHECK(vb.get_uv_layer(n) && aligned(vb.get_uv_layer(n)));
+		}
+		ST_CHECK_THROWS(vb.get_uv_layer(layers));
+
+		gs::vertex vtx = vb.at(vertices - 1);
+		ST_CHECK(vtx.position == &vb.get_positions()[vertices - 1]);
+		ST_CHECK(vtx.normal == (vb.get_normals() ? &vb.get_normals()[vertices - 1] : nullptr));
+		ST_CHECK(vtx.tangent == (vb.get_tangents() ? &vb.get_tangents()[vertices - 1] : nullptr));
+		ST_CHECK(vtx.color == (vb.get_colors() ? &vb.get_colors()[vertices - 1] : nullptr));
+		for (uint8_t n = 0; n < layers; n++) {
+			ST_CHECK(vtx.uv[n] == &vb.get_uv_layer(n)[vertices - 1]);
+		}
+
+		// libobs only creates GPU buffers for what it was given.
+		ST_CHECK(shim::count_calls("gs_vertexbuffer_create", streams(attribs, layers)) == 1);
+		gs_vertbuffer_t* buffer = vb.update(false);
+		ST_CHECK(shim::vertex_buffer_stream(buffer, "points"));
+		ST_CHECK(has(attribs, attributes::Normal) == (shim::vertex_buffer_stream(buffer, "normals") != nullptr));
+		ST_CHECK(has(attribs, attributes::Tangent) == (shim::vertex_buffer_stream(buffer, "tangents") != nullptr));
+		ST_CHECK(has(attribs, attributes::Color) == (shim::vertex_buffer_stream(buffer, "colors") != nullptr));
+		ST_CHECK(!shim::vertex_buffer_stream(buffer, "uv" + std::to_string(layers)));
+	});
+}
+
+ST_TEST(vertexbuffer_upload_changed_only)
+{
+	for_each_layout([](attributes attribs, uint8_t layers) {
+		gs::vertex_buffer vb(vertices, layers, attribs);
+
+		// Freshly created buffers match the GPU already.
+		shim::clear_calls();
+		vb.update(true);
+		ST_CHECK(shim::count_calls("gs_vertexbuffer_flush_direct") == 0);
+
+		shim::clear_calls();
+		fill(vb, 1.f);
+		vb.update(true);
+		ST_CHECK(shim::count_calls("gs_vertexbuffer_flush_direct", streams(attribs, layers)) == 1);
+		ST_CHECK(uploaded(vb));
+
+		shim::clear_calls();
+		vb.update(true);
+		ST_CHECK(shim::count_calls("gs_vertexbuffer_flush_direct") == 0);
+
+		// A single change only sends the attribute it was made to.
+		auto change = [&vb](void* data, const char* expected) {
+			shim::clear_calls();
+			static_cast<float*>(data)[0] += 1.f;
+			vb.update(true);
+			ST_CHECK(shim::count_calls("gs_vertexbuffer_flush_direct") == 1);
+			ST_CHECK(shim::count_calls("gs_vertexbuffer_flush_direct", expected) == 1);
+			ST_CHECK(uploaded(vb));
+		};
+		change(vb.get_positions(), "points");
+		if (vb.get_normals()) {
+			change(vb.get_normals(), "normals");
+		}
+		if (vb.get_tangents()) {
+			change(vb.get_tangents(), "tangents");
+		}
+		if (vb.get_colors()) {
+			change(vb.get_colors(), "colors");
+		}
+		for (uint8_t n = 0; n < layers; n++) {
+			// uv layers are sent in order, up to the last one that changed.
+			std::string expected;
+			for (uint8_t m = 0; m <= n; m++) {
+				expected += (m ? ",uv" : "uv") + std::to_string(m);
+			}
+			change(vb.get_uv_layer(n), expected.c_str());
+		}
+
+		// Growing sends everything again, as the new vertices were never compared.
+		vb.resize(vertices / 2);
+		vb.resize(vertices);
+		shim::clear_calls();
+		vb.update(true);
+		ST_CHECK(shim::count_calls("gs_vertexbuffer_flush_direct", streams(attribs, layers)) == 1);
+	});
+}
+
+ST_TEST(vertexbuffer_copy)
+{
+	for_each_layout([](attributes attribs, uint8_t layers) {
+		gs::vertex_buffer vb(vertices, layers, attribs);
+		fill(vb, 3.f);
+
+		gs::vertex_buffer copy(vb);
+		ST_CHECK(same(vb, copy));
+		copy.update(true);
+		ST_CHECK(uploaded(copy));
+
+		gs::vertex_buffer assigned(1, 0, attributes::All);
+		assigned = vb;
+		ST_CHECK(same(vb, assigned));
+
+		// The copies have memory of their own.
+		fill(vb, 7.f);
+		ST_CHECK(!same(vb, copy) && !same(vb, assigned));
+		assigned.update(true);
+		ST_CHECK(uploaded(assigned));
+	});
+}
+
+ST_TEST(vertexbuffer_from_libobs)
+{
+	for_each_layout([](attributes attribs, uint8_t layers) {
+		// Vertex data as libobs code creates it, owned by the buffer once created.
+		auto allocate = [](bool used, std::size_t element) { return used ? bzalloc(element * vertices) : nullptr; };
+
+		auto* data     = static_cast<gs_vb_data*>(bzalloc(sizeof(gs_vb_data)));
+		data->num      = vertices;
+		data->num_tex  = layers;
+		data->points   = static_cast<vec3*>(allocate(true, sizeof(vec3)));
+		data->normals  = static_cast<vec3*>(allocate(has(attribs, attributes::Normal), sizeof(vec3)));
+		data->tangents = static_cast<vec3*>(allocate(has(attribs, attributes::Tangent), sizeof(vec3)));
+		data->colors   = static_cast<uint32_t*>(allocate(has(attribs, attributes::Color), sizeof(uint32_t)));
+		data->tvarray  = static_cast<gs_tvertarray*>(layers ? bzalloc(sizeof(gs_tvertarray) * layers) : nullptr);
+		for (uint8_t n = 0; n < layers; n++) {
+			// Layers may be narrower than the vec4 the buffer stores them as.
+			data->tvarray[n].width = (n % 4) + 1;
+			data->tvarray[n].array = allocate(true, sizeof(float) * data->tvarray[n].width);
+			for (std::size_t c = 0; c < data->tvarray[n].width; c++) {
+				static_cast<float*>(data->tvarray[n].array)[data->tvarray[n].width + c] = static_cast<float>(n + c);
+			}
+		}
+		vec3_set(&data->points[1], 1.f, 2.f, 3.f);
+		if (data->colors) {
+			data->colors[1] = 0xFF00FF00u;
+		}
+		gs_vertbuffer_t* buffer = gs_vertexbuffer_create(data, 0);
+
+		{
+			gs::vertex_buffer vb(buffer);
+			ST_CHECK(vb.get_attributes() == (attribs | attributes::Position));
+			ST_CHECK((vb.get_uv_layers() == layers) && (vb.size() == vertices));
+			ST_CHECK(vb.get_positions()[1].y == 2.f);
+			ST_CHECK(!vb.get_colors() || (vb.get_colors()[1] == 0xFF00FF00u));
+			for (uint8_t n = 0; n < layers; n++) {
+				for (std::size_t c = 0; c < 4; c++) {
+					float expected = (c <= (n % 4u)) ? static_cast<float>(n + c) : 0.f;
+					ST_CHECK(vb.get_uv_layer(n)[1].ptr[c] == expected);
+				}
+			}
+
+			// Everything it was given is sent to the GPU buffer it creates.
+			vb.update(true);
+			ST_CHECK(uploaded(vb));
+		}
+
+		gs_vertexbuffer_destroy(buffer);
+	});
+}
@@ -0,0 +1,281 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include "obs/obs-frame-graph.hpp"
+#include "shim.hpp"
+
+using namespace streamfx::obs;
+namespace shim = streamfx::tests::shim;
+
+namespace {
+	// A source with a producing filter on it, and a consuming filter above that.
+	struct chain {
+		std::function<void()> producer_render;
+		obs_source_t*         source;
+		obs_source_t*         producer;
+		obs_source_t*         consumer;
+
+		chain()
+		{
+			source   = shim::create_source({});
+			producer = shim::create_source(
+				[this]() {
+					if (producer_render)
+						producer_render();
+				},
+				source);
+			consumer = shim::create_source({}, producer);
+		}
+
+		~chain()
+		{
+			shim::destroy_source(consumer);
+			shim::destroy_source(producer);
+			shim::destroy_source(source);
+		}
+	};
+
+	/** Stands in for Color Grade, Blur and SDF Effects, which take their input and hand over their result the same way.
+	 *
+	 * A filter without a registered filter below falls back to obs_source_process_filter_begin/end, where libobs
+	 * renders the filter below into a private texture that the filter then copies into its cache. That copy is logged
+	 * as "cache_copy". Drawing the result to whatever comes next is logged as "draw_result".
+	 */
+	struct stage {
+		frame_graph&                      graph;
+		obs_source_t*                     self = nullptr;
+		std::shared_ptr<gs::rendertarget> cache_rt;
+		std::shared_ptr<gs::rendertarget> output_rt;
+		std::shared_ptr<gs::texture>      input;
+		std::shared_ptr<gs::texture>      output;
+
+		stage(frame_graph& graph, obs_source_t* target)
+			: graph(graph), cache_rt(std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE)),
+			  output_rt(std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE))
+		{
+			self = shim::create_source([this]() { render(); }, target);
+		}
+
+		~stage()
+		{
+			graph.remove(self);
+			shim::destroy_source(self);
+		}
+
+		void render()
+		{
+			input = graph.capture_input(self, cache_rt, 16, 16);
+			if (!input) {
+				{
+					auto op = cache_rt->render(16, 16);
+					obs_source_video_render(obs_filter_get_target(self));
+					shim::record("cache_copy");
+				}
+				input = cache_rt->get_texture();
+			}
+
+			{
+				auto op = output_rt->render(16, 16);
+				gs_draw_sprite(input->get_object(), 0, 16, 16);
+			}
+			output = output_rt->get_texture();
+
+			if (!graph.publish(self, output)) {
+				shim::record("draw_result");
+			}
+		}
+	};
+
+	void clear_to(float red, float green, float blue, float alpha)
+	{
+		vec4 color;
+		color.x = red;
+		color.y = green;
+		color.z = blue;
+		color.w = alpha;
+		gs_clear(GS_CLEAR_COLOR, &color, 0, 0);
+	}
+} // namespace
+
+ST_TEST(frame_graph_unregistered)
+{
+	chain c;
+	auto  graph = std::make_shared<frame_graph>();
+	auto  rt    = std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+
+	shim::clear_calls();
+	ST_CHECK(graph->capture_input(c.consumer, rt, 16, 16) == nullptr);
+	ST_CHECK(shim::count_calls("obs_source_video_render") == 0);
+	ST_CHECK(shim::count_calls("gs_texrender_begin") == 0);
+}
+
+ST_TEST(frame_graph_not_requested)
+{
+	chain c;
+	auto  graph = std::make_shared<frame_graph>();
+	auto  tex   = std::make_shared<gs::texture>(4, 4, GS_RGBA, 1, nullptr, gs::texture::flags::None);
+
+	// Neither unregistered filters nor filters that nobody asked are allowed to skip drawing.
+	ST_CHECK(!graph->publish(c.producer, tex));
+	graph->add(c.producer);
+	ST_CHECK(!graph->publish(c.producer, tex));
+}
+
+ST_TEST(frame_graph_hand_over)
+{
+	chain c;
+	auto  graph = std::make_shared<frame_graph>();
+	auto  rt    = std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	auto  tex   = std::make_shared<gs::texture>(16, 16, GS_RGBA, 1, nullptr, gs::texture::flags::None);
+	graph->add(c.producer);
+
+	bool published    = false;
+	c.producer_render = [&]() { published = graph->publish(c.producer, tex); };
+
+	shim::clear_calls();
+	auto input = graph->capture_input(c.consumer, rt, 16, 16);
+	ST_CHECK(published);
+	ST_CHECK(input == tex);
+	ST_CHECK(shim::count_calls("gs_blend_state_push") == 1);
+	ST_CHECK(shim::count_calls("gs_blend_state_pop") == 1);
+	ST_CHECK(shim::current_render_target() == nullptr);
+
+	// The request only lasts while the filter below renders.
+	ST_CHECK(!graph->publish(c.producer, tex));
+}
+
+ST_TEST(frame_graph_producer_draws)
+{
+	chain c;
+	auto  graph = std::make_shared<frame_graph>();
+	auto  rt    = std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	graph->add(c.producer);
+
+	c.producer_render = []() { clear_to(1.f, 0.f, 0.f, 1.f); };
+
+	shim::clear_calls();
+	auto input = graph->capture_input(c.consumer, rt, 8, 4);
+	ST_CHECK(input);
+	ST_CHECK(input->get_object() == rt->get_object());
+	ST_CHECK(shim::count_calls("gs_texrender_begin", "8x4") == 1);
+	ST_CHECK(shim::count_calls("gs_texrender_end") == 1);
+
+	gs_texture_t* object = input->get_object();
+	ST_CHECK(object->width == 8);
+	ST_CHECK(object->height == 4);
+	ST_CHECK(object->data[0] == 255);
+	ST_CHECK(object->data[1] == 0);
+	ST_CHECK(object->data[object->data.size() - 1] == 255);
+}
+
+ST_TEST(frame_graph_producer_throws)
+{
+	chain c;
+	auto  graph = std::make_shared<frame_graph>();
+	auto  rt    = std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	auto  tex   = std::make_shared<gs::texture>(16, 16, GS_RGBA, 1, nullptr, gs::texture::flags::None);
+	graph->add(c.producer);
+
+	c.producer_render = []() { throw std::runtime_error("render failed"); };
+
+	shim::clear_calls();
+	ST_CHECK_THROWS(graph->capture_input(c.consumer, rt, 16, 16));
+	ST_CHECK(shim::count_calls("gs_blend_state_push") == 1);
+	ST_CHECK(shim::count_calls("gs_blend_state_pop") == 1);
+	ST_CHECK(shim::count_calls("gs_texrender_end") == 1);
+	ST_CHECK(shim::current_render_target() == nullptr);
+
+	// A request left behind would have the producer skip drawing from now on.
+	ST_CHECK(!graph->publish(c.producer, tex));
+
+	// And the render target can be used again.
+	c.producer_render = []() { clear_to(0.f, 1.f, 0.f, 1.f); };
+	auto input        = graph->capture_input(c.consumer, rt, 16, 16);
+	ST_CHECK(input && (input->get_object()->data[1] == 255));
+}
+
+ST_TEST(frame_graph_remove)
+{
+	chain c;
+	auto  graph = std::make_shared<frame_graph>();
+	auto  rt    = std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	graph->add(c.producer);
+	graph->remove(c.producer);
+
+	ST_CHECK(graph->capture_input(c.consumer, rt, 16, 16) == nullptr);
+}
+
+ST_TEST(frame_graph_clears_input)
+{
+	chain c;
+	auto  graph = std::make_shared<frame_graph>();
+	auto  rt    = std::make_shared<gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	graph->add(c.producer);
+
+	c.producer_render = []() { clear_to(1.f, 0.f, 0.f, 1.f); };
+	graph->capture_input(c.consumer, rt, 4, 4);
+
+	// A producer which draws nothing, like an empty or fully cropped source, must not leave the last frame behind.
+	c.producer_render = []() {};
+	auto input        = graph->capture_input(c.consumer, rt, 4, 4);
+	ST_CHECK(input);
+	bool blank = true;
+	for (auto value : input->get_object()->data) {
+		blank &= (value == 0);
+	}
+	ST_CHECK(blank);
+}
+
+ST_TEST(frame_graph_chain_skips_cache_copies)
+{
+	auto          graph  = std::make_shared<frame_graph>();
+	obs_source_t* source = shim::create_source([]() { clear_to(1.f, 0.f, 0.f, 1.f); });
+
+	{ // Without the graph, every filter copies its input into its cache, and draws its result for the one above.
+		stage color_grade(*graph, source);
+		stage blur(*graph, color_grade.self);
+		stage sdf(*graph, blur.self);
+
+		shim::clear_calls();
+		sdf.render();
+		ST_CHECK(shim::count_calls("cache_copy") == 3);
+		ST_CHECK(shim::count_calls("draw_result") == 3);
+	}
+
+	{ // With it, only Color Grade captures the source, and the others take the result of the filter below directly.
+		stage color_grade(*graph, source);
+		stage blur(*graph, color_grade.self);
+		stage sdf(*graph, blur.self);
+		graph->add(color_grade.self);
+		graph->add(blur.self);
+		graph->add(sdf.self);
+
+		shim::clear_calls();
+		sdf.render();
+		ST_CHECK(shim::count_calls("cache_copy") == 1);
+		ST_CHECK(shim::count_calls("draw_result") == 1);
+		ST_CHECK(blur.input == color_grade.output);
+		ST_CHECK(sdf.input == blur.output);
+		ST_CHECK(color_grade.input->get_object()->data[0] == 255);
+	}
+
+	shim::destroy_source(source);
+}
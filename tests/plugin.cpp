@@ -0,0 +1,47 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Stand-in for the parts of 'source/plugin.cpp' that the rest of StreamFX relies on. Data files are taken straight from
+// the 'data' directory of the source tree.
+
+#include "plugin.hpp"
+#include "util/util-threadpool.hpp"
+
+std::shared_ptr<streamfx::util::threadpool> streamfx::threadpool()
+{
+	// Created on first use instead of by a module load, and stopped when the test exits.
+	static auto pool = std::make_shared<streamfx::util::threadpool>();
+	return pool;
+}
+
+void streamfx::gs_draw_fullscreen_tri()
+{
+	gs_draw(GS_TRIS, 0, 3);
+}
+
+std::filesystem::path streamfx::data_file_path(std::string_view file)
+{
+	return std::filesystem::u8path(ST_DATA_DIRECTORY) / std::filesystem::u8path(file);
+}
+
+std::filesystem::path streamfx::config_file_path(std::string_view file)
+{
+	return std::filesystem::temp_directory_path() / "streamfx-tests" / std::filesystem::u8path(file);
+}
@@ -0,0 +1,32 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <stdbool.h>
+#include "calldata.h"
+
+typedef struct signal_handler signal_handler_t;
+typedef void (*signal_callback_t)(void* data, calldata_t* cd);
+
+/// Signals are declared by their full declaration, "void name(ptr encoder)", and called by name.
+bool signal_handler_add(signal_handler_t* handler, const char* signal_decl);
+void signal_handler_connect(signal_handler_t* handler, const char* signal, signal_callback_t callback, void* data);
+void signal_handler_disconnect(signal_handler_t* handler, const char* signal, signal_callback_t callback, void* data);
+void signal_handler_signal(signal_handler_t* handler, const char* signal, calldata_t* params);
@@ -0,0 +1,265 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <variant>
+
+extern "C" {
+#include "obs-data.h"
+}
+
+namespace {
+	struct object_reference {
+		obs_data_t* object;
+
+		object_reference(obs_data_t* obj) : object(obj)
+		{
+			obs_data_addref(object);
+		}
+		object_reference(const object_reference& other) : object_reference(other.object) {}
+		~object_reference()
+		{
+			obs_data_release(object);
+		}
+		object_reference& operator=(const object_reference&) = delete;
+	};
+
+	typedef std::variant<std::string, long long, double, bool, object_reference> value_t;
+
+	struct item {
+		std::optional<value_t> user;
+		std::optional<value_t> fallback;
+
+		const value_t* get() const
+		{
+			return user ? &user.value() : (fallback ? &fallback.value() : nullptr);
+		}
+	};
+} // namespace
+
+struct obs_data {
+	std::atomic<long>           refs = 1;
+	std::map<std::string, item> items;
+};
+
+static const value_t* find_value(obs_data_t* data, const char* name)
+{
+	if (!data || !name) {
+		return nullptr;
+	}
+	if (auto kv = data->items.find(name); kv != data->items.end()) {
+		return kv->second.get();
+	}
+	return nullptr;
+}
+
+template<typename T>
+static void set_value(obs_data_t* data, const char* name, T&& value, bool is_default)
+{
+	if (!data || !name) {
+		return;
+	}
+	auto& entry = data->items[name];
+	(is_default ? entry.fallback : entry.user).emplace(std::forward<T>(value));
+}
+
+// Numbers convert into each other, like they do in libobs.
+template<typename T>
+static T get_number(obs_data_t* data, const char* name)
+{
+	const value_t* value = find_value(data, name);
+	if (!value) {
+		return T{0};
+	} else if (auto* integer = std::get_if<long long>(value); integer) {
+		return static_cast<T>(*integer);
+	} else if (auto* number = std::get_if<double>(value); number) {
+		return static_cast<T>(*number);
+	}
+	return T{0};
+}
+
+extern "C" obs_data_t* obs_data_create(void)
+{
+	return new obs_data;
+}
+
+// Saved files only live as long as the process does. An empty file is left on disk so that existence checks work, and
+// removing it discards the saved data.
+static std::mutex                                         files_lock;
+static std::map<std::string, std::shared_ptr<obs_data_t>> files;
+
+static obs_data_t* copy_data(obs_data_t* data)
+{
+	obs_data_t* copy = obs_data_create();
+	for (auto& kv : data->items) {
+		auto& entry = copy->items[kv.first];
+		for (auto [from, to] : {std::make_pair(&kv.second.user, &entry.user),
+								std::make_pair(&kv.second.fallback, &entry.fallback)}) {
+			if (!from->has_value()) {
+				continue;
+			} else if (auto* reference = std::get_if<object_reference>(&from->value()); reference) {
+				obs_data_t* object = copy_data(reference->object);
+				to->emplace(object_reference(object));
+				obs_data_release(object);
+			} else {
+				to->emplace(from->value());
+			}
+		}
+	}
+	return copy;
+}
+
+extern "C" obs_data_t* obs_data_create_from_json_file(const char* file)
+{
+	std::error_code              ec;
+	std::unique_lock<std::mutex> lock(files_lock);
+	if (!file || !std::filesystem::exists(std::filesystem::u8path(file), ec)) {
+		return nullptr;
+	} else if (auto kv = files.find(file); kv != files.end()) {
+		return copy_data(kv->second.get());
+	}
+	return nullptr;
+}
+
+extern "C" void obs_data_addref(obs_data_t* data)
+{
+	if (data) {
+		data->refs++;
+	}
+}
+
+extern "C" void obs_data_release(obs_data_t* data)
+{
+	if (data && (--data->refs == 0)) {
+		delete data;
+	}
+}
+
+extern "C" bool obs_data_save_json_safe(obs_data_t* data, const char* file, const char*, const char*)
+{
+	if (!data || !file) {
+		return false;
+	}
+	std::unique_lock<std::mutex> lock(files_lock);
+	if (std::ofstream placeholder(std::filesystem::u8path(file)); !placeholder) {
+		return false;
+	}
+	files[file] = std::shared_ptr<obs_data_t>(copy_data(data), obs_data_release);
+	return true;
+}
+
+extern "C" bool obs_data_has_user_value(obs_data_t* data, const char* name)
+{
+	if (!data || !name) {
+		return false;
+	}
+	auto kv = data->items.find(name);
+	return (kv != data->items.end()) && kv->second.user.has_value();
+}
+
+extern "C" void obs_data_set_string(obs_data_t* data, const char* name, const char* val)
+{
+	set_value(data, name, std::string(val ? val : ""), false);
+}
+
+extern "C" void obs_data_set_int(obs_data_t* data, const char* name, long long val)
+{
+	set_value(data, name, val, false);
+}
+
+extern "C" void obs_data_set_double(obs_data_t* data, const char* name, double val)
+{
+	set_value(data, name, val, false);
+}
+
+extern "C" void obs_data_set_bool(obs_data_t* data, const char* name, bool val)
+{
+	set_value(data, name, val, false);
+}
+
+extern "C" void obs_data_set_obj(obs_data_t* data, const char* name, obs_data_t* obj)
+{
+	set_value(data, name, object_reference(obj), false);
+}
+
+extern "C" void obs_data_set_default_string(obs_data_t* data, const char* name, const char* val)
+{
+	set_value(data, name, std::string(val ? val : ""), true);
+}
+
+extern "C" void obs_data_set_default_int(obs_data_t* data, const char* name, long long val)
+{
+	set_value(data, name, val, true);
+}
+
+extern "C" void obs_data_set_default_double(obs_data_t* data, const char* name, double val)
+{
+	set_value(data, name, val, true);
+}
+
+extern "C" void obs_data_set_default_bool(obs_data_t* data, const char* name, bool val)
+{
+	set_value(data, name, val, true);
+}
+
+extern "C" const char* obs_data_get_string(obs_data_t* data, const char* name)
+{
+	const value_t* value = find_value(data, name);
+	if (auto* string = value ? std::get_if<std::string>(value) : nullptr; string) {
+		return string->c_str();
+	}
+	return "";
+}
+
+extern "C" long long obs_data_get_int(obs_data_t* data, const char* name)
+{
+	return get_number<long long>(data, name);
+}
+
+extern "C" double obs_data_get_double(obs_data_t* data, const char* name)
+{
+	return get_number<double>(data, name);
+}
+
+extern "C" bool obs_data_get_bool(obs_data_t* data, const char* name)
+{
+	const value_t* value = find_value(data, name);
+	if (auto* boolean = value ? std::get_if<bool>(value) : nullptr; boolean) {
+		return *boolean;
+	}
+	return false;
+}
+
+extern "C" obs_data_t* obs_data_get_obj(obs_data_t* data, const char* name)
+{
+	const value_t* value = find_value(data, name);
+	if (auto* reference = value ? std::get_if<object_reference>(value) : nullptr; reference) {
+		obs_data_addref(reference->object);
+		return reference->object;
+	}
+	return nullptr;
+}
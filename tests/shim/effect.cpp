@@ -0,0 +1,432 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Effects for the libobs stand-in. Only declarations are parsed, after resolving includes relative to the effect file:
+// parameters (with annotations and default values) and the names of techniques and passes. Shader code is ignored,
+// and setting a parameter updates and records it.
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <string>
+#include <vector>
+#include "shim.hpp"
+
+extern "C" {
+#include "graphics/effect.h"
+#include "graphics/matrix4.h"
+#include "graphics/vec2.h"
+#include "graphics/vec3.h"
+#include "graphics/vec4.h"
+#include "util/bmem.h"
+}
+
+struct gs_sampler_state {
+	gs_sampler_info info;
+};
+
+namespace {
+	template<typename T, typename A>
+	void darray_assign(A& array, const std::vector<T>& values)
+	{
+		array.num      = values.size();
+		array.capacity = values.size();
+		array.array    = static_cast<T*>(bzalloc(sizeof(T) * std::max<std::size_t>(values.size(), 1)));
+		std::copy(values.begin(), values.end(), array.array);
+	}
+
+	template<typename A>
+	void darray_assign_bytes(A& array, const void* data, std::size_t size)
+	{
+		if (!array.array || (array.capacity < size)) {
+			bfree(array.array);
+			array.capacity = std::max<std::size_t>(size, 1);
+			array.array    = static_cast<uint8_t*>(bzalloc(array.capacity));
+		}
+		array.num = size;
+		if (size > 0) {
+			std::memcpy(array.array, data, size);
+		}
+	}
+
+	gs_shader_param_type parse_type(const std::string& type)
+	{
+		static const std::pair<const char*, gs_shader_param_type> types[] = {
+			{"bool", GS_SHADER_PARAM_BOOL},           {"float", GS_SHADER_PARAM_FLOAT},
+			{"float2", GS_SHADER_PARAM_VEC2},         {"float3", GS_SHADER_PARAM_VEC3},
+			{"float4", GS_SHADER_PARAM_VEC4},         {"int", GS_SHADER_PARAM_INT},
+			{"int2", GS_SHADER_PARAM_INT2},           {"int3", GS_SHADER_PARAM_INT3},
+			{"int4", GS_SHADER_PARAM_INT4},           {"float4x4", GS_SHADER_PARAM_MATRIX4X4},
+			{"string", GS_SHADER_PARAM_STRING},       {"texture", GS_SHADER_PARAM_TEXTURE},
+			{"texture2d", GS_SHADER_PARAM_TEXTURE},   {"texture3d", GS_SHADER_PARAM_TEXTURE},
+			{"texture_cube", GS_SHADER_PARAM_TEXTURE}, {"texture_rect", GS_SHADER_PARAM_TEXTURE},
+		};
+		for (auto& [name, value] : types) {
+			if (type == name) {
+				return value;
+			}
+		}
+		return GS_SHADER_PARAM_UNKNOWN;
+	}
+
+	// Turn a default value such as '1.0', 'float2(1., 2.)', '{1, 2}', 'true' or '"text"' into its binary form.
+	std::vector<uint8_t> parse_value(gs_shader_param_type type, std::string value)
+	{
+		std::vector<uint8_t> data;
+		if (type == GS_SHADER_PARAM_STRING) {
+			if (std::smatch match; std::regex_search(value, match, std::regex("\"([^\"]*)\""))) {
+				data.assign(match[1].first, match[1].second);
+			}
+			return data;
+		}
+
+		value = std::regex_replace(value, std::regex("\\btrue\\b"), "1");
+		value = std::regex_replace(value, std::regex("\\bfalse\\b"), "0");
+		value = std::regex_replace(value, std::regex("\\b[A-Za-z_]\\w*"), " ");
+
+		bool is_float = (type == GS_SHADER_PARAM_FLOAT) || (type == GS_SHADER_PARAM_VEC2)
+						|| (type == GS_SHADER_PARAM_VEC3) || (type == GS_SHADER_PARAM_VEC4)
+						|| (type == GS_SHADER_PARAM_MATRIX4X4);
+		std::regex number("[-+]?([0-9]+\\.?[0-9]*|\\.[0-9]+)([eE][-+]?[0-9]+)?");
+		for (auto iter = std::sregex_iterator(value.begin(), value.end(), number); iter != std::sregex_iterator();
+			 iter++) {
+			if (is_float) {
+				float v = std::stof(iter->str());
+				data.insert(data.end(), reinterpret_cast<uint8_t*>(&v), reinterpret_cast<uint8_t*>(&v) + sizeof(v));
+			} else {
+				int32_t v = static_cast<int32_t>(std::stol(iter->str()));
+				data.insert(data.end(), reinterpret_cast<uint8_t*>(&v), reinterpret_cast<uint8_t*>(&v) + sizeof(v));
+			}
+		}
+		return data;
+	}
+
+	gs_effect_param make_param(gs_effect_t* effect, enum effect_section section, const std::string& type,
+							   const std::string& name, const std::string& value)
+	{
+		gs_effect_param param = {};
+		param.name            = bstrdup(name.c_str());
+		param.section         = section;
+		param.type            = parse_type(type);
+		param.effect          = effect;
+		darray_assign_bytes(param.cur_val, nullptr, 0);
+		auto default_val = parse_value(param.type, value);
+		darray_assign_bytes(param.default_val, default_val.data(), default_val.size());
+		darray_assign(param.annotations, std::vector<gs_effect_param>());
+		return param;
+	}
+
+	void free_param(gs_effect_param& param)
+	{
+		for (std::size_t idx = 0; idx < param.annotations.num; idx++) {
+			free_param(param.annotations.array[idx]);
+		}
+		bfree(param.annotations.array);
+		bfree(param.cur_val.array);
+		bfree(param.default_val.array);
+		bfree(param.name);
+	}
+
+	// The block that starts at 'open', which must be an opening brace, including the braces.
+	std::string block_at(const std::string& code, std::size_t open)
+	{
+		std::size_t depth = 0;
+		for (std::size_t idx = open; idx < code.size(); idx++) {
+			if (code[idx] == '{') {
+				depth++;
+			} else if ((code[idx] == '}') && (--depth == 0)) {
+				return code.substr(open, idx - open + 1);
+			}
+		}
+		return code.substr(open);
+	}
+
+	std::string resolve_includes(std::string code, const std::filesystem::path& directory, std::size_t depth = 0)
+	{
+		std::regex  include("#include\\s+\"([^\"]+)\"");
+		std::smatch match;
+		while ((depth < 16) && std::regex_search(code, match, include)) {
+			std::filesystem::path file = directory / match[1].str();
+			std::ifstream         stream(file, std::ios::binary);
+			std::string           content((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+			code.replace(static_cast<std::size_t>(match.position()), static_cast<std::size_t>(match.length()),
+						 resolve_includes(content, file.parent_path(), depth + 1));
+		}
+		return code;
+	}
+
+	void set_value(gs_eparam_t* param, const char* function, const void* data, std::size_t size)
+	{
+		if (!param) {
+			return;
+		}
+		streamfx::tests::shim::record(function, param->name);
+
+		// Like libobs, only changes are flagged for upload.
+		if ((param->cur_val.num == size) && (std::memcmp(param->cur_val.array, data, size) == 0)) {
+			return;
+		}
+		darray_assign_bytes(param->cur_val, data, size);
+		param->changed = true;
+	}
+
+	void* copy_value(const uint8_t* data, std::size_t size)
+	{
+		if (size == 0) {
+			return nullptr;
+		}
+		void* copy = bmalloc(size);
+		std::memcpy(copy, data, size);
+		return copy;
+	}
+} // namespace
+
+extern "C" gs_samplerstate_t* gs_samplerstate_create(const struct gs_sampler_info* info)
+{
+	return new gs_sampler_state{*info};
+}
+
+extern "C" void gs_samplerstate_destroy(gs_samplerstate_t* samplerstate)
+{
+	delete samplerstate;
+}
+
+extern "C" gs_effect_t* gs_effect_create(const char* effect_string, const char* filename, char** error_string)
+{
+	std::string code = effect_string ? effect_string : "";
+	code             = resolve_includes(code, std::filesystem::u8path(filename ? filename : "").parent_path());
+	code             = std::regex_replace(code, std::regex("//[^\\n]*|/\\*[\\s\\S]*?\\*/"), " ");
+
+	auto* effect = static_cast<gs_effect_t*>(bzalloc(sizeof(gs_effect_t)));
+	effect->effect_path = bstrdup(filename ? filename : "");
+	effect->graphics    = gs_get_context();
+
+	std::vector<gs_effect_param> params;
+	std::regex uniform("uniform\\s+(\\w+)\\s+(\\w+)\\s*(<([^>]*)>)?\\s*(=\\s*([^;]*))?;");
+	std::regex annotation("(\\w+)\\s+(\\w+)\\s*(=\\s*([^;]*))?;");
+	for (auto iter = std::sregex_iterator(code.begin(), code.end(), uniform); iter != std::sregex_iterator(); iter++) {
+		auto& match = *iter;
+		auto  param = make_param(effect, EFFECT_PARAM, match[1], match[2], match[6]);
+
+		std::vector<gs_effect_param> annotations;
+		std::string                  text = match[4];
+		for (auto aiter = std::sregex_iterator(text.begin(), text.end(), annotation); aiter != std::sregex_iterator();
+			 aiter++) {
+			annotations.push_back(make_param(effect, EFFECT_ANNOTATION, (*aiter)[1], (*aiter)[2], (*aiter)[4]));
+		}
+		bfree(param.annotations.array);
+		darray_assign(param.annotations, annotations);
+
+		params.push_back(param);
+	}
+	darray_assign(effect->params, params);
+
+	std::vector<gs_effect_technique> techniques;
+	std::regex                       technique("technique\\s+(\\w+)\\s*\\{");
+	std::regex                       pass("pass\\s*(\\w*)\\s*\\{");
+	for (auto iter = std::sregex_iterator(code.begin(), code.end(), technique); iter != std::sregex_iterator();
+		 iter++) {
+		gs_effect_technique tech = {};
+		tech.name                = bstrdup((*iter)[1].str().c_str());
+		tech.section             = EFFECT_TECHNIQUE;
+		tech.effect              = effect;
+
+		// Every pass is given every parameter, as no shader code is compiled.
+		std::vector<pass_shaderparam> shader_params;
+		for (std::size_t idx = 0; idx < effect->params.num; idx++) {
+			shader_params.push_back({effect->params.array + idx, nullptr});
+		}
+
+		std::vector<gs_effect_pass> passes;
+		std::string body = block_at(code, static_cast<std::size_t>(iter->position() + iter->length() - 1));
+		for (auto piter = std::sregex_iterator(body.begin(), body.end(), pass); piter != std::sregex_iterator();
+			 piter++) {
+			gs_effect_pass epass = {};
+			epass.name           = bstrdup((*piter)[1].str().c_str());
+			epass.section        = EFFECT_PASS;
+			darray_assign(epass.vertshader_params, std::vector<pass_shaderparam>());
+			darray_assign(epass.pixelshader_params, shader_params);
+			passes.push_back(epass);
+		}
+		darray_assign(tech.passes, passes);
+
+		techniques.push_back(tech);
+	}
+	darray_assign(effect->techniques, techniques);
+
+	if (effect->techniques.num == 0) {
+		if (error_string) {
+			*error_string = bstrdup("effect has no techniques");
+		}
+		gs_effect_destroy(effect);
+		return nullptr;
+	}
+	return effect;
+}
+
+extern "C" void gs_effect_destroy(gs_effect_t* effect)
+{
+	if (!effect) {
+		return;
+	}
+
+	for (std::size_t idx = 0; idx < effect->techniques.num; idx++) {
+		auto& tech = effect->techniques.array[idx];
+		for (std::size_t pidx = 0; pidx < tech.passes.num; pidx++) {
+			bfree(tech.passes.array[pidx].vertshader_params.array);
+			bfree(tech.passes.array[pidx].pixelshader_params.array);
+			bfree(tech.passes.array[pidx].name);
+		}
+		bfree(tech.passes.array);
+		bfree(tech.name);
+	}
+	bfree(effect->techniques.array);
+	for (std::size_t idx = 0; idx < effect->params.num; idx++) {
+		free_param(effect->params.array[idx]);
+	}
+	bfree(effect->params.array);
+	bfree(effect->effect_path);
+	bfree(effect);
+}
+
+extern "C" bool gs_effect_loop(gs_effect_t* effect, const char* name)
+{
+	if (!effect) {
+		return false;
+	}
+
+	if (!effect->looping) {
+		effect->cur_technique = nullptr;
+		for (std::size_t idx = 0; idx < effect->techniques.num; idx++) {
+			if (std::strcmp(effect->techniques.array[idx].name, name) == 0) {
+				effect->cur_technique = effect->techniques.array + idx;
+			}
+		}
+		if (!effect->cur_technique) {
+			return false;
+		}
+		effect->looping   = true;
+		effect->loop_pass = 0;
+	}
+
+	if (effect->loop_pass >= effect->cur_technique->passes.num) {
+		effect->looping       = false;
+		effect->cur_technique = nullptr;
+		effect->cur_pass      = nullptr;
+
+		// Ending the technique forgets all values, as in libobs. The next draw uses the defaults unless set again.
+		for (std::size_t idx = 0; idx < effect->params.num; idx++) {
+			auto& param        = effect->params.array[idx];
+			param.cur_val.num  = 0;
+			param.changed      = false;
+			param.next_sampler = nullptr;
+		}
+		return false;
+	}
+
+	// Starting a pass uploads all changed parameters.
+	effect->cur_pass = effect->cur_technique->passes.array + effect->loop_pass++;
+	for (std::size_t idx = 0; idx < effect->params.num; idx++) {
+		effect->params.array[idx].changed = false;
+	}
+	streamfx::tests::shim::record("gs_effect_loop", name);
+	return true;
+}
+
+extern "C" size_t gs_param_get_num_annotations(const gs_eparam_t* param)
+{
+	return param ? param->annotations.num : 0;
+}
+
+extern "C" void gs_effect_set_bool(gs_eparam_t* param, bool val)
+{
+	int32_t value = val ? 1 : 0;
+	set_value(param, "gs_effect_set_bool", &value, sizeof(value));
+}
+
+extern "C" void gs_effect_set_float(gs_eparam_t* param, float val)
+{
+	set_value(param, "gs_effect_set_float", &val, sizeof(val));
+}
+
+extern "C" void gs_effect_set_int(gs_eparam_t* param, int val)
+{
+	set_value(param, "gs_effect_set_int", &val, sizeof(val));
+}
+
+extern "C" void gs_effect_set_matrix4(gs_eparam_t* param, const struct matrix4* val)
+{
+	set_value(param, "gs_effect_set_matrix4", val, sizeof(struct matrix4));
+}
+
+extern "C" void gs_effect_set_vec2(gs_eparam_t* param, const struct vec2* val)
+{
+	set_value(param, "gs_effect_set_vec2", val, sizeof(struct vec2));
+}
+
+extern "C" void gs_effect_set_vec3(gs_eparam_t* param, const struct vec3* val)
+{
+	// Stored without the padding of 'vec3', as in libobs.
+	set_value(param, "gs_effect_set_vec3", val, sizeof(float) * 3);
+}
+
+extern "C" void gs_effect_set_vec4(gs_eparam_t* param, const struct vec4* val)
+{
+	set_value(param, "gs_effect_set_vec4", val, sizeof(struct vec4));
+}
+
+extern "C" void gs_effect_set_texture(gs_eparam_t* param, gs_texture_t* val)
+{
+	set_value(param, "gs_effect_set_texture", &val, sizeof(val));
+}
+
+extern "C" void gs_effect_set_val(gs_eparam_t* param, const void* val, size_t size)
+{
+	set_value(param, "gs_effect_set_val", val, size);
+}
+
+extern "C" void gs_effect_set_next_sampler(gs_eparam_t* param, gs_samplerstate_t* sampler)
+{
+	if (param) {
+		streamfx::tests::shim::record("gs_effect_set_next_sampler", param->name);
+		param->next_sampler = sampler;
+	}
+}
+
+extern "C" void* gs_effect_get_val(gs_eparam_t* param)
+{
+	return param ? copy_value(param->cur_val.array, param->cur_val.num) : nullptr;
+}
+
+extern "C" size_t gs_effect_get_val_size(gs_eparam_t* param)
+{
+	return param ? param->cur_val.num : 0;
+}
+
+extern "C" void* gs_effect_get_default_val(gs_eparam_t* param)
+{
+	return param ? copy_value(param->default_val.array, param->default_val.num) : nullptr;
+}
+
+extern "C" size_t gs_effect_get_default_val_size(gs_eparam_t* param)
+{
+	return param ? param->default_val.num : 0;
+}
@@ -0,0 +1,348 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include "shim.hpp"
+
+struct video_output {
+	video_output_info info;
+	std::string       name;
+};
+
+struct audio_output {
+	audio_output_info info;
+	std::string       name;
+};
+
+struct signal_handler {
+	std::map<std::string, std::list<std::pair<signal_callback_t, void*>>> signals;
+};
+
+struct obs_weak_encoder {
+	std::shared_ptr<obs_encoder_t*> encoder; // Shared with the encoder, which clears it when it is destroyed.
+};
+
+struct obs_encoder {
+	const obs_encoder_info*           info;
+	void*                             data;
+	obs_data_t*                       settings;
+	video_t*                          video;
+	audio_t*                          audio;
+	uint32_t                          width;
+	uint32_t                          height;
+	signal_handler                    signals;
+	std::shared_ptr<obs_encoder_t*>   self;
+};
+
+namespace {
+	std::map<std::string, obs_encoder_info> encoder_types;
+	video_t*                                main_video = nullptr;
+} // namespace
+
+video_t* streamfx::tests::shim::create_video(const video_output_info& info)
+{
+	auto* video      = new video_output{info, info.name ? info.name : ""};
+	video->info.name = video->name.c_str();
+	if (!main_video) {
+		main_video = video;
+	}
+	return video;
+}
+
+void streamfx::tests::shim::destroy_video(video_t* video)
+{
+	if (main_video == video) {
+		main_video = nullptr;
+	}
+	delete video;
+}
+
+audio_t* streamfx::tests::shim::create_audio(const audio_output_info& info)
+{
+	auto* audio      = new audio_output{info, info.name ? info.name : ""};
+	audio->info.name = audio->name.c_str();
+	return audio;
+}
+
+void streamfx::tests::shim::destroy_audio(audio_t* audio)
+{
+	delete audio;
+}
+
+std::vector<std::string> streamfx::tests::shim::encoder_types()
+{
+	std::vector<std::string> ids;
+	for (auto& kv : ::encoder_types) {
+		ids.push_back(kv.first);
+	}
+	return ids;
+}
+
+obs_encoder_t* streamfx::tests::shim::create_encoder(std::string_view id, obs_data_t* settings, video_t* video,
+													  audio_t* audio, uint32_t width, uint32_t height)
+{
+	auto kv = ::encoder_types.find(std::string(id));
+	if (kv == ::encoder_types.end()) {
+		return nullptr;
+	}
+
+	auto* encoder = new obs_encoder{&kv->second, nullptr, settings, video, audio, width, height, {}, nullptr};
+	encoder->self = std::make_shared<obs_encoder_t*>(encoder);
+	obs_data_addref(settings);
+
+	// Like libobs, the defaults of the type sit underneath whatever the user has set.
+	if (encoder->info->get_defaults2) {
+		encoder->info->get_defaults2(settings, encoder->info->type_data);
+	} else if (encoder->info->get_defaults) {
+		encoder->info->get_defaults(settings);
+	}
+
+	encoder->data = encoder->info->create(settings, encoder);
+	if (!encoder->data) {
+		destroy_encoder(encoder);
+		return nullptr;
+	}
+	return encoder;
+}
+
+void streamfx::tests::shim::destroy_encoder(obs_encoder_t* encoder)
+{
+	if (!encoder) {
+		return;
+	}
+	if (encoder->data) {
+		encoder->info->destroy(encoder->data);
+	}
+	*encoder->self = nullptr;
+	obs_data_release(encoder->settings);
+	delete encoder;
+}
+
+const obs_encoder_info* streamfx::tests::shim::encoder_info(obs_encoder_t* encoder)
+{
+	return encoder->info;
+}
+
+void* streamfx::tests::shim::encoder_data(obs_encoder_t* encoder)
+{
+	return encoder->data;
+}
+
+extern "C" void obs_register_encoder(const obs_encoder_info* info)
+{
+	::encoder_types.insert_or_assign(info->id, *info);
+}
+
+extern "C" const video_output_info* video_output_get_info(const video_t* video)
+{
+	return video ? &video->info : nullptr;
+}
+
+extern "C" const audio_output_info* audio_output_get_info(const audio_t* audio)
+{
+	return audio ? &audio->info : nullptr;
+}
+
+extern "C" bool obs_get_video_info(obs_video_info* ovi)
+{
+	if (!main_video) {
+		return false;
+	}
+
+	const video_output_info& info = main_video->info;
+	std::memset(ovi, 0, sizeof(obs_video_info));
+	ovi->graphics_module = "libobs-opengl";
+	ovi->fps_num         = info.fps_num;
+	ovi->fps_den         = info.fps_den;
+	ovi->base_width      = info.width;
+	ovi->base_height     = info.height;
+	ovi->output_width    = info.width;
+	ovi->output_height   = info.height;
+	ovi->output_format   = info.format;
+	ovi->colorspace      = info.colorspace;
+	ovi->range           = info.range;
+	return true;
+}
+
+extern "C" video_t* obs_encoder_video(const obs_encoder_t* encoder)
+{
+	return encoder ? encoder->video : nullptr;
+}
+
+extern "C" audio_t* obs_encoder_audio(const obs_encoder_t* encoder)
+{
+	return encoder ? encoder->audio : nullptr;
+}
+
+extern "C" obs_encoder_type obs_encoder_get_type(const obs_encoder_t* encoder)
+{
+	return encoder ? encoder->info->type : OBS_ENCODER_AUDIO;
+}
+
+extern "C" void* obs_encoder_get_type_data(obs_encoder_t* encoder)
+{
+	return encoder ? encoder->info->type_data : nullptr;
+}
+
+extern "C" uint32_t obs_encoder_get_width(const obs_encoder_t* encoder)
+{
+	if (!encoder || !encoder->video) {
+		return 0;
+	}
+	return encoder->width ? encoder->width : encoder->video->info.width;
+}
+
+extern "C" uint32_t obs_encoder_get_height(const obs_encoder_t* encoder)
+{
+	if (!encoder || !encoder->video) {
+		return 0;
+	}
+	return encoder->height ? encoder->height : encoder->video->info.height;
+}
+
+extern "C" bool obs_encoder_scaling_enabled(const obs_encoder_t* encoder)
+{
+	return encoder && encoder->video
+		   && ((obs_encoder_get_width(encoder) != encoder->video->info.width)
+			   || (obs_encoder_get_height(encoder) != encoder->video->info.height));
+}
+
+extern "C" video_format obs_encoder_get_preferred_video_format(const obs_encoder_t*)
+{
+	return VIDEO_FORMAT_NONE;
+}
+
+extern "C" signal_handler_t* obs_encoder_get_signal_handler(const obs_encoder_t* encoder)
+{
+	return encoder ? const_cast<signal_handler_t*>(&encoder->signals) : nullptr;
+}
+
+extern "C" void* obs_encoder_create_rerouted(obs_encoder_t* encoder, const char* reroute_id)
+{
+	auto kv = ::encoder_types.find(reroute_id);
+	if (!encoder || (kv == ::encoder_types.end())) {
+		return nullptr;
+	}
+
+	encoder->info = &kv->second;
+	return encoder->info->create(encoder->settings, encoder);
+}
+
+// Encoders live until destroy_encoder(), so references are not counted.
+extern "C" void obs_encoder_release(obs_encoder_t*) {}
+
+extern "C" obs_weak_encoder_t* obs_encoder_get_weak_encoder(obs_encoder_t* encoder)
+{
+	return encoder ? new obs_weak_encoder_t{encoder->self} : nullptr;
+}
+
+extern "C" obs_encoder_t* obs_weak_encoder_get_encoder(obs_weak_encoder_t* weak)
+{
+	return weak ? *weak->encoder : nullptr;
+}
+
+extern "C" void obs_weak_encoder_release(obs_weak_encoder_t* weak)
+{
+	delete weak;
+}
+
+extern "C" bool signal_handler_add(signal_handler_t* handler, const char* signal_decl)
+{
+	// "void name(ptr encoder)", only the name matters.
+	const char* name   = std::strchr(signal_decl, ' ');
+	const char* params = std::strchr(signal_decl, '(');
+	if (!handler || !name || !params || (params < name)) {
+		return false;
+	}
+	return handler->signals.emplace(std::string(name + 1, params), decltype(signal_handler::signals)::mapped_type{})
+		.second;
+}
+
+extern "C" void signal_handler_connect(signal_handler_t* handler, const char* signal, signal_callback_t callback,
+									   void* data)
+{
+	if (auto kv = handler->signals.find(signal); kv != handler->signals.end()) {
+		kv->second.emplace_back(callback, data);
+	}
+}
+
+extern "C" void signal_handler_disconnect(signal_handler_t* handler, const char* signal, signal_callback_t callback,
+										  void* data)
+{
+	if (auto kv = handler->signals.find(signal); kv != handler->signals.end()) {
+		kv->second.remove(std::make_pair(callback, data));
+	}
+}
+
+extern "C" void signal_handler_signal(signal_handler_t* handler, const char* signal, calldata_t* params)
+{
+	streamfx::tests::shim::record("signal_handler_signal", signal);
+	if (auto kv = handler->signals.find(signal); kv != handler->signals.end()) {
+		// Callbacks may disconnect themselves while being called.
+		auto callbacks = kv->second;
+		for (auto& [callback, data] : callbacks) {
+			callback(data, params);
+		}
+	}
+}
+
+// Every entry is the name including its terminator, followed by the pointer.
+extern "C" void calldata_init(calldata_t* data)
+{
+	std::memset(data, 0, sizeof(calldata_t));
+}
+
+extern "C" void calldata_free(calldata_t* data)
+{
+	std::free(data->stack);
+	std::memset(data, 0, sizeof(calldata_t));
+}
+
+extern "C" void calldata_set_ptr(calldata_t* data, const char* name, void* ptr)
+{
+	std::size_t length = std::strlen(name) + 1;
+	std::size_t size   = data->size + length + sizeof(void*);
+	if (size > data->capacity) {
+		data->capacity = size * 2;
+		data->stack    = static_cast<uint8_t*>(std::realloc(data->stack, data->capacity));
+	}
+	std::memcpy(data->stack + data->size, name, length);
+	std::memcpy(data->stack + data->size + length, &ptr, sizeof(void*));
+	data->size = size;
+}
+
+extern "C" void* calldata_ptr(const calldata_t* data, const char* name)
+{
+	// Later entries replace earlier ones of the same name.
+	void* result = nullptr;
+	for (std::size_t offset = 0; offset < data->size;) {
+		auto        entry  = reinterpret_cast<const char*>(data->stack + offset);
+		std::size_t length = std::strlen(entry) + 1;
+		if (std::strcmp(entry, name) == 0) {
+			std::memcpy(&result, data->stack + offset + length, sizeof(void*));
+		}
+		offset += length + sizeof(void*);
+	}
+	return result;
+}
@@ -0,0 +1,625 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// A CPU stand-in for the libobs graphics subsystem. Textures hold real memory and render targets can be cleared and
+// copied, everything else is only recorded so that tests can check what was called. With OpenGL enabled, textures and
+// staging surfaces are real OpenGL objects instead, see 'opengl.cpp'.
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "opengl.hpp"
+#include "shim.hpp"
+
+extern "C" {
+#include "graphics/graphics.h"
+#include "graphics/vec3.h"
+#include "graphics/vec4.h"
+#include "util/bmem.h"
+}
+
+struct graphics_subsystem {
+	int                        device_type = GS_DEVICE_OPENGL;
+	std::vector<gs_texture_t*> targets;
+	std::size_t                blend_depth = 0;
+};
+
+struct gs_vertex_buffer {
+	gs_vb_data*                                 data;    // What gs_vertexbuffer_get_data() returns.
+	std::map<std::string, std::vector<uint8_t>> streams; // What the GPU holds, one entry per attribute.
+};
+
+struct gs_stage_surface {
+	uint32_t             width;
+	uint32_t             height;
+	gs_color_format      format;
+	uint32_t             buffer; // OpenGL pixel pack buffer, if enabled.
+	std::vector<uint8_t> data;
+};
+
+struct gs_texture_render {
+	gs_color_format    format;
+	gs_zstencil_format zsformat;
+	gs_texture_t*      texture;
+	bool               rendered;
+};
+
+namespace {
+	graphics_subsystem graphics;
+
+	gs_texture_t* create_texture(gs_texture_type type, uint32_t width, uint32_t height, uint32_t depth,
+								 gs_color_format format, uint32_t levels, const uint8_t** data, uint32_t flags)
+	{
+		auto* tex = new gs_texture{type, width, height, depth, levels, format, flags, 0, {}};
+		if (streamfx::tests::shim::opengl::active() && (type == GS_TEXTURE_2D)) {
+			streamfx::tests::shim::opengl::create_texture(tex, data ? data[0] : nullptr);
+			return tex;
+		}
+
+		tex->data.resize(static_cast<std::size_t>(width) * height * depth * gs_get_format_bpp(format) / 8);
+		if (data && data[0]) {
+			std::memcpy(tex->data.data(), data[0], tex->data.size());
+		}
+		return tex;
+	}
+
+	// Call 'fn(name, array, element size)' for every attribute of the vertex data, in the order libobs uploads them.
+	template<typename T>
+	void for_each_stream(const gs_vb_data* data, T fn)
+	{
+		fn("points", data->points, sizeof(vec3));
+		fn("normals", data->normals, sizeof(vec3));
+		fn("tangents", data->tangents, sizeof(vec3));
+		fn("colors", data->colors, sizeof(uint32_t));
+		for (std::size_t n = 0; (n < data->num_tex) && data->tvarray; n++) {
+			fn("uv" + std::to_string(n), data->tvarray[n].array, sizeof(float) * data->tvarray[n].width);
+		}
+	}
+
+	void* duplicate(const void* array, std::size_t size)
+	{
+		if (!array) {
+			return nullptr;
+		}
+		void* copy = bmalloc(size);
+		std::memcpy(copy, array, size);
+		return copy;
+	}
+} // namespace
+
+gs_texture_t* streamfx::tests::shim::current_render_target()
+{
+	return graphics.targets.empty() ? nullptr : graphics.targets.back();
+}
+
+void streamfx::tests::shim::set_device_type(int type)
+{
+	graphics.device_type = type;
+}
+
+bool streamfx::tests::shim::enable_opengl()
+{
+	return streamfx::tests::shim::opengl::initialize();
+}
+
+extern "C" graphics_t* gs_get_context(void)
+{
+	return &graphics;
+}
+
+extern "C" int gs_get_device_type(void)
+{
+	return graphics.device_type;
+}
+
+extern "C" void* gs_get_device_obj(void)
+{
+	return &graphics;
+}
+
+extern "C" uint32_t gs_get_format_bpp(enum gs_color_format format)
+{
+	switch (format) {
+	case GS_A8:
+	case GS_R8:
+	case GS_DXT3:
+	case GS_DXT5:
+		return 8;
+	case GS_DXT1:
+		return 4;
+	case GS_R8G8:
+	case GS_R16:
+	case GS_R16F:
+		return 16;
+	case GS_RGBA:
+	case GS_BGRX:
+	case GS_BGRA:
+	case GS_R10G10B10A2:
+	case GS_RG16F:
+	case GS_R32F:
+	case GS_RGBA_UNORM:
+	case GS_BGRX_UNORM:
+	case GS_BGRA_UNORM:
+	case GS_RG16:
+		return 32;
+	case GS_RGBA16:
+	case GS_RGBA16F:
+	case GS_RG32F:
+		return 64;
+	case GS_RGBA32F:
+		return 128;
+	case GS_UNKNOWN:
+		return 0;
+	}
+	return 0;
+}
+
+extern "C" void gs_debug_marker_begin(const float[4], const char* markername)
+{
+	streamfx::tests::shim::record("gs_debug_marker_begin", markername ? markername : "");
+}
+
+extern "C" void gs_debug_marker_end(void)
+{
+	streamfx::tests::shim::record("gs_debug_marker_end");
+}
+
+extern "C" void gs_blend_state_push(void)
+{
+	graphics.blend_depth++;
+	streamfx::tests::shim::record("gs_blend_state_push");
+}
+
+extern "C" void gs_blend_state_pop(void)
+{
+	if (graphics.blend_depth == 0) {
+		streamfx::tests::shim::record("gs_blend_state_pop", "underflow");
+		return;
+	}
+	graphics.blend_depth--;
+	streamfx::tests::shim::record("gs_blend_state_pop");
+}
+
+extern "C" void gs_reset_blend_state(void)
+{
+	streamfx::tests::shim::record("gs_reset_blend_state");
+}
+
+extern "C" void gs_enable_blending(bool enable)
+{
+	streamfx::tests::shim::record("gs_enable_blending", enable ? "true" : "false");
+}
+
+extern "C" void gs_enable_depth_test(bool enable)
+{
+	streamfx::tests::shim::record("gs_enable_depth_test", enable ? "true" : "false");
+}
+
+extern "C" void gs_enable_stencil_test(bool enable)
+{
+	streamfx::tests::shim::record("gs_enable_stencil_test", enable ? "true" : "false");
+}
+
+extern "C" void gs_enable_stencil_write(bool enable)
+{
+	streamfx::tests::shim::record("gs_enable_stencil_write", enable ? "true" : "false");
+}
+
+extern "C" void gs_enable_color(bool red, bool green, bool blue, bool alpha)
+{
+	std::string mask;
+	mask += red ? 'r' : '-';
+	mask += green ? 'g' : '-';
+	mask += blue ? 'b' : '-';
+	mask += alpha ? 'a' : '-';
+	streamfx::tests::shim::record("gs_enable_color", mask);
+}
+
+extern "C" void gs_blend_function(enum gs_blend_type src, enum gs_blend_type dest)
+{
+	streamfx::tests::shim::record("gs_blend_function", std::to_string(src) + "," + std::to_string(dest));
+}
+
+extern "C" void gs_set_cull_mode(enum gs_cull_mode mode)
+{
+	streamfx::tests::shim::record("gs_set_cull_mode", std::to_string(mode));
+}
+
+extern "C" void gs_set_viewport(int x, int y, int width, int height)
+{
+	streamfx::tests::shim::record("gs_set_viewport", std::to_string(x) + "," + std::to_string(y) + ","
+														 + std::to_string(width) + "," + std::to_string(height));
+}
+
+extern "C" void gs_ortho(float left, float right, float top, float bottom, float, float)
+{
+	// Integral sizes are all that is ever used, so the log stays readable.
+	streamfx::tests::shim::record("gs_ortho", std::to_string(static_cast<int>(left)) + ","
+												  + std::to_string(static_cast<int>(right)) + ","
+												  + std::to_string(static_cast<int>(top)) + ","
+												  + std::to_string(static_cast<int>(bottom)));
+}
+
+extern "C" void gs_clear(uint32_t clear_flags, const struct vec4* color, float, uint8_t)
+{
+	streamfx::tests::shim::record("gs_clear");
+
+	gs_texture_t* target = streamfx::tests::shim::current_render_target();
+	if (target && color && (clear_flags & GS_CLEAR_COLOR) && streamfx::tests::shim::opengl::active()) {
+		streamfx::tests::shim::opengl::clear(target, color->ptr);
+		return;
+	}
+	if (!target || !color || !(clear_flags & GS_CLEAR_COLOR) || (gs_get_format_bpp(target->format) != 32)) {
+		return;
+	}
+
+	// Stored as RGBA8, which is all that tests read back.
+	uint8_t pixel[4];
+	for (std::size_t idx = 0; idx < 4; idx++) {
+		pixel[idx] = static_cast<uint8_t>(std::clamp(color->ptr[idx], 0.f, 1.f) * 255.f + .5f);
+	}
+	for (std::size_t offset = 0; offset < target->data.size(); offset += 4) {
+		std::memcpy(&target->data[offset], pixel, 4);
+	}
+}
+
+extern "C" void gs_draw(enum gs_draw_mode draw_mode, uint32_t start_vert, uint32_t num_verts)
+{
+	streamfx::tests::shim::record("gs_draw", std::to_string(draw_mode) + "," + std::to_string(start_vert) + ","
+												 + std::to_string(num_verts));
+}
+
+extern "C" void gs_draw_sprite(gs_texture_t*, uint32_t, uint32_t width, uint32_t height)
+{
+	streamfx::tests::shim::record("gs_draw_sprite", std::to_string(width) + "x" + std::to_string(height));
+}
+
+extern "C" void gs_load_vertexbuffer(gs_vertbuffer_t*)
+{
+	streamfx::tests::shim::record("gs_load_vertexbuffer");
+}
+
+extern "C" void gs_load_indexbuffer(gs_indexbuffer_t*)
+{
+	streamfx::tests::shim::record("gs_load_indexbuffer");
+}
+
+extern "C" void gs_load_texture(gs_texture_t*, int unit)
+{
+	streamfx::tests::shim::record("gs_load_texture", std::to_string(unit));
+}
+
+extern "C" gs_texture_t* gs_texture_create(uint32_t width, uint32_t height, enum gs_color_format color_format,
+										   uint32_t levels, const uint8_t** data, uint32_t flags)
+{
+	return create_texture(GS_TEXTURE_2D, width, height, 1, color_format, levels, data, flags);
+}
+
+extern "C" gs_texture_t* gs_texture_create_from_file(const char*)
+{
+	return nullptr;
+}
+
+extern "C" void gs_texture_destroy(gs_texture_t* tex)
+{
+	if (tex) {
+		streamfx::tests::shim::opengl::destroy_texture(tex);
+	}
+	delete tex;
+}
+
+extern "C" uint32_t gs_texture_get_width(const gs_texture_t* tex)
+{
+	return tex ? tex->width : 0;
+}
+
+extern "C" uint32_t gs_texture_get_height(const gs_texture_t* tex)
+{
+	return tex ? tex->height : 0;
+}
+
+extern "C" enum gs_color_format gs_texture_get_color_format(const gs_texture_t* tex)
+{
+	return tex ? tex->format : GS_UNKNOWN;
+}
+
+extern "C" void* gs_texture_get_obj(gs_texture_t* tex)
+{
+	return tex ? &tex->object : nullptr;
+}
+
+extern "C" enum gs_texture_type gs_get_texture_type(const gs_texture_t* texture)
+{
+	return texture ? texture->type : GS_TEXTURE_2D;
+}
+
+extern "C" gs_texture_t* gs_cubetexture_create(uint32_t size, enum gs_color_format color_format, uint32_t levels,
+											   const uint8_t** data, uint32_t flags)
+{
+	return create_texture(GS_TEXTURE_CUBE, size, size, 6, color_format, levels, data, flags);
+}
+
+extern "C" void gs_cubetexture_destroy(gs_texture_t* cubetex)
+{
+	delete cubetex;
+}
+
+extern "C" uint32_t gs_cubetexture_get_size(const gs_texture_t* cubetex)
+{
+	return cubetex ? cubetex->width : 0;
+}
+
+extern "C" gs_texture_t* gs_voltexture_create(uint32_t width, uint32_t height, uint32_t depth,
+											  enum gs_color_format color_format, uint32_t levels, const uint8_t** data,
+											  uint32_t flags)
+{
+	return create_texture(GS_TEXTURE_3D, width, height, depth, color_format, levels, data, flags);
+}
+
+extern "C" void gs_voltexture_destroy(gs_texture_t* voltex)
+{
+	delete voltex;
+}
+
+extern "C" uint32_t gs_voltexture_get_width(const gs_texture_t* voltex)
+{
+	return voltex ? voltex->width : 0;
+}
+
+extern "C" uint32_t gs_voltexture_get_height(const gs_texture_t* voltex)
+{
+	return voltex ? voltex->height : 0;
+}
+
+extern "C" uint32_t gs_voltexture_get_depth(const gs_texture_t* voltex)
+{
+	return voltex ? voltex->depth : 0;
+}
+
+extern "C" void gs_copy_texture_region(gs_texture_t* dst, uint32_t dst_x, uint32_t dst_y, gs_texture_t* src,
+									   uint32_t src_x, uint32_t src_y, uint32_t src_w, uint32_t src_h)
+{
+	streamfx::tests::shim::record("gs_copy_texture_region");
+	if (!dst || !src || (dst->format != src->format)) {
+		return;
+	}
+
+	// A size of 0 means "everything from the offset onwards", as in libobs.
+	uint32_t width  = std::min(src_w ? src_w : src->width - src_x, dst->width - dst_x);
+	uint32_t height = std::min(src_h ? src_h : src->height - src_y, dst->height - dst_y);
+	if (streamfx::tests::shim::opengl::active()) {
+		streamfx::tests::shim::opengl::copy_texture_region(dst, dst_x, dst_y, src, src_x, src_y, width, height);
+		return;
+	}
+
+	std::size_t bpp = gs_get_format_bpp(src->format) / 8;
+	for (uint32_t y = 0; y < height; y++) {
+		std::memcpy(&dst->data[((dst_y + y) * dst->width + dst_x) * bpp],
+					&src->data[((src_y + y) * src->width + src_x) * bpp], width * bpp);
+	}
+}
+
+const std::vector<uint8_t>* streamfx::tests::shim::vertex_buffer_stream(gs_vertbuffer_t* vb, std::string_view name)
+{
+	if (!vb) {
+		return nullptr;
+	}
+	auto found = vb->streams.find(std::string(name));
+	return (found != vb->streams.end()) ? &found->second : nullptr;
+}
+
+extern "C" gs_vertbuffer_t* gs_vertexbuffer_create(struct gs_vb_data* data, uint32_t flags)
+{
+	if (!data) {
+		return nullptr;
+	}
+
+	// Like libobs, the buffer owns the data unless asked to make its own copy of it.
+	auto* vb = new gs_vertex_buffer{data, {}};
+	if (flags & GS_DUP_BUFFER) {
+		vb->data           = static_cast<gs_vb_data*>(bzalloc(sizeof(gs_vb_data)));
+		vb->data->num      = data->num;
+		vb->data->num_tex  = data->num_tex;
+		vb->data->points   = static_cast<vec3*>(duplicate(data->points, sizeof(vec3) * data->num));
+		vb->data->normals  = static_cast<vec3*>(duplicate(data->normals, sizeof(vec3) * data->num));
+		vb->data->tangents = static_cast<vec3*>(duplicate(data->tangents, sizeof(vec3) * data->num));
+		vb->data->colors   = static_cast<uint32_t*>(duplicate(data->colors, sizeof(uint32_t) * data->num));
+		if (data->num_tex && data->tvarray) {
+			vb->data->tvarray = static_cast<gs_tvertarray*>(bzalloc(sizeof(gs_tvertarray) * data->num_tex));
+			for (std::size_t n = 0; n < data->num_tex; n++) {
+				vb->data->tvarray[n].width = data->tvarray[n].width;
+				vb->data->tvarray[n].array =
+					duplicate(data->tvarray[n].array, sizeof(float) * data->tvarray[n].width * data->num);
+			}
+		}
+	}
+
+	// Only attributes present at creation get a GPU buffer, later flushes can not add any.
+	std::string streams;
+	for_each_stream(vb->data, [vb, &streams](std::string name, const void* array, std::size_t element) {
+		if (array) {
+			auto& stream = vb->streams[name];
+			stream.resize(element * vb->data->num);
+			std::memcpy(stream.data(), array, stream.size());
+			streams += (streams.empty() ? "" : ",") + name;
+		}
+	});
+	streamfx::tests::shim::record("gs_vertexbuffer_create", streams);
+	return vb;
+}
+
+extern "C" void gs_vertexbuffer_destroy(gs_vertbuffer_t* vertbuffer)
+{
+	if (vertbuffer) {
+		gs_vbdata_destroy(vertbuffer->data);
+	}
+	delete vertbuffer;
+}
+
+extern "C" void gs_vertexbuffer_flush_direct(gs_vertbuffer_t* vertbuffer, const struct gs_vb_data* data)
+{
+	if (!vertbuffer || !data) {
+		return;
+	}
+
+	// Attributes that are nullptr are skipped, the argument lists the ones that were uploaded.
+	std::string streams;
+	for_each_stream(data, [vertbuffer, data, &streams](std::string name, const void* array, std::size_t element) {
+		auto found = vertbuffer->streams.find(name);
+		if (array && (found != vertbuffer->streams.end())) {
+			std::memcpy(found->second.data(), array, std::min(found->second.size(), element * data->num));
+			streams += (streams.empty() ? "" : ",") + name;
+		}
+	});
+	streamfx::tests::shim::record("gs_vertexbuffer_flush_direct", streams);
+}
+
+extern "C" struct gs_vb_data* gs_vertexbuffer_get_data(const gs_vertbuffer_t* vertbuffer)
+{
+	return vertbuffer ? vertbuffer->data : nullptr;
+}
+
+extern "C" void gs_vbdata_destroy(struct gs_vb_data* data)
+{
+	if (!data) {
+		return;
+	}
+
+	bfree(data->points);
+	bfree(data->normals);
+	bfree(data->tangents);
+	bfree(data->colors);
+	for (std::size_t n = 0; (n < data->num_tex) && data->tvarray; n++) {
+		bfree(data->tvarray[n].array);
+	}
+	bfree(data->tvarray);
+	bfree(data);
+}
+
+extern "C" gs_stagesurf_t* gs_stagesurface_create(uint32_t width, uint32_t height, enum gs_color_format color_format)
+{
+	auto* surface = new gs_stage_surface{width, height, color_format, 0, {}};
+	if (streamfx::tests::shim::opengl::active()) {
+		surface->buffer = streamfx::tests::shim::opengl::create_stage(width, height, color_format);
+	} else {
+		surface->data.resize(static_cast<std::size_t>(width) * height * gs_get_format_bpp(color_format) / 8);
+	}
+	return surface;
+}
+
+extern "C" void gs_stagesurface_destroy(gs_stagesurf_t* stagesurf)
+{
+	if (stagesurf && stagesurf->buffer) {
+		streamfx::tests::shim::opengl::destroy_stage(stagesurf->buffer);
+	}
+	delete stagesurf;
+}
+
+extern "C" bool gs_stagesurface_map(gs_stagesurf_t* stagesurf, uint8_t** data, uint32_t* linesize)
+{
+	if (!stagesurf || !data || !linesize) {
+		return false;
+	}
+
+	*data     = stagesurf->buffer ? streamfx::tests::shim::opengl::map(stagesurf->buffer) : stagesurf->data.data();
+	*linesize = stagesurf->width * gs_get_format_bpp(stagesurf->format) / 8;
+	streamfx::tests::shim::record("gs_stagesurface_map");
+	return *data != nullptr;
+}
+
+extern "C" void gs_stagesurface_unmap(gs_stagesurf_t* stagesurf)
+{
+	if (stagesurf && stagesurf->buffer) {
+		streamfx::tests::shim::opengl::unmap(stagesurf->buffer);
+	}
+	streamfx::tests::shim::record("gs_stagesurface_unmap");
+}
+
+extern "C" void gs_stage_texture(gs_stagesurf_t* dst, gs_texture_t* src)
+{
+	streamfx::tests::shim::record("gs_stage_texture");
+	if (!dst || !src || (dst->width != src->width) || (dst->height != src->height) || (dst->format != src->format)) {
+		return;
+	}
+
+	if (dst->buffer) {
+		streamfx::tests::shim::opengl::stage(dst->buffer, src);
+	} else {
+		std::memcpy(dst->data.data(), src->data.data(), std::min(dst->data.size(), src->data.size()));
+	}
+}
+
+extern "C" gs_texrender_t* gs_texrender_create(enum gs_color_format format, enum gs_zstencil_format zsformat)
+{
+	streamfx::tests::shim::record("gs_texrender_create");
+	return new gs_texture_render{format, zsformat, nullptr, false};
+}
+
+extern "C" void gs_texrender_destroy(gs_texrender_t* texrender)
+{
+	if (texrender) {
+		streamfx::tests::shim::record("gs_texrender_destroy");
+		gs_texture_destroy(texrender->texture);
+	}
+	delete texrender;
+}
+
+extern "C" bool gs_texrender_begin(gs_texrender_t* texrender, uint32_t cx, uint32_t cy)
+{
+	// Like libobs, a render target must be reset before it can be rendered to again.
+	if (!texrender || texrender->rendered || (cx == 0) || (cy == 0)) {
+		return false;
+	}
+
+	if (!texrender->texture || (texrender->texture->width != cx) || (texrender->texture->height != cy)) {
+		gs_texture_destroy(texrender->texture);
+		texrender->texture = gs_texture_create(cx, cy, texrender->format, 1, nullptr, GS_RENDER_TARGET);
+	}
+
+	graphics.targets.push_back(texrender->texture);
+	streamfx::tests::shim::record("gs_texrender_begin", std::to_string(cx) + "x" + std::to_string(cy));
+	return true;
+}
+
+extern "C" void gs_texrender_end(gs_texrender_t* texrender)
+{
+	if (!texrender || graphics.targets.empty() || (graphics.targets.back() != texrender->texture)) {
+		streamfx::tests::shim::record("gs_texrender_end", "mismatched");
+		return;
+	}
+
+	graphics.targets.pop_back();
+	texrender->rendered = true;
+	streamfx::tests::shim::record("gs_texrender_end");
+}
+
+extern "C" void gs_texrender_reset(gs_texrender_t* texrender)
+{
+	if (texrender) {
+		texrender->rendered = false;
+	}
+}
+
+extern "C" gs_texture_t* gs_texrender_get_texture(const gs_texrender_t* texrender)
+{
+	return texrender ? texrender->texture : nullptr;
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The effect structures of 'libobs/graphics/effect.h', which StreamFX accesses directly. Fields are in the same order
+// as in libobs, but end with the last one that StreamFX or the stand-in uses.
+
+#pragma once
+#include "../util/darray.h"
+#include "graphics.h"
+
+enum effect_section {
+	EFFECT_PARAM,
+	EFFECT_TECHNIQUE,
+	EFFECT_SAMPLER,
+	EFFECT_PASS,
+	EFFECT_ANNOTATION,
+};
+
+struct gs_effect_param {
+	char*                     name;
+	enum effect_section       section;
+	enum gs_shader_param_type type;
+	bool                      changed;
+	DARRAY(uint8_t) cur_val;
+	DARRAY(uint8_t) default_val;
+	gs_effect_t*       effect;
+	gs_samplerstate_t* next_sampler;
+	DARRAY(struct gs_effect_param) annotations;
+};
+
+struct pass_shaderparam {
+	struct gs_effect_param* eparam;
+	void*                   sparam;
+};
+
+struct gs_effect_pass {
+	char*               name;
+	enum effect_section section;
+	void*               vertshader;
+	void*               pixelshader;
+	DARRAY(struct pass_shaderparam) vertshader_params;
+	DARRAY(struct pass_shaderparam) pixelshader_params;
+};
+
+struct gs_effect_technique {
+	char*               name;
+	enum effect_section section;
+	struct gs_effect*   effect;
+	DARRAY(struct gs_effect_pass) passes;
+};
+
+struct gs_effect {
+	bool  processing;
+	bool  cached;
+	char* effect_path;
+	char* effect_dir;
+
+	gs_eparam_t* view_proj;
+	gs_eparam_t* world;
+	gs_eparam_t* scale;
+	graphics_t*  graphics;
+
+	struct gs_effect* next;
+
+	size_t loop_pass;
+	bool   looping;
+
+	DARRAY(struct gs_effect_param) params;
+	DARRAY(struct gs_effect_technique) techniques;
+
+	struct gs_effect_technique* cur_technique;
+	struct gs_effect_pass*      cur_pass;
+};
@@ -0,0 +1,295 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Only the parts of 'libobs/graphics/graphics.h' that StreamFX uses, with the same names and values.
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct vec2;
+struct vec3;
+struct vec4;
+struct matrix4;
+
+#define GS_BUILD_MIPMAPS (1 << 0)
+#define GS_DYNAMIC (1 << 1)
+#define GS_RENDER_TARGET (1 << 2)
+#define GS_GL_DUMMYTEX (1 << 3)
+#define GS_DUP_BUFFER (1 << 4)
+#define GS_SHARED_TEX (1 << 5)
+#define GS_SHARED_KM_TEX (1 << 6)
+
+#define GS_CLEAR_COLOR (1 << 0)
+#define GS_CLEAR_DEPTH (1 << 1)
+#define GS_CLEAR_STENCIL (1 << 2)
+
+#define GS_DEVICE_OPENGL 1
+#define GS_DEVICE_DIRECT3D_11 2
+
+enum gs_draw_mode {
+	GS_POINTS,
+	GS_LINES,
+	GS_LINESTRIP,
+	GS_TRIS,
+	GS_TRISTRIP,
+};
+
+enum gs_color_format {
+	GS_UNKNOWN,
+	GS_A8,
+	GS_R8,
+	GS_RGBA,
+	GS_BGRX,
+	GS_BGRA,
+	GS_R10G10B10A2,
+	GS_RGBA16,
+	GS_R16,
+	GS_RGBA16F,
+	GS_RGBA32F,
+	GS_RG16F,
+	GS_RG32F,
+	GS_R16F,
+	GS_R32F,
+	GS_DXT1,
+	GS_DXT3,
+	GS_DXT5,
+	GS_R8G8,
+	GS_RGBA_UNORM,
+	GS_BGRX_UNORM,
+	GS_BGRA_UNORM,
+	GS_RG16,
+};
+
+enum gs_zstencil_format {
+	GS_ZS_NONE,
+	GS_Z16,
+	GS_Z24_S8,
+	GS_Z32F,
+	GS_Z32F_S8X24,
+};
+
+enum gs_index_type {
+	GS_UNSIGNED_SHORT,
+	GS_UNSIGNED_LONG,
+};
+
+enum gs_cull_mode {
+	GS_BACK,
+	GS_FRONT,
+	GS_NEITHER,
+};
+
+enum gs_blend_type {
+	GS_BLEND_ZERO,
+	GS_BLEND_ONE,
+	GS_BLEND_SRCCOLOR,
+	GS_BLEND_INVSRCCOLOR,
+	GS_BLEND_SRCALPHA,
+	GS_BLEND_INVSRCALPHA,
+	GS_BLEND_DSTCOLOR,
+	GS_BLEND_INVDSTCOLOR,
+	GS_BLEND_DSTALPHA,
+	GS_BLEND_INVDSTALPHA,
+	GS_BLEND_SRCALPHASAT,
+};
+
+enum gs_sample_filter {
+	GS_FILTER_POINT,
+	GS_FILTER_LINEAR,
+	GS_FILTER_ANISOTROPIC,
+	GS_FILTER_MIN_MAG_POINT_MIP_LINEAR,
+	GS_FILTER_MIN_POINT_MAG_LINEAR_MIP_POINT,
+	GS_FILTER_MIN_POINT_MAG_MIP_LINEAR,
+	GS_FILTER_MIN_LINEAR_MAG_MIP_POINT,
+	GS_FILTER_MIN_LINEAR_MAG_POINT_MIP_LINEAR,
+	GS_FILTER_MIN_MAG_LINEAR_MIP_POINT,
+};
+
+enum gs_address_mode {
+	GS_ADDRESS_CLAMP,
+	GS_ADDRESS_WRAP,
+	GS_ADDRESS_MIRROR,
+	GS_ADDRESS_BORDER,
+	GS_ADDRESS_MIRRORONCE,
+};
+
+enum gs_texture_type {
+	GS_TEXTURE_2D,
+	GS_TEXTURE_3D,
+	GS_TEXTURE_CUBE,
+};
+
+enum gs_shader_param_type {
+	GS_SHADER_PARAM_UNKNOWN,
+	GS_SHADER_PARAM_BOOL,
+	GS_SHADER_PARAM_FLOAT,
+	GS_SHADER_PARAM_INT,
+	GS_SHADER_PARAM_STRING,
+	GS_SHADER_PARAM_VEC2,
+	GS_SHADER_PARAM_VEC3,
+	GS_SHADER_PARAM_VEC4,
+	GS_SHADER_PARAM_INT2,
+	GS_SHADER_PARAM_INT3,
+	GS_SHADER_PARAM_INT4,
+	GS_SHADER_PARAM_MATRIX4X4,
+	GS_SHADER_PARAM_TEXTURE,
+};
+
+struct gs_tvertarray {
+	size_t width;
+	void*  array;
+};
+
+struct gs_vb_data {
+	size_t                num;
+	struct vec3*          points;
+	struct vec3*          normals;
+	struct vec3*          tangents;
+	uint32_t*             colors;
+	size_t                num_tex;
+	struct gs_tvertarray* tvarray;
+};
+
+struct gs_sampler_info {
+	enum gs_sample_filter filter;
+	enum gs_address_mode  address_u;
+	enum gs_address_mode  address_v;
+	enum gs_address_mode  address_w;
+	int                   max_anisotropy;
+	uint32_t              border_color;
+};
+
+typedef struct graphics_subsystem  graphics_t;
+typedef struct gs_texture          gs_texture_t;
+typedef struct gs_stage_surface    gs_stagesurf_t;
+typedef struct gs_sampler_state    gs_samplerstate_t;
+typedef struct gs_vertex_buffer    gs_vertbuffer_t;
+typedef struct gs_index_buffer     gs_indexbuffer_t;
+typedef struct gs_texture_render   gs_texrender_t;
+typedef struct gs_effect           gs_effect_t;
+typedef struct gs_effect_technique gs_technique_t;
+typedef struct gs_effect_pass      gs_epass_t;
+typedef struct gs_effect_param     gs_eparam_t;
+
+// Context
+graphics_t* gs_get_context(void);
+int         gs_get_device_type(void);
+void*       gs_get_device_obj(void);
+uint32_t    gs_get_format_bpp(enum gs_color_format format);
+
+void gs_debug_marker_begin(const float color[4], const char* markername);
+void gs_debug_marker_end(void);
+
+// State
+void gs_blend_state_push(void);
+void gs_blend_state_pop(void);
+void gs_reset_blend_state(void);
+void gs_enable_blending(bool enable);
+void gs_enable_depth_test(bool enable);
+void gs_enable_stencil_test(bool enable);
+void gs_enable_stencil_write(bool enable);
+void gs_enable_color(bool red, bool green, bool blue, bool alpha);
+void gs_blend_function(enum gs_blend_type src, enum gs_blend_type dest);
+void gs_set_cull_mode(enum gs_cull_mode mode);
+void gs_set_viewport(int x, int y, int width, int height);
+void gs_ortho(float left, float right, float top, float bottom, float znear, float zfar);
+void gs_clear(uint32_t clear_flags, const struct vec4* color, float depth, uint8_t stencil);
+void gs_draw(enum gs_draw_mode draw_mode, uint32_t start_vert, uint32_t num_verts);
+void gs_draw_sprite(gs_texture_t* tex, uint32_t flip, uint32_t width, uint32_t height);
+
+void gs_load_vertexbuffer(gs_vertbuffer_t* vertbuffer);
+void gs_load_indexbuffer(gs_indexbuffer_t* indexbuffer);
+void gs_load_texture(gs_texture_t* tex, int unit);
+
+// Textures
+gs_texture_t* gs_texture_create(uint32_t width, uint32_t height, enum gs_color_format color_format, uint32_t levels,
+								const uint8_t** data, uint32_t flags);
+gs_texture_t* gs_texture_create_from_file(const char* file);
+void          gs_texture_destroy(gs_texture_t* tex);
+uint32_t      gs_texture_get_width(const gs_texture_t* tex);
+uint32_t      gs_texture_get_height(const gs_texture_t* tex);
+enum gs_color_format gs_texture_get_color_format(const gs_texture_t* tex);
+void*                gs_texture_get_obj(gs_texture_t* tex);
+enum gs_texture_type gs_get_texture_type(const gs_texture_t* texture);
+
+gs_texture_t* gs_cubetexture_create(uint32_t size, enum gs_color_format color_format, uint32_t levels,
+									const uint8_t** data, uint32_t flags);
+void          gs_cubetexture_destroy(gs_texture_t* cubetex);
+uint32_t      gs_cubetexture_get_size(const gs_texture_t* cubetex);
+
+gs_texture_t* gs_voltexture_create(uint32_t width, uint32_t height, uint32_t depth, enum gs_color_format color_format,
+								   uint32_t levels, const uint8_t** data, uint32_t flags);
+void          gs_voltexture_destroy(gs_texture_t* voltex);
+uint32_t      gs_voltexture_get_width(const gs_texture_t* voltex);
+uint32_t      gs_voltexture_get_height(const gs_texture_t* voltex);
+uint32_t      gs_voltexture_get_depth(const gs_texture_t* voltex);
+
+void gs_copy_texture_region(gs_texture_t* dst, uint32_t dst_x, uint32_t dst_y, gs_texture_t* src, uint32_t src_x,
+							uint32_t src_y, uint32_t src_w, uint32_t src_h);
+
+// Staging Surfaces
+gs_stagesurf_t* gs_stagesurface_create(uint32_t width, uint32_t height, enum gs_color_format color_format);
+void            gs_stagesurface_destroy(gs_stagesurf_t* stagesurf);
+bool            gs_stagesurface_map(gs_stagesurf_t* stagesurf, uint8_t** data, uint32_t* linesize);
+void            gs_stagesurface_unmap(gs_stagesurf_t* stagesurf);
+void            gs_stage_texture(gs_stagesurf_t* dst, gs_texture_t* src);
+
+// Vertex Buffers
+gs_vertbuffer_t*   gs_vertexbuffer_create(struct gs_vb_data* data, uint32_t flags);
+void               gs_vertexbuffer_destroy(gs_vertbuffer_t* vertbuffer);
+void               gs_vertexbuffer_flush_direct(gs_vertbuffer_t* vertbuffer, const struct gs_vb_data* data);
+struct gs_vb_data* gs_vertexbuffer_get_data(const gs_vertbuffer_t* vertbuffer);
+void               gs_vbdata_destroy(struct gs_vb_data* data);
+
+// Render Targets
+gs_texrender_t* gs_texrender_create(enum gs_color_format format, enum gs_zstencil_format zsformat);
+void            gs_texrender_destroy(gs_texrender_t* texrender);
+bool            gs_texrender_begin(gs_texrender_t* texrender, uint32_t cx, uint32_t cy);
+void            gs_texrender_end(gs_texrender_t* texrender);
+void            gs_texrender_reset(gs_texrender_t* texrender);
+gs_texture_t*   gs_texrender_get_texture(const gs_texrender_t* texrender);
+
+// Samplers
+gs_samplerstate_t* gs_samplerstate_create(const struct gs_sampler_info* info);
+void               gs_samplerstate_destroy(gs_samplerstate_t* samplerstate);
+
+// Effects
+gs_effect_t* gs_effect_create(const char* effect_string, const char* filename, char** error_string);
+void         gs_effect_destroy(gs_effect_t* effect);
+bool         gs_effect_loop(gs_effect_t* effect, const char* name);
+size_t       gs_param_get_num_annotations(const gs_eparam_t* param);
+
+void gs_effect_set_bool(gs_eparam_t* param, bool val);
+void gs_effect_set_float(gs_eparam_t* param, float val);
+void gs_effect_set_int(gs_eparam_t* param, int val);
+void gs_effect_set_matrix4(gs_eparam_t* param, const struct matrix4* val);
+void gs_effect_set_vec2(gs_eparam_t* param, const struct vec2* val);
+void gs_effect_set_vec3(gs_eparam_t* param, const struct vec3* val);
+void gs_effect_set_vec4(gs_eparam_t* param, const struct vec4* val);
+void gs_effect_set_texture(gs_eparam_t* param, gs_texture_t* val);
+void gs_effect_set_val(gs_eparam_t* param, const void* val, size_t size);
+void gs_effect_set_next_sampler(gs_eparam_t* param, gs_samplerstate_t* sampler);
+
+void*  gs_effect_get_val(gs_eparam_t* param);
+size_t gs_effect_get_val_size(gs_eparam_t* param);
+void*  gs_effect_get_default_val(gs_eparam_t* param);
+size_t gs_effect_get_default_val_size(gs_eparam_t* param);
@@ -0,0 +1,82 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define MAX_AV_PLANES 8
+
+enum video_format {
+	VIDEO_FORMAT_NONE,
+	VIDEO_FORMAT_I420,
+	VIDEO_FORMAT_NV12,
+	VIDEO_FORMAT_YVYU,
+	VIDEO_FORMAT_YUY2,
+	VIDEO_FORMAT_UYVY,
+	VIDEO_FORMAT_RGBA,
+	VIDEO_FORMAT_BGRA,
+	VIDEO_FORMAT_BGRX,
+	VIDEO_FORMAT_Y800,
+	VIDEO_FORMAT_I444,
+	VIDEO_FORMAT_BGR3,
+	VIDEO_FORMAT_I422,
+	VIDEO_FORMAT_I40A,
+	VIDEO_FORMAT_I42A,
+	VIDEO_FORMAT_YUVA,
+	VIDEO_FORMAT_AYUV,
+};
+
+enum video_colorspace {
+	VIDEO_CS_DEFAULT,
+	VIDEO_CS_601,
+	VIDEO_CS_709,
+	VIDEO_CS_SRGB,
+};
+
+enum video_range_type {
+	VIDEO_RANGE_DEFAULT,
+	VIDEO_RANGE_PARTIAL,
+	VIDEO_RANGE_FULL,
+};
+
+typedef struct video_output video_t;
+
+struct video_output_info {
+	const char*           name;
+	enum video_format     format;
+	uint32_t              fps_num;
+	uint32_t              fps_den;
+	uint32_t              width;
+	uint32_t              height;
+	size_t                cache_size;
+	enum video_colorspace colorspace;
+	enum video_range_type range;
+};
+
+struct video_scale_info {
+	enum video_format     format;
+	uint32_t              width;
+	uint32_t              height;
+	enum video_range_type range;
+	enum video_colorspace colorspace;
+};
+
+const struct video_output_info* video_output_get_info(const video_t* video);
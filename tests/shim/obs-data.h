@@ -0,0 +1,50 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <stdbool.h>
+
+typedef struct obs_data obs_data_t;
+
+/// Settings are kept in memory only, reading JSON files always fails and writing them always succeeds.
+obs_data_t* obs_data_create(void);
+obs_data_t* obs_data_create_from_json_file(const char* json_file);
+void        obs_data_addref(obs_data_t* data);
+void        obs_data_release(obs_data_t* data);
+bool        obs_data_save_json_safe(obs_data_t* data, const char* file, const char* temp_ext, const char* backup_ext);
+
+bool obs_data_has_user_value(obs_data_t* data, const char* name);
+
+void obs_data_set_string(obs_data_t* data, const char* name, const char* val);
+void obs_data_set_int(obs_data_t* data, const char* name, long long val);
+void obs_data_set_double(obs_data_t* data, const char* name, double val);
+void obs_data_set_bool(obs_data_t* data, const char* name, bool val);
+void obs_data_set_obj(obs_data_t* data, const char* name, obs_data_t* obj);
+
+void obs_data_set_default_string(obs_data_t* data, const char* name, const char* val);
+void obs_data_set_default_int(obs_data_t* data, const char* name, long long val);
+void obs_data_set_default_double(obs_data_t* data, const char* name, double val);
+void obs_data_set_default_bool(obs_data_t* data, const char* name, bool val);
+
+const char* obs_data_get_string(obs_data_t* data, const char* name);
+long long   obs_data_get_int(obs_data_t* data, const char* name);
+double      obs_data_get_double(obs_data_t* data, const char* name);
+bool        obs_data_get_bool(obs_data_t* data, const char* name);
+obs_data_t* obs_data_get_obj(obs_data_t* data, const char* name);
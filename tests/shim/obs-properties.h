@@ -0,0 +1,95 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include "obs-data.h"
+
+typedef struct obs_properties obs_properties_t;
+typedef struct obs_property   obs_property_t;
+
+enum obs_combo_type {
+	OBS_COMBO_TYPE_INVALID,
+	OBS_COMBO_TYPE_EDITABLE,
+	OBS_COMBO_TYPE_LIST,
+};
+
+enum obs_combo_format {
+	OBS_COMBO_FORMAT_INVALID,
+	OBS_COMBO_FORMAT_INT,
+	OBS_COMBO_FORMAT_FLOAT,
+	OBS_COMBO_FORMAT_STRING,
+};
+
+enum obs_text_type {
+	OBS_TEXT_DEFAULT,
+	OBS_TEXT_PASSWORD,
+	OBS_TEXT_MULTILINE,
+};
+
+enum obs_path_type {
+	OBS_PATH_FILE,
+	OBS_PATH_FILE_SAVE,
+	OBS_PATH_DIRECTORY,
+};
+
+enum obs_group_type {
+	OBS_COMBO_INVALID,
+	OBS_GROUP_NORMAL,
+	OBS_GROUP_CHECKABLE,
+};
+
+typedef bool (*obs_property_clicked_t)(obs_properties_t* props, obs_property_t* property, void* data);
+typedef bool (*obs_property_modified_t)(obs_properties_t* props, obs_property_t* property, obs_data_t* settings);
+
+// Properties are not modelled, everything that adds to them gets nothing back, and everything else does nothing.
+obs_properties_t* obs_properties_create(void);
+void              obs_properties_destroy(obs_properties_t* props);
+obs_property_t*   obs_properties_get(obs_properties_t* props, const char* property);
+
+obs_property_t* obs_properties_add_bool(obs_properties_t* props, const char* name, const char* description);
+obs_property_t* obs_properties_add_int(obs_properties_t* props, const char* name, const char* description, int min,
+									   int max, int step);
+obs_property_t* obs_properties_add_int_slider(obs_properties_t* props, const char* name, const char* description,
+											  int min, int max, int step);
+obs_property_t* obs_properties_add_float(obs_properties_t* props, const char* name, const char* description,
+										 double min, double max, double step);
+obs_property_t* obs_properties_add_float_slider(obs_properties_t* props, const char* name, const char* description,
+												double min, double max, double step);
+obs_property_t* obs_properties_add_text(obs_properties_t* props, const char* name, const char* description,
+										enum obs_text_type type);
+obs_property_t* obs_properties_add_path(obs_properties_t* props, const char* name, const char* description,
+										enum obs_path_type type, const char* filter, const char* default_path);
+obs_property_t* obs_properties_add_list(obs_properties_t* props, const char* name, const char* description,
+										enum obs_combo_type type, enum obs_combo_format format);
+obs_property_t* obs_properties_add_button2(obs_properties_t* props, const char* name, const char* text,
+										   obs_property_clicked_t callback, void* priv);
+obs_property_t* obs_properties_add_group(obs_properties_t* props, const char* name, const char* description,
+										 enum obs_group_type type, obs_properties_t* group);
+
+void              obs_property_set_visible(obs_property_t* p, bool visible);
+void              obs_property_set_enabled(obs_property_t* p, bool enabled);
+void              obs_property_set_long_description(obs_property_t* p, const char* long_description);
+void              obs_property_set_modified_callback(obs_property_t* p, obs_property_modified_t modified);
+void              obs_property_int_set_suffix(obs_property_t* p, const char* suffix);
+void              obs_property_float_set_suffix(obs_property_t* p, const char* suffix);
+size_t            obs_property_list_add_int(obs_property_t* p, const char* name, long long val);
+obs_properties_t* obs_property_group_content(obs_property_t* p);
@@ -0,0 +1,104 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Minimal stand-in for libobs, just enough to build parts of StreamFX outside of OBS Studio.
+
+#pragma once
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "obs-config.h"
+#include "callback/calldata.h"
+#include "callback/signal.h"
+#include "util/base.h"
+#include "util/bmem.h"
+#include "graphics/graphics.h"
+#include "graphics/vec2.h"
+#include "graphics/vec3.h"
+#include "graphics/vec4.h"
+#include "media-io/audio-io.h"
+#include "media-io/video-io.h"
+#include "obs-data.h"
+#include "obs-encoder.h"
+#include "obs-properties.h"
+
+typedef struct obs_source       obs_source_t;
+typedef struct obs_weak_source  obs_weak_source_t;
+typedef struct obs_scene        obs_scene_t;
+typedef struct obs_scene_item   obs_sceneitem_t;
+typedef struct obs_weak_encoder obs_weak_encoder_t;
+
+struct obs_video_info {
+	const char*           graphics_module;
+	uint32_t              fps_num;
+	uint32_t              fps_den;
+	uint32_t              base_width;
+	uint32_t              base_height;
+	uint32_t              output_width;
+	uint32_t              output_height;
+	enum video_format     output_format;
+	uint32_t              adapter;
+	bool                  gpu_conversion;
+	enum video_colorspace colorspace;
+	enum video_range_type range;
+};
+
+uint32_t obs_get_version(void);
+
+void obs_enter_graphics(void);
+void obs_leave_graphics(void);
+
+void obs_add_tick_callback(void (*tick)(void* param, float seconds), void* param);
+void obs_remove_tick_callback(void (*tick)(void* param, float seconds), void* param);
+
+obs_source_t* obs_filter_get_target(const obs_source_t* filter);
+void          obs_source_video_render(obs_source_t* source);
+void          obs_source_release(obs_source_t* source);
+void          obs_weak_source_release(obs_weak_source_t* weak);
+void          obs_source_inc_active(obs_source_t* source);
+void          obs_source_dec_active(obs_source_t* source);
+void          obs_source_inc_showing(obs_source_t* source);
+void          obs_source_dec_showing(obs_source_t* source);
+void          obs_scene_release(obs_scene_t* scene);
+void          obs_sceneitem_release(obs_sceneitem_t* item);
+void          obs_sceneitem_remove(obs_sceneitem_t* item);
+
+/// Reports the first video output created through the stand-in, false if there is none.
+bool obs_get_video_info(struct obs_video_info* ovi);
+
+/// The time of the frame being rendered, os_gettime_ns() unless a test set it with shim::set_video_frame_time().
+uint64_t obs_get_video_frame_time(void);
+
+video_t*              obs_encoder_video(const obs_encoder_t* encoder);
+audio_t*              obs_encoder_audio(const obs_encoder_t* encoder);
+enum obs_encoder_type obs_encoder_get_type(const obs_encoder_t* encoder);
+void*                 obs_encoder_get_type_data(obs_encoder_t* encoder);
+uint32_t              obs_encoder_get_width(const obs_encoder_t* encoder);
+uint32_t              obs_encoder_get_height(const obs_encoder_t* encoder);
+bool                  obs_encoder_scaling_enabled(const obs_encoder_t* encoder);
+enum video_format     obs_encoder_get_preferred_video_format(const obs_encoder_t* encoder);
+signal_handler_t*     obs_encoder_get_signal_handler(const obs_encoder_t* encoder);
+void*                 obs_encoder_create_rerouted(obs_encoder_t* encoder, const char* reroute_id);
+void                  obs_encoder_release(obs_encoder_t* encoder);
+obs_weak_encoder_t*   obs_encoder_get_weak_encoder(obs_encoder_t* encoder);
+obs_encoder_t*        obs_weak_encoder_get_encoder(obs_weak_encoder_t* weak);
+void                  obs_weak_encoder_release(obs_weak_encoder_t* weak);
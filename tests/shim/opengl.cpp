@@ -0,0 +1,239 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Textures and staging surfaces as the OpenGL backend of libobs creates them, so that code which talks to OpenGL
+// directly and benchmarks of GPU to CPU transfers see real objects. Mesa provides a software driver that works without
+// a display, which is what this is meant for.
+
+#include "opengl.hpp"
+#include <algorithm>
+
+#define GL_GLEXT_PROTOTYPES
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+namespace {
+	struct format_info {
+		GLenum internal_format;
+		GLenum format;
+		GLenum type;
+	};
+
+	// Same as 'convert_gs_format', 'convert_gs_internal_format' and 'get_gl_format_type' in libobs-opengl.
+	format_info get_format(gs_color_format format)
+	{
+		switch (format) {
+		case GS_A8:
+		case GS_R8:
+			return {GL_R8, GL_RED, GL_UNSIGNED_BYTE};
+		case GS_R8G8:
+			return {GL_RG8, GL_RG, GL_UNSIGNED_BYTE};
+		case GS_RGBA:
+		case GS_RGBA_UNORM:
+			return {GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE};
+		case GS_BGRX:
+		case GS_BGRA:
+		case GS_BGRX_UNORM:
+		case GS_BGRA_UNORM:
+			return {GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE};
+		case GS_R10G10B10A2:
+			return {GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV};
+		case GS_RGBA16:
+			return {GL_RGBA16, GL_RGBA, GL_UNSIGNED_SHORT};
+		case GS_R16:
+			return {GL_R16, GL_RED, GL_UNSIGNED_SHORT};
+		case GS_RG16:
+			return {GL_RG16, GL_RG, GL_UNSIGNED_SHORT};
+		case GS_RGBA16F:
+			return {GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT};
+		case GS_RG16F:
+			return {GL_RG16F, GL_RG, GL_HALF_FLOAT};
+		case GS_R16F:
+			return {GL_R16F, GL_RED, GL_HALF_FLOAT};
+		case GS_RGBA32F:
+			return {GL_RGBA32F, GL_RGBA, GL_FLOAT};
+		case GS_RG32F:
+			return {GL_RG32F, GL_RG, GL_FLOAT};
+		case GS_R32F:
+			return {GL_R32F, GL_RED, GL_FLOAT};
+		default:
+			return {0, 0, 0};
+		}
+	}
+
+	struct context {
+		EGLDisplay display     = EGL_NO_DISPLAY;
+		EGLContext context     = EGL_NO_CONTEXT;
+		GLuint     framebuffer = 0;
+	} state;
+} // namespace
+
+bool streamfx::tests::shim::opengl::initialize()
+{
+	if (state.context != EGL_NO_CONTEXT) {
+		return true;
+	}
+
+	// Prefer a display that needs neither X11 nor Wayland.
+	auto eglGetPlatformDisplayEXT =
+		reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+	if (eglGetPlatformDisplayEXT) {
+		state.display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	}
+	if (state.display == EGL_NO_DISPLAY) {
+		state.display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+	if ((state.display == EGL_NO_DISPLAY) || !eglInitialize(state.display, nullptr, nullptr)
+		|| !eglBindAPI(EGL_OPENGL_API)) {
+		return false;
+	}
+
+	// glCopyImageSubData, which libobs uses for gs_copy_texture_region, needs OpenGL 4.3.
+	const EGLint attributes[] = {EGL_CONTEXT_MAJOR_VERSION,       4, EGL_CONTEXT_MINOR_VERSION, 3,
+								 EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE};
+	state.context = eglCreateContext(state.display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+	if ((state.context == EGL_NO_CONTEXT)
+		|| !eglMakeCurrent(state.display, EGL_NO_SURFACE, EGL_NO_SURFACE, state.context)) {
+		state.context = EGL_NO_CONTEXT;
+		eglTerminate(state.display);
+		return false;
+	}
+
+	glGenFramebuffers(1, &state.framebuffer);
+	return true;
+}
+
+bool streamfx::tests::shim::opengl::active()
+{
+	return state.context != EGL_NO_CONTEXT;
+}
+
+void streamfx::tests::shim::opengl::create_texture(gs_texture* tex, const uint8_t* data)
+{
+	format_info info = get_format(tex->format);
+	if ((tex->type != GS_TEXTURE_2D) || (info.internal_format == 0)) {
+		return;
+	}
+
+	// As in libobs, asking for mip maps without a level count means the full chain.
+	uint32_t levels = tex->levels;
+	if ((levels == 0) || ((tex->flags & GS_BUILD_MIPMAPS) && (levels != 1))) {
+		levels = 1;
+		for (uint32_t size = std::max(tex->width, tex->height); size > 1; size /= 2) {
+			levels++;
+		}
+	}
+
+	glGenTextures(1, &tex->object);
+	glBindTexture(GL_TEXTURE_2D, tex->object);
+	glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(levels), info.internal_format, static_cast<GLsizei>(tex->width),
+				   static_cast<GLsizei>(tex->height));
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels - 1));
+	if (data) {
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, static_cast<GLsizei>(tex->width), static_cast<GLsizei>(tex->height),
+						info.format, info.type, data);
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+	tex->levels = levels;
+}
+
+void streamfx::tests::shim::opengl::destroy_texture(gs_texture* tex)
+{
+	if (tex->object) {
+		glDeleteTextures(1, &tex->object);
+		tex->object = 0;
+	}
+}
+
+void streamfx::tests::shim::opengl::copy_texture_region(gs_texture* dst, uint32_t dst_x, uint32_t dst_y,
+														gs_texture* src, uint32_t src_x, uint32_t src_y,
+														uint32_t width, uint32_t height)
+{
+	if (!dst->object || !src->object) {
+		return;
+	}
+
+	glCopyImageSubData(src->object, GL_TEXTURE_2D, 0, static_cast<GLint>(src_x), static_cast<GLint>(src_y), 0,
+					   dst->object, GL_TEXTURE_2D, 0, static_cast<GLint>(dst_x), static_cast<GLint>(dst_y), 0,
+					   static_cast<GLsizei>(width), static_cast<GLsizei>(height), 1);
+}
+
+void streamfx::tests::shim::opengl::clear(gs_texture* target, const float color[4])
+{
+	if (!target->object) {
+		return;
+	}
+
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, state.framebuffer);
+	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target->object, 0);
+	glViewport(0, 0, static_cast<GLsizei>(target->width), static_cast<GLsizei>(target->height));
+	glClearColor(color[0], color[1], color[2], color[3]);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+}
+
+uint32_t streamfx::tests::shim::opengl::create_stage(uint32_t width, uint32_t height, gs_color_format format)
+{
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+	glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(width) * height * gs_get_format_bpp(format) / 8,
+				 nullptr, GL_DYNAMIC_READ);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	return buffer;
+}
+
+void streamfx::tests::shim::opengl::destroy_stage(uint32_t buffer)
+{
+	glDeleteBuffers(1, &buffer);
+}
+
+void streamfx::tests::shim::opengl::stage(uint32_t buffer, gs_texture* src)
+{
+	format_info info = get_format(src->format);
+	if (!src->object || (info.internal_format == 0)) {
+		return;
+	}
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+	glBindTexture(GL_TEXTURE_2D, src->object);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glGetTexImage(GL_TEXTURE_2D, 0, info.format, info.type, nullptr);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+uint8_t* streamfx::tests::shim::opengl::map(uint32_t buffer)
+{
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+	auto data = static_cast<uint8_t*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	return data;
+}
+
+void streamfx::tests::shim::opengl::unmap(uint32_t buffer)
+{
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+	glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
@@ -0,0 +1,96 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Optional OpenGL storage for the libobs stand-in, on a surfaceless EGL context. Only built if EGL and OpenGL were
+// found, otherwise everything here does nothing and graphics stay on the CPU.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "shim.hpp"
+
+namespace streamfx::tests::shim::opengl {
+#ifdef ST_SHIM_OPENGL
+	/// Create and make current a context, returns false if there is no usable driver.
+	bool initialize();
+
+	/// Whether textures and staging surfaces are backed by OpenGL objects.
+	bool active();
+
+	/// Create the texture object for 'tex' with all its levels, and fill level 0 from 'data' if given.
+	void create_texture(gs_texture* tex, const uint8_t* data);
+
+	void destroy_texture(gs_texture* tex);
+
+	void copy_texture_region(gs_texture* dst, uint32_t dst_x, uint32_t dst_y, gs_texture* src, uint32_t src_x,
+							 uint32_t src_y, uint32_t width, uint32_t height);
+
+	void clear(gs_texture* target, const float color[4]);
+
+	/// Create a pixel pack buffer large enough for a 'width' by 'height' texture, returns its name.
+	uint32_t create_stage(uint32_t width, uint32_t height, gs_color_format format);
+
+	void destroy_stage(uint32_t buffer);
+
+	/// Queue a copy of level 0 of 'src' into 'buffer', without waiting for it.
+	void stage(uint32_t buffer, gs_texture* src);
+
+	/// Map 'buffer' for reading, which waits for the copy queued last.
+	uint8_t* map(uint32_t buffer);
+
+	void unmap(uint32_t buffer);
+#else
+	inline bool initialize()
+	{
+		return false;
+	}
+
+	inline bool active()
+	{
+		return false;
+	}
+
+	inline void create_texture(gs_texture*, const uint8_t*) {}
+
+	inline void destroy_texture(gs_texture*) {}
+
+	inline void copy_texture_region(gs_texture*, uint32_t, uint32_t, gs_texture*, uint32_t, uint32_t, uint32_t,
+									uint32_t)
+	{}
+
+	inline void clear(gs_texture*, const float[4]) {}
+
+	inline uint32_t create_stage(uint32_t, uint32_t, gs_color_format)
+	{
+		return 0;
+	}
+
+	inline void destroy_stage(uint32_t) {}
+
+	inline void stage(uint32_t, gs_texture*) {}
+
+	inline uint8_t* map(uint32_t)
+	{
+		return nullptr;
+	}
+
+	inline void unmap(uint32_t) {}
+#endif
+} // namespace streamfx::tests::shim::opengl
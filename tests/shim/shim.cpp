@@ -0,0 +1,299 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "shim.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <utility>
+
+extern "C" {
+#include "obs-module.h"
+#include "util/platform.h"
+}
+
+struct obs_source {
+	std::function<void()> render;
+	obs_source_t*         target;
+};
+
+namespace {
+	std::vector<streamfx::tests::shim::call>                          call_log;
+	bool                                                              call_log_enabled = true;
+	uint64_t                                                          video_frame_time = 0;
+	std::list<std::pair<void (*)(void* param, float seconds), void*>> tick_callbacks;
+} // namespace
+
+void streamfx::tests::shim::record(std::string_view function, std::string_view argument)
+{
+	if (!call_log_enabled) {
+		return;
+	}
+	call_log.push_back({std::string(function), std::string(argument)});
+}
+
+const std::vector<streamfx::tests::shim::call>& streamfx::tests::shim::calls()
+{
+	return call_log;
+}
+
+void streamfx::tests::shim::set_recording(bool enabled)
+{
+	call_log_enabled = enabled;
+}
+
+void streamfx::tests::shim::clear_calls()
+{
+	call_log.clear();
+}
+
+std::size_t streamfx::tests::shim::count_calls(std::string_view function, std::string_view argument)
+{
+	std::size_t count = 0;
+	for (auto& entry : call_log) {
+		if ((entry.function == function) && (argument.empty() || (entry.argument == argument))) {
+			count++;
+		}
+	}
+	return count;
+}
+
+obs_source_t* streamfx::tests::shim::create_source(std::function<void()> render, obs_source_t* target)
+{
+	return new obs_source{std::move(render), target};
+}
+
+void streamfx::tests::shim::destroy_source(obs_source_t* source)
+{
+	delete source;
+}
+
+void streamfx::tests::shim::tick(float seconds)
+{
+	// Callbacks may remove themselves while being called.
+	auto callbacks = tick_callbacks;
+	for (auto& [callback, param] : callbacks) {
+		callback(param, seconds);
+	}
+}
+
+void streamfx::tests::shim::set_video_frame_time(uint64_t time)
+{
+	video_frame_time = time;
+}
+
+extern "C" void blog(int log_level, const char* format, ...)
+{
+	static const bool verbose = std::getenv("STREAMFX_TESTS_VERBOSE") != nullptr;
+	if ((log_level > LOG_WARNING) && !verbose) {
+		return;
+	}
+
+	char    message[4096];
+	va_list vargs;
+	va_start(vargs, format);
+	std::vsnprintf(message, sizeof(message), format, vargs);
+	va_end(vargs);
+	std::fprintf(stderr, "%s\n", message);
+
+	// Tests look for warnings and errors the code is expected to report.
+	if (log_level <= LOG_WARNING) {
+		streamfx::tests::shim::record("blog", message);
+	}
+}
+
+extern "C" void* bmalloc(size_t size)
+{
+	return std::malloc(size ? size : 1);
+}
+
+extern "C" void* bzalloc(size_t size)
+{
+	return std::calloc(1, size ? size : 1);
+}
+
+extern "C" void* brealloc(void* ptr, size_t size)
+{
+	return std::realloc(ptr, size ? size : 1);
+}
+
+extern "C" void bfree(void* ptr)
+{
+	std::free(ptr);
+}
+
+extern "C" char* bstrdup(const char* str)
+{
+	if (!str) {
+		return nullptr;
+	}
+
+	size_t len  = std::strlen(str);
+	char*  copy = static_cast<char*>(bmalloc(len + 1));
+	std::memcpy(copy, str, len + 1);
+	return copy;
+}
+
+extern "C" uint64_t os_gettime_ns(void)
+{
+	return static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+			.count());
+}
+
+extern "C" uint64_t obs_get_video_frame_time(void)
+{
+	return video_frame_time ? video_frame_time : os_gettime_ns();
+}
+
+extern "C" uint32_t obs_get_version(void)
+{
+	return LIBOBS_API_VER;
+}
+
+extern "C" void obs_enter_graphics(void) {}
+
+extern "C" void obs_leave_graphics(void) {}
+
+extern "C" const char* obs_module_text(const char* lookup_string)
+{
+	return lookup_string;
+}
+
+// Properties are not modelled, code that only adds to them gets nothing to add to.
+extern "C" obs_properties_t* obs_properties_create(void)
+{
+	return nullptr;
+}
+
+extern "C" void obs_properties_destroy(obs_properties_t*) {}
+
+extern "C" obs_property_t* obs_properties_get(obs_properties_t*, const char*)
+{
+	return nullptr;
+}
+
+extern "C" obs_property_t* obs_properties_add_bool(obs_properties_t*, const char*, const char*)
+{
+	return nullptr;
+}
+
+extern "C" obs_property_t* obs_properties_add_int(obs_properties_t*, const char*, const char*, int, int, int)
+{
+	return nullptr;
+}
+
+extern "C" obs_property_t* obs_properties_add_int_slider(obs_properties_t*, const char*, const char*, int, int, int)
+{
+	return nullptr;
+}
+
+extern "C" obs_property_t* obs_properties_add_float(obs_properties_t*, const char*, const char*, double, double,
+													 double)
+{
+	return nullptr;
+}
+
+extern "C" obs_property_t* obs_properties_add_float_slider(obs_properties_t*, const char*, const char*, double, double,
+															double)
+{
+	return nullptr;
+}
+
+extern "C" obs_property_t* obs_properties_add_text(obs_properties_t*, const char*, const char*, enum obs_text_type)
+{
+	return nullptr;
+}
+
+extern "C" obs_property_t* obs_properties_add_path(obs_properties_t*, const char*, const char*, enum obs_path_type,
+													const char*, const char*)
+{
+	return nullptr;
+}
+
+extern "C" obs_property_t* obs_properties_add_list(obs_properties_t*, const char*, const char*, enum obs_combo_type,
+												   enum obs_combo_format)
+{
+	return nullptr;
+}
+
+extern "C" obs_property_t* obs_properties_add_button2(obs_properties_t*, const char*, const char*,
+													   obs_property_clicked_t, void*)
+{
+	return nullptr;
+}
+
+extern "C" obs_property_t* obs_properties_add_group(obs_properties_t*, const char*, const char*, enum obs_group_type,
+													 obs_properties_t*)
+{
+	return nullptr;
+}
+
+extern "C" void obs_property_set_visible(obs_property_t*, bool) {}
+
+extern "C" void obs_property_set_enabled(obs_property_t*, bool) {}
+
+extern "C" void obs_property_set_long_description(obs_property_t*, const char*) {}
+
+extern "C" void obs_property_set_modified_callback(obs_property_t*, obs_property_modified_t) {}
+
+extern "C" void obs_property_int_set_suffix(obs_property_t*, const char*) {}
+
+extern "C" void obs_property_float_set_suffix(obs_property_t*, const char*) {}
+
+extern "C" size_t obs_property_list_add_int(obs_property_t*, const char*, long long)
+{
+	return 0;
+}
+
+extern "C" obs_properties_t* obs_property_group_content(obs_property_t*)
+{
+	return nullptr;
+}
+
+extern "C" int os_stat(const char* file, struct stat* st)
+{
+	return stat(file, st);
+}
+
+extern "C" void obs_add_tick_callback(void (*tick)(void* param, float seconds), void* param)
+{
+	tick_callbacks.emplace_back(tick, param);
+}
+
+extern "C" void obs_remove_tick_callback(void (*tick)(void* param, float seconds), void* param)
+{
+	tick_callbacks.remove(std::make_pair(tick, param));
+}
+
+extern "C" obs_source_t* obs_filter_get_target(const obs_source_t* filter)
+{
+	return filter ? filter->target : nullptr;
+}
+
+extern "C" void obs_source_video_render(obs_source_t* source)
+{
+	streamfx::tests::shim::record("obs_source_video_render");
+	if (source && source->render) {
+		source->render();
+	}
+}
@@ -0,0 +1,124 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Control over the libobs stand-in, for use by tests only.
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+extern "C" {
+#include "obs.h"
+}
+
+struct gs_texture {
+	gs_texture_type      type;
+	uint32_t             width;
+	uint32_t             height;
+	uint32_t             depth;
+	uint32_t             levels;
+	gs_color_format      format;
+	uint32_t             flags;
+	uint32_t             object; // What gs_texture_get_obj() points at.
+	std::vector<uint8_t> data;   // Level 0 only.
+};
+
+namespace streamfx::tests::shim {
+	struct call {
+		std::string function;
+		std::string argument;
+	};
+
+	/// Append a call to the log, with an optional argument that identifies it further. Warnings and errors passed to
+	/// blog() are logged as "blog" with the message.
+	void record(std::string_view function, std::string_view argument = {});
+
+	const std::vector<call>& calls();
+
+	/// Enable or disable the call log, benchmarks disable it so that it doesn't dominate their timings.
+	void set_recording(bool enabled);
+
+	void clear_calls();
+
+	/// Count logged calls of a function, optionally only those with a matching argument.
+	std::size_t count_calls(std::string_view function, std::string_view argument = {});
+
+	/// Create a source, which calls 'render' from obs_source_video_render. Filters are given the source they filter.
+	obs_source_t* create_source(std::function<void()> render, obs_source_t* target = nullptr);
+
+	void destroy_source(obs_source_t* source);
+
+	/// Run all callbacks registered with obs_add_tick_callback.
+	void tick(float seconds);
+
+	/// Change what obs_get_video_frame_time() reports, zero goes back to the current time.
+	void set_video_frame_time(uint64_t time);
+
+	/// The texture of the render target that is currently being rendered to, if any.
+	gs_texture_t* current_render_target();
+
+	/// Change what gs_get_device_type() reports, OpenGL by default.
+	void set_device_type(int type);
+
+	/** Back textures and staging surfaces with OpenGL objects on a surfaceless EGL context, instead of CPU memory.
+	 *
+	 * Only possible if the stand-in was built with EGL, and there is a driver that works without a display.
+	 *
+	 * @return false if OpenGL is not available, in which case everything stays on the CPU.
+	 */
+	bool enable_opengl();
+
+	/// Create a video or audio output for encoders to take their format from. The first video output is the one that
+	/// obs_get_video_info() reports, like the main view of OBS Studio.
+	video_t* create_video(const video_output_info& info);
+
+	void destroy_video(video_t* video);
+
+	audio_t* create_audio(const audio_output_info& info);
+
+	void destroy_audio(audio_t* audio);
+
+	/// Identifiers of every encoder type registered with obs_register_encoder().
+	std::vector<std::string> encoder_types();
+
+	/** Create an encoder of a registered type, like obs_video_encoder_create() and obs_audio_encoder_create() do.
+	 *
+	 * The defaults of the type are added to the settings, which the encoder keeps a reference to. A width and height of
+	 * zero use the size of the video output, anything else has libobs scale to it.
+	 *
+	 * @return nullptr if the type is unknown or refused to create an instance.
+	 */
+	obs_encoder_t* create_encoder(std::string_view id, obs_data_t* settings, video_t* video, audio_t* audio,
+								  uint32_t width = 0, uint32_t height = 0);
+
+	void destroy_encoder(obs_encoder_t* encoder);
+
+	/// The type an encoder was created as, or rerouted to, and the instance it created.
+	const obs_encoder_info* encoder_info(obs_encoder_t* encoder);
+
+	void* encoder_data(obs_encoder_t* encoder);
+
+	/// What the GPU holds for one attribute of a vertex buffer ("points", "normals", "tangents", "colors", "uv0", ...),
+	/// or nullptr if the buffer was created without it.
+	const std::vector<uint8_t>* vertex_buffer_stream(gs_vertbuffer_t* vb, std::string_view name);
+} // namespace streamfx::tests::shim
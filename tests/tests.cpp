@@ -0,0 +1,82 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.hpp"
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace {
+	std::vector<std::pair<const char*, streamfx::tests::test_t>>& registry()
+	{
+		static std::vector<std::pair<const char*, streamfx::tests::test_t>> tests;
+		return tests;
+	}
+} // namespace
+
+streamfx::tests::registration::registration(const char* name, test_t test)
+{
+	registry().emplace_back(name, test);
+}
+
+int streamfx::tests::run(int argc, const char* argv[])
+{
+	int failed  = 0;
+	int passed  = 0;
+	int skipped = 0;
+
+	for (auto& [name, test] : registry()) {
+		bool selected = (argc <= 1);
+		for (int idx = 1; idx < argc; idx++) {
+			selected |= (std::strstr(name, argv[idx]) != nullptr);
+		}
+		if (!selected) {
+			continue;
+		}
+
+		try {
+			test();
+			std::printf("[ OK ] %s\n", name);
+			passed++;
+		} catch (const streamfx::tests::skipped& ex) {
+			std::printf("[SKIP] %s: %s\n", name, ex.what());
+			skipped++;
+		} catch (const std::exception& ex) {
+			std::printf("[FAIL] %s: %s\n", name, ex.what());
+			failed++;
+		} catch (...) {
+			std::printf("[FAIL] %s: Unknown exception.\n", name);
+			failed++;
+		}
+	}
+
+	std::printf("%d passed, %d failed, %d skipped.\n", passed, failed, skipped);
+	if ((failed == 0) && (passed == 0) && (skipped > 0)) {
+		return 77;
+	}
+	return failed;
+}
+
+int main(int argc, const char* argv[])
+{
+	return streamfx::tests::run(argc, argv);
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace streamfx::tests {
+	class failure : public std::runtime_error {
+		public:
+		failure(const char* file, int line, const char* expression)
+			: std::runtime_error(std::string(file) + ":" + std::to_string(line) + ": " + expression)
+		{}
+	};
+
+	/// Thrown by ST_SKIP, for tests that need something which is missing at runtime.
+	class skipped : public std::runtime_error {
+		public:
+		skipped(const char* reason) : std::runtime_error(reason) {}
+	};
+
+	typedef void (*test_t)();
+
+	struct registration {
+		registration(const char* name, test_t test);
+	};
+
+	/** Run all registered tests, or only those whose name contains one of the arguments.
+	 *
+	 * @return The number of failed tests, usable directly as the exit code. 77 if every test was skipped.
+	 */
+	int run(int argc, const char* argv[]);
+} // namespace streamfx::tests
+
+#define ST_TEST(NAME)                                                                                 \
+	static void                                  ST_TEST_##NAME();                                    \
+	static const ::streamfx::tests::registration ST_TEST_REGISTRATION_##NAME(#NAME, &ST_TEST_##NAME); \
+	static void                                  ST_TEST_##NAME()
+
+#define ST_CHECK(EXPRESSION)                                                   \
+	do {                                                                       \
+		if (!(EXPRESSION))                                                     \
+			throw ::streamfx::tests::failure(__FILE__, __LINE__, #EXPRESSION); \
+	} while (false)
+
+#define ST_CHECK_THROWS(EXPRESSION)                                                       \
+	do {                                                                                  \
+		bool thrown = false;                                                              \
+		try {                                                                             \
+			EXPRESSION;                                                                   \
+		} catch (...) {                                                                   \
+			thrown = true;                                                                \
+		}                                                                                 \
+		if (!thrown)                                                                      \
+			throw ::streamfx::tests::failure(__FILE__, __LINE__, "throws: " #EXPRESSION); \
+	} while (false)
+
+#define ST_SKIP(REASON) throw ::streamfx::tests::skipped(REASON)